@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_BENCHMARKS_BASE_H
+#define FTL_BENCHMARKS_BASE_H
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <functional>
+#include <cstddef>
+
+/**
+ * Runs an operation the given number of times.
+ *
+ * Anything the operation computes must be passed to `keep`, or the
+ * optimiser is free to remove the work being measured.
+ */
+using bench_fn = std::function<void(std::size_t)>;
+
+/**
+ * A named operation through FTL, and the hand-written code it is measured
+ * against.
+ *
+ * Both must do the same work, so that the ratio of their times is the
+ * cost (or saving) of going through the library.
+ */
+using bench_t = std::tuple<std::string,bench_fn,bench_fn>;
+
+using bench_set = std::tuple<std::string,std::vector<bench_t>>;
+
+/// Make the optimiser assume that x is read, and may have been changed
+template<typename T>
+inline void keep(const T& x) {
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&x) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &x;
+#endif
+}
+
+#endif
+
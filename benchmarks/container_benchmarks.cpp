@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include <ftl/forward_list.h>
+#include <ftl/view.h>
+#include "container_benchmarks.h"
+
+namespace {
+
+	const int elements = 1000;
+
+	template<typename C>
+	C iota() {
+		C c;
+		auto it = c.before_begin();
+		for(int i = 0; i < elements; ++i) {
+			it = c.insert_after(it, i);
+		}
+
+		return c;
+	}
+
+	template<>
+	std::vector<int> iota() {
+		std::vector<int> v(elements);
+		for(int i = 0; i < elements; ++i) {
+			v[i] = i;
+		}
+
+		return v;
+	}
+
+	template<>
+	std::list<int> iota() {
+		std::list<int> l;
+		for(int i = 0; i < elements; ++i) {
+			l.push_back(i);
+		}
+
+		return l;
+	}
+
+	// Hand-written equivalents of the concept instances, for each container
+	template<typename T>
+	void push(std::vector<T>& c, T x) {
+		c.push_back(x);
+	}
+
+	template<typename T>
+	void push(std::list<T>& c, T x) {
+		c.push_back(x);
+	}
+
+	// Forward lists are built back to front, and reversed once complete
+	template<typename T>
+	void push(std::forward_list<T>& c, T x) {
+		c.push_front(x);
+	}
+
+	template<typename T>
+	void finish(std::vector<T>&) {}
+
+	template<typename T>
+	void finish(std::list<T>&) {}
+
+	template<typename T>
+	void finish(std::forward_list<T>& c) {
+		c.reverse();
+	}
+
+	template<typename T>
+	void prepare(std::vector<T>& c, std::size_t n) {
+		c.reserve(n);
+	}
+
+	template<typename T>
+	void prepare(std::list<T>&, std::size_t) {}
+
+	template<typename T>
+	void prepare(std::forward_list<T>&, std::size_t) {}
+
+	template<typename C>
+	std::vector<bench_t> container_set(const std::string& name) {
+		return {
+			std::make_tuple(
+				"fmap on " + name,
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						auto r = ftl::fmap([](int x){ return x * 3; }, c);
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						C r;
+						prepare(r, elements);
+						for(auto x : c) {
+							push(r, x * 3);
+						}
+						finish(r);
+						keep(r);
+					}
+				})
+			),
+			std::make_tuple(
+				"foldl on " + name,
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(c);
+						auto r = ftl::foldl(
+							[](long acc, int x){ return acc + x; }, 0L, c
+						);
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(c);
+						long r = 0;
+						for(auto x : c) {
+							r += x;
+						}
+						keep(r);
+					}
+				})
+			),
+			std::make_tuple(
+				"concatMap on " + name,
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						auto r = ftl::concatMap(
+							[](int x){ return C{x, -x}; }, c
+						);
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto c = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						C r;
+						prepare(r, 2 * elements);
+						for(auto x : c) {
+							push(r, x);
+							push(r, -x);
+						}
+						finish(r);
+						keep(r);
+					}
+				})
+			),
+			std::make_tuple(
+				"zipWith on " + name,
+				bench_fn([](std::size_t n) {
+					auto c1 = iota<C>();
+					auto c2 = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						auto r = ftl::zipWith(
+							[](int x, int y){ return x * y; }, c1, c2
+						);
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto c1 = iota<C>();
+					auto c2 = iota<C>();
+					for(std::size_t i = 0; i < n; ++i) {
+						C r;
+						prepare(r, elements);
+						auto it1 = c1.begin();
+						auto it2 = c2.begin();
+						for(; it1 != c1.end() && it2 != c2.end(); ++it1, ++it2) {
+							push(r, *it1 * *it2);
+						}
+						finish(r);
+						keep(r);
+					}
+				})
+			)
+		};
+	}
+
+	std::vector<bench_t> all_containers() {
+		std::vector<bench_t> bs;
+		for(auto& b : container_set<std::vector<int>>("vector")) {
+			bs.push_back(std::move(b));
+		}
+		for(auto& b : container_set<std::list<int>>("list")) {
+			bs.push_back(std::move(b));
+		}
+		for(auto& b : container_set<std::forward_list<int>>("forward_list")) {
+			bs.push_back(std::move(b));
+		}
+
+		// Generated views should fold as tightly as the loop they replace
+		bs.push_back(std::make_tuple(
+			std::string("foldl over take(n, iterate)"),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = ftl::foldl(
+						[](unsigned long s, unsigned long x){ return s + x; }, 0UL,
+						ftl::take(elements, ftl::iterate(
+							[](unsigned long x){ return x * 3 + 1; }, i
+						))
+					);
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					unsigned long r = 0, x = i;
+					for(int j = 0; j < elements; ++j) {
+						r += x;
+						x = x * 3 + 1;
+					}
+					keep(r);
+				}
+			})
+		));
+
+		return bs;
+	}
+}
+
+bench_set container_benchmarks{
+	std::string("containers"),
+	all_containers()
+};
+
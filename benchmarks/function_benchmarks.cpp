@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/function.h>
+#include "function_benchmarks.h"
+
+namespace {
+
+	// Fits in the inline buffer of both ftl::function and std::function
+	struct small {
+		int k;
+
+		int operator() (int x) const {
+			return x + k;
+		}
+	};
+
+	// Too large for either to store in place
+	struct large {
+		int k[16];
+
+		int operator() (int x) const {
+			return x + k[x & 15];
+		}
+	};
+
+	static_assert(
+		sizeof(small) <= ftl::function<int(int)>::inline_size,
+		"small should be stored in place"
+	);
+
+	static_assert(
+		sizeof(large) > ftl::function<int(int)>::inline_size,
+		"large should be stored on the heap"
+	);
+
+	template<typename F>
+	std::vector<bench_t> callable_set(const std::string& name, F f) {
+		return {
+			std::make_tuple(
+				"construct " + name,
+				bench_fn([f](std::size_t n) {
+					for(std::size_t i = 0; i < n; ++i) {
+						ftl::function<int(int)> g(f);
+						keep(g);
+					}
+				}),
+				bench_fn([f](std::size_t n) {
+					for(std::size_t i = 0; i < n; ++i) {
+						std::function<int(int)> g(f);
+						keep(g);
+					}
+				})
+			),
+			std::make_tuple(
+				"call " + name,
+				bench_fn([f](std::size_t n) {
+					ftl::function<int(int)> g(f);
+					int r = 0;
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(g);
+						r += g(int(i));
+					}
+					keep(r);
+				}),
+				bench_fn([f](std::size_t n) {
+					std::function<int(int)> g(f);
+					int r = 0;
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(g);
+						r += g(int(i));
+					}
+					keep(r);
+				})
+			)
+		};
+	}
+
+	std::vector<bench_t> all_callables() {
+		std::vector<bench_t> bs;
+		for(auto& b : callable_set("inline function", small{3})) {
+			bs.push_back(std::move(b));
+		}
+		for(auto& b : callable_set("heap function", large{{3}})) {
+			bs.push_back(std::move(b));
+		}
+
+		// What a call costs with no type erasure at all
+		bs.push_back(std::make_tuple(
+			std::string("call function_ref"),
+			bench_fn([](std::size_t n) {
+				small f{3};
+				ftl::function_ref<int(int)> g(f);
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(g);
+					r += g(int(i));
+				}
+				keep(r);
+			}),
+			bench_fn([](std::size_t n) {
+				small f{3};
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(f);
+					r += f(int(i));
+				}
+				keep(r);
+			})
+		));
+
+		return bs;
+	}
+}
+
+bench_set function_benchmarks{
+	std::string("function"),
+	all_callables()
+};
+
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <future>
+#include <ftl/future.h>
+#include "future_benchmarks.h"
+
+namespace {
+
+	const int stages = 4;
+
+	int step(int x) {
+		return x + 1;
+	}
+
+	/*
+	 * The standard library has no continuations, so the baseline for a
+	 * chain hands each value on through a promise and future of its own.
+	 */
+	int std_chain(int x) {
+		for(int i = 0; i < stages; ++i) {
+			std::promise<int> p;
+			auto f = p.get_future();
+			p.set_value(step(x));
+			x = f.get();
+		}
+
+		return x;
+	}
+}
+
+bench_set future_benchmarks{
+	std::string("future"),
+	{
+		std::make_tuple(
+			std::string("chain on a ready future"),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = ftl::make_ready_future(int(i))
+						.then(step)
+						.then(step)
+						.then(step)
+						.then(step)
+						.get();
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = std_chain(int(i));
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("chain built before the value"),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::promise<int> p;
+					auto f = p.get_future()
+						.then(step)
+						.then(step)
+						.then(step)
+						.then(step);
+					p.set_value(int(i));
+					auto r = f.get();
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					std::promise<int> p;
+					auto f = p.get_future();
+					p.set_value(int(i));
+					auto r = std_chain(f.get());
+					keep(r);
+				}
+			})
+		)
+	}
+};
+
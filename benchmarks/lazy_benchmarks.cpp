@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <memory>
+#include <ftl/lazy.h>
+#include "lazy_benchmarks.h"
+
+namespace {
+
+	// A thunk memoised by hand, shared the same way a lazy value is
+	struct memo {
+		int (*f)(int);
+		int arg;
+		bool ready;
+		int value;
+
+		int force() {
+			if(!ready) {
+				value = f(arg);
+				ready = true;
+			}
+
+			return value;
+		}
+	};
+
+	int triple(int x) {
+		return x * 3;
+	}
+}
+
+bench_set lazy_benchmarks{
+	std::string("lazy"),
+	{
+		std::make_tuple(
+			std::string("create and force"),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					int x = int(i);
+					ftl::lazy<int> l([x](){ return triple(x); });
+					keep(*l);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					auto m = std::make_shared<memo>(
+						memo{triple, int(i), false, 0}
+					);
+					keep(m->force());
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("force when already evaluated"),
+			bench_fn([](std::size_t n) {
+				ftl::lazy<int> l([](){ return triple(7); });
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(l);
+					r += *l;
+				}
+				keep(r);
+			}),
+			bench_fn([](std::size_t n) {
+				auto m = std::make_shared<memo>(memo{triple, 7, false, 0});
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(m);
+					r += m->force();
+				}
+				keep(r);
+			})
+		)
+	}
+};
+
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include "base.h"
+#include "container_benchmarks.h"
+#include "sum_type_benchmarks.h"
+#include "function_benchmarks.h"
+#include "lazy_benchmarks.h"
+#include "future_benchmarks.h"
+#include "parser_benchmarks.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// Runs of a benchmark should last at least this long to be timed reliably
+static const std::chrono::nanoseconds min_run = std::chrono::milliseconds(20);
+
+static double time_run(const bench_fn& f, std::size_t n) {
+	auto t0 = bench_clock::now();
+	f(n);
+	auto t1 = bench_clock::now();
+
+	return std::chrono::duration<double,std::nano>(t1 - t0).count();
+}
+
+// Nanoseconds per iteration of f, the best of a few calibrated runs
+static double ns_per_op(const bench_fn& f) {
+	std::size_t n = 1;
+	while(time_run(f, n) < min_run.count() && n < (std::size_t(1) << 40)) {
+		n *= 2;
+	}
+
+	double best = time_run(f, n);
+	for(int i = 0; i < 4; ++i) {
+		best = std::min(best, time_run(f, n));
+	}
+
+	return best / double(n);
+}
+
+void run_bench_set(bench_set& bs, const std::string& filter) {
+	std::cout << "Running benchmark set '" << std::get<0>(bs) << "'"
+		<< std::endl;
+
+	for(auto& b : std::get<1>(bs)) {
+		auto& name = std::get<0>(b);
+		if(name.find(filter) == std::string::npos)
+			continue;
+
+		auto ftl = ns_per_op(std::get<1>(b));
+		auto base = ns_per_op(std::get<2>(b));
+
+		std::cout << "  " << std::left << std::setw(44) << name
+			<< std::right << std::fixed << std::setprecision(1)
+			<< std::setw(12) << ftl << " ns"
+			<< std::setw(12) << base << " ns"
+			<< std::setprecision(2)
+			<< std::setw(8) << ftl / base << "x" << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	// Only run benchmarks whose names contain the argument, if any
+	std::string filter = argc > 1 ? argv[1] : "";
+
+	std::cout << "  " << std::left << std::setw(44) << "benchmark"
+		<< std::right << std::setw(15) << "ftl"
+		<< std::setw(15) << "baseline"
+		<< std::setw(9) << "ratio" << std::endl;
+
+	run_bench_set(container_benchmarks, filter);
+	run_bench_set(sum_type_benchmarks, filter);
+	run_bench_set(function_benchmarks, filter);
+	run_bench_set(lazy_benchmarks, filter);
+	run_bench_set(future_benchmarks, filter);
+	run_bench_set(parser_benchmarks, filter);
+
+	return 0;
+}
+
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <sstream>
+#include <ftl/executor.h>
+#include "../examples/parser_combinator/parser_combinator.h"
+#include "../examples/parser_combinator/buffer_parser.h"
+#include "../examples/parser_combinator/records.h"
+#include "parser_benchmarks.h"
+
+namespace {
+
+	const int digits = 4096;
+	const int lines = 1024;
+
+	std::string number() {
+		std::string s;
+		for(int i = 0; i < digits; ++i) {
+			s.push_back(char('0' + i % 10));
+		}
+
+		return s;
+	}
+
+	// Lines of "<number>,<text>"
+	std::string records() {
+		std::string s;
+		for(int i = 0; i < lines; ++i) {
+			s += std::to_string(i * 7919) + ",some text\n";
+		}
+
+		return s;
+	}
+
+	int to_int(const char* first, const char* last) {
+		int x = 0;
+		for(; first != last; ++first) {
+			x = x * 10 + (*first - '0');
+		}
+
+		return x;
+	}
+
+	bool is_digit(char c) {
+		return c >= '0' && c <= '9';
+	}
+}
+
+bench_set parser_benchmarks{
+	std::string("parser combinator example"),
+	{
+		std::make_tuple(
+			std::string("stream parser: many1 digits"),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				auto p = many1(oneOf("0123456789"));
+				for(std::size_t i = 0; i < n; ++i) {
+					std::istringstream is(s);
+					auto r = run(p, is);
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				for(std::size_t i = 0; i < n; ++i) {
+					std::istringstream is(s);
+					std::string r;
+					while(is_digit(char(is.peek()))) {
+						r.push_back(char(is.get()));
+					}
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("buffer parser: many1 digits"),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				auto p = buffer::many1(buffer::oneOf("0123456789"));
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(s);
+					auto r = run(p, s);
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(s);
+					auto e = s.data();
+					while(e != s.data() + s.size() && is_digit(*e)) {
+						++e;
+					}
+					slice r(s.data(), e);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("buffer parser: takeWhile1 digits"),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				auto p = buffer::takeWhile1(char_class("0123456789"));
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(s);
+					auto r = run(p, s);
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				auto s = number();
+				for(std::size_t i = 0; i < n; ++i) {
+					keep(s);
+					auto e = s.data();
+					while(e != s.data() + s.size() && is_digit(*e)) {
+						++e;
+					}
+					slice r(s.data(), e);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("parse_records: leading numbers"),
+			bench_fn([](std::size_t n) {
+				using ftl::operator%;
+
+				auto s = records();
+				auto p = [](slice x){ return to_int(x.begin(), x.end()); }
+					% buffer::takeWhile1(char_class("0123456789"));
+				ftl::inline_executor ex;
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = parse_records(ex, p, s);
+					keep(r);
+				}
+			}),
+			bench_fn([](std::size_t n) {
+				auto s = records();
+				for(std::size_t i = 0; i < n; ++i) {
+					std::vector<int> r;
+					auto b = s.data();
+					auto last = s.data() + s.size();
+					while(b != last) {
+						auto e = static_cast<const char*>(
+							std::memchr(b, '\n', std::size_t(last - b))
+						);
+						if(!e)
+							e = last;
+
+						auto d = b;
+						while(d != e && is_digit(*d)) {
+							++d;
+						}
+						r.push_back(to_int(b, d));
+						b = e == last ? e : e + 1;
+					}
+					keep(r);
+				}
+			})
+		)
+	}
+};
+
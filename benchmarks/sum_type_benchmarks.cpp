@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/sum_type.h>
+#include "sum_type_benchmarks.h"
+
+namespace {
+
+	const int elements = 1024;
+
+	// Distinct alternatives, all with the same payload
+	template<int I>
+	struct alt {
+		int x;
+	};
+
+	struct payload {
+		template<int I>
+		int operator() (const alt<I>& a) const {
+			return a.x + I;
+		}
+	};
+
+	// Match requires a clause per alternative
+	template<typename>
+	using clause = payload;
+
+	template<typename...Ts>
+	int match_one(const ftl::sum_type<Ts...>& x) {
+		return x.match(clause<Ts>()...);
+	}
+
+	// What a sum type amounts to, written out by hand
+	struct tagged {
+		int tag;
+		union {
+			int i;
+			double d;
+		};
+	};
+
+	template<typename>
+	struct width;
+
+	template<typename...Ts>
+	struct width<ftl::sum_type<Ts...>>
+	: std::integral_constant<int,sizeof...(Ts)> {};
+
+	template<typename S, int I>
+	struct fill {
+		static void at(std::vector<S>& v, int i) {
+			if(i % width<S>::value == I) {
+				v.emplace_back(ftl::constructor<alt<I>>(), alt<I>{i});
+			}
+			else {
+				fill<S,I-1>::at(v, i);
+			}
+		}
+	};
+
+	template<typename S>
+	struct fill<S,-1> {
+		static void at(std::vector<S>&, int) {}
+	};
+
+	template<typename S>
+	std::vector<S> values() {
+		std::vector<S> v;
+		v.reserve(elements);
+		for(int i = 0; i < elements; ++i) {
+			fill<S,width<S>::value-1>::at(v, i);
+		}
+
+		return v;
+	}
+
+	std::vector<tagged> tagged_values(int width) {
+		std::vector<tagged> v(elements);
+		for(int i = 0; i < elements; ++i) {
+			v[i].tag = i % width;
+			v[i].i = i;
+		}
+
+		return v;
+	}
+
+	int match_tagged(const tagged& t) {
+		switch(t.tag) {
+		case 0: return t.i;
+		case 1: return t.i + 1;
+		case 2: return t.i + 2;
+		case 3: return t.i + 3;
+		case 4: return t.i + 4;
+		case 5: return t.i + 5;
+		case 6: return t.i + 6;
+		default: return t.i + 7;
+		}
+	}
+
+	template<typename S>
+	std::vector<bench_t> width_set(const std::string& name) {
+		return {
+			std::make_tuple(
+				"match " + name,
+				bench_fn([](std::size_t n) {
+					auto v = values<S>();
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(v);
+						int r = 0;
+						for(auto& x : v) {
+							r += match_one(x);
+						}
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto v = tagged_values(width<S>::value);
+					for(std::size_t i = 0; i < n; ++i) {
+						keep(v);
+						int r = 0;
+						for(auto& x : v) {
+							r += match_tagged(x);
+						}
+						keep(r);
+					}
+				})
+			),
+			std::make_tuple(
+				"copy " + name,
+				bench_fn([](std::size_t n) {
+					auto v = values<S>();
+					for(std::size_t i = 0; i < n; ++i) {
+						auto r = v;
+						keep(r);
+					}
+				}),
+				bench_fn([](std::size_t n) {
+					auto v = tagged_values(width<S>::value);
+					for(std::size_t i = 0; i < n; ++i) {
+						auto r = v;
+						keep(r);
+					}
+				})
+			)
+		};
+	}
+
+	std::vector<bench_t> all_widths() {
+		using sum2 = ftl::sum_type<alt<0>,alt<1>>;
+		using sum4 = ftl::sum_type<alt<0>,alt<1>,alt<2>,alt<3>>;
+		using sum8 = ftl::sum_type<
+			alt<0>,alt<1>,alt<2>,alt<3>,alt<4>,alt<5>,alt<6>,alt<7>
+		>;
+
+		std::vector<bench_t> bs;
+		for(auto& b : width_set<sum2>("sum_type of 2")) {
+			bs.push_back(std::move(b));
+		}
+		for(auto& b : width_set<sum4>("sum_type of 4")) {
+			bs.push_back(std::move(b));
+		}
+		for(auto& b : width_set<sum8>("sum_type of 8")) {
+			bs.push_back(std::move(b));
+		}
+
+		return bs;
+	}
+}
+
+bench_set sum_type_benchmarks{
+	std::string("sum_type"),
+	all_widths()
+};
+
@@ -0,0 +1,108 @@
+#include "buffer_parser.h"
+
+using namespace ftl;
+
+namespace buffer {
+	buffer_parser<char> anyChar() {
+		return buffer_parser<char>([](cursor& c) {
+			if(c.pos != c.last)
+				return yield(*c.pos++);
+
+			return fail<char>(error::kind::any_char, c);
+		});
+	}
+
+	buffer_parser<char> parseChar(char ch) {
+		return buffer_parser<char>([ch](cursor& c) {
+			if(c.pos != c.last && *c.pos == ch) {
+				++c.pos;
+				return yield(ch);
+			}
+
+			return fail<char>(error::kind::is_char, c, ch);
+		});
+	}
+
+	buffer_parser<char> notChar(char ch) {
+		return buffer_parser<char>([ch](cursor& c) {
+			if(c.pos != c.last && *c.pos != ch)
+				return yield(*c.pos++);
+
+			return fail<char>(error::kind::not_char, c, ch);
+		});
+	}
+
+	buffer_parser<char> oneOf(const char* str) {
+		return satisfy(char_class(str));
+	}
+
+	buffer_parser<char> satisfy(char_class cs) {
+		return buffer_parser<char>([cs](cursor& c) {
+			if(c.pos != c.last && cs.contains(*c.pos))
+				return yield(*c.pos++);
+
+			return fail<char>(error::kind::one_of, c, 0, cs.chars());
+		});
+	}
+
+	buffer_parser<slice> takeWhile(char_class cs) {
+		return buffer_parser<slice>([cs](cursor& c) {
+			const char* start = c.pos;
+			c.pos = cs.span(c.pos, c.last);
+
+			// The run might go on in input yet to come
+			c.starved = c.starved || c.pos == c.last;
+			return yield(slice(start, c.pos));
+		});
+	}
+
+	buffer_parser<slice> takeWhile1(char_class cs) {
+		return buffer_parser<slice>([cs](cursor& c) {
+			const char* start = c.pos;
+			c.pos = cs.span(c.pos, c.last);
+			if(c.pos == start)
+				return fail<slice>(error::kind::one_of, c, 0, cs.chars());
+
+			c.starved = c.starved || c.pos == c.last;
+			return yield(slice(start, c.pos));
+		});
+	}
+
+	buffer_parser<std::size_t> skipWhile(char_class cs) {
+		return buffer_parser<std::size_t>([cs](cursor& c) {
+			const char* start = c.pos;
+			c.pos = cs.span(c.pos, c.last);
+			c.starved = c.starved || c.pos == c.last;
+			return yield(std::size_t(c.pos - start));
+		});
+	}
+
+	// Runs p for as long as it succeeds, and stops where its last success did
+	static const char* skipMany(const buffer_parser<char>& p, cursor& c) {
+		const char* mark = c.pos;
+		while((*p)(c).template is<Right<char>>()) {
+			mark = c.pos;
+		}
+
+		c.pos = mark;
+		return mark;
+	}
+
+	buffer_parser<slice> many(buffer_parser<char> p) {
+		return buffer_parser<slice>([p](cursor& c) {
+			const char* start = c.pos;
+			return yield(slice(start, skipMany(p, c)));
+		});
+	}
+
+	buffer_parser<slice> many1(buffer_parser<char> p) {
+		return buffer_parser<slice>([p](cursor& c) {
+			const char* start = c.pos;
+			auto r = (*p)(c);
+			if(r.template is<Left<error>>())
+				return make_left<slice>(*get<Left<error>>(r));
+
+			return yield(slice(start, skipMany(p, c)));
+		});
+	}
+}
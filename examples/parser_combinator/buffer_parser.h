@@ -0,0 +1,347 @@
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+#include <unordered_map>
+#include <ftl/arena.h>
+#include "parser_combinator.h"
+#include "char_class.h"
+
+#ifndef BUFFER_PARSER_H
+#define BUFFER_PARSER_H
+
+class memo_table;
+
+/**
+ * Position of a parser in a contiguous buffer of input.
+ *
+ * Parsing from memory rather than from a `std::istream` spares every
+ * character a virtual call and a sentry, and lets parsers return pieces of
+ * the input as they are, instead of copying them into fresh strings.
+ */
+struct cursor {
+	/// Start of the input, from which error positions are counted
+	const char* first;
+
+	/// Next character to be parsed
+	const char* pos;
+
+	/// One past the end of the input
+	const char* last;
+
+	/// Results of rules already run, if parsing in packrat mode
+	memo_table* memo;
+
+	/// Whether more input may follow last, when parsing incrementally
+	bool more;
+
+	/// Whether a parser failed for want of input since this was reset
+	bool starved;
+};
+
+/**
+ * A piece of the input of a buffer parser.
+ *
+ * Refers to the buffer being parsed, which must thus outlive it.
+ */
+class slice {
+public:
+	constexpr slice() noexcept = default;
+
+	constexpr slice(const char* first, const char* last) noexcept
+	: b(first), n(std::size_t(last - first)) {}
+
+	const char* begin() const noexcept {
+		return b;
+	}
+
+	const char* end() const noexcept {
+		return b + n;
+	}
+
+	std::size_t size() const noexcept {
+		return n;
+	}
+
+	bool empty() const noexcept {
+		return n == 0;
+	}
+
+	char operator[] (std::size_t i) const noexcept {
+		return b[i];
+	}
+
+	/// Copy out the characters of the slice
+	std::string str() const {
+		return std::string(b, n);
+	}
+
+	friend bool operator== (const slice& s1, const slice& s2) noexcept {
+		return s1.n == s2.n && std::equal(s1.begin(), s1.end(), s2.begin());
+	}
+
+	friend bool operator!= (const slice& s1, const slice& s2) noexcept {
+		return !(s1 == s2);
+	}
+
+private:
+	const char* b = nullptr;
+	std::size_t n = 0;
+};
+
+/**
+ * Convenience function to reduce template gibberish
+ *
+ * Failing at the end of the input marks c as starved, as the parser might
+ * have succeeded given more of it.
+ */
+template<typename T>
+ftl::either<error,T> fail(
+		error::kind k, cursor& c, char ch = 0, const char* chars = nullptr
+) {
+	c.starved = c.starved || c.pos == c.last;
+	return ftl::make_left<T>(error(k, c.pos - c.first, ch, chars));
+}
+
+/**
+ * A parser of Ts, over a buffer in memory.
+ *
+ * Has the same concepts as `parser`, and is built from the primitives in
+ * namespace `buffer`, which mirror the ones for streams.
+ */
+template<typename T>
+using buffer_parser = ftl::eitherT<error,ftl::function<T(cursor&)>>;
+
+/**
+ * Results of the rules of one parse, for packrat parsing.
+ *
+ * When a parse is run with a memo table, every rule made by
+ * `buffer::lazy` runs at most once per input position. Further attempts
+ * at the same position, after backtracking, reuse the result and skip
+ * ahead to where it ended. Grammars that backtrack over shared prefixes
+ * thus take linear rather than exponential time.
+ *
+ * Results are kept in an `ftl::arena`, and all released at once when the
+ * next parse starts, or when the table is destroyed.
+ */
+class memo_table {
+public:
+	memo_table() = default;
+	memo_table(const memo_table&) = delete;
+	memo_table& operator= (const memo_table&) = delete;
+
+	~memo_table() {
+		clear();
+	}
+
+	/// Forget all results, and reset the statistics
+	void clear() noexcept {
+		for(auto& kv : entries) {
+			kv.second.destroy(kv.second.value);
+		}
+
+		entries.clear();
+		store.release();
+		nlookups = nhits = 0;
+	}
+
+	/// Number of times a rule was about to be run
+	std::size_t lookups() const noexcept {
+		return nlookups;
+	}
+
+	/// Number of times a rule's result was reused instead
+	std::size_t hits() const noexcept {
+		return nhits;
+	}
+
+	/// Fraction of lookups that were hits
+	double hit_rate() const noexcept {
+		return nlookups ? double(nhits) / double(nlookups) : 0.;
+	}
+
+	/// Result of rule at c, running it with parse if it has not yet been
+	template<typename R, typename F>
+	R memoise(void (*rule)(), cursor& c, const F& parse) {
+		++nlookups;
+
+		auto it = entries.find(key{rule, c.pos});
+		if(it != entries.end()) {
+			++nhits;
+			c.pos = it->second.end;
+			return *static_cast<const R*>(it->second.value);
+		}
+
+		const char* start = c.pos;
+		R r = parse(c);
+
+		void* value = new (store.allocate(sizeof(R), alignof(R))) R(r);
+		entries.emplace(key{rule, start}, entry{value, c.pos, &destroy<R>});
+
+		return r;
+	}
+
+private:
+	struct key {
+		void (*rule)();
+		const char* pos;
+
+		bool operator== (const key& k) const noexcept {
+			return rule == k.rule && pos == k.pos;
+		}
+	};
+
+	struct key_hash {
+		std::size_t operator() (const key& k) const noexcept {
+			auto h = std::hash<const char*>()(k.pos);
+			return h ^ (reinterpret_cast<std::uintptr_t>(k.rule) + (h << 6));
+		}
+	};
+
+	struct entry {
+		void* value;
+		const char* end;
+		void (*destroy)(void*);
+	};
+
+	template<typename R>
+	static void destroy(void* p) noexcept {
+		static_cast<R*>(p)->~R();
+	}
+
+	std::unordered_map<key,entry,key_hash> entries;
+	ftl::arena store;
+	std::size_t nlookups = 0;
+	std::size_t nhits = 0;
+};
+
+/**
+ * Run a buffer parser over the characters in `[first, last)`.
+ */
+template<typename T>
+ftl::either<error,T> run(buffer_parser<T> p, const char* first, const char* last) {
+	cursor c{first, first, last, nullptr, false, false};
+	return (*p)(c);
+}
+
+/// \overload
+template<typename T>
+ftl::either<error,T> run(buffer_parser<T> p, const std::string& s) {
+	return run(std::move(p), s.data(), s.data() + s.size());
+}
+
+/**
+ * Run a buffer parser in packrat mode, memoising rules in memo.
+ *
+ * Anything memo held from an earlier parse is cleared first. Its
+ * statistics are those of this parse, once it returns.
+ */
+template<typename T>
+ftl::either<error,T> run(
+		buffer_parser<T> p, const char* first, const char* last, memo_table& memo
+) {
+	memo.clear();
+	cursor c{first, first, last, &memo, false, false};
+	return (*p)(c);
+}
+
+/// \overload
+template<typename T>
+ftl::either<error,T> run(
+		buffer_parser<T> p, const std::string& s, memo_table& memo) {
+	return run(std::move(p), s.data(), s.data() + s.size(), memo);
+}
+
+namespace buffer {
+	/// Parses any one character
+	buffer_parser<char> anyChar();
+
+	/// Parses one specific character
+	buffer_parser<char> parseChar(char c);
+
+	/// Parses any character except c
+	buffer_parser<char> notChar(char c);
+
+	/**
+	 * Parses one of the characters in str.
+	 *
+	 * As for `::oneOf`, str must have static storage duration.
+	 */
+	buffer_parser<char> oneOf(const char* str);
+
+	/// Parses one character in cs
+	buffer_parser<char> satisfy(char_class cs);
+
+	/**
+	 * Parses the longest run of characters in cs, which may be empty.
+	 *
+	 * Equivalent to `many(satisfy(cs))`, but scans the input in one go,
+	 * instead of calling a parser per character.
+	 */
+	buffer_parser<slice> takeWhile(char_class cs);
+
+	/// As `takeWhile`, but fails unless the run has at least one character
+	buffer_parser<slice> takeWhile1(char_class cs);
+
+	/// As `takeWhile`, but only counts the characters in the run
+	buffer_parser<std::size_t> skipWhile(char_class cs);
+
+	/**
+	 * Greedily parses 0 or more of p, and returns the input they span.
+	 *
+	 * Unlike its stream counterpart, any input that the last, failed, run
+	 * of p consumed is given back.
+	 */
+	buffer_parser<slice> many(buffer_parser<char> p);
+
+	/**
+	 * Greedily parses 1 or more of p, and returns the input they span.
+	 *
+	 * This parser will fail if the first attempt at parsing p fails.
+	 */
+	buffer_parser<slice> many1(buffer_parser<char> p);
+
+	/**
+	 * Run p, giving back any input it consumed if it fails.
+	 *
+	 * Alternatives do not backtrack by themselves, as in Parsec. With
+	 * `attempt`, the next alternative starts where p did, which is what
+	 * makes memoising rules with `lazy` pay off.
+	 */
+	template<typename T>
+	buffer_parser<T> attempt(buffer_parser<T> p) {
+		return buffer_parser<T>([p](cursor& c) {
+			const char* start = c.pos;
+			auto r = (*p)(c);
+			if(r.template is<ftl::Left<error>>())
+				c.pos = start;
+
+			return r;
+		});
+	}
+
+	/**
+	 * Lazily run the parser generated by f
+	 *
+	 * This is the rule of packrat mode: run with a `memo_table`, f's parser
+	 * is only generated and run once per input position.
+	 */
+	template<typename T>
+	buffer_parser<T> lazy(buffer_parser<T>(*f)()) {
+		return buffer_parser<T>([f](cursor& c) {
+			auto parse = [f](cursor& c) {
+				return (*f())(c);
+			};
+
+			if(!c.memo)
+				return parse(c);
+
+			return c.memo->template memoise<ftl::either<error,T>>(
+				reinterpret_cast<void (*)()>(f), c, parse
+			);
+		});
+	}
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+/**
+ * A set of characters, for parsers to test input against.
+ *
+ * Membership is a lookup in a 256 bit bitmap, rather than a search
+ * through the characters of the set. Runs of members are found by `span`,
+ * which compares 16 bytes at a time with SSE4.2 when the set is small
+ * enough and the build allows it (e.g. `-msse4.2`).
+ */
+class char_class {
+public:
+	/**
+	 * The set of the characters in chars.
+	 *
+	 * chars must have static storage duration, e.g. be a string literal,
+	 * as it also describes the set in errors.
+	 */
+	explicit char_class(const char* chars) noexcept : desc(chars) {
+		std::size_t n = std::strlen(chars);
+		for(std::size_t i = 0; i < n; ++i) {
+			auto u = static_cast<unsigned char>(chars[i]);
+			bits[u >> 6] |= std::uint64_t(1) << (u & 63);
+		}
+
+		if(n <= sizeof(small)) {
+			nsmall = int(n);
+			std::memcpy(small, chars, n);
+		}
+	}
+
+	bool contains(char c) const noexcept {
+		auto u = static_cast<unsigned char>(c);
+		return (bits[u >> 6] >> (u & 63)) & 1;
+	}
+
+	/// The first character in `[first, last)` not in the set, or last
+	const char* span(const char* first, const char* last) const noexcept {
+#if defined(__SSE4_2__)
+		if(nsmall >= 0) {
+			const __m128i set = _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(small)
+			);
+
+			while(last - first >= 16) {
+				const __m128i in = _mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(first)
+				);
+
+				int i = _mm_cmpestri(
+					set, nsmall, in, 16,
+					_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY
+					| _SIDD_NEGATIVE_POLARITY
+				);
+
+				if(i < 16)
+					return first + i;
+
+				first += 16;
+			}
+		}
+#endif
+		while(first != last && contains(*first))
+			++first;
+
+		return first;
+	}
+
+	/// The characters the set was made from
+	const char* chars() const noexcept {
+		return desc;
+	}
+
+private:
+	std::uint64_t bits[4] = {0, 0, 0, 0};
+	const char* desc;
+
+	// The set as a string, if short enough to compare in one go
+	char small[16] = {};
+	int nsmall = -1;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include <string>
+#include <utility>
+#include "buffer_parser.h"
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+/**
+ * Runs a buffer parser over input that arrives in chunks.
+ *
+ * Each chunk is parsed in place, for as many whole messages as it holds.
+ * When a parser runs out of input before it is done, it is not failed.
+ * Instead, the unparsed rest of the chunk is held back until the next one
+ * arrives, and the message is parsed again from its start. Only input of
+ * messages that straddle chunks is ever copied.
+ *
+ * Results may refer to the input, as slices do. Those parsed from a chunk
+ * are valid for as long as the chunk is, while those parsed from held back
+ * input are valid until the next call to `feed` or `finish`.
+ *
+ * \par Examples
+ *
+ * \code
+ *   incremental<message> in(parseMessage());
+ *   while(auto n = read(sock, buf, sizeof(buf))) {
+ *       in.feed(buf, buf + n, [](ftl::either<error,message> m) {
+ *           // Handle a message, or a parse error
+ *       });
+ *   }
+ *   in.finish(handler);
+ * \endcode
+ */
+template<typename T>
+class incremental {
+public:
+	explicit incremental(buffer_parser<T> p) : p(std::move(p)) {}
+
+	/**
+	 * Parse the next chunk of input.
+	 *
+	 * Calls `f` with the result of every message that the input so far
+	 * completes. After a parse error, the rest of the input is dropped.
+	 */
+	template<typename F>
+	void feed(const char* first, const char* last, F&& f) {
+		if(held.empty()) {
+			parse(first, last, true, f);
+		}
+		else {
+			held.append(first, last);
+			parse_held(true, f);
+		}
+	}
+
+	/**
+	 * Signal the end of the input.
+	 *
+	 * Parses what has been held back, knowing that no more input is coming.
+	 */
+	template<typename F>
+	void finish(F&& f) {
+		if(!held.empty())
+			parse_held(false, f);
+
+		held.clear();
+	}
+
+	/// Number of bytes held back, waiting for more input
+	std::size_t pending() const noexcept {
+		return held.size();
+	}
+
+private:
+	template<typename F>
+	void parse_held(bool more, F& f) {
+		std::string input;
+		input.swap(held);
+		parse(input.data(), input.data() + input.size(), more, f);
+	}
+
+	template<typename F>
+	void parse(const char* first, const char* last, bool more, F& f) {
+		cursor c{first, first, last, nullptr, more, false};
+
+		while(c.pos != last) {
+			const char* start = c.pos;
+			c.starved = false;
+
+			auto r = (*p)(c);
+			if(more && c.starved) {
+				held.assign(start, last);
+				return;
+			}
+
+			bool failed = r.template is<ftl::Left<error>>();
+			f(std::move(r));
+
+			// Parsers that consume nothing would match forever
+			if(failed || c.pos == start)
+				return;
+		}
+	}
+
+	buffer_parser<T> p;
+	std::string held;
+};
+
+#endif
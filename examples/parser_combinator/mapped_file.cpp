@@ -0,0 +1,125 @@
+#include "mapped_file.h"
+#include <system_error>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+static std::system_error last_error(const std::string& what) {
+	return std::system_error(
+		int(GetLastError()), std::system_category(), what
+	);
+}
+
+mapped_file::mapped_file(const std::string& path) {
+	HANDLE file = CreateFileA(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+	);
+	if(file == INVALID_HANDLE_VALUE)
+		throw last_error("Could not open " + path);
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size)) {
+		auto e = last_error("Could not get the size of " + path);
+		CloseHandle(file);
+		throw e;
+	}
+
+	// Empty files cannot be mapped, nor do they need to be
+	if(size.QuadPart == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(
+		file, nullptr, PAGE_READONLY, 0, 0, nullptr
+	);
+	CloseHandle(file);
+	if(!mapping)
+		throw last_error("Could not map " + path);
+
+	// The view keeps the mapping alive on its own
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!view)
+		throw last_error("Could not map " + path);
+
+	p = static_cast<const char*>(view);
+	n = std::size_t(size.QuadPart);
+}
+
+void mapped_file::unmap() noexcept {
+	if(p)
+		UnmapViewOfFile(p);
+}
+
+#else
+
+static std::system_error last_error(const std::string& what) {
+	return std::system_error(errno, std::system_category(), what);
+}
+
+mapped_file::mapped_file(const std::string& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw last_error("Could not open " + path);
+
+	struct stat st;
+	if(::fstat(fd, &st) != 0) {
+		auto e = last_error("Could not get the size of " + path);
+		::close(fd);
+		throw e;
+	}
+
+	// Empty files cannot be mapped, nor do they need to be
+	if(st.st_size == 0) {
+		::close(fd);
+		return;
+	}
+
+	// The mapping outlives the descriptor
+	void* addr = ::mmap(
+		nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0
+	);
+	::close(fd);
+	if(addr == MAP_FAILED)
+		throw last_error("Could not map " + path);
+
+	// Parsers go through their input front to back
+	::madvise(addr, std::size_t(st.st_size), MADV_SEQUENTIAL);
+
+	p = static_cast<const char*>(addr);
+	n = std::size_t(st.st_size);
+}
+
+void mapped_file::unmap() noexcept {
+	if(p)
+		::munmap(const_cast<char*>(p), n);
+}
+
+#endif
+
+mapped_file::~mapped_file() {
+	unmap();
+}
+
+mapped_file& mapped_file::operator= (mapped_file&& f) noexcept {
+	if(this != &f) {
+		unmap();
+		p = f.p;
+		n = f.n;
+		f.p = nullptr;
+		f.n = 0;
+	}
+
+	return *this;
+}
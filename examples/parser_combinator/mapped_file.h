@@ -0,0 +1,77 @@
+#include <string>
+#include <cstddef>
+#include "buffer_parser.h"
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/**
+ * A file mapped read-only into memory.
+ *
+ * Buffer parsers run over its contents in place, so that input is paged in
+ * from the file as it is parsed, rather than copied into the heap. Slices
+ * parsed out of a mapped file are valid for as long as the mapping is.
+ *
+ * Uses `mmap` on POSIX systems and `MapViewOfFile` on Windows.
+ */
+class mapped_file {
+public:
+	/**
+	 * Map the file at path.
+	 *
+	 * \throws std::system_error if the file cannot be opened or mapped.
+	 */
+	explicit mapped_file(const std::string& path);
+
+	mapped_file(const mapped_file&) = delete;
+
+	mapped_file(mapped_file&& f) noexcept : p(f.p), n(f.n) {
+		f.p = nullptr;
+		f.n = 0;
+	}
+
+	~mapped_file();
+
+	mapped_file& operator= (const mapped_file&) = delete;
+
+	mapped_file& operator= (mapped_file&& f) noexcept;
+
+	const char* data() const noexcept {
+		return p;
+	}
+
+	std::size_t size() const noexcept {
+		return n;
+	}
+
+	const char* begin() const noexcept {
+		return p;
+	}
+
+	const char* end() const noexcept {
+		return p + n;
+	}
+
+private:
+	void unmap() noexcept;
+
+	const char* p = nullptr;
+	std::size_t n = 0;
+};
+
+/**
+ * Run a buffer parser over the contents of a mapped file.
+ */
+template<typename T>
+ftl::either<error,T> run(buffer_parser<T> p, const mapped_file& f) {
+	return run(std::move(p), f.begin(), f.end());
+}
+
+/// \overload
+template<typename T>
+ftl::either<error,T> run(
+		buffer_parser<T> p, const mapped_file& f, memo_table& memo) {
+	return run(std::move(p), f.begin(), f.end(), memo);
+}
+
+#endif
@@ -1,8 +1,40 @@
 #include "parser_combinator.h" 
+#include "char_class.h"
 #include <sstream>
 
 using namespace ftl;
 
+std::string error::message() const {
+	std::ostringstream oss;
+	for(unsigned i = 0; i < n; ++i) {
+		if(i > 0)
+			oss << " or ";
+
+		switch(alts[i].k) {
+		case kind::any_char:
+			oss << "any character";
+			break;
+
+		case kind::is_char:
+			oss << "'" << alts[i].c << "'";
+			break;
+
+		case kind::not_char:
+			oss << "any character but '" << alts[i].c << "'";
+			break;
+
+		case kind::one_of:
+			oss << "one of \"" << alts[i].chars << "\"";
+			break;
+		}
+	}
+
+	if(truncated)
+		oss << " or ...";
+
+	return oss.str();
+}
+
 parser<char> anyChar() {
 	return parser<char>([](std::istream& s) {
 		char ch;
@@ -10,7 +42,7 @@ parser<char> anyChar() {
 			return yield(ch);
 		}
 
-		return fail<char>("any character");
+		return fail<char>(error::kind::any_char, s);
 	});
 }
 
@@ -25,9 +57,7 @@ parser<char> parseChar(char c) {
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "'" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(error::kind::is_char, s, c);
 	}};
 }
 
@@ -41,26 +71,23 @@ parser<char> notChar(char c) {
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "any character but '" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(error::kind::not_char, s, c);
 	});
 }
 
-parser<char> oneOf(std::string str) {
-	return parser<char>{[str](std::istream& s) {
+parser<char> oneOf(const char* str) {
+	char_class cs(str);
+	return parser<char>{[cs](std::istream& s) {
 		if(s) {
-			char peek = s.peek();
-			auto pos = str.find(peek);
-			if(pos != std::string::npos) {
+			auto peek = s.peek();
+			if(peek != std::istream::traits_type::eof()
+					&& cs.contains(char(peek))) {
 				s.get();
-				return yield(peek);
+				return yield(char(peek));
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "one of \"" << str << "\"";
-		return fail<char>(oss.str());
+		return fail<char>(error::kind::one_of, s, 0, cs.chars());
 	}};
 }
 
@@ -7,41 +7,85 @@
 
 /**
  * Error reporting class.
- * 
- * We could have used a string directly, but this thin wrapper conveys more
- * semantic information to users of the library.
+ *
+ * Failing is the common case in grammars with many alternatives, so an
+ * error is a small, trivially copyable record of what was expected, and
+ * where. The message is only put together when someone asks for it.
+ *
+ * Errors from alternatives that got equally far are combined, up to
+ * `capacity` of them. Otherwise, the one that got the furthest wins.
  */
 class error {
 public:
-	// Default versions of c-tors default, copy, and move are acceptable
+	/// What kind of input a failed parser expected
+	enum class kind : unsigned char {
+		any_char, is_char, not_char, one_of
+	};
 
-	/// Construct from string error message
-	explicit error(const std::string& msg) noexcept : e(msg) {}
-	explicit error(std::string&& msg) noexcept : e(std::move(msg)) {}
+	static constexpr unsigned capacity = 4;
+
+	/// The identity: no expectation at all
+	constexpr error() noexcept = default;
+
+	/**
+	 * Construct from an expectation.
+	 *
+	 * \param chars the set of a `kind::one_of`. Must have static storage
+	 *              duration, e.g. be a string literal.
+	 */
+	error(kind k, std::streamoff where, char c = 0, const char* chars = nullptr)
+	noexcept : n(1), pos(where) {
+		alts[0] = expectation{k, c, chars};
+	}
 
-	/// Access the error message
-	std::string message() const noexcept {
-		return e;
+	/// Position in the stream where the failure happened
+	std::streamoff where() const noexcept {
+		return pos;
 	}
 
+	/// Build the error message
+	std::string message() const;
+
+	friend struct ftl::monoid<error>;
+
 private:
-	std::string e;
+	struct expectation {
+		kind k;
+		char c;
+		const char* chars;
+	};
+
+	expectation alts[capacity] = {};
+	unsigned char n = 0;
+	bool truncated = false;
+	std::streamoff pos = -1;
 };
 
 namespace ftl {
 	template<>
 	struct monoid<error> {
-		static error id() {
-			return error(std::string(""));
+		static error id() noexcept {
+			return error();
 		}
 
-		static error append(const error& e1, const error& e2) {
-			if(e1.message().empty())
-				return error(e2.message());
-			if(e2.message().empty())
-				return error(e1.message());
+		static error append(const error& e1, const error& e2) noexcept {
+			if(e1.n == 0 || e2.pos > e1.pos)
+				return e2;
+			if(e2.n == 0 || e1.pos > e2.pos)
+				return e1;
+
+			error e = e1;
+			for(unsigned i = 0; i < e2.n; ++i) {
+				if(e.n == error::capacity) {
+					e.truncated = true;
+					break;
+				}
+
+				e.alts[e.n++] = e2.alts[i];
+			}
+			e.truncated = e.truncated || e2.truncated;
 
-			return error(e1.message() + " or " + e2.message());
+			return e;
 		}
 
 		static constexpr bool instance = true;
@@ -50,8 +94,12 @@ namespace ftl {
 
 /// Convenience function to reduce template gibberish
 template<typename T>
-ftl::either<error,T> fail(const std::string& s) {
-	return ftl::make_left<T>(error(s));
+ftl::either<error,T> fail(
+		error::kind k, std::istream& s, char c = 0, const char* chars = nullptr
+) {
+	// tellg would set the failbit of a stream at its end
+	std::streamoff where = s.good() ? std::streamoff(s.tellg()) : -1;
+	return ftl::make_left<T>(error(k, where, c, chars));
 }
 
 /// Convenience function to reduce template gibberish
@@ -111,9 +159,10 @@ parser<char> notChar(char c);
  * Parses one of the characters in str.
  *
  * This parser will fail if the next character in the stream does not appear
- * in str.
+ * in str. As it ends up in errors, str must have static storage duration,
+ * e.g. be a string literal.
  */
-parser<char> oneOf(std::string str);
+parser<char> oneOf(const char* str);
 
 /**
  * Greedily parses 0 or more of p.
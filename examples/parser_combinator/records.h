@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <ftl/parallel.h>
+#include "buffer_parser.h"
+#include "mapped_file.h"
+
+#ifndef RECORDS_H
+#define RECORDS_H
+
+/**
+ * Parse every delimited record in `[first, last)`, in parallel.
+ *
+ * The input is split at each occurrence of delim, and each record between
+ * two delimiters is parsed on its own, by tasks on ex. The delimiters are
+ * not part of any record, and a delimiter at the very end of the input
+ * does not start an empty one. Suits newline separated formats such as
+ * CSV or JSON lines, where no record may contain the delimiter.
+ *
+ * Results are in the order of the records. As with `run`, a record that
+ * p does not consume completely is not an error. Error positions are
+ * counted from first, not from the start of the record.
+ *
+ * p may be run concurrently, so it must not be run in packrat mode, nor
+ * refer to any state that it modifies.
+ *
+ * \tparam Executor must satisfy \ref executorpg
+ *
+ * \par Examples
+ *
+ * \code
+ *   ftl::thread_pool pool;
+ *   mapped_file f("access.log");
+ *   for(auto& r : parse_records(pool, parseLine(), f)) {
+ *       // Handle a line, or a parse error
+ *   }
+ * \endcode
+ */
+template<typename Executor, typename T>
+std::vector<ftl::either<error,T>> parse_records(
+		Executor& ex, buffer_parser<T> p,
+		const char* first, const char* last, char delim = '\n'
+) {
+	std::vector<slice> records;
+	for(auto b = first; b != last;) {
+		auto e = static_cast<const char*>(std::memchr(b, delim, last - b));
+		if(!e) {
+			records.emplace_back(b, last);
+			break;
+		}
+
+		records.emplace_back(b, e);
+		b = e + 1;
+	}
+
+	return ftl::par_fmap(ex, [&](const slice& r) {
+		cursor c{first, r.begin(), r.end(), nullptr, false, false};
+		return (*p)(c);
+	}, records);
+}
+
+/// \overload
+template<typename Executor, typename T>
+std::vector<ftl::either<error,T>> parse_records(
+		Executor& ex, buffer_parser<T> p, const std::string& s,
+		char delim = '\n'
+) {
+	return parse_records(ex, std::move(p), s.data(), s.data() + s.size(), delim);
+}
+
+/// \overload
+template<typename Executor, typename T>
+std::vector<ftl::either<error,T>> parse_records(
+		Executor& ex, buffer_parser<T> p, const mapped_file& f,
+		char delim = '\n'
+) {
+	return parse_records(ex, std::move(p), f.begin(), f.end(), delim);
+}
+
+#endif
+
@@ -0,0 +1,279 @@
+#include <utility>
+#include "buffer_parser.h"
+
+#ifndef STATIC_PARSER_H
+#define STATIC_PARSER_H
+
+/**
+ * Statically typed parser combinators.
+ *
+ * A `buffer_parser` erases the type of every parser behind an
+ * `ftl::function`, so parsers combined from it call each other
+ * indirectly and cannot be inlined into one another. The parsers in this
+ * namespace instead each have a type of their own, which `>>`, `<<`, `|`
+ * and `fmap` compose into the type of the whole expression. The compiler
+ * thus sees, and can inline, all of a rule.
+ *
+ * They behave just like their `buffer_parser` counterparts, and convert to
+ * them with `erase`, e.g. at the boundaries of rules or where a grammar
+ * recurses. `ref` goes the other way.
+ *
+ * \par Examples
+ *
+ * \code
+ *   char_class alpha("abcdefghijklmnopqrstuvwxyz");
+ *   auto word = sp::take_while1(alpha) << sp::skip_while(char_class(" "));
+ *   buffer_parser<slice> rule = sp::erase(word);
+ * \endcode
+ */
+namespace sp {
+	/**
+	 * Base of all static parsers.
+	 *
+	 * A static parser P has a `value_type`, and a call operator taking a
+	 * `cursor&` and returning an `ftl::either<error,value_type>`.
+	 */
+	template<typename P>
+	struct expr {
+		const P& self() const noexcept {
+			return static_cast<const P&>(*this);
+		}
+	};
+
+	/// Parses one specific character
+	struct char_ : expr<char_> {
+		using value_type = char;
+
+		explicit char_(char c) noexcept : c(c) {}
+
+		ftl::either<error,char> operator() (cursor& cur) const {
+			if(cur.pos != cur.last && *cur.pos == c) {
+				++cur.pos;
+				return yield(c);
+			}
+
+			return fail<char>(error::kind::is_char, cur, c);
+		}
+
+		char c;
+	};
+
+	inline char_ ch(char c) noexcept {
+		return char_(c);
+	}
+
+	/// Parses one character in a class
+	struct satisfy_ : expr<satisfy_> {
+		using value_type = char;
+
+		explicit satisfy_(char_class cs) noexcept : cs(cs) {}
+
+		ftl::either<error,char> operator() (cursor& c) const {
+			if(c.pos != c.last && cs.contains(*c.pos))
+				return yield(*c.pos++);
+
+			return fail<char>(error::kind::one_of, c, 0, cs.chars());
+		}
+
+		char_class cs;
+	};
+
+	inline satisfy_ satisfy(char_class cs) noexcept {
+		return satisfy_(cs);
+	}
+
+	/// str must have static storage duration
+	inline satisfy_ one_of(const char* str) noexcept {
+		return satisfy_(char_class(str));
+	}
+
+	/// Parses a run of characters in a class, at least Min of them
+	template<unsigned Min>
+	struct take_while_ : expr<take_while_<Min>> {
+		using value_type = slice;
+
+		explicit take_while_(char_class cs) noexcept : cs(cs) {}
+
+		ftl::either<error,slice> operator() (cursor& c) const {
+			const char* start = c.pos;
+			c.pos = cs.span(c.pos, c.last);
+			if(Min > 0 && c.pos == start)
+				return fail<slice>(error::kind::one_of, c, 0, cs.chars());
+
+			c.starved = c.starved || c.pos == c.last;
+			return yield(slice(start, c.pos));
+		}
+
+		char_class cs;
+	};
+
+	inline take_while_<0> take_while(char_class cs) noexcept {
+		return take_while_<0>(cs);
+	}
+
+	inline take_while_<1> take_while1(char_class cs) noexcept {
+		return take_while_<1>(cs);
+	}
+
+	/// Skips a run of characters in a class, and counts them
+	struct skip_while_ : expr<skip_while_> {
+		using value_type = std::size_t;
+
+		explicit skip_while_(char_class cs) noexcept : cs(cs) {}
+
+		ftl::either<error,std::size_t> operator() (cursor& c) const {
+			const char* start = c.pos;
+			c.pos = cs.span(c.pos, c.last);
+			c.starved = c.starved || c.pos == c.last;
+			return yield(std::size_t(c.pos - start));
+		}
+
+		char_class cs;
+	};
+
+	inline skip_while_ skip_while(char_class cs) noexcept {
+		return skip_while_(cs);
+	}
+
+	/// a >> b
+	template<typename A, typename B>
+	struct then_ : expr<then_<A,B>> {
+		using value_type = typename B::value_type;
+
+		then_(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+		ftl::either<error,value_type> operator() (cursor& c) const {
+			auto r = a(c);
+			if(r.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(std::move(*ftl::get<0>(r)));
+
+			return b(c);
+		}
+
+		A a;
+		B b;
+	};
+
+	/// a << b
+	template<typename A, typename B>
+	struct skip_ : expr<skip_<A,B>> {
+		using value_type = typename A::value_type;
+
+		skip_(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+		ftl::either<error,value_type> operator() (cursor& c) const {
+			auto r = a(c);
+			if(r.template is<ftl::Left<error>>())
+				return r;
+
+			auto r2 = b(c);
+			if(r2.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(std::move(*ftl::get<0>(r2)));
+
+			return r;
+		}
+
+		A a;
+		B b;
+	};
+
+	/// a | b
+	template<typename A, typename B>
+	struct alt_ : expr<alt_<A,B>> {
+		using value_type = typename A::value_type;
+
+		alt_(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+		ftl::either<error,value_type> operator() (cursor& c) const {
+			auto r = a(c);
+			if(r.template is<ftl::Right<value_type>>())
+				return r;
+
+			auto r2 = b(c);
+			if(r2.template is<ftl::Right<value_type>>())
+				return r2;
+
+			return ftl::make_left<value_type>(ftl::monoid<error>::append(
+				*ftl::get<0>(r), *ftl::get<0>(r2)
+			));
+		}
+
+		A a;
+		B b;
+	};
+
+	/// fmap(f, a)
+	template<typename F, typename A>
+	struct map_ : expr<map_<F,A>> {
+		using value_type = ftl::result_of<F(typename A::value_type)>;
+
+		map_(F f, A a) : f(std::move(f)), a(std::move(a)) {}
+
+		ftl::either<error,value_type> operator() (cursor& c) const {
+			auto r = a(c);
+			if(r.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(std::move(*ftl::get<0>(r)));
+
+			return yield(f(std::move(*ftl::get<1>(r))));
+		}
+
+		F f;
+		A a;
+	};
+
+	/// An erased parser, for use in static expressions
+	template<typename T>
+	struct ref_ : expr<ref_<T>> {
+		using value_type = T;
+
+		explicit ref_(buffer_parser<T> p) : p(std::move(p)) {}
+
+		ftl::either<error,T> operator() (cursor& c) const {
+			return (*p)(c);
+		}
+
+		buffer_parser<T> p;
+	};
+
+	template<typename T>
+	ref_<T> ref(buffer_parser<T> p) {
+		return ref_<T>(std::move(p));
+	}
+
+	template<typename A, typename B>
+	then_<A,B> operator>> (const expr<A>& a, const expr<B>& b) {
+		return then_<A,B>(a.self(), b.self());
+	}
+
+	template<typename A, typename B>
+	skip_<A,B> operator<< (const expr<A>& a, const expr<B>& b) {
+		return skip_<A,B>(a.self(), b.self());
+	}
+
+	template<
+			typename A,
+			typename B,
+			typename = ftl::Requires<
+				std::is_same<typename A::value_type, typename B::value_type>::value
+			>
+	>
+	alt_<A,B> operator| (const expr<A>& a, const expr<B>& b) {
+		return alt_<A,B>(a.self(), b.self());
+	}
+
+	template<typename F, typename A>
+	map_<ftl::plain_type<F>,A> fmap(F&& f, const expr<A>& a) {
+		return map_<ftl::plain_type<F>,A>(std::forward<F>(f), a.self());
+	}
+
+	/// Type erase a static parser, e.g. to end a rule
+	template<typename P>
+	buffer_parser<typename P::value_type> erase(const expr<P>& p) {
+		const P& q = p.self();
+		return buffer_parser<typename P::value_type>([q](cursor& c) {
+			return q(c);
+		});
+	}
+}
+
+#endif
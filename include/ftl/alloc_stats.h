@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_ALLOC_STATS_H
+#define FTL_ALLOC_STATS_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace ftl {
+	/**
+	 * \defgroup alloc_stats Allocation Statistics
+	 *
+	 * Optional per thread counts of the allocations FTL makes.
+	 *
+	 * \code
+	 *   #include <ftl/alloc_stats.h>
+	 * \endcode
+	 *
+	 * Defining `FTL_ALLOC_STATS` (which must then be the case in every
+	 * translation unit of the program) has the library count, for each
+	 * thread, the allocations made by:
+	 * - `ftl::function`, for function objects not stored in place
+	 * - `ftl::lazy`, for the shared state of each computation
+	 * - the `std::shared_ptr` instances, for each new result
+	 * - `fmap`, `concatMap` and `zipWith` on `std::vector`, `std::list` and
+	 *   `std::forward_list`, for the storage of each new result
+	 *
+	 * Meant for tests asserting that some code path does not allocate, and
+	 * for exporting to metrics. Without the macro, nothing is counted and
+	 * none of the below is declared.
+	 *
+	 * Allocations through a user supplied allocator are counted as well, as
+	 * are those of function objects given to `ftl::function` that allocate
+	 * themselves, but not those of user functions called by a combinator.
+	 * The storage of a result vector counts as one allocation, that of a
+	 * result list as one per element. Combinators reusing a temporary
+	 * argument for their result count nothing, nor do list nodes spliced
+	 * into a result from lists returned by a user function.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::reset_alloc_stats();
+	 *   auto r = ftl::fmap(f, v);
+	 *   assert(ftl::alloc_stats().container == 1);
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<cstddef>`
+	 * - `<iterator>`
+	 * - `<utility>`
+	 */
+
+#ifdef FTL_ALLOC_STATS
+	/**
+	 * Allocations made by the calling thread.
+	 *
+	 * Only available if `FTL_ALLOC_STATS` is defined.
+	 *
+	 * \see alloc_stats
+	 *
+	 * \ingroup alloc_stats
+	 */
+	struct allocation_statistics {
+		/// Function objects stored on the heap by `ftl::function`
+		size_t function;
+
+		/// Shared states of lazy computations
+		size_t lazy;
+
+		/// Results of the `std::shared_ptr` concept instances
+		size_t shared_ptr;
+
+		/// Storage of containers built by combinators
+		size_t container;
+	};
+#endif
+
+	namespace _dtl {
+		enum class alloc_site {
+			function,
+			lazy,
+			shared_ptr,
+			container
+		};
+
+#ifdef FTL_ALLOC_STATS
+		inline allocation_statistics& alloc_stats_counters() noexcept {
+			static thread_local allocation_statistics counters{0, 0, 0, 0};
+			return counters;
+		}
+
+		inline void note_alloc(alloc_site s, size_t n = 1) noexcept {
+			auto& c = alloc_stats_counters();
+			switch(s) {
+			case alloc_site::function: c.function += n; break;
+			case alloc_site::lazy: c.lazy += n; break;
+			case alloc_site::shared_ptr: c.shared_ptr += n; break;
+			case alloc_site::container: c.container += n; break;
+			}
+		}
+
+		// Contiguous containers hold all elements in one block
+		template<typename C>
+		auto container_allocs(const C& c, int)
+		-> decltype(size_t(c.capacity())) {
+			return c.capacity() ? 1 : 0;
+		}
+
+		// Node based ones, one per element
+		template<typename C>
+		size_t container_allocs(const C& c, long) {
+			using std::begin;
+			using std::end;
+
+			return size_t(std::distance(begin(c), end(c)));
+		}
+
+		template<typename C>
+		void note_container_alloc(const C& c) noexcept {
+			note_alloc(alloc_site::container, container_allocs(c, 0));
+		}
+#else
+		inline void note_alloc(alloc_site, size_t = 1) noexcept {}
+
+		template<typename C>
+		void note_container_alloc(const C&) noexcept {}
+#endif
+	}
+
+#ifdef FTL_ALLOC_STATS
+	/**
+	 * Get the allocations made by the calling thread so far.
+	 *
+	 * Counts start from zero when a thread starts, or when it last called
+	 * `reset_alloc_stats()`.
+	 *
+	 * \ingroup alloc_stats
+	 */
+	inline allocation_statistics alloc_stats() noexcept {
+		return _dtl::alloc_stats_counters();
+	}
+
+	/**
+	 * Set the counts of the calling thread back to zero.
+	 *
+	 * \ingroup alloc_stats
+	 */
+	inline void reset_alloc_stats() noexcept {
+		_dtl::alloc_stats_counters() = allocation_statistics{0, 0, 0, 0};
+	}
+#endif
+
+}
+
+#endif
+
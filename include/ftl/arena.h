@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_ARENA_H
+#define FTL_ARENA_H
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ftl {
+
+	/**
+	 * \defgroup arena Arena
+	 *
+	 * Monotonic arena allocation for short lived containers.
+	 *
+	 * \code
+	 *   #include <ftl/arena.h>
+	 * \endcode
+	 *
+	 * Containers using `ftl::arena_allocator` take their memory from the
+	 * innermost `ftl::arena_scope` of the current thread. As the container
+	 * instances of FTL rebind the allocator of their argument (see e.g.
+	 * `parametric_type_traits<std::vector<T,A>>`), every intermediate
+	 * container made by `fmap`, `concatMap`, `zipWith`, and so on, is
+	 * allocated from the same arena, and all of it is released at once
+	 * when the arena is.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename T>
+	 *   using avector = std::vector<T, ftl::arena_allocator<T>>;
+	 *
+	 *   ftl::arena a;
+	 *   int total;
+	 *   {
+	 *       ftl::arena_scope scope(a);
+	 *       avector<int> v{1,2,3};
+	 *       auto w = ftl::fmap([](int x){ return x*2; }, v);
+	 *       total = ftl::foldl([](int x, int y){ return x+y; }, 0, w);
+	 *   }
+	 *   a.release(); // Frees v and w, total == 12
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<memory>`
+	 */
+
+	/**
+	 * Monotonic memory resource.
+	 *
+	 * Memory is handed out from large chunks, by bumping a pointer.
+	 * Deallocating does nothing; everything allocated is returned at once by
+	 * `release`, or when the arena is destroyed. Any container still using
+	 * the arena at that point is left dangling.
+	 *
+	 * An arena may only be used from one thread at a time.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 *
+	 * \ingroup arena
+	 */
+	class arena {
+	public:
+		/// Size of the chunks requested from the heap, unless specified.
+		static constexpr std::size_t default_chunk = 4096;
+
+		explicit arena(std::size_t chunk_size = default_chunk) noexcept
+		: chunk_size(chunk_size) {}
+
+		arena(const arena&) = delete;
+		arena& operator= (const arena&) = delete;
+
+		~arena() {
+			release();
+		}
+
+		/// Allocate `n` bytes, aligned to `align`.
+		void* allocate(std::size_t n, std::size_t align) {
+			auto p = bump(n, align);
+			if(p)
+				return p;
+
+			grow(n + align);
+			return bump(n, align);
+		}
+
+		/// Free all memory allocated from the arena.
+		void release() noexcept {
+			while(head) {
+				auto next = head->next;
+				::operator delete(head);
+				head = next;
+			}
+
+			cur = end = nullptr;
+			allocated = 0;
+		}
+
+		/// Total number of bytes handed out since the last `release`.
+		std::size_t used() const noexcept {
+			return allocated;
+		}
+
+		/**
+		 * The innermost arena put in scope by this thread.
+		 *
+		 * If there is no `arena_scope` active, `nullptr`.
+		 */
+		static arena* current() noexcept {
+			return current_ref();
+		}
+
+	private:
+		friend class arena_scope;
+
+		struct chunk {
+			chunk* next;
+		};
+
+		static arena*& current_ref() noexcept {
+			static thread_local arena* a = nullptr;
+			return a;
+		}
+
+		void* bump(std::size_t n, std::size_t align) noexcept {
+			if(!cur)
+				return nullptr;
+
+			auto p = reinterpret_cast<std::uintptr_t>(cur);
+			auto a = (p + align - 1) & ~std::uintptr_t(align - 1);
+			if(a + n > reinterpret_cast<std::uintptr_t>(end))
+				return nullptr;
+
+			cur = reinterpret_cast<char*>(a + n);
+			allocated += n;
+			return reinterpret_cast<void*>(a);
+		}
+
+		void grow(std::size_t n) {
+			auto size = sizeof(chunk) + (n > chunk_size ? n : chunk_size);
+			auto c = static_cast<chunk*>(::operator new(size));
+
+			c->next = head;
+			head = c;
+			cur = reinterpret_cast<char*>(c + 1);
+			end = reinterpret_cast<char*>(c) + size;
+
+			// Grow geometrically, so large workloads need few chunks
+			if(chunk_size < (std::size_t(1) << 20))
+				chunk_size *= 2;
+		}
+
+		chunk* head = nullptr;
+		char* cur = nullptr;
+		char* end = nullptr;
+		std::size_t chunk_size;
+		std::size_t allocated = 0;
+	};
+
+	/**
+	 * Makes an arena the current one of this thread, for its lifetime.
+	 *
+	 * Scopes nest: when one ends, the arena that was current before it
+	 * becomes current again.
+	 *
+	 * \ingroup arena
+	 */
+	class arena_scope {
+	public:
+		explicit arena_scope(arena& a) noexcept
+		: previous(arena::current_ref()) {
+			arena::current_ref() = &a;
+		}
+
+		arena_scope(const arena_scope&) = delete;
+		arena_scope& operator= (const arena_scope&) = delete;
+
+		~arena_scope() {
+			arena::current_ref() = previous;
+		}
+
+	private:
+		arena* previous;
+	};
+
+	/**
+	 * Allocator taking its memory from an `ftl::arena`.
+	 *
+	 * A default constructed `arena_allocator` uses whatever arena is
+	 * current at the time, or the global heap if there is none. Containers
+	 * created without an explicit allocator, such as the results of the
+	 * FTL container instances, thereby end up in the current arena.
+	 *
+	 * Copying a container selects the current arena anew, rather than the
+	 * one of the original. A result can thus be copied out of an arena that
+	 * is about to be released, simply by copying it outside any scope.
+	 *
+	 * Two allocators compare equal if they use the same arena (or both use
+	 * the heap), which is what e.g. `std::list::splice` requires.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref copycons
+	 * - \ref eq
+	 *
+	 * \ingroup arena
+	 */
+	template<typename T>
+	class arena_allocator {
+		template<typename>
+		friend class arena_allocator;
+
+	public:
+		using value_type = T;
+
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		arena_allocator() noexcept : a(arena::current()) {}
+
+		explicit arena_allocator(arena* a) noexcept : a(a) {}
+
+		template<typename U>
+		arena_allocator(const arena_allocator<U>& alloc) noexcept
+		: a(alloc.a) {}
+
+		T* allocate(std::size_t n) {
+			if(a)
+				return static_cast<T*>(a->allocate(n * sizeof(T), alignof(T)));
+
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, std::size_t) noexcept {
+			if(!a)
+				::operator delete(p);
+		}
+
+		arena_allocator select_on_container_copy_construction() const noexcept {
+			return arena_allocator();
+		}
+
+		/// The arena used, or `nullptr` if allocating from the heap.
+		arena* resource() const noexcept {
+			return a;
+		}
+
+		template<typename U>
+		bool operator== (const arena_allocator<U>& alloc) const noexcept {
+			return a == alloc.a;
+		}
+
+		template<typename U>
+		bool operator!= (const arena_allocator<U>& alloc) const noexcept {
+			return a != alloc.a;
+		}
+
+	private:
+		arena* a;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_ATOM_H
+#define FTL_ATOM_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "memory.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup atom Atom
+	 *
+	 * A shared, mutable reference to an immutable value.
+	 *
+	 * \code
+	 *   #include <ftl/atom.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - \ref memory
+	 */
+
+	namespace _dtl {
+		/*
+		 * Hazard pointers. A reader publishes, in a slot of its own, the
+		 * address of a node it is about to use. Writers only free a node
+		 * they have unlinked once no slot holds its address.
+		 *
+		 * Slots are kept in a list that only ever grows, shared by every
+		 * atom. A thread claims slots as it needs them, keeps them in a
+		 * cache for reuse, and gives them back when it exits.
+		 */
+		struct hazard_slot {
+			std::atomic<const void*> p{nullptr};
+			std::atomic<bool> taken{true};
+			hazard_slot* next = nullptr;
+		};
+
+		class hazard_registry {
+		public:
+			hazard_slot* acquire() {
+				for(auto s = head.load(); s; s = s->next) {
+					if(!s->taken.load(std::memory_order_relaxed)
+					&& !s->taken.exchange(true))
+						return s;
+				}
+
+				auto s = new hazard_slot;
+				s->next = head.load();
+				while(!head.compare_exchange_weak(s->next, s));
+
+				return s;
+			}
+
+			bool hazarded(const void* p) const noexcept {
+				for(auto s = head.load(); s; s = s->next) {
+					if(s->p.load() == p)
+						return true;
+				}
+
+				return false;
+			}
+
+		private:
+			std::atomic<hazard_slot*> head{nullptr};
+		};
+
+		inline hazard_registry& hazards() {
+			static hazard_registry r;
+			return r;
+		}
+
+		// The slots a thread has claimed, but is not using
+		class hazard_cache {
+		public:
+			~hazard_cache() {
+				for(auto s : free)
+					s->taken.store(false);
+			}
+
+			hazard_slot* take() {
+				if(free.empty())
+					return hazards().acquire();
+
+				auto s = free.back();
+				free.pop_back();
+				return s;
+			}
+
+			void give(hazard_slot* s) {
+				free.push_back(s);
+			}
+
+		private:
+			std::vector<hazard_slot*> free;
+		};
+
+		inline hazard_cache& local_hazards() {
+			static thread_local hazard_cache c;
+			return c;
+		}
+
+		// Holds one hazard slot for as long as it lives
+		class hazard_guard {
+		public:
+			hazard_guard() : s(local_hazards().take()) {}
+
+			hazard_guard(const hazard_guard&) = delete;
+			hazard_guard& operator= (const hazard_guard&) = delete;
+
+			~hazard_guard() {
+				clear();
+				local_hazards().give(s);
+			}
+
+			/*
+			 * Read a, and publish the result, until what was published is
+			 * still what a holds. From then on, it will not be freed until
+			 * the guard is cleared.
+			 */
+			template<typename N>
+			N* protect(const std::atomic<N*>& a) noexcept {
+				N* p = a.load();
+				for(;;) {
+					s->p.store(p);
+
+					N* q = a.load();
+					if(q == p)
+						return p;
+
+					p = q;
+				}
+			}
+
+			void clear() noexcept {
+				s->p.store(nullptr, std::memory_order_release);
+			}
+
+		private:
+			hazard_slot* s;
+		};
+	}
+
+	/**
+	 * A shared, mutable reference to an immutable value.
+	 *
+	 * Modelled on Clojure's atoms. An atom always refers to one complete
+	 * version of a value. Readers take a snapshot of the current version,
+	 * which they can keep for as long as they like, while writers replace
+	 * it with new versions. Versions are never modified once published.
+	 *
+	 * Neither reading nor writing takes a lock. `load` is wait-free in
+	 * practice: a couple of atomic loads and stores, and a reference count
+	 * increment. `swap` computes a new version from the current one and
+	 * publishes it if no other writer got there first, or else tries again
+	 * with theirs. Versions that have been replaced are freed as soon as
+	 * no reader is in the middle of loading them, which is tracked with
+	 * hazard pointers, and as soon as no snapshot of them remains.
+	 *
+	 * This suits read-mostly data, such as configuration or routing tables,
+	 * best if `T` is cheap to copy with a small change, as are
+	 * `persistent_vector` and `persistent_map`. Snapshots are
+	 * `std::shared_ptr`s, so the instances in \ref memory apply to them.
+	 *
+	 * \par Concepts
+	 * - \ref defcons, if `T` is
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::atom<ftl::persistent_map<std::string,int>> routes;
+	 *
+	 *   // Writer
+	 *   routes.swap([](ftl::persistent_map<std::string,int> m) {
+	 *       m.insert_or_assign("/index", 3);
+	 *       return m;
+	 *   });
+	 *
+	 *   // Readers, on any thread
+	 *   auto r = routes.load();
+	 *   auto it = r->find("/index");
+	 * \endcode
+	 *
+	 * \ingroup atom
+	 */
+	template<typename T>
+	class atom {
+		struct node {
+			explicit node(std::shared_ptr<const T> v) : value(std::move(v)) {}
+
+			std::shared_ptr<const T> value;
+			node* next = nullptr;
+		};
+
+	public:
+		/// The type of snapshots.
+		using snapshot = std::shared_ptr<const T>;
+
+		atom() : atom(T()) {}
+
+		explicit atom(T x) : cur(new node(std::make_shared<const T>(std::move(x))))
+		{}
+
+		atom(const atom&) = delete;
+		atom& operator= (const atom&) = delete;
+
+		/// Must not be called while any other thread is using the atom.
+		~atom() {
+			delete cur.load();
+			free_all(retired.load());
+		}
+
+		/// The current version.
+		snapshot load() const {
+			_dtl::hazard_guard g;
+			return g.protect(cur)->value;
+		}
+
+		/// Publish `x` as the new version, whatever the current one is.
+		void store(T x) {
+			std::unique_ptr<node> n(new node(std::make_shared<const T>(std::move(x))));
+
+			retire(cur.exchange(n.release()));
+		}
+
+		/**
+		 * Publish `f(current)` as the new version.
+		 *
+		 * If another writer publishes a version while `f` runs, `f` is run
+		 * again on that version, so `f` must be free of side effects. Has
+		 * no effect if `f` throws.
+		 *
+		 * \tparam F must satisfy \ref fn`<T(const T&)>`
+		 *
+		 * \return The version published.
+		 */
+		template<typename F>
+		snapshot swap(F&& f) {
+			_dtl::hazard_guard g;
+			for(;;) {
+				// Guarded all the way to the exchange, lest it be freed and
+				// its address reused for a newer version
+				node* old = g.protect(cur);
+
+				std::unique_ptr<node> n(
+					new node(std::make_shared<const T>(f(*old->value)))
+				);
+				auto r = n->value;
+
+				if(cur.compare_exchange_strong(old, n.get())) {
+					n.release();
+					g.clear();
+					retire(old);
+
+					return r;
+				}
+			}
+		}
+
+		/**
+		 * Publish `x`, only if `expected` is still the current version.
+		 *
+		 * \return Whether `x` was published.
+		 */
+		bool compare_and_set(const snapshot& expected, T x) {
+			_dtl::hazard_guard g;
+			node* old = g.protect(cur);
+			if(old->value != expected)
+				return false;
+
+			std::unique_ptr<node> n(new node(std::make_shared<const T>(std::move(x))));
+			if(!cur.compare_exchange_strong(old, n.get()))
+				return false;
+
+			n.release();
+			g.clear();
+			retire(old);
+
+			return true;
+		}
+
+	private:
+		/*
+		 * Put n, which is no longer current, on the list of nodes to free,
+		 * and free every node on it that no reader is looking at.
+		 */
+		void retire(node* n) {
+			push_retired(n);
+
+			node* keep = nullptr;
+			for(node* r = retired.exchange(nullptr); r;) {
+				node* next = r->next;
+				if(_dtl::hazards().hazarded(r)) {
+					r->next = keep;
+					keep = r;
+				}
+				else {
+					delete r;
+				}
+
+				r = next;
+			}
+
+			while(keep) {
+				node* next = keep->next;
+				push_retired(keep);
+				keep = next;
+			}
+		}
+
+		void push_retired(node* n) noexcept {
+			n->next = retired.load();
+			while(!retired.compare_exchange_weak(n->next, n));
+		}
+
+		static void free_all(node* n) noexcept {
+			while(n) {
+				node* next = n->next;
+				delete n;
+				n = next;
+			}
+		}
+
+		std::atomic<node*> cur;
+		std::atomic<node*> retired{nullptr};
+	};
+}
+
+#endif
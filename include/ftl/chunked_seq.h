@@ -0,0 +1,717 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CHUNKED_SEQ_H
+#define FTL_CHUNKED_SEQ_H
+
+#include <list>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+#include "implementation/contiguous_fold.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup chunked_seq Chunked Sequence
+	 *
+	 * Sequence container stored as a list of contiguous chunks.
+	 *
+	 * \code
+	 *   #include <ftl/chunked_seq.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::chunked_seq`:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - `<list>`
+	 * - `<vector>`
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 */
+
+	namespace _dtl {
+		// Enough elements to fill about a page, and at least one
+		template<typename T>
+		struct default_chunk_size {
+			static constexpr size_t value =
+				sizeof(T) < 4096 ? 4096 / sizeof(T) : 1;
+		};
+
+		/*
+		 * Position in a list of vectors: the chunk, and the index in it. No
+		 * chunk is ever empty, so the end is the end of the list, at index 0.
+		 */
+		template<typename V, typename ChunkIt>
+		class chunked_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = typename std::remove_const<V>::type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = V*;
+			using reference = V&;
+
+			chunked_iterator() = default;
+
+			chunked_iterator(ChunkIt c, size_t i) noexcept : c(c), i(i) {}
+
+			// Mutable to const conversion
+			template<
+					typename W,
+					typename ChunkJt,
+					typename = Requires<std::is_convertible<W*,V*>::value>
+			>
+			chunked_iterator(const chunked_iterator<W,ChunkJt>& it) noexcept
+			: c(it.c), i(it.i) {}
+
+			reference operator* () const noexcept {
+				return (*c)[i];
+			}
+
+			pointer operator-> () const noexcept {
+				return &(*c)[i];
+			}
+
+			chunked_iterator& operator++ () noexcept {
+				if(++i == c->size()) {
+					++c;
+					i = 0;
+				}
+
+				return *this;
+			}
+
+			chunked_iterator operator++ (int) noexcept {
+				auto it = *this;
+				++*this;
+				return it;
+			}
+
+			chunked_iterator& operator-- () noexcept {
+				if(i == 0) {
+					--c;
+					i = c->size();
+				}
+
+				--i;
+				return *this;
+			}
+
+			chunked_iterator operator-- (int) noexcept {
+				auto it = *this;
+				--*this;
+				return it;
+			}
+
+			bool operator== (const chunked_iterator& it) const noexcept {
+				return c == it.c && i == it.i;
+			}
+
+			bool operator!= (const chunked_iterator& it) const noexcept {
+				return !(*this == it);
+			}
+
+		private:
+			template<typename, typename>
+			friend class chunked_iterator;
+
+			ChunkIt c;
+			size_t i = 0;
+		};
+	}
+
+	/**
+	 * Sequence container made of linked, contiguous chunks.
+	 *
+	 * Elements are kept in chunks of up to `N` elements each, which are
+	 * in turn kept in a linked list. It sits between `std::vector` and
+	 * `std::list`:
+	 * - Appending a temporary sequence relinks its chunks, rather than
+	 *   moving its elements, so concatenating in a fold costs constant time
+	 *   per append. An operand small enough to fit in the last chunk is
+	 *   moved into it instead, so that many small appends still make full
+	 *   chunks.
+	 * - Within a chunk, elements are contiguous, so folds and maps run
+	 *   tight loops over arrays, with one branch per chunk.
+	 * - Growing never moves existing elements: references stay valid until
+	 *   the element is removed.
+	 * - Chunks are natural units of work for parallel folds, see
+	 *   \ref parallel.
+	 *
+	 * There is no constant time indexing; iterators are bidirectional.
+	 * Every chunk holds at least one element. Chunks linked in from other
+	 * sequences may hold fewer than `N`, and results of `fmap` keep the
+	 * chunk sizes of their source.
+	 *
+	 * \tparam N Elements per chunk; by default, as many as fit in 4 KiB.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref eq, if `T` is
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   // Linear in the number of elements, not quadratic
+	 *   auto all = ftl::foldMap(
+	 *       [](const Row& r){ return parse_fields(r); },  // chunked_seq<Field>
+	 *       rows
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N = _dtl::default_chunk_size<T>::value>
+	class chunked_seq {
+		static_assert(N > 0, "Chunks must have room for at least one element");
+
+		using chunk = std::vector<T>;
+		using chunk_list = std::list<chunk>;
+
+		template<typename, size_t>
+		friend class chunked_seq;
+
+		template<typename>
+		friend struct monad;
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using iterator =
+			_dtl::chunked_iterator<T, typename chunk_list::iterator>;
+		using const_iterator =
+			_dtl::chunked_iterator<const T, typename chunk_list::const_iterator>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		/// Largest number of elements in a chunk the sequence allocates.
+		static constexpr size_t chunk_size = N;
+
+		chunked_seq() = default;
+		chunked_seq(const chunked_seq&) = default;
+
+		chunked_seq(chunked_seq&& s) noexcept
+		: cs(std::move(s.cs)), count(s.count) {
+			s.cs.clear();
+			s.count = 0;
+		}
+
+		chunked_seq(std::initializer_list<T> l) {
+			for(auto& x : l)
+				push_back(x);
+		}
+
+		template<
+				typename It,
+				typename = Requires<std::is_convertible<
+					typename std::iterator_traits<It>::iterator_category,
+					std::input_iterator_tag
+				>::value>
+		>
+		chunked_seq(It first, It last) {
+			for(; first != last; ++first)
+				push_back(*first);
+		}
+
+		chunked_seq& operator= (const chunked_seq&) = default;
+
+		chunked_seq& operator= (chunked_seq&& s) noexcept {
+			if(this != &s) {
+				cs = std::move(s.cs);
+				count = s.count;
+				s.cs.clear();
+				s.count = 0;
+			}
+
+			return *this;
+		}
+
+		size_type size() const noexcept {
+			return count;
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		T& front() {
+			return cs.front().front();
+		}
+
+		const T& front() const {
+			return cs.front().front();
+		}
+
+		T& back() {
+			return cs.back().back();
+		}
+
+		const T& back() const {
+			return cs.back().back();
+		}
+
+		iterator begin() noexcept {
+			return iterator(cs.begin(), 0);
+		}
+
+		iterator end() noexcept {
+			return iterator(cs.end(), 0);
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(cs.begin(), 0);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(cs.end(), 0);
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		void push_back(const T& x) {
+			emplace_back(x);
+		}
+
+		void push_back(T&& x) {
+			emplace_back(std::move(x));
+		}
+
+		/// Append an element constructed from `args`.
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			open_chunk().emplace_back(std::forward<Args>(args)...);
+			++count;
+		}
+
+		/// Remove the last element.
+		void pop_back() {
+			cs.back().pop_back();
+			if(cs.back().empty())
+				cs.pop_back();
+
+			--count;
+		}
+
+		void clear() noexcept {
+			cs.clear();
+			count = 0;
+		}
+
+		/**
+		 * Append all of `s`, relinking its chunks.
+		 *
+		 * Constant time, unless `s` fits in the room left in the last chunk,
+		 * in which case its elements are moved there. Leaves `s` empty.
+		 */
+		void append(chunked_seq&& s) {
+			if(s.empty())
+				return;
+
+			if(!cs.empty() && cs.back().size() + s.count <= N) {
+				auto& last = cs.back();
+				for(auto& c : s.cs) {
+					last.insert(
+						last.end(),
+						std::make_move_iterator(c.begin()),
+						std::make_move_iterator(c.end())
+					);
+				}
+			}
+			else {
+				cs.splice(cs.end(), s.cs);
+			}
+
+			count += s.count;
+			s.clear();
+		}
+
+		/// Append a copy of every element of `s`.
+		void append(const chunked_seq& s) {
+			chunked_seq t(s);
+			append(std::move(t));
+		}
+
+		/// Number of chunks the elements are stored in.
+		size_type chunk_count() const noexcept {
+			return cs.size();
+		}
+
+		/**
+		 * The chunks, in order.
+		 *
+		 * Each is a non-empty vector of consecutive elements. Useful to run
+		 * inner loops over contiguous memory, or to hand out the chunks as
+		 * separate tasks.
+		 */
+		const chunk_list& chunks() const noexcept {
+			return cs;
+		}
+
+	private:
+		// The chunk to add an element to, starting a new one if need be
+		chunk& open_chunk() {
+			if(cs.empty() || cs.back().size() >= N) {
+				// Short sequences should not pay for a whole chunk
+				bool first = cs.empty();
+				cs.emplace_back();
+				if(!first)
+					cs.back().reserve(N);
+			}
+
+			return cs.back();
+		}
+
+		// Start a new chunk with room for n elements, filled by the caller
+		chunk& new_chunk(size_t n) {
+			cs.emplace_back();
+			cs.back().reserve(n);
+
+			return cs.back();
+		}
+
+		chunk_list cs;
+		size_type count = 0;
+	};
+
+	template<typename T, size_t N>
+	constexpr size_t chunked_seq<T,N>::chunk_size;
+
+	/**
+	 * Equality comparison of chunked sequences.
+	 *
+	 * Compares the elements only; how they are split into chunks does not
+	 * matter.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	bool operator== (const chunked_seq<T,N>& a, const chunked_seq<T,N>& b) {
+		if(a.size() != b.size())
+			return false;
+
+		return std::equal(a.begin(), a.end(), b.begin());
+	}
+
+	/// \ingroup chunked_seq
+	template<typename T, size_t N>
+	bool operator!= (const chunked_seq<T,N>& a, const chunked_seq<T,N>& b) {
+		return !(a == b);
+	}
+
+	/**
+	 * Free function versions of `begin` and `end`, for argument dependent
+	 * lookup.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	typename chunked_seq<T,N>::const_iterator begin(
+			const chunked_seq<T,N>& s) noexcept {
+		return s.begin();
+	}
+
+	/// \ingroup chunked_seq
+	template<typename T, size_t N>
+	typename chunked_seq<T,N>::const_iterator end(
+			const chunked_seq<T,N>& s) noexcept {
+		return s.end();
+	}
+
+	/// \ingroup chunked_seq
+	template<typename T, size_t N>
+	typename chunked_seq<T,N>::iterator begin(chunked_seq<T,N>& s) noexcept {
+		return s.begin();
+	}
+
+	/// \ingroup chunked_seq
+	template<typename T, size_t N>
+	typename chunked_seq<T,N>::iterator end(chunked_seq<T,N>& s) noexcept {
+		return s.end();
+	}
+
+	// Rebinding keeps the number of elements per chunk
+	template<typename T, size_t N>
+	struct parametric_type_traits<chunked_seq<T,N>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = chunked_seq<U,N>;
+	};
+
+	/**
+	 * Monoid instance for chunked sequences.
+	 *
+	 * Identity element is the empty sequence, monoid operation is
+	 * concatenation. Where the right operand is a temporary, its chunks are
+	 * relinked onto the left, so that `foldMap` into chunked sequences does
+	 * not copy its partial results over and over, as it would with
+	 * `std::vector`.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	struct monoid<chunked_seq<T,N>> {
+		static chunked_seq<T,N> id() {
+			return chunked_seq<T,N>();
+		}
+
+		static chunked_seq<T,N> append(
+				const chunked_seq<T,N>& s1, const chunked_seq<T,N>& s2) {
+
+			chunked_seq<T,N> r(s1);
+			r.append(s2);
+			return r;
+		}
+
+		static chunked_seq<T,N> append(
+				chunked_seq<T,N>&& s1, const chunked_seq<T,N>& s2) {
+
+			s1.append(s2);
+			return std::move(s1);
+		}
+
+		static chunked_seq<T,N> append(
+				const chunked_seq<T,N>& s1, chunked_seq<T,N>&& s2) {
+
+			chunked_seq<T,N> r(s1);
+			r.append(std::move(s2));
+			return r;
+		}
+
+		static chunked_seq<T,N> append(
+				chunked_seq<T,N>&& s1, chunked_seq<T,N>&& s2) {
+
+			s1.append(std::move(s2));
+			return std::move(s1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for chunked sequences.
+	 *
+	 * Each fold runs an inner loop per chunk. `fold` folds each chunk as a
+	 * contiguous array, which takes the faster paths `std::vector` has for
+	 * sums, products, `any` and `all`.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	struct foldable<chunked_seq<T,N>>
+	: deriving_foldMap<chunked_seq<T,N>> {
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const chunked_seq<T,N>& s) {
+			for(auto& c : s.chunks()) {
+				for(auto& x : c)
+					z = fn(std::move(z), x);
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const chunked_seq<T,N>& s) {
+			auto& cs = s.chunks();
+			for(auto c = cs.rbegin(); c != cs.rend(); ++c) {
+				for(auto x = c->rbegin(); x != c->rend(); ++x)
+					z = fn(*x, std::move(z));
+			}
+
+			return z;
+		}
+
+		template<typename M = T>
+		static M fold(const chunked_seq<T,N>& s) {
+			static_assert(Monoid<M>(), "M must satisfy Monoid");
+
+			M acc = monoid<M>::id();
+			for(auto& c : s.chunks()) {
+				acc = monoid<M>::append(
+					std::move(acc),
+					_dtl::contiguous_fold<T>::fold(c.data(), c.size())
+				);
+
+				if(_dtl::is_absorbing(acc))
+					break;
+			}
+
+			return acc;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad instance for chunked sequences.
+	 *
+	 * Equivalent to `monad<std::vector<T>>`. `map` builds each chunk of the
+	 * result from the matching chunk of the source, in a single allocation,
+	 * and maps temporaries in place when `f` keeps the element type.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	struct monad<chunked_seq<T,N>>
+	: deriving_pure<chunked_seq<T,N>>
+	, deriving_join<in_terms_of_bind<chunked_seq<T,N>>>
+	, deriving_apply<in_terms_of_bind<chunked_seq<T,N>>> {
+
+		template<typename U>
+		using seq = Rebind<chunked_seq<T,N>,U>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static seq<U> map(F&& f, const chunked_seq<T,N>& s) {
+			seq<U> r;
+			for(auto& c : s.cs) {
+				auto& rc = r.new_chunk(c.size());
+				for(auto& x : c)
+					rc.push_back(f(x));
+
+				r.count += rc.size();
+			}
+
+			_dtl::note_alloc(_dtl::alloc_site::container, r.chunk_count());
+			return r;
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static seq<U> map(F&& f, chunked_seq<T,N>&& s) {
+			seq<U> r;
+			for(auto& c : s.cs) {
+				auto& rc = r.new_chunk(c.size());
+				for(auto& x : c)
+					rc.push_back(f(std::move(x)));
+
+				r.count += rc.size();
+			}
+
+			s.clear();
+			_dtl::note_alloc(_dtl::alloc_site::container, r.chunk_count());
+			return r;
+		}
+
+		/**
+		 * Endofunction mapped over a temporary.
+		 *
+		 * Replaces the elements in place, and reuses every chunk.
+		 */
+		template<
+				typename F,
+				typename = Requires<std::is_same<T, result_of<F(T)>>::value>
+		>
+		static chunked_seq<T,N> map(F&& f, chunked_seq<T,N>&& s) {
+			for(auto& c : s.cs) {
+				for(auto& x : c)
+					x = f(std::move(x));
+			}
+
+			return std::move(s);
+		}
+
+		template<
+				typename F,
+				typename Cu = result_of<F(T)>,
+				typename U = Value_type<Cu>,
+				typename = Requires<ForwardIterable<Cu>()>
+		>
+		static seq<U> bind(const chunked_seq<T,N>& s, F&& f) {
+			seq<U> r;
+			for(auto& c : s.cs) {
+				for(auto& x : c) {
+					auto ys = f(x);
+					for(auto& y : ys)
+						r.push_back(std::move(y));
+				}
+			}
+
+			_dtl::note_alloc(_dtl::alloc_site::container, r.chunk_count());
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for chunked sequences.
+	 *
+	 * As with `std::vector`, a chunked sequence can be zipped with any
+	 * \ref fwditerable.
+	 *
+	 * \ingroup chunked_seq
+	 */
+	template<typename T, size_t N>
+	struct zippable<chunked_seq<T,N>>
+	: deriving_zippable<back_insertable_container<chunked_seq<T,N>>> {};
+}
+
+#endif
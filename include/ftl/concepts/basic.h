@@ -362,20 +362,17 @@ namespace ftl {
 	 * \ingroup concepts_basic
 	 */
 	template<template<typename> class Pred, typename...Ts>
-	struct All;
+	struct All {
+	private:
+		template<bool...>
+		struct bools {};
 
-	template<template<typename> class Pred>
-	struct All<Pred> {
-		static constexpr bool value = true;
-
-		constexpr operator bool() const noexcept {
-			return true;
-		}
-	};
-
-	template<template<typename> class Pred, typename T, typename...Ts>
-	struct All<Pred, T, Ts...> {
-		static constexpr bool value = Pred<T>::value && All<Pred,Ts...>::value;
+	public:
+		// Expanded in one go, rather than recursing once per type
+		static constexpr bool value = std::is_same<
+			bools<true, bool(Pred<Ts>::value)...>,
+			bools<bool(Pred<Ts>::value)..., true>
+		>::value;
 
 		constexpr operator bool() const noexcept {
 			return value;
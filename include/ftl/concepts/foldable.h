@@ -240,7 +240,7 @@ namespace ftl {
 			);
 
 			for(auto& e : f) {
-				z = fn(z, e);
+				z = fn(std::move(z), e);
 			}
 
 			return z;
@@ -256,7 +256,7 @@ namespace ftl {
 			);
 
 			for(auto& e : f) {
-				z = fn(z, std::move(e));
+				z = fn(std::move(z), std::move(e));
 			}
 
 			return z;
@@ -295,7 +295,7 @@ namespace ftl {
 			);
 
 			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(*it, z);
+				z = fn(*it, std::move(z));
 			}
 
 			return z;
@@ -311,13 +311,42 @@ namespace ftl {
 			);
 
 			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(std::move(*it), z);
+				z = fn(std::move(*it), std::move(z));
 			}
 
 			return z;
 		}
 	};
 
+	namespace _dtl {
+		namespace adl {
+			using std::begin;
+
+			// What a range-for over an F would start from
+			template<typename F>
+			auto begin_of(const F& f) -> decltype(begin(f));
+		}
+
+		// Whether iterating over an F visits its Value_types, not e.g. pairs
+		template<typename F, bool = has_begin<F>::value && has_end<F>::value>
+		struct iterates_values : std::is_same<
+			plain_type<decltype(*adl::begin_of(std::declval<const F&>()))>,
+			Value_type<F>
+		> {};
+
+		template<typename F>
+		struct iterates_values<F,false> : std::false_type {};
+
+		/*
+		 * Monoids that are best appended all at once, rather than one
+		 * element at a time, can take over foldMaps over iterable foldables
+		 * by specialising this with a static
+		 *   template<typename Fn, typename F> M foldMap(Fn& fn, const F& f)
+		 */
+		template<typename M>
+		struct deferred_foldMap : std::false_type {};
+	}
+
 	/**
 	 * Inheritable implementation of `foldable::foldMap`.
 	 *
@@ -325,6 +354,12 @@ namespace ftl {
 	 * this struct to get `foldable::foldMap` for "free". Naturally, it works
 	 * together with `ftl::deriving_foldl`.
 	 *
+	 * If `F` satisfies \ref fwditerable, iterating over its values, the
+	 * elements are visited directly, moving the partial result into each
+	 * `append`. If the monoid has absorbing elements (see \ref monoid), the
+	 * fold also stops as soon as its result is absorbing. Strings are
+	 * instead concatenated in one go, see \ref string.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -349,15 +384,56 @@ namespace ftl {
 				"The result of Fn(T) is not an instance of Monoid."
 			);
 
+			return foldMap(
+				fn, f,
+				std::integral_constant<bool,_dtl::iterates_values<F>::value>()
+			);
+		}
+
+	private:
+		template<typename Fn, typename M = result_of<Fn(Value_type<F>)>>
+		static M foldMap(Fn& fn, const F& f, std::false_type) {
+			using T = Value_type<F>;
+
 			return foldable<F>::foldl(
-					[fn](const T& a, const M& b) {
-						return monoid<M>::append(
-							fn(a),
-							b);
+					[fn](const M& acc, const T& a) {
+						return monoid<M>::append(acc, fn(a));
 					},
 					monoid<M>::id(),
 					f);
 		}
+
+		template<typename Fn, typename M = result_of<Fn(Value_type<F>)>>
+		static M foldMap(Fn& fn, const F& f, std::true_type) {
+			return foldMap(
+				fn, f, std::true_type(),
+				std::integral_constant<bool,_dtl::deferred_foldMap<M>::value>()
+			);
+		}
+
+		template<typename Fn, typename M = result_of<Fn(Value_type<F>)>>
+		static M foldMap(Fn& fn, const F& f, std::true_type, std::true_type) {
+			return _dtl::deferred_foldMap<M>::foldMap(fn, f);
+		}
+
+		/*
+		 * The partial result is moved into each append, so that e.g.
+		 * containers can grow it in place instead of copying it every step.
+		 * Stops at the first absorbing partial result.
+		 */
+		template<typename Fn, typename M = result_of<Fn(Value_type<F>)>>
+		static M foldMap(Fn& fn, const F& f, std::true_type, std::false_type) {
+			M acc = monoid<M>::id();
+
+			for(auto&& e : f) {
+				acc = monoid<M>::append(std::move(acc), fn(e));
+
+				if(_dtl::is_absorbing(acc))
+					break;
+			}
+
+			return acc;
+		}
 	};
 
 	/**
@@ -496,6 +572,194 @@ namespace ftl {
 	foldMap;
 #endif
 
+	namespace _dtl {
+		template<typename C>
+		struct is_indexable {
+		private:
+			template<typename D>
+			static auto check(const D* d)
+			-> decltype((*d)[size_t(0)], size_t(d->size()), std::true_type());
+
+			static std::false_type check(...);
+
+		public:
+			static constexpr bool value =
+				decltype(check(static_cast<const C*>(nullptr)))::value;
+		};
+
+		// Number of elements reduced by hand at the leaves of a tree fold
+		constexpr size_t tree_leaf = 4;
+
+		/*
+		 * foldMap of [first,last), as a balanced tree of appends. fn is
+		 * called on the elements in order, but appends of independent
+		 * subtrees do not wait on each other. If the left half of a range is
+		 * absorbing, the right half is skipped.
+		 */
+		template<typename M, typename Fn, typename C>
+		M tree_foldMap(Fn& fn, const C& c, size_t first, size_t last) {
+			const size_t n = last - first;
+
+			if(n > tree_leaf) {
+				const size_t mid = first + n/2;
+
+				M l = tree_foldMap<M>(fn, c, first, mid);
+				if(is_absorbing(l))
+					return l;
+
+				return monoid<M>::append(
+					std::move(l), tree_foldMap<M>(fn, c, mid, last)
+				);
+			}
+
+			if(n == 0)
+				return monoid<M>::id();
+
+			M a = fn(c[first]);
+			if(n == 1)
+				return a;
+
+			M b = fn(c[first+1]);
+			if(n == 2)
+				return monoid<M>::append(std::move(a), std::move(b));
+
+			M ab = monoid<M>::append(std::move(a), std::move(b));
+			M x = fn(c[first+2]);
+			if(n == 3)
+				return monoid<M>::append(std::move(ab), std::move(x));
+
+			M y = fn(c[first+3]);
+			return monoid<M>::append(
+				std::move(ab), monoid<M>::append(std::move(x), std::move(y))
+			);
+		}
+	}
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _tree_foldMap : public _dtl::curried_binf<_tree_foldMap> {
+		template<
+				typename Fn,
+				typename C,
+				typename T = Value_type<C>,
+				typename M = result_of<Fn(T)>,
+				typename = Requires<_dtl::is_indexable<C>::value && Monoid<M>()>
+		>
+		M operator() (Fn&& fn, const C& c) const {
+			return _dtl::tree_foldMap<M>(fn, c, 0, c.size());
+		}
+
+		using curried_binf<_tree_foldMap>::operator();
+	} tree_foldMap {};
+
+	constexpr struct _tree_fold {
+		template<
+				typename C,
+				typename M = Value_type<C>,
+				typename = Requires<_dtl::is_indexable<C>::value && Monoid<M>()>
+		>
+		M operator() (const C& c) const {
+			return _dtl::tree_foldMap<M>(id, c, 0, c.size());
+		}
+	} tree_fold {};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * `foldMap` over a random access container, reduced as a balanced tree.
+	 *
+	 * The result is the same as that of `foldMap` (as `append` is
+	 * associative), but the appends are grouped pairwise:
+	 * `(f(a) <> f(b)) <> (f(c) <> f(d))` rather than
+	 * `((f(a) <> f(b)) <> f(c)) <> f(d)`. Neighbouring appends do not depend
+	 * on each other, so the processor can work on several at once. For
+	 * floating point monoids, such as `sum_monoid<double>`, rounding errors
+	 * grow with the logarithm of the size, rather than linearly.
+	 *
+	 * `fn` is still called on the elements in order. If part of the fold is
+	 * absorbing (see \ref monoid), the rest of it is skipped.
+	 *
+	 * Works with anything that has `size()` and `operator[]`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<double> xs(1000000, .1);
+	 *   double total = tree_foldMap(sum<double>, xs);
+	 * \endcode
+	 *
+	 * \ingroup foldable
+	 */
+	tree_foldMap;
+
+	/**
+	 * `fold` over a random access container, reduced as a balanced tree.
+	 *
+	 * \see tree_foldMap
+	 *
+	 * \ingroup foldable
+	 */
+	tree_fold;
+#endif
+
+	namespace _dtl {
+		/*
+		 * Appends v to the value at k in a map, or inserts it there, with a
+		 * single lookup. Specialised by the headers of each supported map.
+		 */
+		template<typename Map>
+		struct keyed_append;
+	}
+
+	/**
+	 * Map every element to a key and a monoid, and fold the monoids per key.
+	 *
+	 * For every element `x` of `xs`, in order, `valFn(x)` is appended to the
+	 * value at `keyFn(x)` in the resulting map, or becomes that value if the
+	 * key is new. Each element costs a single lookup in the map.
+	 *
+	 * `Map` is the map template to build, given explicitly. Supported maps
+	 * are `std::map` (\ref map) and `std::unordered_map` (\ref unord_map),
+	 * the corresponding header of which must be included.
+	 *
+	 * \par Examples
+	 *
+	 * Counting words by length:
+	 * \code
+	 *   std::vector<std::string> ws = {"a", "bb", "cc", "d"};
+	 *   auto m = ftl::foldMapByKey<std::map>(
+	 *       [](const std::string& w){ return w.size(); },
+	 *       [](const std::string&){ return ftl::sum(1); },
+	 *       ws
+	 *   );
+	 *   // m == {{1, sum(2)}, {2, sum(2)}}
+	 * \endcode
+	 *
+	 * \ingroup foldable
+	 */
+	template<
+			template<typename...> class Map,
+			typename KFn,
+			typename VFn,
+			typename F,
+			typename T = Value_type<F>,
+			typename K = plain_type<result_of<KFn(const T&)>>,
+			typename M = plain_type<result_of<VFn(const T&)>>,
+			typename = Requires<ForwardIterable<F>()>
+	>
+	Map<K,M> foldMapByKey(KFn&& keyFn, VFn&& valFn, const F& xs) {
+		static_assert(
+			Monoid<M>(),
+			"The result of VFn(T) is not an instance of Monoid."
+		);
+
+		Map<K,M> m;
+		for(auto& x : xs) {
+			_dtl::keyed_append<Map<K,M>>::append(m, keyFn(x), valFn(x));
+		}
+
+		return m;
+	}
+
 #ifndef DOCUMENTATION_GENERATOR
 	constexpr struct _foldr : public _dtl::curried_ternf<_foldr> {
 		template<
@@ -605,6 +869,61 @@ namespace ftl {
 	 */
 	foldl;
 #endif
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _foldl_inplace : public _dtl::curried_ternf<_foldl_inplace> {
+		template<
+				typename Fn,
+				typename U,
+				typename F,
+				typename = Requires<ForwardIterable<F>()>
+		>
+		plain_type<U> operator() (Fn&& fn, U&& z, const F& f) const {
+			plain_type<U> acc(std::forward<U>(z));
+
+			for(auto& e : f) {
+				fn(acc, e);
+			}
+
+			return acc;
+		}
+
+		using curried_ternf<_foldl_inplace>::operator();
+	} foldl_inplace{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Strict left fold that updates its accumulator in place.
+	 *
+	 * Behaves as if it were a curried function of type
+	 * \code
+	 *   ((U&,T) -> void, U, F<T>) -> U
+	 * \endcode
+	 *
+	 * Where `foldl` passes the accumulator to `fn` and assigns back the
+	 * result, `foldl_inplace` passes it as an lvalue reference for `fn` to
+	 * modify. No accumulator is ever copied or moved between elements, which
+	 * matters when building up large containers or strings.
+	 *
+	 * Works with any \ref fwditerable.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<std::string> ws = {"a", "b", "c"};
+	 *   auto s = ftl::foldl_inplace(
+	 *       [](std::string& acc, const std::string& w){ acc += w; },
+	 *       std::string(),
+	 *       ws
+	 *   );
+	 *   // s == "abc"
+	 * \endcode
+	 *
+	 * \ingroup foldable
+	 */
+	foldl_inplace;
+#endif
 }
 
 #endif
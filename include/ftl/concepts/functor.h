@@ -25,6 +25,8 @@
 
 #include "../prelude.h"
 #include "common.h"
+#include "../alloc_stats.h"
+#include "../implementation/contiguous_map.h"
 
 namespace ftl {
 	// Forward declaration so we can mention applicatives
@@ -154,6 +156,47 @@ namespace ftl {
 	template<typename F>
 	struct deriving_map;
 
+	namespace _dtl {
+		// Reserve room for as many elements as src has, where possible
+		template<typename C, typename S>
+		auto reserve_for(C& c, const S& src, int)
+		-> decltype(c.reserve(src.size()), void()) {
+			c.reserve(src.size());
+		}
+
+		template<typename C, typename S>
+		void reserve_for(C&, const S&, long) {}
+
+		/*
+		 * Map fn over src, into the empty container r.
+		 *
+		 * If both are contiguous and the results arithmetic, r is resized
+		 * once and written through a pointer. Without emplace_back's
+		 * capacity check on every element, compilers can vectorise the
+		 * loop (see contiguous_map). Elements of src are moved into fn if
+		 * Move is set.
+		 */
+		template<
+				bool Move, typename R, typename Fn, typename S,
+				typename = Requires<std::is_arithmetic<Value_type<R>>::value>
+		>
+		auto map_elements(R& r, Fn& fn, S& src, int)
+		-> decltype(r.resize(src.size()), void(r.data()), void(src.data())) {
+			r.resize(src.size());
+			contiguous_map<Move>(r.data(), src.data(), src.size(), fn);
+		}
+
+		template<bool Move, typename R, typename Fn, typename S>
+		void map_elements(R& r, Fn& fn, S& src, long) {
+			using E = typename std::remove_reference<decltype(*src.begin())>::type;
+
+			reserve_for(r, src, 0);
+			for(auto& e : src) {
+				r.emplace_back(fn(static_cast<map_elem_ref<Move,E>>(e)));
+			}
+		}
+	}
+
 	/**
 	 * Implementation of `functor::map`, inheritable by many containers.
 	 *
@@ -163,6 +206,13 @@ namespace ftl {
 	 * - There must exist a method, `emplace_back(T&&)`, behaving semantically
 	 *   equivalent of e.g. the `std::list::emplace_back` of the same signature.
 	 *
+	 * Containers with a `reserve` method have room made for the result up
+	 * front. Where both source and result have `data` and the result has
+	 * `resize`, arithmetic results are instead written through a pointer into
+	 * storage sized once, a loop compilers can vectorise. Mapping an
+	 * endofunction over a temporary container reuses the container itself,
+	 * assigning each result in place.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -189,10 +239,9 @@ namespace ftl {
 		template<typename Fn, typename U = result_of<Fn(T)>>
 		static F<U> map(Fn&& fn, const F<T>& f) {
 			F<U> result;
-			for(auto& e : f) {
-				result.emplace_back(fn(e));
-			}
+			_dtl::map_elements<false>(result, fn, f, 0);
 
+			_dtl::note_container_alloc(result);
 			return result;
 		}
 
@@ -206,10 +255,9 @@ namespace ftl {
 		>
 		static F<U> map(Fn&& fn, F<T>&& f) {
 			F<U> result;
-			for(auto& e : f) {
-				result.emplace_back(fn(std::move(e)));
-			}
+			_dtl::map_elements<true>(result, fn, f, 0);
 
+			_dtl::note_container_alloc(result);
 			return result;
 		}
 
@@ -226,7 +274,7 @@ namespace ftl {
 				e = fn(std::move(e));
 			}
 
-			return f;
+			return std::move(f);
 		}
 	};
 
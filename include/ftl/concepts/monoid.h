@@ -24,6 +24,8 @@
 #define FTL_MONOID_H
 
 #include <type_traits>
+#include <limits>
+#include <cstddef>
 #include "../prelude.h"
 
 namespace ftl {
@@ -71,6 +73,8 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - `<type_traits>`
+	 * - `<limits>`
+	 * - `<cstddef>`
 	 * - \ref prelude
 	 */
 
@@ -82,6 +86,14 @@ namespace ftl {
 	 * For any type to be an instance of the monoid concept, it must specialise
 	 * this interface.
 	 *
+	 * Instances may additionally define
+	 * \code
+	 *   static bool absorbing(const M& m);
+	 * \endcode
+	 * returning true if `m` is left absorbing, i.e. `append(m, x) == m` for
+	 * every `x`. Folds use this to stop as soon as their accumulated result
+	 * can no longer change, such as upon the first `true` in a fold of `any`.
+	 *
 	 * \ingroup monoid
 	 */
 	template<typename M>
@@ -147,6 +159,42 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<typename M>
+		struct has_absorbing {
+		private:
+			template<typename U>
+			static decltype(
+				monoid<U>::absorbing(std::declval<const U&>()),
+				std::true_type()
+			) check(U*);
+
+			template<typename>
+			static std::false_type check(...);
+
+		public:
+			static constexpr bool value = decltype(check<M>(nullptr))::value;
+		};
+
+		template<typename M>
+		constexpr bool is_absorbing(const M& m, std::true_type) {
+			return monoid<M>::absorbing(m);
+		}
+
+		template<typename M>
+		constexpr bool is_absorbing(const M&, std::false_type) noexcept {
+			return false;
+		}
+
+		// Whether m is known to be left absorbing; false if M cannot tell
+		template<typename M>
+		constexpr bool is_absorbing(const M& m) {
+			return is_absorbing(
+				m, std::integral_constant<bool,has_absorbing<M>::value>()
+			);
+		}
+	}
+
 	/**
 	 * Convenience operator to ease use of append.
 	 *
@@ -606,6 +654,11 @@ namespace ftl {
 			return a1.b || a2.b;
 		}
 
+		/// `true` absorbs everything
+		static constexpr bool absorbing(any a) noexcept {
+			return a.b;
+		}
+
 		static constexpr bool instance = true;
 	};
 
@@ -674,6 +727,295 @@ namespace ftl {
 			return a1 && a2;
 		}
 
+		/// `false` absorbs everything
+		static constexpr bool absorbing(all a) noexcept {
+			return !a.b;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+
+	/**
+	 * Monoid of the smallest of a set of numbers.
+	 *
+	 * \code
+	 *   id() => the largest N (infinity, if N has one)
+	 *   append => std::min
+	 * \endcode
+	 *
+	 * The smallest `N` (negative infinity, if `N` has one) absorbs
+	 * everything.
+	 *
+	 * \tparam N Any type for which `std::numeric_limits` is specialised and
+	 *           that implements `operator<`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v{3, 1, 2};
+	 *   int least = ftl::foldMap(ftl::minimum<int>, v);
+	 *   // least == 1
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct min_monoid {
+		/// Construct from `N`.
+		constexpr min_monoid(N num)
+		noexcept(std::is_nothrow_copy_constructible<N>::value)
+			: n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create new minimums.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr min_monoid<N> minimum(N num)
+	noexcept(std::is_nothrow_copy_constructible<N>::value) {
+		return min_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for minimums.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<min_monoid<N>> {
+		static constexpr min_monoid<N> id() noexcept {
+			return std::numeric_limits<N>::has_infinity
+				? std::numeric_limits<N>::infinity()
+				: std::numeric_limits<N>::max();
+		}
+
+		static constexpr min_monoid<N> append(
+				const min_monoid<N>& n1,
+				const min_monoid<N>& n2) {
+
+			return n2.n < n1.n ? n2 : n1;
+		}
+
+		static constexpr bool absorbing(const min_monoid<N>& m) {
+			return !(std::numeric_limits<N>::has_infinity
+				? -std::numeric_limits<N>::infinity() < m.n
+				: std::numeric_limits<N>::lowest() < m.n);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of the largest of a set of numbers.
+	 *
+	 * \code
+	 *   id() => the smallest N (negative infinity, if N has one)
+	 *   append => std::max
+	 * \endcode
+	 *
+	 * The largest `N` (infinity, if `N` has one) absorbs everything.
+	 *
+	 * \tparam N Any type for which `std::numeric_limits` is specialised and
+	 *           that implements `operator<`.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct max_monoid {
+		/// Construct from `N`.
+		constexpr max_monoid(N num)
+		noexcept(std::is_nothrow_copy_constructible<N>::value)
+			: n(num) {}
+
+		/// Implicit cast back to `N`.
+		constexpr operator N () const noexcept {
+			return n;
+		}
+
+		N n;
+	};
+
+	/**
+	 * Convenience function to concisely create new maximums.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr max_monoid<N> maximum(N num)
+	noexcept(std::is_nothrow_copy_constructible<N>::value) {
+		return max_monoid<N>(num);
+	}
+
+	/*
+	 * Actual implementation of monoid for maximums.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<max_monoid<N>> {
+		static constexpr max_monoid<N> id() noexcept {
+			return std::numeric_limits<N>::has_infinity
+				? -std::numeric_limits<N>::infinity()
+				: std::numeric_limits<N>::lowest();
+		}
+
+		static constexpr max_monoid<N> append(
+				const max_monoid<N>& n1,
+				const max_monoid<N>& n2) {
+
+			return n1.n < n2.n ? n2 : n1;
+		}
+
+		static constexpr bool absorbing(const max_monoid<N>& m) {
+			return !(m.n < (std::numeric_limits<N>::has_infinity
+				? std::numeric_limits<N>::infinity()
+				: std::numeric_limits<N>::max()));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid counting the elements of a fold.
+	 *
+	 * Any value can be mapped to a `count_monoid` of 1 with `ftl::count`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::list<std::string> l{"a", "b", "c"};
+	 *   size_t n = ftl::foldMap(ftl::count<std::string>, l);
+	 *   // n == 3
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	struct count_monoid {
+		/// Construct from a count.
+		constexpr count_monoid(size_t num) noexcept : n(num) {}
+
+		/// Implicit cast back to `size_t`.
+		constexpr operator size_t () const noexcept {
+			return n;
+		}
+
+		size_t n;
+	};
+
+	/**
+	 * Counts any value as a single element.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename T>
+	constexpr count_monoid count(const T&) noexcept {
+		return count_monoid(1);
+	}
+
+	/*
+	 * Monoid implementation for counts.
+	 *
+	 * \ingroup monoid
+	 */
+	template<>
+	struct monoid<count_monoid> {
+		static constexpr count_monoid id() noexcept {
+			return 0;
+		}
+
+		static constexpr count_monoid append(
+				count_monoid n1, count_monoid n2) noexcept {
+			return n1.n + n2.n;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid of the arithmetic mean of a set of numbers.
+	 *
+	 * Keeps the sum of the numbers and how many there are. Appending adds
+	 * both, so means of parts combine into the mean of the whole, which a
+	 * plain average would not.
+	 *
+	 * \tparam N Any type that implements `operator+` and `operator/`, and
+	 *           can be constructed from `0` and from `size_t`. Integral `N`
+	 *           give truncated means.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<double> v{1., 2., 6.};
+	 *   double avg = ftl::foldMap(ftl::mean<double>, v);
+	 *   // avg == 3.
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct mean_monoid {
+		/// Mean of no numbers.
+		constexpr mean_monoid()
+		noexcept(std::is_nothrow_constructible<N,int>::value)
+			: total(0), n(0) {}
+
+		/// Mean of a sum of `count` numbers.
+		constexpr mean_monoid(N sum, size_t count)
+		noexcept(std::is_nothrow_copy_constructible<N>::value)
+			: total(sum), n(count) {}
+
+		/**
+		 * Implicit cast to the mean.
+		 *
+		 * The mean of no numbers is `0`.
+		 */
+		constexpr operator N () const {
+			return n == 0 ? N(0) : total / N(n);
+		}
+
+		N total;
+		size_t n;
+	};
+
+	/**
+	 * Convenience function to make the mean of a single number.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	constexpr mean_monoid<N> mean(N num)
+	noexcept(std::is_nothrow_copy_constructible<N>::value) {
+		return mean_monoid<N>(num, 1);
+	}
+
+	/*
+	 * Actual implementation of monoid for means.
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename N>
+	struct monoid<mean_monoid<N>> {
+		static constexpr mean_monoid<N> id() {
+			return mean_monoid<N>();
+		}
+
+		static constexpr mean_monoid<N> append(
+				const mean_monoid<N>& m1,
+				const mean_monoid<N>& m2) {
+
+			return mean_monoid<N>(m1.total + m2.total, m1.n + m2.n);
+		}
+
 		static constexpr bool instance = true;
 	};
 
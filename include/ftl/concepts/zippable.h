@@ -26,6 +26,8 @@
 #include <tuple>
 #include "../prelude.h"
 #include "common.h"
+#include "../alloc_stats.h"
+#include "../implementation/contiguous_map.h"
 
 namespace ftl {
 	/**
@@ -139,6 +141,194 @@ namespace ftl {
 	template<typename>
 	struct deriving_zippable {};
 
+	namespace _dtl {
+		// Reserve room for the shorter of a and b, where both sizes are known
+		template<typename C, typename A, typename B>
+		auto zip_reserve(C& c, const A& a, const B& b, int)
+		-> decltype(c.reserve(size_t(a.size())), size_t(b.size()), void()) {
+			auto n = size_t(a.size());
+			auto m = size_t(b.size());
+			c.reserve(n < m ? n : m);
+		}
+
+		template<typename C, typename A, typename B>
+		void zip_reserve(C&, const A&, const B&, long) {}
+
+		// Hand an element to the zipping function, moved if Move is set
+		template<bool Move, typename X>
+		auto zip_elem(X& x) noexcept
+		-> typename std::conditional<Move,X&&,X&>::type {
+			return static_cast<typename std::conditional<Move,X&&,X&>::type>(x);
+		}
+
+		/*
+		 * Zip a and b with f, into the empty container r.
+		 *
+		 * If all three are contiguous and the results arithmetic, r is
+		 * resized once and written through a pointer, so that compilers
+		 * can vectorise the loop.
+		 */
+		template<
+				bool MoveA, bool MoveB, typename R, typename F,
+				typename A, typename B,
+				typename = Requires<std::is_arithmetic<Value_type<R>>::value>
+		>
+		auto zip_elements(R& r, F& f, A& a, B& b, int)
+		-> decltype(
+			r.resize(size_t(a.size())), void(r.data()),
+			void(a.data()), void(b.data()), void(b.size())
+		) {
+			const size_t n = size_t(a.size()) < size_t(b.size())
+				? size_t(a.size()) : size_t(b.size());
+			r.resize(n);
+
+			contiguous_zip<MoveA,MoveB>(r.data(), a.data(), b.data(), n, f);
+		}
+
+		template<
+				bool MoveA, bool MoveB, typename R, typename F,
+				typename A, typename B
+		>
+		void zip_elements(R& r, F& f, A& a, B& b, long) {
+			using std::begin;
+			using std::end;
+
+			zip_reserve(r, a, b, 0);
+
+			auto it1 = begin(a);
+			auto end1 = end(a);
+			auto it2 = begin(b);
+			auto end2 = end(b);
+
+			while(it1 != end1 && it2 != end2) {
+				r.push_back(f(zip_elem<MoveA>(*it1), zip_elem<MoveB>(*it2)));
+				++it1; ++it2;
+			}
+		}
+
+		// Size of c, or size_t(-1) if it is not known without walking it
+		template<typename C>
+		auto known_size(const C& c, int) -> decltype(size_t(c.size())) {
+			return size_t(c.size());
+		}
+
+		template<typename C>
+		size_t known_size(const C&, long) {
+			return size_t(-1);
+		}
+
+		inline size_t shortest() noexcept {
+			return size_t(-1);
+		}
+
+		template<typename C, typename...Cs>
+		size_t shortest(const C& c, const Cs&...cs) {
+			auto n = known_size(c, 0);
+			auto m = shortest(cs...);
+			return n < m ? n : m;
+		}
+
+		template<typename C>
+		auto reserve_n(C& c, size_t n, int) -> decltype(c.reserve(n), void()) {
+			if(n != size_t(-1))
+				c.reserve(n);
+		}
+
+		template<typename C>
+		void reserve_n(C&, size_t, long) {}
+
+		template<typename Its, typename Ends, size_t...Is>
+		bool zip_done(const Its& its, const Ends& ends, seq<Is...>) {
+			bool done = false;
+			int dummy[] = {
+				(done = done || std::get<Is>(its) == std::get<Is>(ends), 0)...
+			};
+			(void)dummy;
+
+			return done;
+		}
+
+		template<typename Its, size_t...Is>
+		void zip_next(Its& its, seq<Is...>) {
+			int dummy[] = { (++std::get<Is>(its), 0)... };
+			(void)dummy;
+		}
+
+		/*
+		 * Walk all of cs in lockstep, until the shortest one runs out, and
+		 * pass the result of f on each set of elements to sink. Elements of
+		 * temporaries are moved into f.
+		 */
+		template<typename S, typename F, size_t...Is, typename...Cs>
+		void zip_walk(S&& sink, F& f, seq<Is...> is, Cs&&...cs) {
+			using std::begin;
+			using std::end;
+
+			auto its = std::make_tuple(begin(cs)...);
+			auto ends = std::make_tuple(end(cs)...);
+
+			while(!zip_done(its, ends, is)) {
+				sink(f(
+					zip_elem<!std::is_lvalue_reference<Cs>::value>(
+						*std::get<Is>(its)
+					)...
+				));
+
+				zip_next(its, is);
+			}
+		}
+
+		template<typename C>
+		struct back_sink {
+			C& c;
+
+			template<typename X>
+			void operator() (X&& x) {
+				c.push_back(std::forward<X>(x));
+			}
+		};
+
+		template<typename C, typename Tup, typename Is>
+		struct unzipped;
+
+		template<typename C, typename Tup, size_t...Is>
+		struct unzipped<C,Tup,seq<Is...>> {
+			using type = std::tuple<
+				Rebind<C,plain_type<typename std::tuple_element<Is,Tup>::type>>...
+			>;
+		};
+
+		template<bool Move, typename Cols, typename Rows, size_t...Is>
+		void unzip_into(Cols& cols, Rows& rows, seq<Is...>) {
+			auto n = known_size(rows, 0);
+			int dummy[] = { (reserve_n(std::get<Is>(cols), n, 0), 0)... };
+			(void)dummy;
+
+			for(auto& r : rows) {
+				int push[] = {
+					(std::get<Is>(cols).push_back(
+						zip_elem<Move>(std::get<Is>(r))
+					), 0)...
+				};
+				(void)push;
+			}
+		}
+
+		template<typename C>
+		struct can_truncate {
+		private:
+			template<typename D>
+			static auto check(D* d)
+			-> decltype(d->erase(d->begin(), d->end()), std::true_type());
+
+			static std::false_type check(...);
+
+		public:
+			static constexpr bool value =
+				decltype(check(static_cast<C*>(nullptr)))::value;
+		};
+	}
+
 	/**
 	 * Inhertiable zippable implementation for many container types.
 	 *
@@ -157,6 +347,16 @@ namespace ftl {
 	 * \ref fwditerable. In other words, it would be possible to zip a list
 	 * deriving this implementation with e.g. a `maybe<SomeType>`.
 	 *
+	 * Elements of either operand are moved into the zipping function if that
+	 * operand is a temporary. If the first one is, and the function does not
+	 * change its type, the result is computed in place, in the first operand,
+	 * which is then cut down to the length of the shorter one (this requires
+	 * `Z` to have a range `erase`). When both operands have a `size`, and `Z`
+	 * a `reserve`, room for the result is made up front. Arithmetic results
+	 * of zipping two contiguous operands (with `data`) into a contiguous,
+	 * resizable `Z` are written through a pointer, a loop compilers can
+	 * vectorise.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -182,33 +382,199 @@ namespace ftl {
 				>
 		>
 		static Z_<U> zipWith(F f, const Z_<T>& z, const Iterable& i) {
-			auto it1 = z.begin();
-			auto it2 = i.begin();
+			return zip_into<false,false,U>(f, z, i);
+		}
 
-			Z_<U> result;
+		/// \overload
+		template<
+				typename F, typename Iterable,
+				typename I = plain_type<Iterable>,
+				typename U = result_of<F(T,Value_type<I>)>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& !std::is_lvalue_reference<Iterable>::value
+				>
+		>
+		static Z_<U> zipWith(F f, const Z_<T>& z, Iterable&& i) {
+			return zip_into<false,true,U>(f, z, i);
+		}
+
+		/// \overload
+		template<
+				typename F, typename Iterable,
+				typename I = plain_type<Iterable>,
+				typename U = result_of<F(T,Value_type<I>)>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& !(std::is_same<T,U>::value
+						&& std::is_move_assignable<T>::value
+						&& _dtl::can_truncate<Z_<T>>::value)
+				>
+		>
+		static Z_<U> zipWith(F f, Z_<T>&& z, Iterable&& i) {
+			return zip_into<true,!std::is_lvalue_reference<Iterable>::value,U>(
+				f, z, i
+			);
+		}
 
-			while(it1 != z.end() && it2 != i.end()) {
-				result.push_back(f(*it1, *it2));
+		/**
+		 * In place version.
+		 *
+		 * Kicks in if `z` is a temporary and `f` does not change its type.
+		 */
+		template<
+				typename F, typename Iterable,
+				typename I = plain_type<Iterable>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& std::is_same<T,result_of<F(T,Value_type<I>)>>::value
+					&& std::is_move_assignable<T>::value
+					&& _dtl::can_truncate<Z_<T>>::value
+				>
+		>
+		static Z_<T> zipWith(F f, Z_<T>&& z, Iterable&& i) {
+			constexpr bool move_i = !std::is_lvalue_reference<Iterable>::value;
+
+			using std::begin;
+			using std::end;
+
+			auto it1 = z.begin();
+			auto it2 = begin(i);
+			auto end2 = end(i);
+
+			while(it1 != z.end() && it2 != end2) {
+				*it1 = f(std::move(*it1), _dtl::zip_elem<move_i>(*it2));
 				++it1; ++it2;
 			}
 
+			z.erase(it1, z.end());
+			return std::move(z);
+		}
+
+		/**
+		 * N-ary version.
+		 *
+		 * Walks `z` and every `is` in lockstep, in a single pass, applying `f`
+		 * to one element of each. The result ends with the shortest of them.
+		 */
+		template<
+				typename F, typename Zc, typename I1, typename I2,
+				typename...Is,
+				typename = Requires<
+					std::is_same<plain_type<Zc>,Z_<T>>::value
+				>,
+				typename U = result_of<F(
+					T,
+					Value_type<plain_type<I1>>,
+					Value_type<plain_type<I2>>,
+					Value_type<plain_type<Is>>...
+				)>
+		>
+		static Z_<U> zipWith(F f, Zc&& z, I1&& i1, I2&& i2, Is&&...is) {
+			Z_<U> result;
+			_dtl::reserve_n(result, _dtl::shortest(z, i1, i2, is...), 0);
+
+			_dtl::zip_walk(
+				_dtl::back_sink<Z_<U>>{result},
+				f,
+				gen_seq<0,sizeof...(Is)+2>(),
+				std::forward<Zc>(z),
+				std::forward<I1>(i1),
+				std::forward<I2>(i2),
+				std::forward<Is>(is)...
+			);
+
+			_dtl::note_container_alloc(result);
 			return result;
 		}
 
 		static constexpr bool instance = true;
 
+	private:
+		template<bool MoveZ, bool MoveI, typename U, typename F, typename C, typename I>
+		static Z_<U> zip_into(F& f, C& z, I& i) {
+			Z_<U> result;
+			_dtl::zip_elements<MoveZ,MoveI>(result, f, z, i, 0);
+
+			_dtl::note_container_alloc(result);
+			return result;
+		}
 	};
 
+	/**
+	 * Split a container of tuples into a tuple of containers.
+	 *
+	 * The inverse of `zip`: element `i` of every tuple in `rows` goes into
+	 * the `i`th container of the result, in order. Every column is reserved
+	 * up front, if `rows` knows its size, and filled in a single pass. If
+	 * `rows` is a temporary, the elements are moved rather than copied.
+	 *
+	 * Works with anything \ref fwditerable whose elements are tuple-like
+	 * (so `std::pair` and `std::array` too), and whose rebound types have
+	 * `push_back`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<std::tuple<int,std::string>> rows{
+	 *       std::make_tuple(1, "a"), std::make_tuple(2, "b")
+	 *   };
+	 *
+	 *   auto cols = unzip(rows);
+	 *   // std::get<0>(cols) == std::vector<int>{1,2}
+	 *   // std::get<1>(cols) == std::vector<std::string>{"a","b"}
+	 * \endcode
+	 *
+	 * \ingroup zippable
+	 */
+	template<
+			typename C,
+			typename C_ = plain_type<C>,
+			typename Tup = Value_type<C_>,
+			typename Is = gen_seq<0,std::tuple_size<Tup>::value-1>,
+			typename R = typename _dtl::unzipped<C_,Tup,Is>::type,
+			typename = Requires<ForwardIterable<C_>()>
+	>
+	R unzip(C&& rows) {
+		R cols;
+		_dtl::unzip_into<!std::is_lvalue_reference<C>::value>(cols, rows, Is());
+
+		return cols;
+	}
+
 #ifndef DOCUMENTATION_GENERATOR
 	constexpr struct _zipWith : public _dtl::curried_ternf<_zipWith>
 	{
 		template<
 				typename F, typename Z, typename I,
-				typename = Requires<Zippable<Z>{}>
+				typename Z_ = plain_type<Z>,
+				typename = Requires<Zippable<Z_>{}>
+		>
+		auto operator() (F&& f, Z&& z, I&& i) const
+		-> decltype(zippable<Z_>::zipWith(
+			std::forward<F>(f), std::forward<Z>(z), std::forward<I>(i)
+		)) {
+			return zippable<Z_>::zipWith(
+				std::forward<F>(f), std::forward<Z>(z), std::forward<I>(i)
+			);
+		}
+
+		template<
+				typename F, typename Z, typename I1, typename I2,
+				typename...Is,
+				typename Z_ = plain_type<Z>,
+				typename = Requires<Zippable<Z_>{}>
 		>
-		auto operator() (F&& f, const Z& z, const I& i) const
-		-> decltype(zippable<Z>::zipWith(std::forward<F>(f), z, i)) {
-			return zippable<Z>::zipWith(std::forward<F>(f), z, i);
+		auto operator() (F&& f, Z&& z, I1&& i1, I2&& i2, Is&&...is) const
+		-> decltype(zippable<Z_>::zipWith(
+			std::forward<F>(f), std::forward<Z>(z),
+			std::forward<I1>(i1), std::forward<I2>(i2), std::forward<Is>(is)...
+		)) {
+			return zippable<Z_>::zipWith(
+				std::forward<F>(f), std::forward<Z>(z),
+				std::forward<I1>(i1), std::forward<I2>(i2),
+				std::forward<Is>(is)...
+			);
 		}
 
 		using curried_ternf<_zipWith>::operator();
@@ -226,10 +592,20 @@ namespace ftl {
 	 *
 	 * Allows a clean and terse call syntax of the concept method.
 	 *
+	 * Any number of containers may be zipped at once, in which case `f`
+	 * takes one argument per container. This is supported by the containers
+	 * deriving `deriving_zippable<back_insertable_container<Z>>`, as well as
+	 * `std::forward_list`. The zip is done in a single pass, without any
+	 * intermediate containers.
+	 *
 	 * \par Examples
 	 *
 	 * \code
 	 *   auto z = ftl::zipWith(foo, std::list{...}, std::list{...});
+	 *
+	 *   auto w = ftl::zipWith(
+	 *       [](int a, int b, int c){ return a*b + c; }, as, bs, cs
+	 *   );
 	 * \endcode
 	 *
 	 * \ingroup zippable
@@ -259,15 +635,55 @@ namespace ftl {
 			}
 		};
 
+		template<typename...Ts>
+		struct mktupn {
+			template<typename...Xs>
+			std::tuple<Ts...> operator() (Xs&&...xs) const {
+				return std::tuple<Ts...>(std::forward<Xs>(xs)...);
+			}
+		};
+
 	public:
 		template<
 				typename Z, typename I,
-				typename = Requires<Zippable<Z>{}>
+				typename Z_ = plain_type<Z>,
+				typename I_ = plain_type<I>,
+				typename = Requires<Zippable<Z_>{}>
 		>
-		auto operator() (const Z& z, const I& i) const
-		-> decltype(zippable<Z>::zipWith(mktup<Value_type<Z>,Value_type<I>>{}, z, i)) {
+		auto operator() (Z&& z, I&& i) const
+		-> decltype(zippable<Z_>::zipWith(
+			mktup<Value_type<Z_>,Value_type<I_>>{},
+			std::forward<Z>(z), std::forward<I>(i)
+		)) {
+
+			return zippable<Z_>::zipWith(
+				mktup<Value_type<Z_>,Value_type<I_>>{},
+				std::forward<Z>(z), std::forward<I>(i)
+			);
+		}
 
-			return zippable<Z>::zipWith(mktup<Value_type<Z>,Value_type<I>>{}, z, i);
+		template<
+				typename Z, typename I1, typename I2, typename...Is,
+				typename Z_ = plain_type<Z>,
+				typename Tup = mktupn<
+					Value_type<Z_>,
+					Value_type<plain_type<I1>>,
+					Value_type<plain_type<I2>>,
+					Value_type<plain_type<Is>>...
+				>,
+				typename = Requires<Zippable<Z_>{}>
+		>
+		auto operator() (Z&& z, I1&& i1, I2&& i2, Is&&...is) const
+		-> decltype(zippable<Z_>::zipWith(
+			Tup{}, std::forward<Z>(z),
+			std::forward<I1>(i1), std::forward<I2>(i2), std::forward<Is>(is)...
+		)) {
+
+			return zippable<Z_>::zipWith(
+				Tup{}, std::forward<Z>(z),
+				std::forward<I1>(i1), std::forward<I2>(i2),
+				std::forward<Is>(is)...
+			);
 		}
 
 		using curried_binf<_zip>::operator();
@@ -284,7 +700,8 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * In other words, zipping two lists with this function object results in
-	 * a list containing pairs of elements.
+	 * a list containing pairs of elements. Zipping more lists gives flat
+	 * tuples with one element per list, rather than nested pairs.
 	 *
 	 * \par Examples
 	 *
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_COROUTINE_H
+#define FTL_COROUTINE_H
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "ftl/coroutine.h requires C++20 coroutine support"
+#endif
+
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include "maybe.h"
+#include "either.h"
+#include "future.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup coroutine Coroutines
+	 *
+	 * `co_await` support for maybe, either and ftl::future.
+	 *
+	 * \code
+	 *   #include <ftl/coroutine.h>
+	 * \endcode
+	 *
+	 * This header is opt-in, and requires a C++20 compiler. Including it makes
+	 * functions returning `maybe<T>`, `either<L,T>` and `ftl::future<T>` into
+	 * coroutines, as soon as they use `co_await` or `co_return`.
+	 *
+	 * In a coroutine returning `maybe<T>`, `co_await m` on a `maybe<U>`
+	 * either yields the contained `U`, or, if `m` is nothing, abandons the
+	 * rest of the body and makes the result nothing. The same goes for
+	 * `either<L,T>`, awaiting `either<L,U>`: a left value is propagated as
+	 * the result. This is the same short-circuiting as monadic bind, without
+	 * nesting a lambda for every step, and without allocating one closure per
+	 * step; there is a single coroutine frame for the whole body.
+	 *
+	 * `co_await` on an `ftl::future` suspends until the future is ready,
+	 * then resumes on whichever thread completed it. A coroutine returning
+	 * `ftl::future<T>` runs eagerly, up to its first suspension, and fulfils
+	 * its future when it finishes. Exceptions escaping the body are stored in
+	 * the future.
+	 *
+	 * \code
+	 *   maybe<int> parse(const std::string&);
+	 *
+	 *   maybe<int> sum(const std::string& a, const std::string& b) {
+	 *       int x = co_await parse(a);
+	 *       int y = co_await parse(b);
+	 *       co_return x + y;
+	 *   }
+	 * \endcode
+	 *
+	 * The maybe and either coroutines hand their result over when their
+	 * return object is converted, which relies on the compiler performing
+	 * that conversion once the coroutine first returns to its caller. This is
+	 * the case for GCC from version 10, MSVC, and Clang from version 17.
+	 *
+	 * The transformers (`maybeT`, `eitherT`) are not covered, as they carry
+	 * their short-circuit state inside another monad, which a coroutine
+	 * cannot inspect without first awaiting the inner monad itself. Awaiting
+	 * an `ftl::future` inside a coroutine returning `ftl::future<maybe<T>>`
+	 * covers the common case.
+	 *
+	 * \par Dependencies
+	 * - `<coroutine>`
+	 * - `<optional>`
+	 * - `<exception>`
+	 * - \ref maybe
+	 * - \ref either
+	 * - \ref future
+	 */
+
+	namespace _dtl {
+		// Where a short-circuiting coroutine leaves its result
+		template<typename R>
+		struct co_result_state {
+			std::optional<R> result;
+			std::exception_ptr error;
+		};
+
+		/* Return object of short-circuiting coroutines.
+		 *
+		 * The coroutine either runs to completion or stops at the first
+		 * failing co_await, in both cases staying suspended so the result can
+		 * be moved out here.
+		 */
+		template<typename R>
+		class co_result {
+		public:
+			co_result(std::coroutine_handle<> h, co_result_state<R>* s) noexcept
+			: h(h), s(s) {}
+
+			co_result(const co_result&) = delete;
+			co_result(co_result&& r) noexcept : h(r.h), s(r.s) {
+				r.h = nullptr;
+			}
+
+			~co_result() {
+				if(h)
+					h.destroy();
+			}
+
+			operator R() {
+				if(s->error) {
+					// The exception leaves the coroutine's ramp, which frees
+					// the frame on the way out
+					h = nullptr;
+					std::rethrow_exception(s->error);
+				}
+
+				return std::move(*s->result);
+			}
+
+		private:
+			std::coroutine_handle<> h;
+			co_result_state<R>* s;
+		};
+
+		template<typename R, typename P>
+		struct co_result_promise : co_result_state<R> {
+			co_result<R> get_return_object() noexcept {
+				return co_result<R>{
+					std::coroutine_handle<P>::from_promise(static_cast<P&>(*this)),
+					this
+				};
+			}
+
+			std::suspend_never initial_suspend() const noexcept {
+				return {};
+			}
+
+			std::suspend_always final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() noexcept {
+				this->error = std::current_exception();
+			}
+		};
+
+		/* Awaiter for an M in a coroutine returning R
+		 *
+		 * V is the type of the value yielded on success, and Fail converts M's
+		 * failure into an R.
+		 */
+		template<typename M, typename V, typename R, typename Fail>
+		struct co_short_circuit {
+			M m;
+
+			bool await_ready() const noexcept {
+				return m.template is<V>();
+			}
+
+			void await_suspend(std::coroutine_handle<> h) {
+				(void)h;
+				s->result.emplace(Fail::fail(std::move(m)));
+			}
+
+			V await_resume() {
+				return std::move(get<V>(m));
+			}
+
+			co_result_state<R>* s;
+		};
+
+		template<typename T>
+		struct maybe_fail {
+			template<typename U>
+			static maybe<T> fail(maybe<U>&&) {
+				return maybe<T>{constructor<Nothing>()};
+			}
+		};
+
+		template<typename T>
+		struct maybe_promise : co_result_promise<maybe<T>,maybe_promise<T>> {
+			template<typename U>
+			void return_value(U&& u) {
+				this->result.emplace(constructor<T>(), std::forward<U>(u));
+			}
+
+			template<typename U>
+			auto await_transform(maybe<U> m) {
+				using A = co_short_circuit<maybe<U>,U,maybe<T>,maybe_fail<T>>;
+				return A{std::move(m), this};
+			}
+		};
+
+		template<typename L, typename R>
+		struct either_fail {
+			template<typename U>
+			static either<L,R> fail(either<L,U>&& e) {
+				return either<L,R>{
+					constructor<Left<L>>(), std::move(get<Left<L>>(e))
+				};
+			}
+		};
+
+		template<typename L, typename R>
+		struct either_promise
+		: co_result_promise<either<L,R>,either_promise<L,R>> {
+			template<typename U>
+			void return_value(U&& u) {
+				this->result.emplace(constructor<Right<R>>(), std::forward<U>(u));
+			}
+
+			template<typename U>
+			auto await_transform(either<L,U> e) {
+				struct awaiter
+				: co_short_circuit<either<L,U>,Right<U>,either<L,R>,either_fail<L,R>> {
+					U await_resume() {
+						return std::move(*get<Right<U>>(this->m));
+					}
+				};
+
+				return awaiter{{std::move(e), this}};
+			}
+		};
+
+		template<typename T>
+		struct future_promise_base {
+			promise<T> p;
+
+			template<typename U>
+			void return_value(U&& u) {
+				p.set_value(std::forward<U>(u));
+			}
+		};
+
+		template<>
+		struct future_promise_base<void> {
+			promise<void> p;
+
+			void return_void() {
+				p.set_value();
+			}
+		};
+
+		template<typename T>
+		struct future_promise : future_promise_base<T> {
+			future<T> get_return_object() {
+				return this->p.get_future();
+			}
+
+			std::suspend_never initial_suspend() const noexcept {
+				return {};
+			}
+
+			std::suspend_never final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() noexcept {
+				this->p.set_exception(std::current_exception());
+			}
+		};
+
+		template<typename T>
+		struct future_awaiter {
+			future<T> f;
+
+			bool await_ready() const {
+				return f.is_ready();
+			}
+
+			void await_suspend(std::coroutine_handle<> h) {
+				// May resume h right here, if f became ready in the meantime
+				future_access::state(f)->on_ready([h](){ h.resume(); });
+			}
+
+			T await_resume() {
+				return f.get();
+			}
+		};
+	}
+
+	/**
+	 * Suspend the current coroutine until `f` is ready.
+	 *
+	 * The coroutine is resumed on the thread that completed `f`, or inline,
+	 * if `f` is already ready. After resuming, `co_await` yields the value
+	 * of `f`, or throws its exception.
+	 *
+	 * \ingroup coroutine
+	 */
+	template<typename T>
+	_dtl::future_awaiter<T> operator co_await (future<T>&& f) {
+		return _dtl::future_awaiter<T>{std::move(f)};
+	}
+}
+
+namespace std {
+	template<typename T, typename...Args>
+	struct coroutine_traits<::ftl::sum_type<T,::ftl::Nothing>, Args...> {
+		using promise_type = ::ftl::_dtl::maybe_promise<T>;
+	};
+
+	template<typename L, typename R, typename...Args>
+	struct coroutine_traits<
+		::ftl::sum_type<::ftl::Left<L>,::ftl::Right<R>>, Args...
+	> {
+		using promise_type = ::ftl::_dtl::either_promise<L,R>;
+	};
+
+	template<typename T, typename...Args>
+	struct coroutine_traits<::ftl::future<T>, Args...> {
+		using promise_type = ::ftl::_dtl::future_promise<T>;
+	};
+}
+
+#endif
+
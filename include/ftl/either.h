@@ -23,6 +23,8 @@
 #ifndef FTL_EITHER_H
 #define FTL_EITHER_H
 
+#include <vector>
+#include <utility>
 #include "sum_type.h"
 #include "concepts/orderable.h"
 #include "concepts/monad.h"
@@ -40,6 +42,8 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * The following additional headers and modules are included by this module.
+	 * - `<vector>`
+	 * - `<utility>`
 	 * - \ref sum_type
 	 * - \ref monad
 	 * - \ref orderable
@@ -92,6 +96,9 @@ namespace ftl {
 	 * - \ref applicative (in R)
 	 * - \ref monad (in R)
 	 *
+	 * Switching an `either` between its sides in place is done with
+	 * `e.emplace<Left<L>>(args...)` or `e.emplace<Right<R>>(args...)`.
+	 *
 	 * \par Examples
 	 *
 	 * Basic pattern matching:
@@ -170,6 +177,9 @@ namespace ftl {
 		Left(Left&&) = default;
 		~Left() = default;
 
+		Left& operator= (const Left&) = default;
+		Left& operator= (Left&&) = default;
+
 		explicit constexpr Left(const T& t) : val(t) {}
 		explicit constexpr Left(T&& t) : val(std::move(t)) {}
 
@@ -178,14 +188,19 @@ namespace ftl {
 			return either<T,R>{constructor<Left<T>>{}, val};
 		}
 
-		T& operator* () noexcept {
+		T& operator* () & noexcept {
 			return val;
 		}
 
-		constexpr const T& operator* () const noexcept {
+		constexpr const T& operator* () const & noexcept {
 			return val;
 		}
 
+		/// Moves the value out of a temporary.
+		T&& operator* () && noexcept {
+			return std::move(val);
+		}
+
 		T* operator-> () noexcept {
 			return std::addressof(val);
 		}
@@ -356,8 +371,7 @@ namespace ftl {
 	 */
 	template<typename L, typename T>
 	struct monad<either<L,T>>
-	: deriving_join<in_terms_of_bind<either<L,T>>>
-	, deriving_apply<in_terms_of_bind<either<L,T>>> {
+	: deriving_join<in_terms_of_bind<either<L,T>>> {
 
 		/**
 		 * Embeds a value as a right value.
@@ -419,6 +433,48 @@ namespace ftl {
 			);
 		}
 
+		/**
+		 * Apply a function in a right value to a right value.
+		 *
+		 * The result is the first left value of `ef` and `e`, if either is
+		 * one. Temporary operands are moved from: the function into the call,
+		 * and the value into the function.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static either<L,U> apply(const either<L,F>& ef, const either<L,T>& e) {
+			return ef.match(
+				[&e](const Right<F>& f){ return map(*f, e); },
+				[](const Left<L>& l){ return make_left<U>(*l); }
+			);
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static either<L,U> apply(const either<L,F>& ef, either<L,T>&& e) {
+			return ef.match(
+				[&e](const Right<F>& f){ return map(*f, std::move(e)); },
+				[](const Left<L>& l){ return make_left<U>(*l); }
+			);
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static either<L,U> apply(either<L,F>&& ef, const either<L,T>& e) {
+			return ef.match(
+				[&e](Right<F>& f){ return map(std::move(*f), e); },
+				[](Left<L>& l){ return make_left<U>(std::move(*l)); }
+			);
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static either<L,U> apply(either<L,F>&& ef, either<L,T>&& e) {
+			return ef.match(
+				[&e](Right<F>& f){ return map(std::move(*f), std::move(e)); },
+				[](Left<L>& l){ return make_left<U>(std::move(*l)); }
+			);
+		}
+
 		/**
 		 * Bind `e` with the monadic computation `f`.
 		 *
@@ -449,6 +505,261 @@ namespace ftl {
 
 		static constexpr bool instance = true;
 	};
+
+	namespace _dtl {
+		template<typename E>
+		struct either_left {};
+
+		template<typename L, typename R>
+		struct either_left<either<L,R>> {
+			using type = L;
+		};
+
+		template<typename L, typename R, typename A>
+		void reserve_eithers(
+				std::pair<std::vector<L>,std::vector<R>>& r,
+				const std::vector<either<L,R>,A>& v) {
+			size_t n = 0;
+			for(auto& e : v)
+				n += e.template is<Left<L>>();
+
+			r.first.reserve(n);
+			r.second.reserve(v.size() - n);
+		}
+
+		template<typename L, typename R>
+		void push_either(
+				std::pair<std::vector<L>,std::vector<R>>& r, either<L,R>&& e) {
+			if(e.template is<Left<L>>())
+				r.first.push_back(std::move(*get<0>(e)));
+			else
+				r.second.push_back(std::move(*get<1>(e)));
+		}
+	}
+
+	/**
+	 * Turn a vector of `either`s into an `either` vector.
+	 *
+	 * The result is the first left value of `v`, if there is one; otherwise,
+	 * it holds all the right values of `v`, in order. Stops at the first
+	 * left value, and reserves the resulting vector only once.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<either<std::string,int>> v{
+	 *       make_right<std::string>(1),
+	 *       make_left<int>(std::string("bad")),
+	 *       make_left<int>(std::string("worse"))
+	 *   };
+	 *   auto e = sequence(v);
+	 *   // e == make_left<std::vector<int>>(std::string("bad"))
+	 * \endcode
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	either<L,std::vector<R>> sequence(const std::vector<either<L,R>,A>& v) {
+		std::vector<R> r;
+		r.reserve(v.size());
+
+		for(auto& e : v) {
+			if(e.template is<Left<L>>())
+				return make_left<std::vector<R>>(*get<0>(e));
+
+			r.push_back(*get<1>(e));
+		}
+
+		return make_right<L>(std::move(r));
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Moves the values out of `v`.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	either<L,std::vector<R>> sequence(std::vector<either<L,R>,A>&& v) {
+		std::vector<R> r;
+		r.reserve(v.size());
+
+		for(auto& e : v) {
+			if(e.template is<Left<L>>())
+				return make_left<std::vector<R>>(std::move(*get<0>(e)));
+
+			r.push_back(std::move(*get<1>(e)));
+		}
+
+		return make_right<L>(std::move(r));
+	}
+
+	/**
+	 * Map `f` over a vector, collecting the results if none is a left value.
+	 *
+	 * Equivalent to `sequence(f % v)`, but without the intermediate vector.
+	 * `f` is invoked on the elements in order, and not at all on those after
+	 * the first left value it returns, which becomes the result.
+	 *
+	 * \tparam F must be callable with `const T&`, returning an `either`.
+	 *
+	 * \ingroup either
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename E = result_of<F(const T&)>,
+			typename L = typename _dtl::either_left<E>::type,
+			typename U = Value_type<E>
+	>
+	either<L,std::vector<U>> traverse(F f, const std::vector<T,A>& v) {
+		std::vector<U> r;
+		r.reserve(v.size());
+
+		for(auto& x : v) {
+			auto e = f(x);
+			if(e.template is<Left<L>>())
+				return make_left<std::vector<U>>(std::move(*get<0>(e)));
+
+			r.push_back(std::move(*get<1>(e)));
+		}
+
+		return make_right<L>(std::move(r));
+	}
+
+	/**
+	 * Split a vector of `either`s into its left and its right values.
+	 *
+	 * Both halves keep the order of `v`. Which alternative each element
+	 * holds is counted first, so that both halves are reserved exactly.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<either<std::string,int>> v{
+	 *       make_right<std::string>(1),
+	 *       make_left<int>(std::string("bad")),
+	 *       make_right<std::string>(2)
+	 *   };
+	 *   auto r = partitionEithers(v);
+	 *   // r.first == {"bad"}, r.second == {1,2}
+	 * \endcode
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	std::pair<std::vector<L>,std::vector<R>> partitionEithers(
+			const std::vector<either<L,R>,A>& v) {
+		std::pair<std::vector<L>,std::vector<R>> r;
+		_dtl::reserve_eithers(r, v);
+
+		for(auto& e : v) {
+			if(e.template is<Left<L>>())
+				r.first.push_back(*get<0>(e));
+			else
+				r.second.push_back(*get<1>(e));
+		}
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Moves the values out of `v`.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename R, typename A>
+	std::pair<std::vector<L>,std::vector<R>> partitionEithers(
+			std::vector<either<L,R>,A>&& v) {
+		std::pair<std::vector<L>,std::vector<R>> r;
+		_dtl::reserve_eithers(r, v);
+
+		for(auto& e : v) {
+			if(e.template is<Left<L>>())
+				r.first.push_back(std::move(*get<0>(e)));
+			else
+				r.second.push_back(std::move(*get<1>(e)));
+		}
+
+		return r;
+	}
+
+	/**
+	 * Map `f` over a vector, splitting the results into left and right values.
+	 *
+	 * Equivalent to `partitionEithers(f % v)`, but without the intermediate
+	 * vector. Unlike `traverse`, a left value does not stop the mapping.
+	 * As `f` is only invoked once per element, the halves cannot be
+	 * reserved exactly. Instead, both are reserved room for all of `v`, so
+	 * neither is ever reallocated; `shrink_to_fit` whichever is to be kept
+	 * for long.
+	 *
+	 * \tparam F must be callable with `const T&`, returning an `either`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto parse = [](const std::string& s) -> either<std::string,int> {
+	 *       ...
+	 *   };
+	 *   auto r = mapEither(parse, lines);
+	 *   // r.first holds every error, r.second every parsed value
+	 * \endcode
+	 *
+	 * \ingroup either
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			// Not result_of, lest an f that only takes r-values be an error
+			// rather than a reason to pick the other overload
+			typename E = plain_type<typename std::result_of<F(const T&)>::type>,
+			typename L = typename _dtl::either_left<E>::type,
+			typename U = Value_type<E>
+	>
+	std::pair<std::vector<L>,std::vector<U>> mapEither(
+			F f, const std::vector<T,A>& v) {
+		std::pair<std::vector<L>,std::vector<U>> r;
+		r.first.reserve(v.size());
+		r.second.reserve(v.size());
+
+		for(auto& x : v)
+			_dtl::push_either(r, f(x));
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Passes the elements of `v` to `f` as r-values.
+	 *
+	 * \ingroup either
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename E = result_of<F(T&&)>,
+			typename L = typename _dtl::either_left<E>::type,
+			typename U = Value_type<E>
+	>
+	std::pair<std::vector<L>,std::vector<U>> mapEither(
+			F f, std::vector<T,A>&& v) {
+		std::pair<std::vector<L>,std::vector<U>> r;
+		r.first.reserve(v.size());
+		r.second.reserve(v.size());
+
+		for(auto& x : v)
+			_dtl::push_either(r, f(std::move(x)));
+
+		return r;
+	}
 }
 
 #endif
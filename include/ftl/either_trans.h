@@ -23,6 +23,7 @@
 #ifndef FTL_EITHER_TRANS_H
 #define FTL_EITHER_TRANS_H
 
+#include <vector>
 #include "prelude.h"
 #include "either.h"
 #include "concepts/monoid.h"
@@ -142,12 +143,129 @@ namespace ftl {
 		using rebind = eitherT<L,Rebind<M,T>>;
 	};
 
+	namespace _dtl {
+		/*
+		 * Binds of eitherT over Met that skip Met's own bind, so that each
+		 * bind costs a single continuation. Only specialised for base monads
+		 * where that makes a difference.
+		 */
+		template<typename Met>
+		struct fused_eitherT : std::false_type {};
+
+		/*
+		 * Going through function's bind would wrap every step in two
+		 * closures, allocate a pure function for every left value, and copy
+		 * the function of the continuation before running it.
+		 */
+		template<typename L, typename T, typename...Ps>
+		struct fused_eitherT<function<either<L,T>(Ps...)>> : std::true_type {
+			template<typename U>
+			using Fn = function<either<L,U>(Ps...)>;
+
+			// f returns an eitherT
+			template<typename U, typename F>
+			static Fn<U> bind(Fn<T> m, F f) {
+				return [m,f](Ps...ps) -> either<L,U> {
+					auto e = m(ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<0>(e)));
+
+					return (*f(std::move(*get<1>(e))))(ps...);
+				};
+			}
+
+			// f returns a function, lifted into eitherT
+			template<typename U, typename F>
+			static Fn<U> lift(Fn<T> m, F f) {
+				return [m,f](Ps...ps) -> either<L,U> {
+					auto e = m(ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<0>(e)));
+
+					return make_right<L>(f(std::move(*get<1>(e)))(ps...));
+				};
+			}
+
+			// f returns a plain either, hoisted into eitherT
+			template<typename U, typename F>
+			static Fn<U> hoist(Fn<T> m, F f) {
+				return [m,f](Ps...ps) -> either<L,U> {
+					auto e = m(ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<0>(e)));
+
+					return f(std::move(*get<1>(e)));
+				};
+			}
+
+			/*
+			 * Computations tried in order until one returns a right value,
+			 * with the left values of the failed ones appended together.
+			 */
+			struct alternatives {
+				std::vector<Fn<T>> fs;
+
+				either<L,T> operator() (Ps...ps) const {
+					auto it = fs.begin();
+					auto e = (*it)(ps...);
+					if(e.template is<Right<T>>())
+						return e;
+
+					L l = std::move(*get<0>(e));
+					for(++it; it != fs.end(); ++it) {
+						auto e2 = (*it)(ps...);
+						if(e2.template is<Right<T>>())
+							return e2;
+
+						l = monoid<L>::append(std::move(l), std::move(*get<0>(e2)));
+					}
+
+					return make_left<T>(std::move(l));
+				}
+			};
+
+			/*
+			 * Chains of orDo all end up in the same list of alternatives,
+			 * which is reused outright when the left-hand chain is a temporary.
+			 */
+			static Fn<T> orDo(Fn<T>&& e1, const Fn<T>& e2) {
+				if(auto alts = e1.template target<alternatives>()) {
+					push(*alts, e2);
+					return std::move(e1);
+				}
+
+				return orDo(static_cast<const Fn<T>&>(e1), e2);
+			}
+
+			static Fn<T> orDo(const Fn<T>& e1, const Fn<T>& e2) {
+				alternatives alts;
+				push(alts, e1);
+				push(alts, e2);
+
+				return alts;
+			}
+
+		private:
+			static void push(alternatives& alts, const Fn<T>& e) {
+				if(auto es = e.template target<alternatives>())
+					alts.fs.insert(alts.fs.end(), es->fs.begin(), es->fs.end());
+
+				else
+					alts.fs.push_back(e);
+			}
+		};
+	}
+
 	/**
 	 * Monad instance for `eitherT`.
 	 *
 	 * In essence, composes the basic monadic operations of `M` with
 	 * `ftl::either`.
 	 *
+	 * Where `M` is an `ftl::function`, as for parsers, binds do not go
+	 * through the function monad. Instead, each bind makes a single function
+	 * that runs the computation, and the continuation only on right values.
+	 *
 	 * \ingroup eitherT
 	 */
 	template<typename L, typename M>
@@ -228,6 +346,8 @@ namespace ftl {
 		static constexpr bool instance = true;
 
 	private:
+		using fused = _dtl::fused_eitherT<M_<either<L,T>>>;
+
 		// Helper struct required to implement automatic lift and hoist
 		template<typename M2>
 		struct bind_helper {
@@ -239,6 +359,31 @@ namespace ftl {
 					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
 			>
 			static eT<U> bind(const eT<T>& e, F f) {
+				return bind(e, std::move(f), fused{});
+			}
+
+			template<
+					typename F,
+					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
+			>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return bind(std::move(e), std::move(f), fused{});
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::true_type) {
+				return eT<U>{fused::template lift<U>(*e, std::move(f))};
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f, std::true_type) {
+				return eT<U>{
+					fused::template lift<U>(std::move(*e), std::move(f))
+				};
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::false_type) {
 				return eT<U>{
 					*e >>= [f](const either<L,T>& e) {
 						return e.match(
@@ -251,11 +396,8 @@ namespace ftl {
 				};
 			}
 
-			template<
-					typename F,
-					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
-			>
-			static eT<U> bind(eT<T>&& e, F f) {
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f, std::false_type) {
 				return eT<U>{
 					std::move(*e) >>= [f](either<L,T>&& e) {
 						return e.match(
@@ -276,6 +418,28 @@ namespace ftl {
 
 			template<typename F>
 			static eT<U> bind(const eT<T>& e, F f) {
+				return bind(e, std::move(f), fused{});
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return bind(std::move(e), std::move(f), fused{});
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::true_type) {
+				return eT<U>{fused::template bind<U>(*e, std::move(f))};
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f, std::true_type) {
+				return eT<U>{
+					fused::template bind<U>(std::move(*e), std::move(f))
+				};
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::false_type) {
 				return eT<U>{
 					*e >>= [f](const either<L,T>& e) {
 						return e.match(
@@ -287,7 +451,7 @@ namespace ftl {
 			}
 
 			template<typename F>
-			static eT<U> bind(eT<T>&& e, F f) {
+			static eT<U> bind(eT<T>&& e, F f, std::false_type) {
 				return eT<U>{
 					std::move(*e) >>= [f](either<L,T>&& e) -> M_<either<L,U>> {
 						return e.match(
@@ -305,6 +469,28 @@ namespace ftl {
 
 			template<typename F>
 			static eT<U> bind(const eT<T>& e, F f) {
+				return bind(e, std::move(f), fused{});
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return bind(std::move(e), std::move(f), fused{});
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::true_type) {
+				return eT<U>{fused::template hoist<U>(*e, std::move(f))};
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f, std::true_type) {
+				return eT<U>{
+					fused::template hoist<U>(std::move(*e), std::move(f))
+				};
+			}
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f, std::false_type) {
 				return e >>= [f](const T& t) {
 					return eT<U>{
 						monad<M_<either<L,U>>>::pure(
@@ -315,7 +501,7 @@ namespace ftl {
 			}
 
 			template<typename F>
-			static eT<U> bind(eT<T>&& e, F f) {
+			static eT<U> bind(eT<T>&& e, F f, std::false_type) {
 				return std::move(e) >>= [f](T&& t) {
 					return eT<U>{
 						monad<M_<either<L,U>>>::pure(
@@ -418,8 +604,36 @@ namespace ftl {
 		 * `e2` is checked for rightness. If both `e1` and `e2` wrap left
 		 * values, they are combined using `monoid<L>::append` and a new left
 		 * value (embedded as if by `monad<M>::pure`) is returned.
+		 *
+		 * Where `M` is an `ftl::function`, as for parsers, a chain such as
+		 * `a | b | c` is kept as one flat list of alternatives, run in a
+		 * single loop.
 		 */
 		static eitherT<L,M> orDo(const eitherT<L,M>& e1, eitherT<L,M> e2) {
+			return orDo(e1, std::move(e2), fused{});
+		}
+
+		static eitherT<L,M> orDo(eitherT<L,M>&& e1, eitherT<L,M> e2) {
+			return orDo(std::move(e1), std::move(e2), fused{});
+		}
+
+		static constexpr bool instance = monoid<L>::instance;
+
+	private:
+		using fused = _dtl::fused_eitherT<Met>;
+
+		static eitherT<L,M> orDo(
+				const eitherT<L,M>& e1, eitherT<L,M> e2, std::true_type) {
+			return eitherT<L,M>{fused::orDo(*e1, *e2)};
+		}
+
+		static eitherT<L,M> orDo(
+				eitherT<L,M>&& e1, eitherT<L,M> e2, std::true_type) {
+			return eitherT<L,M>{fused::orDo(std::move(*e1), *e2)};
+		}
+
+		static eitherT<L,M> orDo(
+				const eitherT<L,M>& e1, eitherT<L,M> e2, std::false_type) {
 			return eitherT<L,M> {
 				*e1 >>= [e2](const either<L,T>& e) -> Met {
 					if(e.template is<Right<T>>()) {
@@ -443,8 +657,6 @@ namespace ftl {
 				}
 			};
 		}
-
-		static constexpr bool instance = monoid<L>::instance;
 	};
 
 }	
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_EXECUTOR_H
+#define FTL_EXECUTOR_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include "function.h"
+
+namespace ftl {
+	/**
+	 * \page executorpg Executor
+	 *
+	 * Abstraction of places where tasks can be run.
+	 *
+	 * An executor is any type `E`, such that given an instance `e` and a
+	 * `unique_function<void()>` `task`, the expression
+	 * \code
+	 *   e.execute(std::move(task))
+	 * \endcode
+	 * is valid, and eventually invokes `task` exactly once. Where, and on
+	 * which thread, is up to the executor. Tasks must not throw.
+	 *
+	 * Combinators that accept an executor, such as `ftl::future::then` and
+	 * `ftl::spark`, take it by reference, and require it to outlive any task
+	 * they hand to it.
+	 *
+	 * \see \ref executor (module)
+	 */
+
+	/**
+	 * \defgroup executor Executor
+	 *
+	 * The \ref executorpg concept, and executors implementing it.
+	 *
+	 * \code
+	 *   #include <ftl/executor.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<thread>`
+	 * - `<mutex>`
+	 * - `<condition_variable>`
+	 * - `<atomic>`
+	 * - `<deque>`
+	 * - `<vector>`
+	 * - `<memory>`
+	 * - \ref function
+	 */
+
+	/**
+	 * Predicate to check whether a type satisfies \ref executorpg.
+	 *
+	 * \ingroup executor
+	 */
+	template<typename E>
+	struct is_executor {
+	private:
+		template<typename U>
+		static decltype(
+			std::declval<U&>().execute(std::declval<unique_function<void()>>()),
+			std::true_type()
+		) check(U*);
+
+		template<typename>
+		static std::false_type check(...);
+
+	public:
+		static constexpr bool value = decltype(check<E>(nullptr))::value;
+	};
+
+	/**
+	 * Executor that runs every task immediately, on the calling thread.
+	 *
+	 * \ingroup executor
+	 */
+	struct inline_executor {
+		void execute(unique_function<void()> task) {
+			task();
+		}
+	};
+
+	/**
+	 * A fixed size pool of threads, with work stealing.
+	 *
+	 * Every worker thread has its own queue of tasks. Tasks submitted by a
+	 * worker (e.g. a continuation that schedules further continuations) go on
+	 * that worker's own queue, and are run most recent first, which keeps
+	 * related work on the same core. Tasks submitted from any other thread
+	 * are spread over the queues in turn. A worker whose queue is empty
+	 * steals the oldest task of some other worker, before going to sleep.
+	 *
+	 * The number of threads is fixed at construction. Destroying the pool
+	 * waits for every task already submitted to finish.
+	 *
+	 * \par Concepts
+	 * - \ref executorpg
+	 *
+	 * \par Examples
+	 *
+	 * Pinning every worker to a core, on Linux:
+	 * \code
+	 *   ftl::thread_pool pool(4, [](size_t i) {
+	 *       cpu_set_t set;
+	 *       CPU_ZERO(&set);
+	 *       CPU_SET(i, &set);
+	 *       pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	 *   });
+	 * \endcode
+	 *
+	 * \ingroup executor
+	 */
+	class thread_pool {
+	public:
+		/**
+		 * Start a pool of `n` threads.
+		 *
+		 * If `n` is zero, one thread is started.
+		 */
+		explicit thread_pool(size_t n = default_size())
+		: thread_pool(n, function<void(size_t)>())
+		{}
+
+		/**
+		 * Start a pool of `n` threads, running `on_start` in each.
+		 *
+		 * `on_start` is invoked by each worker thread, with the index of the
+		 * worker (from `0` to `n-1`), before it runs any task. This is the
+		 * place to set e.g. thread affinity or priority.
+		 */
+		thread_pool(size_t n, function<void(size_t)> on_start) {
+			if(n == 0)
+				n = 1;
+
+			for(size_t i = 0; i < n; ++i)
+				queues.emplace_back(new worker_queue);
+
+			threads.reserve(n);
+			try {
+				for(size_t i = 0; i < n; ++i) {
+					threads.emplace_back([this,i,on_start](){
+						if(on_start)
+							on_start(i);
+
+						work(i);
+					});
+				}
+			}
+			catch(...) {
+				// Joinable threads must not be destroyed
+				stop();
+				throw;
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator= (const thread_pool&) = delete;
+
+		~thread_pool() {
+			stop();
+		}
+
+		/// Submit a task to be run by one of the workers.
+		void execute(unique_function<void()> task) {
+			auto& self = current();
+			size_t i = self.pool == this
+				? self.index
+				: next.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+			{
+				// Counted before the lock is released, lest a worker take
+				// the task and count it down first
+				std::lock_guard<std::mutex> lock(queues[i]->m);
+				queues[i]->tasks.push_back(std::move(task));
+				pending.fetch_add(1, std::memory_order_release);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(sleep_m);
+			}
+
+			sleep_cv.notify_one();
+		}
+
+		/// Number of worker threads.
+		size_t size() const noexcept {
+			return threads.size();
+		}
+
+		/// Number of hardware threads, or 1 if that is unknown.
+		static size_t default_size() noexcept {
+			auto n = std::thread::hardware_concurrency();
+			return n == 0 ? 1 : n;
+		}
+
+	private:
+		struct worker_queue {
+			std::mutex m;
+			std::deque<unique_function<void()>> tasks;
+		};
+
+		struct worker_id {
+			thread_pool* pool;
+			size_t index;
+		};
+
+		static worker_id& current() noexcept {
+			static thread_local worker_id id{nullptr, 0};
+			return id;
+		}
+
+		void stop() noexcept {
+			{
+				std::lock_guard<std::mutex> lock(sleep_m);
+				stopping = true;
+			}
+
+			sleep_cv.notify_all();
+
+			for(auto& t : threads)
+				t.join();
+		}
+
+		static void run(unique_function<void()>& task) noexcept {
+			task();
+		}
+
+		bool pop_local(size_t i, unique_function<void()>& task) {
+			auto& q = *queues[i];
+			std::lock_guard<std::mutex> lock(q.m);
+			if(q.tasks.empty())
+				return false;
+
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+
+		bool steal(size_t i, unique_function<void()>& task) {
+			for(size_t k = 1; k < queues.size(); ++k) {
+				auto& q = *queues[(i + k) % queues.size()];
+				std::lock_guard<std::mutex> lock(q.m);
+				if(!q.tasks.empty()) {
+					task = std::move(q.tasks.front());
+					q.tasks.pop_front();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void work(size_t i) {
+			current() = worker_id{this, i};
+
+			for(;;) {
+				unique_function<void()> task;
+				if(pop_local(i, task) || steal(i, task)) {
+					pending.fetch_sub(1, std::memory_order_relaxed);
+					run(task);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(sleep_m);
+				sleep_cv.wait(lock, [this](){
+					return stopping
+						|| pending.load(std::memory_order_acquire) > 0;
+				});
+
+				if(stopping && pending.load(std::memory_order_acquire) == 0)
+					return;
+			}
+		}
+
+		std::vector<std::unique_ptr<worker_queue>> queues;
+		std::vector<std::thread> threads;
+		std::atomic<size_t> pending{0};
+		std::atomic<size_t> next{0};
+		std::mutex sleep_m;
+		std::condition_variable sleep_cv;
+		bool stopping = false;
+	};
+}
+
+#endif
+
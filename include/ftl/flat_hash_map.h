@@ -0,0 +1,947 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FLAT_HASH_MAP_H
+#define FTL_FLAT_HASH_MAP_H
+
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <initializer_list>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "maybe.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup flat_hash_map Flat Hash Map
+	 *
+	 * Open addressing hash map, and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/flat_hash_map.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::flat_hash_map`:
+	 * - \ref functorpg
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 *
+	 * As with `std::unordered_map`, the iteration order, and thereby the
+	 * result of folds with non-commutative functions, is unspecified.
+	 *
+	 * \par Dependencies
+	 * - `<memory>`
+	 * - \ref maybe
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	namespace _dtl {
+		/*
+		 * Every slot of the table has a control byte: the low 7 bits of the
+		 * hash of its key if it is full, or one of the negative markers
+		 * below if not. Lookups compare a whole group of control bytes at a
+		 * time, and only look at the keys whose bytes match.
+		 */
+		constexpr size_t fh_group = 16;
+		constexpr signed char fh_empty = -128;
+		constexpr signed char fh_deleted = -2;
+
+		// Bit i is set if c[i] == b, for the group of bytes starting at c
+		inline unsigned fh_match(const signed char* c, signed char b) noexcept {
+#if defined(__SSE2__)
+			auto g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+			return static_cast<unsigned>(
+				_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b)))
+			);
+#else
+			unsigned m = 0;
+			for(size_t i = 0; i < fh_group; ++i)
+				m |= unsigned(c[i] == b) << i;
+
+			return m;
+#endif
+		}
+
+		// Bit i is set if c[i] is empty or deleted, i.e. negative
+		inline unsigned fh_match_free(const signed char* c) noexcept {
+#if defined(__SSE2__)
+			auto g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+			return static_cast<unsigned>(_mm_movemask_epi8(g));
+#else
+			unsigned m = 0;
+			for(size_t i = 0; i < fh_group; ++i)
+				m |= unsigned(c[i] < 0) << i;
+
+			return m;
+#endif
+		}
+
+		inline unsigned fh_lowest(unsigned m) noexcept {
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_ctz(m));
+#else
+			unsigned i = 0;
+			while(!(m & 1u)) {
+				m >>= 1;
+				++i;
+			}
+
+			return i;
+#endif
+		}
+
+		/*
+		 * Spread the entropy of a hash over all its bits. Hashes such as
+		 * std::hash<int> are often the identity, which would leave the
+		 * control bytes of consecutive keys all but equal.
+		 */
+		inline size_t fh_mix(size_t h) noexcept {
+			h *= static_cast<size_t>(0x9E3779B97F4A7C15ull);
+			return h ^ (h >> (sizeof(size_t) * 4));
+		}
+	}
+
+	/**
+	 * Hash map storing its elements directly in one array.
+	 *
+	 * Modelled on Abseil's "Swiss tables": keys are placed by open
+	 * addressing, and a separate array holds one control byte per slot, with
+	 * 7 bits of the key's hash. A lookup compares a group of 16 control
+	 * bytes in parallel (using SSE2 where available), and only compares keys
+	 * whose bytes matched. Typically, that is a single key, in the same
+	 * cache line as all its neighbours. There are no per-element
+	 * allocations, nor pointers to chase.
+	 *
+	 * The table is kept at most 7/8 full, and its capacity is a power of two.
+	 * Erased elements leave a marker behind, which is cleaned up by the next
+	 * rehash. Any insertion may rehash, invalidating all iterators and
+	 * references; erasing does not.
+	 *
+	 * Lookups that may fail are best done with `lookup`, which returns a
+	 * `maybe` holding a reference to the value.
+	 *
+	 * Iterators are `const`, and only iterate forwards. Values can be
+	 * changed through `operator[]`, `at`, `lookup` and `insert_or_assign`.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref eq, if `V` is
+	 * - \ref functorpg
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   flat_hash_map<std::string,int> m{{"one",1},{"two",2}};
+	 *
+	 *   auto n = m.lookup("one").match(
+	 *       [](int x){ return x; },
+	 *       [](Nothing){ return 0; }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup flat_hash_map
+	 */
+	template<
+			typename K,
+			typename V,
+			typename H = std::hash<K>,
+			typename E = std::equal_to<K>,
+			typename A = std::allocator<std::pair<K,V>>
+	>
+	class flat_hash_map {
+		using slot_alloc = typename std::allocator_traits<A>
+			::template rebind_alloc<std::pair<K,V>>;
+		using slot_traits = std::allocator_traits<slot_alloc>;
+		using ctrl_alloc = typename std::allocator_traits<A>
+			::template rebind_alloc<signed char>;
+		using ctrl_traits = std::allocator_traits<ctrl_alloc>;
+
+		template<typename, typename, typename, typename, typename>
+		friend class flat_hash_map;
+
+		template<typename>
+		friend struct functor;
+
+		template<typename>
+		friend struct foldable;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K,V>;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = H;
+		using key_equal = E;
+		using allocator_type = A;
+		using reference = const value_type&;
+		using const_reference = const value_type&;
+
+		/// Forward iterator over the elements, in unspecified order.
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::pair<K,V>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			const_iterator() = default;
+
+			reference operator* () const noexcept {
+				return m->slots[i];
+			}
+
+			pointer operator-> () const noexcept {
+				return &m->slots[i];
+			}
+
+			const_iterator& operator++ () noexcept {
+				++i;
+				skip();
+				return *this;
+			}
+
+			const_iterator operator++ (int) noexcept {
+				auto it = *this;
+				++*this;
+				return it;
+			}
+
+			bool operator== (const const_iterator& it) const noexcept {
+				return i == it.i;
+			}
+
+			bool operator!= (const const_iterator& it) const noexcept {
+				return i != it.i;
+			}
+
+		private:
+			friend class flat_hash_map;
+
+			const_iterator(const flat_hash_map* m, size_type i) noexcept
+			: m(m), i(i) {}
+
+			void skip() noexcept {
+				while(i < m->cap && m->ctrl[i] < 0)
+					++i;
+			}
+
+			const flat_hash_map* m = nullptr;
+			size_type i = 0;
+		};
+
+		using iterator = const_iterator;
+
+		flat_hash_map() = default;
+
+		explicit flat_hash_map(
+				size_type n,
+				const H& hash = H(),
+				const E& eq = E(),
+				const A& alloc = A())
+		: hash(hash), eq(eq), salloc(alloc), calloc(alloc) {
+			reserve(n);
+		}
+
+		template<
+				typename It,
+				typename = Requires<std::is_convertible<
+					typename std::iterator_traits<It>::iterator_category,
+					std::input_iterator_tag
+				>::value>
+		>
+		flat_hash_map(It first, It last, size_type n = 0, const H& hash = H())
+		: flat_hash_map(n, hash) {
+			for(; first != last; ++first)
+				insert(*first);
+		}
+
+		flat_hash_map(std::initializer_list<value_type> l)
+		: flat_hash_map(l.begin(), l.end(), l.size()) {}
+
+		flat_hash_map(const flat_hash_map& m)
+		: hash(m.hash), eq(m.eq)
+		, salloc(slot_traits::select_on_container_copy_construction(m.salloc))
+		, calloc(ctrl_traits::select_on_container_copy_construction(m.calloc)) {
+			if(m.cap == 0)
+				return;
+
+			allocate(m.cap);
+			try {
+				for(size_type i = 0; i < cap; ++i) {
+					if(m.ctrl[i] >= 0) {
+						slot_traits::construct(salloc, slots + i, m.slots[i]);
+						set_ctrl(i, m.ctrl[i]);
+					}
+				}
+			}
+			catch(...) {
+				release();
+				throw;
+			}
+
+			std::copy(m.ctrl, m.ctrl + cap + _dtl::fh_group, ctrl);
+			length = m.length;
+			deleted = m.deleted;
+		}
+
+		flat_hash_map(flat_hash_map&& m) noexcept
+		: hash(std::move(m.hash)), eq(std::move(m.eq))
+		, salloc(std::move(m.salloc)), calloc(std::move(m.calloc)) {
+			steal(m);
+		}
+
+		~flat_hash_map() {
+			release();
+		}
+
+		flat_hash_map& operator= (const flat_hash_map& m) {
+			if(this != &m) {
+				flat_hash_map t(m);
+				*this = std::move(t);
+			}
+
+			return *this;
+		}
+
+		flat_hash_map& operator= (flat_hash_map&& m) noexcept {
+			if(this != &m) {
+				release();
+				hash = std::move(m.hash);
+				eq = std::move(m.eq);
+				salloc = std::move(m.salloc);
+				calloc = std::move(m.calloc);
+				steal(m);
+			}
+
+			return *this;
+		}
+
+		size_type size() const noexcept {
+			return length;
+		}
+
+		bool empty() const noexcept {
+			return length == 0;
+		}
+
+		/// Number of slots in the table.
+		size_type bucket_count() const noexcept {
+			return cap;
+		}
+
+		float load_factor() const noexcept {
+			return cap ? float(length) / float(cap) : 0.f;
+		}
+
+		/// The table grows rather than get fuller than this.
+		constexpr float max_load_factor() const noexcept {
+			return .875f;
+		}
+
+		hasher hash_function() const {
+			return hash;
+		}
+
+		key_equal key_eq() const {
+			return eq;
+		}
+
+		allocator_type get_allocator() const {
+			return allocator_type(salloc);
+		}
+
+		/// Make room for `n` elements, so that inserting them cannot rehash.
+		void reserve(size_type n) {
+			auto c = capacity_for(n);
+			if(n && c > cap)
+				rehash(c);
+		}
+
+		void clear() noexcept {
+			for(size_type i = 0; i < cap; ++i) {
+				if(ctrl[i] >= 0)
+					slot_traits::destroy(salloc, slots + i);
+			}
+
+			if(cap)
+				std::fill(ctrl, ctrl + cap + _dtl::fh_group, _dtl::fh_empty);
+
+			length = 0;
+			deleted = 0;
+		}
+
+		const_iterator begin() const noexcept {
+			const_iterator it(this, 0);
+			if(cap)
+				it.skip();
+
+			return it;
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(this, cap);
+		}
+
+		const_iterator find(const K& k) const {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			return i == npos ? end() : const_iterator(this, i);
+		}
+
+		size_type count(const K& k) const {
+			return find_index(k, _dtl::fh_mix(hash(k))) == npos ? 0 : 1;
+		}
+
+		/**
+		 * Look up the value of `k`.
+		 *
+		 * \return A reference to the value, or `Nothing`.
+		 */
+		maybe<std::reference_wrapper<const V>> lookup(const K& k) const {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			if(i == npos)
+				return nothing<std::reference_wrapper<const V>>();
+
+			return just(std::cref(slots[i].second));
+		}
+
+		/// \overload
+		maybe<std::reference_wrapper<V>> lookup(const K& k) {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			if(i == npos)
+				return nothing<std::reference_wrapper<V>>();
+
+			return just(std::ref(slots[i].second));
+		}
+
+		/// Value of `k`, throws `std::out_of_range` if there is none.
+		const V& at(const K& k) const {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			if(i == npos)
+				throw std::out_of_range("flat_hash_map::at");
+
+			return slots[i].second;
+		}
+
+		/// \overload
+		V& at(const K& k) {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			if(i == npos)
+				throw std::out_of_range("flat_hash_map::at");
+
+			return slots[i].second;
+		}
+
+		/// Value of `k`, inserting a default constructed one if needed.
+		V& operator[] (const K& k) {
+			auto i = try_emplace(k).first.i;
+			return slots[i].second;
+		}
+
+		/**
+		 * Insert a value constructed from `args` if `k` is not present.
+		 *
+		 * Nothing is constructed if it is.
+		 */
+		template<typename KK, typename...Args>
+		std::pair<const_iterator,bool> try_emplace(KK&& k, Args&&...args) {
+			auto h = _dtl::fh_mix(hash(k));
+			auto i = find_index(k, h);
+			if(i != npos)
+				return std::make_pair(const_iterator(this, i), false);
+
+			i = prepare(h);
+			slot_traits::construct(
+					salloc, slots + i,
+					std::piecewise_construct,
+					std::forward_as_tuple(std::forward<KK>(k)),
+					std::forward_as_tuple(std::forward<Args>(args)...)
+			);
+			commit(i, h);
+
+			return std::make_pair(const_iterator(this, i), true);
+		}
+
+		/// Insert a key/value pair, unless the key is already present.
+		std::pair<const_iterator,bool> insert(const value_type& kv) {
+			return try_emplace(kv.first, kv.second);
+		}
+
+		/// \overload
+		std::pair<const_iterator,bool> insert(value_type&& kv) {
+			return try_emplace(std::move(kv.first), std::move(kv.second));
+		}
+
+		/// Associate `v` with `k`, whether or not `k` is already present.
+		std::pair<const_iterator,bool> insert_or_assign(const K& k, V v) {
+			auto r = try_emplace(k, std::move(v));
+			if(!r.second)
+				slots[r.first.i].second = std::move(v);
+
+			return r;
+		}
+
+		size_type erase(const K& k) {
+			auto i = find_index(k, _dtl::fh_mix(hash(k)));
+			if(i == npos)
+				return 0;
+
+			erase_at(i);
+			return 1;
+		}
+
+		/// \overload
+		const_iterator erase(const_iterator it) {
+			erase_at(it.i);
+			return ++it;
+		}
+
+	private:
+		static constexpr size_type npos = size_type(-1);
+
+		static size_type capacity_for(size_type n) noexcept {
+			size_type c = _dtl::fh_group;
+			while(n > c - c/8)
+				c *= 2;
+
+			return c;
+		}
+
+		size_type find_index(const K& k, size_t h) const {
+			if(cap == 0)
+				return npos;
+
+			auto mask = cap - 1;
+			auto pos = (h >> 7) & mask;
+			auto h2 = static_cast<signed char>(h & 0x7F);
+
+			for(size_type step = _dtl::fh_group;; step += _dtl::fh_group) {
+				for(auto m = _dtl::fh_match(ctrl + pos, h2); m; m &= m - 1) {
+					auto i = (pos + _dtl::fh_lowest(m)) & mask;
+					if(eq(slots[i].first, k))
+						return i;
+				}
+
+				if(_dtl::fh_match(ctrl + pos, _dtl::fh_empty))
+					return npos;
+
+				pos = (pos + step) & mask;
+			}
+		}
+
+		// First empty or deleted slot on the probe sequence of h
+		size_type free_slot(size_t h) const noexcept {
+			auto mask = cap - 1;
+			auto pos = (h >> 7) & mask;
+
+			for(size_type step = _dtl::fh_group;; step += _dtl::fh_group) {
+				auto m = _dtl::fh_match_free(ctrl + pos);
+				if(m)
+					return (pos + _dtl::fh_lowest(m)) & mask;
+
+				pos = (pos + step) & mask;
+			}
+		}
+
+		// Find a slot for a new element with hash h, growing if needed
+		size_type prepare(size_t h) {
+			if(length + deleted + 1 > cap - cap/8) {
+				// Mostly markers of erased elements: clean up, don't grow
+				if(cap && length * 32 <= cap * 25)
+					rehash(cap);
+				else
+					rehash(std::max(cap * 2, capacity_for(length + 1)));
+			}
+
+			return free_slot(h);
+		}
+
+		void commit(size_type i, size_t h) noexcept {
+			if(ctrl[i] == _dtl::fh_deleted)
+				--deleted;
+
+			set_ctrl(i, static_cast<signed char>(h & 0x7F));
+			++length;
+		}
+
+		void erase_at(size_type i) {
+			slot_traits::destroy(salloc, slots + i);
+			set_ctrl(i, _dtl::fh_deleted);
+			--length;
+			++deleted;
+		}
+
+		// The first group of control bytes is mirrored after the last slot,
+		// so that a group can be loaded from any position.
+		void set_ctrl(size_type i, signed char c) noexcept {
+			ctrl[i] = c;
+			if(i < _dtl::fh_group)
+				ctrl[cap + i] = c;
+		}
+
+		// Nothing is changed unless both arrays could be allocated, so that
+		// a failed rehash leaves the old table as it was
+		void allocate(size_type c) {
+			auto n = ctrl_traits::allocate(calloc, c + _dtl::fh_group);
+			value_type* s;
+			try {
+				s = slot_traits::allocate(salloc, c);
+			}
+			catch(...) {
+				ctrl_traits::deallocate(calloc, n, c + _dtl::fh_group);
+				throw;
+			}
+
+			std::fill(n, n + c + _dtl::fh_group, _dtl::fh_empty);
+			ctrl = n;
+			slots = s;
+			cap = c;
+		}
+
+		void rehash(size_type c) {
+			auto old_ctrl = ctrl;
+			auto old_slots = slots;
+			auto old_cap = cap;
+
+			allocate(c);
+			deleted = 0;
+
+			for(size_type i = 0; i < old_cap; ++i) {
+				if(old_ctrl[i] < 0)
+					continue;
+
+				auto h = _dtl::fh_mix(hash(old_slots[i].first));
+				auto j = free_slot(h);
+				slot_traits::construct(
+						salloc, slots + j, std::move(old_slots[i])
+				);
+				set_ctrl(j, static_cast<signed char>(h & 0x7F));
+				slot_traits::destroy(salloc, old_slots + i);
+			}
+
+			if(old_cap) {
+				slot_traits::deallocate(salloc, old_slots, old_cap);
+				ctrl_traits::deallocate(
+						calloc, old_ctrl, old_cap + _dtl::fh_group
+				);
+			}
+		}
+
+		void release() noexcept {
+			if(cap == 0)
+				return;
+
+			clear();
+			slot_traits::deallocate(salloc, slots, cap);
+			ctrl_traits::deallocate(calloc, ctrl, cap + _dtl::fh_group);
+			ctrl = nullptr;
+			slots = nullptr;
+			cap = 0;
+		}
+
+		void steal(flat_hash_map& m) noexcept {
+			ctrl = m.ctrl;
+			slots = m.slots;
+			cap = m.cap;
+			length = m.length;
+			deleted = m.deleted;
+
+			m.ctrl = nullptr;
+			m.slots = nullptr;
+			m.cap = m.length = m.deleted = 0;
+		}
+
+		/*
+		 * Build a map with the same hash function and slot layout, where the
+		 * value in each slot is mk(slot). As the keys go in the same slots,
+		 * nothing is hashed or probed.
+		 */
+		template<typename M, typename Mk>
+		M with_layout(Mk&& mk) const {
+			using r_traits = typename M::slot_traits;
+
+			M r(0, hash, eq, typename M::allocator_type(salloc));
+			if(cap == 0)
+				return r;
+
+			r.allocate(cap);
+			for(size_type i = 0; i < cap; ++i) {
+				if(ctrl[i] >= 0) {
+					r_traits::construct(
+							r.salloc, r.slots + i, mk(slots[i])
+					);
+					r.set_ctrl(i, ctrl[i]);
+				}
+			}
+
+			std::copy(ctrl, ctrl + cap + _dtl::fh_group, r.ctrl);
+			r.length = length;
+			r.deleted = deleted;
+
+			return r;
+		}
+
+		signed char* ctrl = nullptr;
+		value_type* slots = nullptr;
+		size_type cap = 0;
+		size_type length = 0;
+		size_type deleted = 0;
+
+		H hash;
+		E eq;
+		slot_alloc salloc;
+		ctrl_alloc calloc;
+	};
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	constexpr typename flat_hash_map<K,V,H,E,A>::size_type
+	flat_hash_map<K,V,H,E,A>::npos;
+
+	/**
+	 * Equality of flat hash maps.
+	 *
+	 * True if both hold the same keys, with equal values.
+	 *
+	 * \ingroup flat_hash_map
+	 */
+	template<typename K, typename V, typename H, typename E, typename A>
+	bool operator== (
+			const flat_hash_map<K,V,H,E,A>& a,
+			const flat_hash_map<K,V,H,E,A>& b) {
+
+		if(a.size() != b.size())
+			return false;
+
+		for(auto& kv : a) {
+			auto it = b.find(kv.first);
+			if(it == b.end() || !(it->second == kv.second))
+				return false;
+		}
+
+		return true;
+	}
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	bool operator!= (
+			const flat_hash_map<K,V,H,E,A>& a,
+			const flat_hash_map<K,V,H,E,A>& b) {
+		return !(a == b);
+	}
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	struct parametric_type_traits<flat_hash_map<K,V,H,E,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = V;
+
+		template<typename U>
+		using rebind =
+			flat_hash_map<K,U,H,E,rebind_allocator<std::pair<K,U>>>;
+	};
+
+	/**
+	 * Functor instance for flat hash maps.
+	 *
+	 * Maps over the values, keeping the keys. The result has the same
+	 * capacity, and every key goes in the slot it had in the original, so
+	 * it is built without hashing a single key.
+	 *
+	 * \ingroup flat_hash_map
+	 */
+	template<typename K, typename T, typename H, typename E, typename A>
+	struct functor<flat_hash_map<K,T,H,E,A>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = Rebind<flat_hash_map<K,T,H,E,A>,U>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			return m.template with_layout<Map<U>>(
+				[&f](const std::pair<K,T>& kv) {
+					return std::pair<K,U>(kv.first, f(kv.second));
+				}
+			);
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static Map<U> map(F&& f, Map<T>&& m) {
+			auto r = m.template with_layout<Map<U>>(
+				[&f](std::pair<K,T>& kv) {
+					return std::pair<K,U>(
+							std::move(kv.first), f(std::move(kv.second))
+					);
+				}
+			);
+
+			// Its keys are gone, leave m in a state that does not rely on them
+			m.clear();
+			return r;
+		}
+
+		/**
+		 * Mutating, no-copy optimised version.
+		 *
+		 * Kicks in if `f` does not change domain and `m` is a temporary.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			for(size_t i = 0; i < m.cap; ++i) {
+				if(m.ctrl[i] >= 0)
+					m.slots[i].second = f(std::move(m.slots[i].second));
+			}
+
+			return std::move(m);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid instance for flat hash maps.
+	 *
+	 * Identity element is the empty map, monoid operation is left biased
+	 * union: keys present in both operands keep their value from the left.
+	 * Room for both operands is reserved up front, and a temporary operand
+	 * is reused to hold the result.
+	 *
+	 * \ingroup flat_hash_map
+	 */
+	template<typename K, typename V, typename H, typename E, typename A>
+	struct monoid<flat_hash_map<K,V,H,E,A>> {
+		using map_type = flat_hash_map<K,V,H,E,A>;
+
+		static map_type id() {
+			return map_type();
+		}
+
+		static map_type append(const map_type& m1, const map_type& m2) {
+			map_type r(m1);
+			return append(std::move(r), m2);
+		}
+
+		static map_type append(map_type&& m1, const map_type& m2) {
+			m1.reserve(m1.size() + m2.size());
+			for(auto& kv : m2) {
+				m1.insert(kv);
+			}
+
+			return std::move(m1);
+		}
+
+		static map_type append(const map_type& m1, map_type&& m2) {
+			m2.reserve(m1.size() + m2.size());
+			for(auto& kv : m1) {
+				m2.insert_or_assign(kv.first, kv.second);
+			}
+
+			return std::move(m2);
+		}
+
+		static map_type append(map_type&& m1, map_type&& m2) {
+			if(m1.size() >= m2.size())
+				return append(std::move(m1), static_cast<const map_type&>(m2));
+			else
+				return append(static_cast<const map_type&>(m1), std::move(m2));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for flat hash maps.
+	 *
+	 * Folds over the values, in the (unspecified) order of the table.
+	 *
+	 * \ingroup flat_hash_map
+	 */
+	template<typename K, typename T, typename H, typename E, typename A>
+	struct foldable<flat_hash_map<K,T,H,E,A>>
+	: deriving_fold<flat_hash_map<K,T,H,E,A>>
+	, deriving_foldMap<flat_hash_map<K,T,H,E,A>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const flat_hash_map<K,T,H,E,A>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const flat_hash_map<K,T,H,E,A>& m) {
+			for(size_t i = m.cap; i > 0; --i) {
+				if(m.ctrl[i-1] >= 0)
+					z = f(m.slots[i-1].second, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
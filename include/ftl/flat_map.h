@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FLAT_MAP_H
+#define FTL_FLAT_MAP_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "flat_set.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup flat_map Flat Map
+	 *
+	 * Sorted map stored in one contiguous array, and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/flat_map.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to `ftl::flat_map`:
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \par Dependencies
+	 * - <vector>
+	 * - <algorithm>
+	 * - \ref flat_set
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	namespace _dtl {
+		// Orders key/value pairs by key alone
+		template<typename C>
+		struct flat_key_compare {
+			C cmp;
+
+			template<typename P>
+			bool operator() (const P& a, const P& b) const {
+				return cmp(a.first, b.first);
+			}
+		};
+	}
+
+	/**
+	 * Ordered map, kept as a sorted `std::vector` of key/value pairs.
+	 *
+	 * The flat counterpart of `std::map`, with the same trade-offs as
+	 * `ftl::flat_set`: lookups are binary searches over contiguous memory,
+	 * while inserting or erasing single keys is linear.
+	 *
+	 * Iterators are `const`, as changing a key through one would break the
+	 * order. Values can be changed through `operator[]`, `at`, and
+	 * `insert_or_assign`.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref eq, if `K` and `V` are
+	 * - \ref orderablepg, if `K` and `V` are
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   flat_map<std::string,int> m{{"b",2},{"a",1}};
+	 *   m["c"] = 3;
+	 *
+	 *   // m.begin()->first == "a", m.at("c") == 3
+	 * \endcode
+	 *
+	 * \ingroup flat_map
+	 */
+	template<
+			typename K,
+			typename V,
+			typename C = std::less<K>,
+			typename A = std::allocator<std::pair<K,V>>
+	>
+	class flat_map {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K,V>;
+		using key_compare = C;
+		using value_compare = _dtl::flat_key_compare<C>;
+		using allocator_type = A;
+		using container_type = std::vector<value_type,A>;
+		using size_type = typename container_type::size_type;
+		using difference_type = typename container_type::difference_type;
+		using reference = const value_type&;
+		using const_reference = const value_type&;
+		using iterator = typename container_type::const_iterator;
+		using const_iterator = iterator;
+		using reverse_iterator = typename container_type::const_reverse_iterator;
+		using const_reverse_iterator = reverse_iterator;
+
+		flat_map() = default;
+
+		explicit flat_map(const C& cmp) : cmp{cmp} {}
+
+		/**
+		 * Construct from a range of pairs in any order.
+		 *
+		 * Of several pairs with equivalent keys, the first is kept.
+		 */
+		template<
+				typename It,
+				typename = Requires<std::is_convertible<
+					typename std::iterator_traits<It>::iterator_category,
+					std::input_iterator_tag
+				>::value>
+		>
+		flat_map(It first, It last, const C& cmp = C())
+		: elems(first, last), cmp{cmp} {
+			_dtl::sort_unique(elems, elems.begin(), this->cmp);
+		}
+
+		flat_map(std::initializer_list<value_type> l, const C& cmp = C())
+		: flat_map(l.begin(), l.end(), cmp) {}
+
+		/**
+		 * Take over a vector of pairs already sorted by unique keys.
+		 *
+		 * Constant time; the order is not checked.
+		 */
+		flat_map(sorted_unique_t, container_type v, const C& cmp = C())
+		: elems(std::move(v)), cmp{cmp} {}
+
+		size_type size() const noexcept {
+			return elems.size();
+		}
+
+		bool empty() const noexcept {
+			return elems.empty();
+		}
+
+		void reserve(size_type n) {
+			elems.reserve(n);
+		}
+
+		void clear() noexcept {
+			elems.clear();
+		}
+
+		key_compare key_comp() const {
+			return cmp.cmp;
+		}
+
+		value_compare value_comp() const {
+			return cmp;
+		}
+
+		/// The underlying vector of pairs, sorted by key.
+		const container_type& sequence() const noexcept {
+			return elems;
+		}
+
+		/// Move the underlying vector out, leaving the map empty.
+		container_type extract() && {
+			container_type v = std::move(elems);
+			elems.clear();
+			return v;
+		}
+
+		const_iterator begin() const noexcept {
+			return elems.begin();
+		}
+
+		const_iterator end() const noexcept {
+			return elems.end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return elems.rbegin();
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return elems.rend();
+		}
+
+		const_iterator lower_bound(const K& k) const {
+			return std::lower_bound(
+					elems.begin(), elems.end(), k,
+					[this](const value_type& kv, const K& k) {
+						return cmp.cmp(kv.first, k);
+					}
+			);
+		}
+
+		const_iterator find(const K& k) const {
+			auto it = lower_bound(k);
+			return it != end() && !cmp.cmp(k, it->first) ? it : end();
+		}
+
+		size_type count(const K& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		/**
+		 * Heterogeneous lookups, for a transparent `C`.
+		 *
+		 * `k` may be of any type that `C` compares with `K`, and is never
+		 * converted to `K`.
+		 */
+		template<typename X, typename C2 = C, typename = typename C2::is_transparent>
+		const_iterator lower_bound(const X& k) const {
+			return std::lower_bound(
+					elems.begin(), elems.end(), k,
+					[this](const value_type& kv, const X& k) {
+						return cmp.cmp(kv.first, k);
+					}
+			);
+		}
+
+		/// \overload
+		template<typename X, typename C2 = C, typename = typename C2::is_transparent>
+		const_iterator find(const X& k) const {
+			auto it = lower_bound(k);
+			return it != end() && !cmp.cmp(k, it->first) ? it : end();
+		}
+
+		/// \overload
+		template<typename X, typename C2 = C, typename = typename C2::is_transparent>
+		size_type count(const X& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		/// Value of `k`, throws `std::out_of_range` if there is none.
+		const V& at(const K& k) const {
+			auto it = find(k);
+			if(it == end())
+				throw std::out_of_range("flat_map::at");
+
+			return it->second;
+		}
+
+		/// \overload
+		V& at(const K& k) {
+			return mutable_at(find(k))->second;
+		}
+
+		/// Value of `k`, inserting a default constructed one if needed.
+		V& operator[] (const K& k) {
+			auto it = lower_bound(k);
+			if(it == end() || cmp.cmp(k, it->first))
+				it = elems.emplace(it, k, V());
+
+			return mutable_at(it)->second;
+		}
+
+		/**
+		 * Insert a key/value pair, unless the key is already present.
+		 *
+		 * Appending in order is amortised constant time, inserting
+		 * elsewhere is linear in the number of keys after it.
+		 */
+		std::pair<const_iterator,bool> insert(value_type kv) {
+			if(elems.empty() || cmp.cmp(elems.back().first, kv.first)) {
+				elems.push_back(std::move(kv));
+				return std::make_pair(std::prev(elems.end()), true);
+			}
+
+			auto it = lower_bound(kv.first);
+			if(!cmp.cmp(kv.first, it->first))
+				return std::make_pair(it, false);
+
+			return std::make_pair(elems.insert(it, std::move(kv)), true);
+		}
+
+		/// Associate `v` with `k`, whether or not `k` is already present.
+		std::pair<const_iterator,bool> insert_or_assign(const K& k, V v) {
+			auto it = lower_bound(k);
+			if(it != end() && !cmp.cmp(k, it->first)) {
+				mutable_at(it)->second = std::move(v);
+				return std::make_pair(it, false);
+			}
+
+			return std::make_pair(elems.emplace(it, k, std::move(v)), true);
+		}
+
+		size_type erase(const K& k) {
+			auto it = find(k);
+			if(it == end())
+				return 0;
+
+			elems.erase(it);
+			return 1;
+		}
+
+		const_iterator erase(const_iterator it) {
+			return elems.erase(it);
+		}
+
+	private:
+		typename container_type::iterator mutable_at(const_iterator it) {
+			if(it == end())
+				throw std::out_of_range("flat_map::at");
+
+			return elems.begin() + (it - elems.cbegin());
+		}
+
+		container_type elems;
+		value_compare cmp;
+	};
+
+	template<typename K, typename V, typename C, typename A>
+	bool operator== (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return a.sequence() == b.sequence();
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	bool operator!= (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return !(a == b);
+	}
+
+	/// Lexicographical comparison, like that of the standard containers.
+	template<typename K, typename V, typename C, typename A>
+	bool operator< (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return a.sequence() < b.sequence();
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	bool operator> (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return b < a;
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	bool operator<= (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return !(b < a);
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	bool operator>= (const flat_map<K,V,C,A>& a, const flat_map<K,V,C,A>& b) {
+		return !(a < b);
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	struct parametric_type_traits<flat_map<K,V,C,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = V;
+
+		template<typename U>
+		using rebind = flat_map<K,U,C,rebind_allocator<std::pair<K,U>>>;
+	};
+
+	/**
+	 * Monoid instance for flat maps.
+	 *
+	 * Identity element is the empty map, monoid operation is left biased
+	 * union: keys present in both operands keep their value from the left.
+	 * The union is a single linear merge of the two sorted arrays.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename V, typename C, typename A>
+	struct monoid<flat_map<K,V,C,A>> {
+		static flat_map<K,V,C,A> id() {
+			return flat_map<K,V,C,A>{};
+		}
+
+		static flat_map<K,V,C,A> append(
+				const flat_map<K,V,C,A>& m1,
+				const flat_map<K,V,C,A>& m2) {
+
+			if(m2.empty())
+				return m1;
+
+			if(m1.empty())
+				return m2;
+
+			typename flat_map<K,V,C,A>::container_type v;
+			v.reserve(m1.size() + m2.size());
+			std::set_union(
+					m1.begin(), m1.end(), m2.begin(), m2.end(),
+					std::back_inserter(v), m1.value_comp()
+			);
+
+			return flat_map<K,V,C,A>(sorted_unique, std::move(v), m1.key_comp());
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Functor instance for flat maps.
+	 *
+	 * Maps over the values, keeping the keys. The keys are already in
+	 * order, so the result is built in one pass, without any searching or
+	 * sorting.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct functor<flat_map<K,T,C,A>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = Rebind<flat_map<K,T,C,A>,U>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			typename Map<U>::container_type v;
+			v.reserve(m.size());
+			for(const auto& kv : m) {
+				v.emplace_back(kv.first, f(kv.second));
+			}
+
+			return Map<U>(sorted_unique, std::move(v), m.key_comp());
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static Map<U> map(F&& f, Map<T>&& m) {
+			auto cmp = m.key_comp();
+			auto src = std::move(m).extract();
+
+			typename Map<U>::container_type v;
+			v.reserve(src.size());
+			for(auto& kv : src) {
+				v.emplace_back(std::move(kv.first), f(std::move(kv.second)));
+			}
+
+			return Map<U>(sorted_unique, std::move(v), cmp);
+		}
+
+		/**
+		 * Mutating, no-copy optimised version.
+		 *
+		 * Kicks in if `f` does not change domain and `m` is a temporary.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			auto cmp = m.key_comp();
+			auto v = std::move(m).extract();
+			for(auto& kv : v) {
+				kv.second = f(std::move(kv.second));
+			}
+
+			return Map<T>(sorted_unique, std::move(v), cmp);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for flat maps.
+	 *
+	 * Folds over the values, in key order.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct foldable<flat_map<K,T,C,A>>
+	: deriving_fold<flat_map<K,T,C,A>>, deriving_foldMap<flat_map<K,T,C,A>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const flat_map<K,T,C,A>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const flat_map<K,T,C,A>& m) {
+			for(auto it = m.rbegin(); it != m.rend(); ++it) {
+				z = f(it->second, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
@@ -68,9 +68,86 @@ namespace ftl {
 		using rebind = std::forward_list<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		template<typename C>
+		struct fwd_sink {
+			C& c;
+			typename C::iterator it;
+
+			template<typename X>
+			void operator() (X&& x) {
+				it = c.insert_after(it, std::forward<X>(x));
+			}
+		};
+
+		/*
+		 * Append one of the results of a bind after it, the last element of
+		 * r, and return the new last element. Lists we own are spliced in,
+		 * anything else is copied or moved element by element.
+		 */
+		template<typename U, typename A>
+		typename std::forward_list<U,A>::iterator fwd_append(
+				std::forward_list<U,A>& r,
+				typename std::forward_list<U,A>::iterator it,
+				std::forward_list<U,A>&& l) {
+
+			if(r.get_allocator() == l.get_allocator()) {
+				r.splice_after(it, l);
+				while(std::next(it) != r.end())
+					++it;
+
+				return it;
+			}
+
+			note_alloc(
+					alloc_site::container,
+					size_t(std::distance(l.begin(), l.end()))
+			);
+			return r.insert_after(
+					it,
+					std::make_move_iterator(l.begin()),
+					std::make_move_iterator(l.end())
+			);
+		}
+
+		template<typename U, typename A, typename C>
+		typename std::forward_list<U,A>::iterator fwd_append(
+				std::forward_list<U,A>& r,
+				typename std::forward_list<U,A>::iterator it,
+				const C& c) {
+
+			for(auto& e : c) {
+				it = r.insert_after(it, e);
+				note_alloc(alloc_site::container);
+			}
+
+			return it;
+		}
+
+		template<
+				typename U, typename A, typename C,
+				typename = Requires<!std::is_lvalue_reference<C>::value>
+		>
+		typename std::forward_list<U,A>::iterator fwd_append(
+				std::forward_list<U,A>& r,
+				typename std::forward_list<U,A>::iterator it,
+				C&& c) {
+
+			for(auto& e : c) {
+				it = r.insert_after(it, std::move(e));
+				note_alloc(alloc_site::container);
+			}
+
+			return it;
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * Results of `f` that are forward lists are spliced into the result,
+	 * other containers have their elements moved.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref fwditerable`<U>(T)>`
 	 *
 	 * \ingroup fwdlist
@@ -87,15 +164,10 @@ namespace ftl {
 			const std::forward_list<T,A>& l) {
 
 		std::forward_list<U,Au> result;
-		auto nested = std::forward<F>(f) % l;
 
 		auto it = result.before_begin();
-		for(auto& el : nested) {
-			it = result.insert_after(
-					it,
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+		for(auto& e : l) {
+			it = _dtl::fwd_append(result, it, f(e));
 		}
 
 		return result;
@@ -117,17 +189,11 @@ namespace ftl {
 			F&& f,
 			std::forward_list<T,A>&& l) {
 
-		auto nested = std::forward<F>(f) % std::move(l);
-
 		std::forward_list<U,Au> result;
 
 		auto it = result.before_begin();
-		for(auto& el : nested) {
-			it = result.insert_after(
-					it,
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+		for(auto& e : l) {
+			it = _dtl::fwd_append(result, it, f(std::move(e)));
 		}
 
 		return result;
@@ -177,7 +243,7 @@ namespace ftl {
 
 			l2.splice_after(l2.before_begin(), std::move(l));
 
-			return l2;
+			return std::move(l2);
 		}
 
 		static std::forward_list<Ts...> append(
@@ -186,7 +252,7 @@ namespace ftl {
 
 			l2.splice_after(l2.before_begin(), std::move(l1));
 
-			return l2;
+			return std::move(l2);
 		}
 
 		static constexpr bool instance = true;
@@ -203,8 +269,7 @@ namespace ftl {
 	template<typename T, typename A>
 	struct monad<std::forward_list<T,A>>
 	: deriving_pure<std::forward_list<T,A>>
-	, deriving_join<in_terms_of_bind<std::forward_list<T,A>>>
-	, deriving_apply<in_terms_of_bind<std::forward_list<T,A>>> {
+	, deriving_join<in_terms_of_bind<std::forward_list<T,A>>> {
 
 		/// Alias to make type signatures more easily read.
 		template<typename U>
@@ -238,6 +303,7 @@ namespace ftl {
 				it = rl.insert_after(it, f(e));
 			}
 
+			_dtl::note_container_alloc(rl);
 			return rl;
 		}
 
@@ -256,6 +322,7 @@ namespace ftl {
 				it = rl.insert_after(it, f(std::move(e)));
 			}
 
+			_dtl::note_container_alloc(rl);
 			return rl;
 		}
 
@@ -272,7 +339,33 @@ namespace ftl {
 
 			auto rl = std::move(l);
 			for(auto& e : rl) {
-				e = f(e);
+				e = f(std::move(e));
+			}
+
+			return rl;
+		}
+
+		/**
+		 * Applies every function in `fs` to every element of `l`.
+		 *
+		 * The results are grouped by function, in the order of `fs`. The
+		 * result is built in one forward pass, without any intermediate
+		 * lists.
+		 */
+		template<
+				typename Mf,
+				typename Mf_ = plain_type<Mf>,
+				typename F = Value_type<Mf_>,
+				typename U = result_of<F(T)>
+		>
+		static forward_list<U> apply(Mf&& fs, const forward_list<T>& l) {
+
+			forward_list<U> rl;
+			auto it = rl.before_begin();
+			for(auto& f : fs) {
+				for(const auto& e : l) {
+					it = rl.insert_after(it, f(e));
+				}
 			}
 
 			return rl;
@@ -371,6 +464,8 @@ namespace ftl {
 	 * any type that satisfies \ref fwditerable. Thus, one can zip a
 	 * `forward_list` with a `vector`, `list` or even `maybe`.
 	 *
+	 * Elements of temporary operands are moved into the zipping function.
+	 *
 	 * \ingroup fwdlist
 	 */
 	template<typename T, typename A>
@@ -389,22 +484,154 @@ namespace ftl {
 		static std::forward_list<V,A_<V>> zipWith(
 				F f, const std::forward_list<T,A>& l, const FwdIt& it
 		) {
-			std::forward_list<V,A_<V>> result;
+			return zip_into<false,false,V>(f, l, it);
+		}
 
-			auto insert_it = result.before_begin();
+		/// \overload
+		template<
+				typename F,
+				typename FwdIt,
+				typename I = plain_type<FwdIt>,
+				typename V = result_of<F(T,Value_type<I>)>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& !std::is_lvalue_reference<FwdIt>::value
+				>
+		>
+		static std::forward_list<V,A_<V>> zipWith(
+				F f, const std::forward_list<T,A>& l, FwdIt&& it
+		) {
+			return zip_into<false,true,V>(f, l, it);
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename FwdIt,
+				typename I = plain_type<FwdIt>,
+				typename V = result_of<F(T,Value_type<I>)>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& !(std::is_same<T,V>::value
+						&& std::is_move_assignable<T>::value)
+				>
+		>
+		static std::forward_list<V,A_<V>> zipWith(
+				F f, std::forward_list<T,A>&& l, FwdIt&& it
+		) {
+			return zip_into<true,!std::is_lvalue_reference<FwdIt>::value,V>(
+				f, l, it
+			);
+		}
+
+		/**
+		 * In place version.
+		 *
+		 * Kicks in if `l` is a temporary and `f` does not change its type.
+		 * The nodes of `l` are reused, and any that are left over when `it`
+		 * runs out are erased.
+		 */
+		template<
+				typename F,
+				typename FwdIt,
+				typename I = plain_type<FwdIt>,
+				typename = Requires<
+					ForwardIterable<I>()
+					&& std::is_same<T,result_of<F(T,Value_type<I>)>>::value
+					&& std::is_move_assignable<T>::value
+				>
+		>
+		static std::forward_list<T,A> zipWith(
+				F f, std::forward_list<T,A>&& l, FwdIt&& it
+		) {
+			constexpr bool move_i = !std::is_lvalue_reference<FwdIt>::value;
+
+			using std::begin;
+			using std::end;
+
+			auto prev = l.before_begin();
 			auto it1 = l.begin();
-			auto it2 = it.begin();
-			while(it1 != l.end() && it2 != std::end(it)) {
-				insert_it = result.insert_after(insert_it, f(*it1, *it2));
+			auto it2 = begin(it);
+			auto end2 = end(it);
+			while(it1 != l.end() && it2 != end2) {
+				*it1 = f(std::move(*it1), _dtl::zip_elem<move_i>(*it2));
 
+				prev = it1;
 				++it1;
 				++it2;
 			}
 
+			l.erase_after(prev, l.end());
+			return std::move(l);
+		}
+
+		/**
+		 * N-ary version.
+		 *
+		 * Walks `l` and every `is` in lockstep, in a single pass, applying `f`
+		 * to one element of each. The result ends with the shortest of them.
+		 */
+		template<
+				typename F, typename L, typename I1, typename I2,
+				typename...Is,
+				typename = Requires<
+					std::is_same<plain_type<L>,std::forward_list<T,A>>::value
+				>,
+				typename V = result_of<F(
+					T,
+					Value_type<plain_type<I1>>,
+					Value_type<plain_type<I2>>,
+					Value_type<plain_type<Is>>...
+				)>
+		>
+		static std::forward_list<V,A_<V>> zipWith(
+				F f, L&& l, I1&& i1, I2&& i2, Is&&...is
+		) {
+			std::forward_list<V,A_<V>> result;
+
+			_dtl::zip_walk(
+				_dtl::fwd_sink<std::forward_list<V,A_<V>>>{
+					result, result.before_begin()
+				},
+				f,
+				gen_seq<0,sizeof...(Is)+2>(),
+				std::forward<L>(l),
+				std::forward<I1>(i1),
+				std::forward<I2>(i2),
+				std::forward<Is>(is)...
+			);
+
+			_dtl::note_container_alloc(result);
 			return result;
 		}
 
 		static constexpr bool instance = true;
+
+	private:
+		template<bool MoveL, bool MoveI, typename V, typename F, typename L, typename I>
+		static std::forward_list<V,A_<V>> zip_into(F& f, L& l, I& it) {
+			using std::begin;
+			using std::end;
+
+			std::forward_list<V,A_<V>> result;
+
+			auto insert_it = result.before_begin();
+			auto it1 = l.begin();
+			auto it2 = begin(it);
+			auto end2 = end(it);
+			while(it1 != l.end() && it2 != end2) {
+				insert_it = result.insert_after(
+						insert_it,
+						f(_dtl::zip_elem<MoveL>(*it1), _dtl::zip_elem<MoveI>(*it2))
+				);
+
+				++it1;
+				++it2;
+			}
+
+			_dtl::note_container_alloc(result);
+			return result;
+		}
 	};
 
 }
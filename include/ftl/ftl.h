@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FTL_H
+#define FTL_FTL_H
+
+/**
+ * \file ftl.h
+ *
+ * Every module of the library, in one header.
+ *
+ * \code
+ *   #include <ftl/ftl.h>
+ * \endcode
+ *
+ * Meant to be precompiled. Including the modules one at a time is cheaper
+ * for a single translation unit, but a build of many translation units that
+ * each use several modules is better off precompiling this header once, and
+ * including it first everywhere. Nothing in it depends on what is included
+ * before it, so the same precompiled header serves the whole build.
+ *
+ * The configuration macros, `FTL_LAZY_STATS`, `FTL_LAZY_SINGLE_THREADED`,
+ * `FTL_ALLOC_STATS` and `FTL_TRACE`, must be defined the same way when the
+ * header is precompiled as when it is used. The \ref coroutine module is
+ * only included if the compiler supports coroutines.
+ */
+
+#include "prelude.h"
+#include "type_functions.h"
+#include "type_traits.h"
+#include "function.h"
+#include "functional.h"
+#include "memoize.h"
+#include "alloc_stats.h"
+#include "trace.h"
+#include "concepts/basic.h"
+#include "concepts/iterator.h"
+#include "concepts/orderable.h"
+#include "concepts/monoid.h"
+#include "concepts/functor.h"
+#include "concepts/applicative.h"
+#include "concepts/monad.h"
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+
+#include "sum_type.h"
+#include "sum_vector.h"
+#include "maybe.h"
+#include "maybe_vector.h"
+#include "either.h"
+#include "ord.h"
+#include "tuple.h"
+#include "memory.h"
+#include "rc.h"
+#include "atom.h"
+#include "intern.h"
+#include "string.h"
+#include "view.h"
+#include "stream.h"
+
+#include "vector.h"
+#include "list.h"
+#include "forward_list.h"
+#include "set.h"
+#include "map.h"
+#include "unordered_map.h"
+#include "flat_set.h"
+#include "flat_map.h"
+#include "flat_hash_map.h"
+#include "chunked_seq.h"
+#include "persistent_vector.h"
+#include "persistent_map.h"
+#include "arena.h"
+
+#include "maybe_trans.h"
+#include "either_trans.h"
+#include "lazy.h"
+#include "lazy_trans.h"
+#include "lazy_strategies.h"
+
+#include "executor.h"
+#include "parallel.h"
+#include "future.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include "coroutine.h"
+#endif
+
+#endif
+
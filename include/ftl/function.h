@@ -86,6 +86,13 @@ namespace ftl {
 	 * has several overloaded call operators that differ only in the number of
 	 * parameters they take.
 	 *
+	 * \par Small object optimisation
+	 * Function objects no larger than `inline_size` bytes, that are nothrow
+	 * move constructible, are stored in place rather than on the heap. The
+	 * size defaults to two `size_t`, and can be changed by defining
+	 * `FTL_FUNCTION_INLINE_SIZE` before including any FTL header. If you do,
+	 * make sure it is defined the same in every translation unit.
+	 *
 	 * \warning Curried calling _will_ result in copies of the parameter being
 	 *          made. Every time you invoke `operator()` without filling the
 	 *          complete parameter list, you are creating copies.
@@ -96,7 +103,8 @@ namespace ftl {
 	class function {};
 
 	template<typename R, typename...Ps>
-	class function<R(Ps...)> : private ::ftl::_dtl::curried<R,Ps...> {
+	class function<R(Ps...)>
+	: private ::ftl::_dtl::curried<function<R(Ps...)>,R,Ps...> {
 	public:
 		/**
 		 * Type sequence representation of the function's parameter list.
@@ -109,6 +117,10 @@ namespace ftl {
 		/// Type returned when calling the function object.
 		using result_type = R;
 
+		/// Size of the buffer for in place stored function objects.
+		static constexpr size_t inline_size
+			= sizeof(::ftl::_dtl::functor_padding);
+
 		/// Equivalent of function(std::nullptr_t)
 		function() noexcept {
 			initialise_empty();
@@ -207,10 +219,104 @@ namespace ftl {
 				const function& other
 		)
 		: call(other.call) {
+			copy_initialise(allocator, other, std::is_empty<Allocator>());
+		}
+
+		/// Move construct using a custom allocator
+		template<typename Allocator>
+		function(std::allocator_arg_t, const Allocator&, function&& other) noexcept {
+			// ignore the allocator because there's no allocation
+			initialise_empty();
+			swap(other);
+		}
+
+		~function() noexcept {
+			manager_storage.manager(
+					&manager_storage,
+					nullptr,
+					::ftl::_dtl::call_destroy);
+		}
+
+		function& operator= (function other) noexcept {
+			swap(other);
+			return *this;
+		}
+
+		// Inherit the curried function call operator(s)
+		using ::ftl::_dtl::curried<function,R,Ps...>::operator();
+
+		/// Call the wrapped function object
+		R operator()(Ps...ps) const {
+			return call(manager_storage.functor, std::forward<Ps>(ps)...);
+		}
+
+		template<typename F, typename Allocator>
+		void assign(F&& f, const Allocator& alloc)
+		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
+			function(std::allocator_arg, alloc, f).swap(*this);
+		}
+
+		void swap(function& other) noexcept {
+			::ftl::_dtl::manager_storage_type temp_storage;
+
+			other.manager_storage.manager(
+					&temp_storage,
+					&other.manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			manager_storage.manager(
+					&other.manager_storage,
+					&manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			temp_storage.manager(
+					&manager_storage,
+					&temp_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			std::swap(call, other.call);
+		}
+
+		/// Check if function is nullary
+		constexpr operator bool() const noexcept {
+			return call != &::ftl::_dtl::empty_call<R, Ps...>;
+		}
+
+		/**
+		 * Get the wrapped function object, if it is an `F`.
+		 *
+		 * Like `std::function::target`, except that only objects stored with
+		 * the default allocator are recognised. Returns `nullptr` otherwise.
+		 */
+		template<typename F>
+		F* target() noexcept {
+			using A = std::allocator<F>;
 
+			if(manager_storage.manager != &::ftl::_dtl::function_manager<F,A>)
+				return nullptr;
+
+			return &::ftl::_dtl::function_manager_inplace_specialisation<F,A>
+				::get_functor_ref(manager_storage);
+		}
+
+		template<typename F>
+		const F* target() const noexcept {
+			return const_cast<function*>(this)->template target<F>();
+		}
+
+	private:
+		::ftl::_dtl::manager_storage_type manager_storage;
+		R (*call)(const ::ftl::_dtl::functor_padding&, Ps...);
+
+		template<typename Allocator>
+		void copy_initialise(
+				const Allocator& allocator,
+				const function& other,
+				std::true_type
+		) {
 			using alloc_traits = std::allocator_traits<Allocator>;
 			using MyAllocator =
-				typename alloc_traits::template rebind_alloc<function>::other;
+				typename alloc_traits::template rebind_alloc<function>;
 
 			// first try to see if the allocator matches the target type
 			::ftl::_dtl::manager_type manager_for_allocator =
@@ -263,41 +369,322 @@ namespace ftl {
 			}
 		}
 
-		/// Move construct using a custom allocator
 		template<typename Allocator>
-		function(std::allocator_arg_t, const Allocator&, function&& other) noexcept {
-			// ignore the allocator because there's no allocation
+		void copy_initialise(
+				const Allocator& allocator,
+				const function& other,
+				std::false_type
+		) {
+			using MyAllocator = typename std::allocator_traits<Allocator>
+				::template rebind_alloc<function>;
+
+			using wrapper = ::ftl::_dtl::function_manager_inplace_specialisation<
+				function, MyAllocator
+			>;
+
+			if(!other)
+				initialise_empty();
+
+			// as above, do not wrap functions that are already wrappers
+			else if(other.manager_storage.manager
+					== &::ftl::_dtl::stateful_function_manager<function, MyAllocator>
+			) {
+				initialise(
+					wrapper::get_functor_ref(other.manager_storage),
+					MyAllocator(allocator)
+				);
+			}
+
+			else
+				initialise(other, MyAllocator(allocator));
+		}
+
+		template<typename F, typename Allocator>
+		void initialise(F f, Allocator&& alloc) {
+
+			using A = plain_type<Allocator>;
+
+			call = &::ftl::_dtl::function_manager_inplace_specialisation<F,A>
+				::template call<R, Ps...>;
+
+			::ftl::_dtl::initialise_manager(
+					manager_storage,
+					std::forward<Allocator>(alloc),
+					std::move(f));
+		}
+
+		using empty_fn_type = R(*)(Ps...);
+
+		void initialise_empty() noexcept {
+			using Allocator = std::allocator<empty_fn_type>;
+
+			static_assert(
+				::ftl::_dtl::is_inplace_allocated<empty_fn_type, Allocator>::value,
+				"The empty function should benefit from small functor optimization");
+
+			::ftl::_dtl::create_manager<empty_fn_type,Allocator>(
+					manager_storage,
+					Allocator()
+			);
+
+			::ftl::_dtl
+				::function_manager_inplace_specialisation<empty_fn_type,Allocator>
+					::store_functor(manager_storage, nullptr);
+
+			call = &::ftl::_dtl::empty_call<R, Ps...>;
+		}
+	};
+
+	template<typename R, typename...Ps>
+	struct parametric_type_traits<function<R(Ps...)>> {
+		using value_type = R;
+
+		template<typename S>
+		using rebind = function<S(Ps...)>;
+	};
+
+	/**
+	 * Non-owning reference to a function or function object.
+	 *
+	 * \tparam R Return value of the referenced function.
+	 * \tparam Ps Parameter pack of the referenced function's `operator()`.
+	 *
+	 * A `function_ref` is two pointers wide, never allocates, and calling it
+	 * costs a single indirect call. In exchange, it does not extend the
+	 * lifetime of what it refers to: it is meant for parameters of functions
+	 * that invoke a callback, but do not store it.
+	 *
+	 * \code
+	 *   int apply_twice(ftl::function_ref<int(int)> f, int x) {
+	 *       return f(f(x));
+	 *   }
+	 *
+	 *   apply_twice([](int x){ return x + 1; }, 0); // Fine, the lambda lives
+	 *                                               // until apply_twice returns
+	 * \endcode
+	 *
+	 * Curried calling is supported just like with `ftl::function`. The
+	 * partially applied function is an `ftl::function` however, holding a
+	 * copy of the `function_ref` (and thus still referring to the original
+	 * function object).
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref assignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \ingroup function
+	 */
+	template<typename>
+	class function_ref {};
+
+	template<typename R, typename...Ps>
+	class function_ref<R(Ps...)>
+	: private ::ftl::_dtl::curried<function_ref<R(Ps...)>,R,Ps...> {
+		template<typename F>
+		using is_ref_argument = std::integral_constant<
+			bool,
+			!std::is_same<plain_type<F>,function_ref>::value
+			&& !std::is_member_pointer<plain_type<F>>::value
+			&& ::ftl::_dtl::is_callable_as<
+				typename std::remove_reference<F>::type, R (Ps...)
+			>::value
+		>;
+
+		template<typename F>
+		using is_function_pointer = std::is_function<
+			typename std::remove_pointer<plain_type<F>>::type
+		>;
+
+	public:
+		/// \copydoc function::parameter_types
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the referenced function.
+		using result_type = R;
+
+		function_ref(const function_ref&) = default;
+		function_ref& operator= (const function_ref&) = default;
+
+		/**
+		 * Refer to a function object.
+		 *
+		 * `f` must outlive the `function_ref` and any copies of it.
+		 */
+		template<
+				typename F,
+				typename std::enable_if<
+					is_ref_argument<F>::value && !is_function_pointer<F>::value,
+					int
+				>::type = 0
+		>
+		function_ref(F&& f) noexcept
+		: call(&call_object<typename std::remove_reference<F>::type>) {
+			target.object = const_cast<void*>(
+				static_cast<const void*>(std::addressof(f))
+			);
+		}
+
+		/// Refer to a free function.
+		template<
+				typename F,
+				typename std::enable_if<
+					is_ref_argument<F>::value && is_function_pointer<F>::value,
+					int
+				>::type = 0
+		>
+		function_ref(F&& f) noexcept
+		: call(&call_function<plain_type<F>>) {
+			target.function = reinterpret_cast<void (*)()>(plain_type<F>(f));
+		}
+
+		// Inherit the curried function call operator(s)
+		using ::ftl::_dtl::curried<function_ref,R,Ps...>::operator();
+
+		/// Call the referenced function
+		R operator()(Ps...ps) const {
+			return call(target, std::forward<Ps>(ps)...);
+		}
+
+	private:
+		union target_type {
+			void* object;
+			void (*function)();
+		};
+
+		template<typename F>
+		static R call_object(target_type t, Ps...ps) {
+			return (*static_cast<F*>(t.object))(std::forward<Ps>(ps)...);
+		}
+
+		template<typename F>
+		static R call_function(target_type t, Ps...ps) {
+			return reinterpret_cast<F>(t.function)(std::forward<Ps>(ps)...);
+		}
+
+		target_type target;
+		R (*call)(target_type, Ps...);
+	};
+
+	/**
+	 * Move-only counterpart of `ftl::function`.
+	 *
+	 * \tparam R Return value of the wrapped function or function object.
+	 * \tparam Ps Parameter pack of the wrapped function's `operator()`.
+	 *
+	 * As the wrapper itself need never be copied, neither does the wrapped
+	 * function object. This means it is possible to wrap lambdas and other
+	 * function objects that own a `std::unique_ptr`, a `std::future`, or
+	 * anything else that is expensive or impossible to copy.
+	 *
+	 * Storage works exactly as in `ftl::function`, including the size of the
+	 * in place buffer. Curried calling is not supported, as the partially
+	 * applied function would have to share ownership of the original.
+	 *
+	 * \code
+	 *   struct deref {
+	 *       std::unique_ptr<int> p;
+	 *       int operator() () const { return *p; }
+	 *   };
+	 *
+	 *   ftl::unique_function<int()> f = deref{std::unique_ptr<int>(new int(5))};
+	 *   auto g = std::move(f);
+	 *   g(); // 5
+	 * \endcode
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref movecons
+	 * - \ref moveassignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \ingroup function
+	 */
+	template<typename>
+	class unique_function {};
+
+	template<typename R, typename...Ps>
+	class unique_function<R(Ps...)> {
+		template<typename F>
+		using is_argument = std::integral_constant<
+			bool,
+			::ftl::_dtl::is_valid_function_argument<F, R (Ps...)>::value
+			|| std::is_same<F, function<R(Ps...)>>::value
+		>;
+
+	public:
+		/// \copydoc function::parameter_types
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the function object.
+		using result_type = R;
+
+		/// Equivalent of unique_function(std::nullptr_t)
+		unique_function() noexcept {
 			initialise_empty();
-			swap(other);
 		}
 
-		~function() noexcept {
+		/// Initialise a nullary function wrapper
+		unique_function(std::nullptr_t) noexcept {
+			initialise_empty();
+		}
+
+		unique_function(const unique_function&) = delete;
+
+		unique_function(unique_function&& f) noexcept {
+			initialise_empty();
+			swap(f);
+		}
+
+		/**
+		 * Construct from arbitrary function object.
+		 *
+		 * \tparam F must have a function call operator matching the type the
+		 *           `ftl::unique_function` is declared as. It need only be
+		 *           move constructible.
+		 */
+		template<
+				typename F,
+				typename = typename std::enable_if<is_argument<F>::value>::type
+		>
+		unique_function(F f)
+		noexcept(::ftl::_dtl::is_inplace_allocated<
+				F,
+				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>>::value
+		)
+		{
+			if(::ftl::_dtl::is_null(f))
+				initialise_empty();
+
+			else {
+				using functor_type = typename ::ftl::_dtl::functor_type<F>::type;
+				initialise(
+					::ftl::_dtl::to_functor(std::move(f)),
+					std::allocator<functor_type>()
+				);
+			}
+		}
+
+		~unique_function() noexcept {
 			manager_storage.manager(
 					&manager_storage,
 					nullptr,
 					::ftl::_dtl::call_destroy);
 		}
 
-		function& operator= (function other) noexcept {
-			swap(other);
+		unique_function& operator= (const unique_function&) = delete;
+
+		unique_function& operator= (unique_function&& other) noexcept {
+			unique_function(std::move(other)).swap(*this);
 			return *this;
 		}
 
-		// Inherit the curried function call operator(s)
-		using ::ftl::_dtl::curried<R,Ps...>::operator();
-
 		/// Call the wrapped function object
 		R operator()(Ps...ps) const {
 			return call(manager_storage.functor, std::forward<Ps>(ps)...);
 		}
 
-		template<typename F, typename Allocator>
-		void assign(F&& f, const Allocator& alloc)
-		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
-			function(std::allocator_arg, alloc, f).swap(*this);
-		}
-
-		void swap(function& other) noexcept {
+		void swap(unique_function& other) noexcept {
 			::ftl::_dtl::manager_storage_type temp_storage;
 
 			other.manager_storage.manager(
@@ -333,12 +720,12 @@ namespace ftl {
 			call = &::ftl::_dtl::function_manager_inplace_specialisation<F,Allocator>
 				::template call<R, Ps...>;
 
-			::ftl::_dtl::create_manager<F,Allocator>(
+			::ftl::_dtl::create_move_only_manager<F,Allocator>(
 					manager_storage,
 					std::forward<Allocator>(alloc));
 
 			::ftl::_dtl::function_manager_inplace_specialisation<F, Allocator>
-				::store_functor(manager_storage, std::forward<F>(f));
+				::store_functor(manager_storage, std::move(f));
 		}
 
 		using empty_fn_type = R(*)(Ps...);
@@ -346,11 +733,7 @@ namespace ftl {
 		void initialise_empty() noexcept {
 			using Allocator = std::allocator<empty_fn_type>;
 
-			static_assert(
-				::ftl::_dtl::is_inplace_allocated<empty_fn_type, Allocator>::value,
-				"The empty function should benefit from small functor optimization");
-
-			::ftl::_dtl::create_manager<empty_fn_type,Allocator>(
+			::ftl::_dtl::create_move_only_manager<empty_fn_type,Allocator>(
 					manager_storage,
 					Allocator()
 			);
@@ -364,11 +747,11 @@ namespace ftl {
 	};
 
 	template<typename R, typename...Ps>
-	struct parametric_type_traits<function<R(Ps...)>> {
+	struct parametric_type_traits<unique_function<R(Ps...)>> {
 		using value_type = R;
 
 		template<typename S>
-		using rebind = function<S(Ps...)>;
+		using rebind = unique_function<S(Ps...)>;
 	};
 
 }
@@ -24,15 +24,26 @@
 #define FTL_FUTURE_H
 
 #include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include <tuple>
+#include <initializer_list>
+#include <chrono>
+#include <vector>
 #include "concepts/monad.h"
 #include "concepts/monoid.h"
+#include "either.h"
+#include "trace.h"
 
 namespace ftl {
 
 	/**
 	 * \defgroup future Future
 	 *
-	 * Concept instances for `std::future`.
+	 * Concept instances for `std::future`, and a future with continuations.
 	 *
 	 * \code
 	 *   #include <ftl/future.h>
@@ -44,10 +55,25 @@ namespace ftl {
 	 * - \ref monadpg
 	 * - \ref monoidpg
 	 *
+	 * It also provides `ftl::future` and `ftl::promise`, which support
+	 * attaching continuations, and have non-blocking instances of the first
+	 * three.
+	 *
 	 * \par Dependencies
 	 * - `<future>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<condition_variable>`
+	 * - `<exception>`
+	 * - `<atomic>`
+	 * - `<tuple>`
+	 * - `<initializer_list>`
+	 * - `<chrono>`
+	 * - `<vector>`
 	 * - \ref monad
 	 * - \ref monoid
+	 * - \ref either
+	 * - \ref trace
 	 */
 
 	// Because futures cannot be copied, only moved, we need to specialise
@@ -55,6 +81,15 @@ namespace ftl {
 
 	// TODO: When lambdas can capture by move, this won't be necessary
 	namespace _dtl {
+		template<typename A, typename B>
+		struct pure_after {
+			std::future<B> operator() (A&& a) const {
+				return monad<std::future<B>>::pure(fn(std::forward<A>(a)));
+			}
+
+			unique_function<B(A)> fn;
+		};
+
 		template<typename A, typename B>
 		struct inner_ap {
 			using result_type = B;
@@ -62,10 +97,9 @@ namespace ftl {
 			explicit inner_ap(std::future<A>&& f) noexcept
 			: _f(std::move(f)) {}
 
-			std::future<B> operator() (function<B(A)> fn) {
-				return std::move(_f) >>= [fn](A&& a) {
-					return monad<std::future<B>>::pure(fn(std::forward<A>(a)));
-				};
+			// Taking a unique_function lets move-only functions be applied
+			std::future<B> operator() (unique_function<B(A)> fn) {
+				return std::move(_f) >>= pure_after<A,B>{std::move(fn)};
 			}
 
 			std::future<A> _f;
@@ -140,7 +174,7 @@ namespace ftl {
 				[](F f, std::future<T>&& fa) {
 					return f(fa.get());
 				},
-				f,
+				std::move(f),
 				std::move(fa)
 			);
 		}
@@ -229,6 +263,1213 @@ namespace ftl {
 
 		static constexpr bool instance = monoid<T>::instance;
 	};
+
+	template<typename T>
+	class future;
+
+	template<typename T>
+	class promise;
+
+	namespace _dtl {
+		struct cancellation_state {
+			bool is_cancelled() const noexcept {
+				return cancelled.load(std::memory_order_acquire)
+					|| (has_deadline && clock::now() >= deadline);
+			}
+
+			using clock = std::chrono::steady_clock;
+
+			std::atomic<bool> cancelled{false};
+			bool has_deadline = false;
+			clock::time_point deadline;
+		};
+	}
+
+	/**
+	 * Exception stored in futures whose pipeline was cancelled.
+	 *
+	 * \see cancellation_source
+	 *
+	 * \ingroup future
+	 */
+	class operation_cancelled : public std::exception {
+	public:
+		const char* what() const noexcept override {
+			return "ftl::operation_cancelled";
+		}
+	};
+
+	/**
+	 * Read-only view of whether some work is still wanted.
+	 *
+	 * Tokens are obtained from a `cancellation_source`, and are cheap to
+	 * copy. A default constructed token is never cancelled.
+	 *
+	 * \ingroup future
+	 */
+	class cancellation_token {
+	public:
+		cancellation_token() noexcept = default;
+
+		/**
+		 * Check whether the source was cancelled, or its deadline passed.
+		 *
+		 * Long running computations may poll this to stop early.
+		 */
+		bool is_cancelled() const noexcept {
+			return state && state->is_cancelled();
+		}
+
+		/// Check whether this token belongs to any source at all.
+		bool can_be_cancelled() const noexcept {
+			return static_cast<bool>(state);
+		}
+
+	private:
+		friend class cancellation_source;
+
+		explicit cancellation_token(
+				std::shared_ptr<_dtl::cancellation_state> s
+		) noexcept
+		: state(std::move(s))
+		{}
+
+		std::shared_ptr<_dtl::cancellation_state> state;
+	};
+
+	/**
+	 * The controlling end of cancellation.
+	 *
+	 * An `ftl::future` given a token, using `future::with_cancellation`,
+	 * passes it on to every future derived from it by `then`, `fmap`, `>>=`,
+	 * `apply`, `when_all` and the like. Once the token is cancelled (or its
+	 * deadline has passed), those continuations that have not yet started
+	 * are not run at all, and their futures fail with `operation_cancelled`.
+	 *
+	 * Cancellation is cooperative: a continuation that is already running is
+	 * not interrupted, but may check `cancellation_token::is_cancelled`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto src = cancellation_source::with_timeout(
+	 *       std::chrono::milliseconds(50)
+	 *   );
+	 *
+	 *   auto f = fetch().with_cancellation(src.token());
+	 *   auto g = parse % std::move(f);
+	 *
+	 *   // If fetch takes longer than 50 ms, parse is never run, and g.get()
+	 *   // throws operation_cancelled.
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	class cancellation_source {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		/// Create a source that is cancelled only by calling `cancel`.
+		cancellation_source()
+		: state(std::make_shared<_dtl::cancellation_state>())
+		{}
+
+		/// Create a source that is also cancelled once `deadline` passes.
+		explicit cancellation_source(clock::time_point deadline)
+		: cancellation_source() {
+			state->has_deadline = true;
+			state->deadline = deadline;
+		}
+
+		/// Create a source that is also cancelled once `d` has elapsed.
+		template<typename Rep, typename Period>
+		static cancellation_source with_timeout(
+				const std::chrono::duration<Rep,Period>& d
+		) {
+			return cancellation_source(
+				clock::now() + std::chrono::duration_cast<clock::duration>(d)
+			);
+		}
+
+		/// Cancel all work holding a token of this source.
+		void cancel() noexcept {
+			state->cancelled.store(true, std::memory_order_release);
+		}
+
+		cancellation_token token() const noexcept {
+			return cancellation_token{state};
+		}
+
+	private:
+		std::shared_ptr<_dtl::cancellation_state> state;
+	};
+
+	namespace _dtl {
+		/* The part of a future's shared state that does not depend on the
+		 * type of the value.
+		 *
+		 * A future is move only, and then() consumes it, so there is never more
+		 * than one continuation to run. It is run by whichever thread makes the
+		 * state ready, or, if the state is already ready, by the thread
+		 * attaching it.
+		 *
+		 * The cancellation token is inherited by the states of futures derived
+		 * from this one, and checked before running their continuations.
+		 */
+		class future_state_base {
+		public:
+			future_state_base() = default;
+			future_state_base(const future_state_base&) = delete;
+			future_state_base& operator= (const future_state_base&) = delete;
+
+			bool is_ready() const {
+				std::lock_guard<std::mutex> lock(m);
+				return done;
+			}
+
+			void wait() const {
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [this](){ return done; });
+			}
+
+			void on_ready(unique_function<void()> k) {
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(!done) {
+						continuation = std::move(k);
+						return;
+					}
+				}
+
+				k();
+			}
+
+			void set_exception(std::exception_ptr e) {
+				complete([this,&e](){ error = std::move(e); });
+			}
+
+			// Called when a promise is destroyed without being satisfied
+			void abandon() {
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(done)
+						return;
+				}
+
+				set_exception(std::make_exception_ptr(
+					std::future_error(std::future_errc::broken_promise)
+				));
+			}
+
+			void set_token(cancellation_token t) {
+				std::lock_guard<std::mutex> lock(m);
+				token = std::move(t);
+			}
+
+			cancellation_token get_token() const {
+				std::lock_guard<std::mutex> lock(m);
+				return token;
+			}
+
+			bool cancelled() const {
+				return get_token().is_cancelled();
+			}
+
+		protected:
+			template<typename G>
+			void complete(G g) {
+				unique_function<void()> k;
+
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(done) {
+						throw std::future_error(
+							std::future_errc::promise_already_satisfied
+						);
+					}
+
+					g();
+					done = true;
+					k = std::move(continuation);
+				}
+
+				cv.notify_all();
+
+				if(k)
+					k();
+			}
+
+			void rethrow_if_failed() const {
+				if(error)
+					std::rethrow_exception(error);
+			}
+
+		private:
+			mutable std::mutex m;
+			mutable std::condition_variable cv;
+			bool done = false;
+			std::exception_ptr error;
+			unique_function<void()> continuation;
+			cancellation_token token;
+		};
+
+		template<typename T>
+		class future_state : public future_state_base {
+		public:
+			future_state() = default;
+
+			~future_state() {
+				if(has_value)
+					value().~T();
+			}
+
+			template<typename U>
+			void set_value(U&& u) {
+				complete([this,&u](){
+					new (&storage) T(std::forward<U>(u));
+					has_value = true;
+				});
+			}
+
+			// Only valid once ready, and only once
+			T take() {
+				rethrow_if_failed();
+				return std::move(value());
+			}
+
+		private:
+			T& value() noexcept {
+				return *reinterpret_cast<T*>(&storage);
+			}
+
+			bool has_value = false;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		};
+
+		template<>
+		class future_state<void> : public future_state_base {
+		public:
+			void set_value() {
+				complete([](){});
+			}
+
+			void take() {
+				rethrow_if_failed();
+			}
+		};
+
+		template<typename F, typename T>
+		struct continuation_result {
+			using type = result_of<F(T)>;
+		};
+
+		template<typename F>
+		struct continuation_result<F,void> {
+			using type = result_of<F()>;
+		};
+
+		template<typename F, typename T>
+		auto call_with_value(F& f, future_state<T>& s)
+		-> decltype(f(s.take())) {
+			return f(s.take());
+		}
+
+		template<typename F>
+		auto call_with_value(F& f, future_state<void>& s) -> decltype(f()) {
+			s.take();
+			return f();
+		}
+
+		template<typename U, typename G>
+		void fulfil(promise<U>& p, G& g, std::false_type) {
+			p.set_value(g());
+		}
+
+		template<typename U, typename G>
+		void fulfil(promise<U>& p, G& g, std::true_type) {
+			g();
+			p.set_value();
+		}
+
+		// Satisfy p with the result of g, or whatever g throws
+		template<typename U, typename G>
+		void fulfil(promise<U>& p, G g) {
+			try {
+				fulfil(p, g, std::is_void<U>());
+			}
+			catch(...) {
+				p.set_exception(std::current_exception());
+			}
+		}
+
+		struct future_access {
+			template<typename T>
+			static std::shared_ptr<future_state<T>>& state(future<T>& f) {
+				return f.state;
+			}
+		};
+
+		// Give r the first cancellation token found among srcs, if any
+		template<typename U, typename It>
+		void inherit_token(future<U>& r, It first, It last) {
+			for(; first != last; ++first) {
+				auto t = (*first)->get_token();
+				if(t.can_be_cancelled()) {
+					future_access::state(r)->set_token(std::move(t));
+					return;
+				}
+			}
+		}
+
+		template<typename U>
+		void inherit_token(
+				future<U>& r,
+				std::initializer_list<const future_state_base*> srcs
+		) {
+			inherit_token(r, srcs.begin(), srcs.end());
+		}
+
+		inline std::exception_ptr cancelled_error() {
+			return std::make_exception_ptr(operation_cancelled());
+		}
+
+		template<typename T, typename F, typename U>
+		struct then_continuation {
+			void operator() () {
+				if(src->cancelled()) {
+					p.set_exception(cancelled_error());
+					return;
+				}
+
+				fulfil(p, [this]() -> U { return call_with_value(f, *src); });
+			}
+
+			std::shared_ptr<future_state<T>> src;
+			F f;
+			promise<U> p;
+		};
+
+		template<typename U>
+		struct forward_continuation {
+			void operator() () {
+				fulfil(p, [this]() -> U { return src->take(); });
+			}
+
+			std::shared_ptr<future_state<U>> src;
+			promise<U> p;
+		};
+
+		template<typename T, typename F, typename U>
+		struct bind_continuation {
+			void operator() () {
+				if(src->cancelled()) {
+					p.set_exception(cancelled_error());
+					return;
+				}
+
+				future<U> inner;
+				try {
+					inner = call_with_value(f, *src);
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+					return;
+				}
+
+				auto s = std::move(future_access::state(inner));
+				s->on_ready(forward_continuation<U>{s, std::move(p)});
+			}
+
+			std::shared_ptr<future_state<T>> src;
+			F f;
+			promise<U> p;
+		};
+
+		template<typename Executor, typename K>
+		struct post_continuation {
+			void operator() () {
+				trace_ready(k.f);
+				ex->execute(unique_function<void()>{std::move(k)});
+			}
+
+			Executor* ex;
+			K k;
+		};
+	}
+
+	/**
+	 * A future value with continuations.
+	 *
+	 * Unlike `std::future`, an `ftl::future` can be given a continuation using
+	 * `then`, which is run as soon as the value is available, rather than
+	 * when someone asks for it. Chains of `fmap` and `>>=` on `ftl::future`
+	 * are thus non-blocking: no thread waits for anything until `get` or
+	 * `wait` is called on the final result.
+	 *
+	 * Instances are move only, and typically created using a `promise`, or
+	 * `make_ready_future`.
+	 *
+	 * If the computation producing the value fails, the exception is stored
+	 * and passed along to any continuation's future, without running the
+	 * continuation. It is rethrown by `get`.
+	 *
+	 * \par Concepts
+	 * - \ref defcons (an invalid future)
+	 * - \ref movecons
+	 * - \ref moveassignable
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::promise<int> p;
+	 *   auto f = [](int x){ return x*2; } % p.get_future();
+	 *
+	 *   p.set_value(2); // Runs the continuation
+	 *   f.get();        // 4
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	class future {
+	public:
+		/// The type of the promised value.
+		using value_type = T;
+
+		/// Creates an invalid future, with no state.
+		future() noexcept = default;
+		future(const future&) = delete;
+		future(future&&) noexcept = default;
+		~future() = default;
+
+		future& operator= (const future&) = delete;
+		future& operator= (future&&) noexcept = default;
+
+		/// Check whether this future refers to a shared state.
+		bool valid() const noexcept {
+			return static_cast<bool>(state);
+		}
+
+		/**
+		 * Check whether the value (or an exception) is available.
+		 *
+		 * \note Undefined behaviour if `!valid()`.
+		 */
+		bool is_ready() const {
+			return state->is_ready();
+		}
+
+		/// Block until the value (or an exception) is available.
+		void wait() const {
+			state->wait();
+		}
+
+		/**
+		 * Wait for, and then move out, the value.
+		 *
+		 * If the computation failed, its exception is thrown instead. In
+		 * either case, the future is invalid afterwards.
+		 */
+		T get() {
+			auto s = std::move(state);
+			s->wait();
+			return s->take();
+		}
+
+		/**
+		 * Make this future, and every future derived from it, cancellable.
+		 *
+		 * Continuations attached to this future, directly or further down
+		 * a pipeline, are skipped once `t` is cancelled, and their futures
+		 * fail with `operation_cancelled`. This future itself still gets
+		 * whatever value it is given.
+		 *
+		 * This future is invalid after the call.
+		 */
+		future with_cancellation(cancellation_token t) && {
+			state->set_token(std::move(t));
+			return std::move(*this);
+		}
+
+		/**
+		 * Attach a continuation.
+		 *
+		 * `f` is invoked with the value as soon as it is available, on the
+		 * thread that provides it. If the value is already available, `f` is
+		 * invoked right away, on the calling thread.
+		 *
+		 * \return A future of whatever `f` returns. If this future fails, or
+		 *         `f` throws, the returned future holds the exception.
+		 *
+		 * This future is invalid after the call.
+		 */
+		template<
+				typename F,
+				typename U = typename _dtl::continuation_result<F,T>::type
+		>
+		future<U> then(F f) && {
+			promise<U> p;
+			auto r = p.get_future();
+			auto s = std::move(state);
+			_dtl::inherit_token(r, {s.get()});
+
+			s->on_ready(_dtl::then_continuation<T,F,U>{
+				s, std::move(f), std::move(p)
+			});
+
+			return r;
+		}
+
+		/**
+		 * Attach a continuation to be run by an executor.
+		 *
+		 * As the other `then`, except that once the value is available,
+		 * invoking `f` is handed to `ex` as a task.
+		 *
+		 * \tparam Executor must satisfy \ref executorpg, see for example
+		 *                  `ftl::thread_pool`. `ex` must outlive the
+		 *                  completion of this future.
+		 */
+		template<
+				typename Executor,
+				typename F,
+				typename U = typename _dtl::continuation_result<F,T>::type
+		>
+		future<U> then(Executor& ex, F f) && {
+			using K = _dtl::then_continuation<T,F,U>;
+
+			promise<U> p;
+			auto r = p.get_future();
+			auto s = std::move(state);
+			_dtl::inherit_token(r, {s.get()});
+
+			s->on_ready(_dtl::post_continuation<Executor,K>{
+				std::addressof(ex), K{s, std::move(f), std::move(p)}
+			});
+
+			return r;
+		}
+
+	private:
+		friend class promise<T>;
+		friend struct _dtl::future_access;
+
+		explicit future(std::shared_ptr<_dtl::future_state<T>> s) noexcept
+		: state(std::move(s))
+		{}
+
+		std::shared_ptr<_dtl::future_state<T>> state;
+	};
+
+	/**
+	 * The producing end of an `ftl::future`.
+	 *
+	 * Much like `std::promise`, but with `ftl::future` as its future type.
+	 * Satisfying the promise runs the future's continuation, if there is
+	 * one, on the calling thread.
+	 *
+	 * A promise that is destroyed without being satisfied leaves a
+	 * `std::future_error` with `std::future_errc::broken_promise` in its
+	 * future.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	class promise {
+	public:
+		promise() : state(std::make_shared<_dtl::future_state<T>>()) {}
+		promise(const promise&) = delete;
+		promise(promise&&) noexcept = default;
+
+		~promise() {
+			if(state)
+				state->abandon();
+		}
+
+		promise& operator= (const promise&) = delete;
+
+		promise& operator= (promise&& other) noexcept {
+			promise(std::move(other)).swap(*this);
+			return *this;
+		}
+
+		void swap(promise& other) noexcept {
+			state.swap(other.state);
+			std::swap(retrieved, other.retrieved);
+		}
+
+		/**
+		 * Get the future of this promise.
+		 *
+		 * \throws std::future_error if called more than once.
+		 */
+		future<T> get_future() {
+			if(retrieved) {
+				throw std::future_error(
+					std::future_errc::future_already_retrieved
+				);
+			}
+
+			retrieved = true;
+			return future<T>{state};
+		}
+
+		/**
+		 * Satisfy the promise with a value.
+		 *
+		 * \throws std::future_error if the promise was already satisfied.
+		 */
+		template<typename U = T>
+		void set_value(U&& u) {
+			state->set_value(std::forward<U>(u));
+		}
+
+		/// Satisfy the promise with an exception.
+		void set_exception(std::exception_ptr e) {
+			state->set_exception(std::move(e));
+		}
+
+	private:
+		std::shared_ptr<_dtl::future_state<T>> state;
+		bool retrieved = false;
+	};
+
+	/**
+	 * Promise of nothing.
+	 *
+	 * \ingroup future
+	 */
+	template<>
+	class promise<void> {
+	public:
+		promise() : state(std::make_shared<_dtl::future_state<void>>()) {}
+		promise(const promise&) = delete;
+		promise(promise&&) noexcept = default;
+
+		~promise() {
+			if(state)
+				state->abandon();
+		}
+
+		promise& operator= (const promise&) = delete;
+
+		promise& operator= (promise&& other) noexcept {
+			promise(std::move(other)).swap(*this);
+			return *this;
+		}
+
+		void swap(promise& other) noexcept {
+			state.swap(other.state);
+			std::swap(retrieved, other.retrieved);
+		}
+
+		future<void> get_future() {
+			if(retrieved) {
+				throw std::future_error(
+					std::future_errc::future_already_retrieved
+				);
+			}
+
+			retrieved = true;
+			return future<void>{state};
+		}
+
+		void set_value() {
+			state->set_value();
+		}
+
+		void set_exception(std::exception_ptr e) {
+			state->set_exception(std::move(e));
+		}
+
+	private:
+		std::shared_ptr<_dtl::future_state<void>> state;
+		bool retrieved = false;
+	};
+
+	/**
+	 * Create a future that is already ready with the value `t`.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	future<plain_type<T>> make_ready_future(T&& t) {
+		promise<plain_type<T>> p;
+		p.set_value(std::forward<T>(t));
+		return p.get_future();
+	}
+
+	namespace _dtl {
+		/* Waits for a number of futures at once.
+		 *
+		 * The states of the input futures are kept, rather than their values,
+		 * and each is given a continuation that counts down remaining. The
+		 * last one to arrive moves every value out, in order, to satisfy p.
+		 *
+		 * remaining starts one above the number of inputs, and is counted
+		 * down once more after all continuations are attached, so that no
+		 * input can complete the result before that, and so that zero inputs
+		 * work.
+		 */
+		template<typename S>
+		struct when_all_arrival {
+			void operator() () {
+				s->arrive();
+			}
+
+			std::shared_ptr<S> s;
+		};
+
+		template<typename...Ts>
+		struct when_all_state {
+			explicit when_all_state(future<Ts>&&...fs)
+			: inputs(std::move(future_access::state(fs))...)
+			{}
+
+			template<size_t...Is>
+			static void attach(
+					const std::shared_ptr<when_all_state>& self, seq<Is...>
+			) {
+				int dummy[] = {
+					0,
+					(std::get<Is>(self->inputs)->on_ready(
+						when_all_arrival<when_all_state>{self}
+					), 0)...
+				};
+				(void)dummy;
+			}
+
+			template<size_t...Is>
+			static void inherit(
+					future<std::tuple<Ts...>>& r,
+					const when_all_state& self,
+					seq<Is...>
+			) {
+				inherit_token(r, {std::get<Is>(self.inputs).get()...});
+			}
+
+			void arrive() {
+				if(remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					finish(typename tup_indices<sizeof...(Ts)>::type());
+			}
+
+			template<size_t...Is>
+			void finish(seq<Is...>) {
+				fulfil(p, [this](){
+					return std::tuple<Ts...>{std::get<Is>(inputs)->take()...};
+				});
+			}
+
+			std::tuple<std::shared_ptr<future_state<Ts>>...> inputs;
+			std::atomic<size_t> remaining{sizeof...(Ts) + 1};
+			promise<std::tuple<Ts...>> p;
+		};
+
+		template<typename T>
+		struct when_all_vector_state {
+			void arrive() {
+				if(remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					fulfil(p, [this](){
+						std::vector<T> r;
+						r.reserve(inputs.size());
+						for(auto& s : inputs)
+							r.push_back(s->take());
+
+						return r;
+					});
+				}
+			}
+
+			std::vector<std::shared_ptr<future_state<T>>> inputs;
+			std::atomic<size_t> remaining{1};
+			promise<std::vector<T>> p;
+		};
+
+		template<typename F, typename T, typename U>
+		struct apply_pair {
+			U operator() (std::tuple<F,T> t) {
+				return std::get<0>(t)(std::move(std::get<1>(t)));
+			}
+		};
+	}
+
+	/**
+	 * Wait for several futures at once.
+	 *
+	 * \return A future that becomes ready when _all_ of `fs` are, with a
+	 *         tuple of their values. If any of `fs` fails, the result holds
+	 *         the exception of the first one (in argument order) to have
+	 *         failed, once all of them are done.
+	 *
+	 * No thread blocks while waiting, and the inputs may complete in any
+	 * order.
+	 *
+	 * \note The futures must not be of `void`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto all = when_all(rpc_a(), rpc_b(), rpc_c());
+	 *   auto r = std::move(all).then([](std::tuple<A,B,C> t){ ... });
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename...Ts>
+	future<std::tuple<Ts...>> when_all(future<Ts>&&...fs) {
+		using state_t = _dtl::when_all_state<Ts...>;
+
+		auto s = std::make_shared<state_t>(std::move(fs)...);
+		auto r = s->p.get_future();
+
+		state_t::inherit(r, *s, typename _dtl::tup_indices<sizeof...(Ts)>::type());
+		state_t::attach(s, typename _dtl::tup_indices<sizeof...(Ts)>::type());
+		s->arrive();
+
+		return r;
+	}
+
+	/**
+	 * Wait for every future in a vector.
+	 *
+	 * As the variadic version, but with a vector of values as the result.
+	 * The order of the values is that of `fs`.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	future<std::vector<T>> when_all(std::vector<future<T>>&& fs) {
+		using state_t = _dtl::when_all_vector_state<T>;
+
+		auto s = std::make_shared<state_t>();
+		auto r = s->p.get_future();
+
+		s->inputs.reserve(fs.size());
+		for(auto& f : fs)
+			s->inputs.push_back(std::move(_dtl::future_access::state(f)));
+
+		_dtl::inherit_token(r, s->inputs.begin(), s->inputs.end());
+
+		s->remaining.store(fs.size() + 1, std::memory_order_relaxed);
+		for(auto& i : s->inputs)
+			i->on_ready(_dtl::when_all_arrival<state_t>{s});
+
+		s->arrive();
+
+		return r;
+	}
+
+	/**
+	 * Turn a vector of futures into a future vector.
+	 *
+	 * Equivalent of `when_all(std::move(fs))`, by its Haskell name.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	future<std::vector<T>> sequence(std::vector<future<T>>&& fs) {
+		return when_all(std::move(fs));
+	}
+
+	/**
+	 * Start a future computation per element, and wait for all of them.
+	 *
+	 * Invokes `f` on every element of `v`, in order, and then waits for all
+	 * the resulting futures concurrently, as `sequence` does.
+	 *
+	 * \tparam F must be callable with `const T&`, returning an `ftl::future`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   future<response> fetch(const request&);
+	 *
+	 *   std::vector<request> rs = ...;
+	 *   future<std::vector<response>> all = traverse(fetch, rs);
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<
+			typename F,
+			typename T,
+			typename U = Value_type<result_of<F(T)>>,
+			typename = Requires<
+				std::is_same<result_of<F(T)>, future<U>>::value
+			>
+	>
+	future<std::vector<U>> traverse(F f, const std::vector<T>& v) {
+		std::vector<future<U>> fs;
+		fs.reserve(v.size());
+
+		for(auto& x : v)
+			fs.push_back(f(x));
+
+		return when_all(std::move(fs));
+	}
+
+	/**
+	 * Monad instance for `ftl::future`.
+	 *
+	 * In contrast to the instance for `std::future`, nothing here blocks or
+	 * defers anything until `get` is called. Every operation attaches a
+	 * continuation, run as soon as its input is available.
+	 *
+	 * As with `std::future`, all operations work on r-value references only.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	struct monad<future<T>>
+#ifndef DOCUMENTATION_GENERATOR
+	: deriving_join<in_terms_of_bind<future<T>>>
+#endif
+	{
+		/// Creates a future that is already ready with `t`.
+		static future<T> pure(T t) {
+			return make_ready_future(std::move(t));
+		}
+
+		/// Equivalent of `std::move(fa).then(f)`.
+		template<typename F, typename U = result_of<F(T)>>
+		static future<U> map(F f, future<T>&& fa) {
+			return std::move(fa).then(std::move(f));
+		}
+
+		/**
+		 * Apply a future function to a future value.
+		 *
+		 * `f` and `m` are waited for concurrently, as by `when_all`, and the
+		 * function is applied once both are available. Thus, in
+		 * `fn % fa * fb * fc`, the inputs may complete in any order.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static future<U> apply(future<F>&& f, future<T>&& m) {
+			return when_all(std::move(f), std::move(m))
+				.then(_dtl::apply_pair<F,T,U>());
+		}
+
+		/**
+		 * Binds a future value to another future computation.
+		 *
+		 * Once `fa` is available, `f` is invoked with it, and the future it
+		 * returns is in turn given a continuation that satisfies the result.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static future<U> bind(future<T>&& fa, F f) {
+			promise<U> p;
+			auto r = p.get_future();
+			auto s = std::move(_dtl::future_access::state(fa));
+			_dtl::inherit_token(r, {s.get()});
+
+			s->on_ready(_dtl::bind_continuation<T,F,U>{
+				s, std::move(f), std::move(p)
+			});
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		template<typename T>
+		struct append_pair {
+			T operator() (std::tuple<T,T> t) {
+				return monoid<T>::append(
+					std::move(std::get<0>(t)), std::move(std::get<1>(t))
+				);
+			}
+		};
+	}
+
+	/**
+	 * Monoid instance of `ftl::future`.
+	 *
+	 * Unlike the instance of `std::future`, `append` waits on both operands
+	 * concurrently, as by `when_all`, and never blocks.
+	 *
+	 * \tparam T must satisfy \ref monoidpg
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	struct monoid<future<T>> {
+
+		/// Future that is already ready with `monoid<T>::id()`
+		static auto id()
+		-> typename std::enable_if<monoid<T>::instance,future<T>>::type {
+			return make_ready_future(monoid<T>::id());
+		}
+
+		/// Future of `monoid<T>::append` of the values of `f1` and `f2`
+		static auto append(future<T>&& f1, future<T>&& f2)
+		-> typename std::enable_if<monoid<T>::instance,future<T>>::type {
+			return when_all(std::move(f1), std::move(f2))
+				.then(_dtl::append_pair<T>());
+		}
+
+		static constexpr bool instance = monoid<T>::instance;
+	};
+
+	namespace _dtl {
+		template<typename T>
+		struct when_any_state {
+			std::atomic<bool> decided{false};
+			promise<T> p;
+		};
+
+		template<typename T>
+		struct when_any_arrival {
+			void operator() () {
+				if(!s->decided.exchange(true, std::memory_order_acq_rel))
+					fulfil(s->p, [this](){ return src->take(); });
+			}
+
+			std::shared_ptr<when_any_state<T>> s;
+			std::shared_ptr<future_state<T>> src;
+		};
+
+		template<typename L, typename R>
+		struct first_success_state {
+			explicit first_success_state(size_t n) noexcept : remaining(n) {}
+
+			std::atomic<size_t> remaining;
+			std::atomic<bool> decided{false};
+			promise<either<L,R>> p;
+		};
+
+		/* A Right decides the result right away. Otherwise, the last input
+		 * to arrive does, be it a Left or an exception.
+		 */
+		template<typename L, typename R>
+		struct first_success_arrival {
+			void operator() () {
+				try {
+					auto e = src->take();
+					bool ok = e.template is<Right<R>>();
+					if((arrive() || ok) && decide())
+						s->p.set_value(std::move(e));
+				}
+				catch(...) {
+					if(arrive() && decide())
+						s->p.set_exception(std::current_exception());
+				}
+			}
+
+			// True if this was the last input
+			bool arrive() noexcept {
+				return s->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+			}
+
+			bool decide() noexcept {
+				return !s->decided.exchange(true, std::memory_order_acq_rel);
+			}
+
+			std::shared_ptr<first_success_state<L,R>> s;
+			std::shared_ptr<future_state<either<L,R>>> src;
+		};
+	}
+
+	/**
+	 * Race a number of futures.
+	 *
+	 * \return A future that becomes ready as soon as _any_ of `fs` does, with
+	 *         the value (or exception) of that one. The remaining futures
+	 *         are ignored: they run to completion, but their results are
+	 *         dropped.
+	 *
+	 * If `fs` is empty, the result fails with
+	 * `std::future_errc::broken_promise`.
+	 *
+	 * \par Examples
+	 *
+	 * Hedging a request:
+	 * \code
+	 *   std::vector<future<response>> fs;
+	 *   for(auto& r : replicas)
+	 *       fs.push_back(r.fetch(req));
+	 *
+	 *   future<response> fastest = when_any(std::move(fs));
+	 * \endcode
+	 *
+	 * \ingroup future
+	 */
+	template<typename T>
+	future<T> when_any(std::vector<future<T>>&& fs) {
+		auto s = std::make_shared<_dtl::when_any_state<T>>();
+		auto r = s->p.get_future();
+
+		std::vector<std::shared_ptr<_dtl::future_state<T>>> srcs;
+		srcs.reserve(fs.size());
+		for(auto& f : fs)
+			srcs.push_back(std::move(_dtl::future_access::state(f)));
+
+		_dtl::inherit_token(r, srcs.begin(), srcs.end());
+
+		for(auto& src : srcs)
+			src->on_ready(_dtl::when_any_arrival<T>{s, src});
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * All of `fs` must be r-values of `future<T>`.
+	 *
+	 * \ingroup future
+	 */
+	template<typename T, typename...Fs>
+	future<T> when_any(future<T>&& f, Fs&&...fs) {
+		std::vector<future<T>> v;
+		v.reserve(sizeof...(Fs) + 1);
+		v.push_back(std::move(f));
+
+		int dummy[] = { 0, (v.push_back(std::move(fs)), 0)... };
+		(void)dummy;
+
+		return when_any(std::move(v));
+	}
+
+	/**
+	 * Wait for the first successful result of a number of futures.
+	 *
+	 * \return A future that becomes ready with the first `Right` value among
+	 *         `fs`. If there is none, it holds whatever the last of `fs` to
+	 *         complete held, be it a `Left` or an exception.
+	 *
+	 * As with `when_any`, futures completing after the result is decided are
+	 * ignored. If `fs` is empty, the result fails with
+	 * `std::future_errc::broken_promise`.
+	 *
+	 * \ingroup future
+	 */
+	template<typename L, typename R>
+	future<either<L,R>> first_success(std::vector<future<either<L,R>>>&& fs) {
+		using E = either<L,R>;
+
+		auto s = std::make_shared<_dtl::first_success_state<L,R>>(fs.size());
+		auto r = s->p.get_future();
+
+		std::vector<std::shared_ptr<_dtl::future_state<E>>> srcs;
+		srcs.reserve(fs.size());
+		for(auto& f : fs)
+			srcs.push_back(std::move(_dtl::future_access::state(f)));
+
+		_dtl::inherit_token(r, srcs.begin(), srcs.end());
+
+		for(auto& src : srcs)
+			src->on_ready(_dtl::first_success_arrival<L,R>{s, src});
+
+		return r;
+	}
 }
 
 #endif
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CONTIGUOUS_FOLD_H
+#define FTL_CONTIGUOUS_FOLD_H
+
+#include <type_traits>
+#include <cstddef>
+#include "../concepts/monoid.h"
+
+namespace ftl {
+	namespace _dtl {
+		// Number of independent accumulators used by the arithmetic folds
+		constexpr size_t fold_lanes = 8;
+
+		// Block size between early exit checks in the boolean folds
+		constexpr size_t fold_block = 64;
+
+		/* Signed integers are accumulated as unsigned, so that reassociating
+		 * the sum cannot introduce overflow where the plain sum had none. The
+		 * result is the same whenever it is representable.
+		 */
+		template<typename N, bool = std::is_integral<N>::value>
+		struct fold_accumulator {
+			using type = typename std::make_unsigned<N>::type;
+		};
+
+		template<typename N>
+		struct fold_accumulator<N,false> {
+			using type = N;
+		};
+
+		template<>
+		struct fold_accumulator<bool,true> {
+			using type = bool;
+		};
+
+		/* Fold of n consecutive monoid values, starting at p.
+		 *
+		 * This is the plain left to right fold, stopping early if M has
+		 * absorbing elements, and specialised below for monoids that can be
+		 * folded faster when their storage is contiguous.
+		 */
+		template<typename M, typename = void>
+		struct contiguous_fold {
+			static M fold(const M* p, size_t n) {
+				M acc = monoid<M>::id();
+				for(size_t i = 0; i < n; ++i) {
+					acc = monoid<M>::append(acc, p[i]);
+
+					if(is_absorbing(acc))
+						break;
+				}
+
+				return acc;
+			}
+		};
+
+		/* Sums and products of arithmetic types are split over a number of
+		 * independent accumulators, which breaks the dependency from one
+		 * element to the next, and lets the compiler vectorise the loop. Note
+		 * that for floating point numbers, this may change the rounding of
+		 * the result, just as any other regrouping of the terms would.
+		 */
+		template<typename M, typename N, typename Op>
+		struct lane_fold {
+			static M fold(const M* p, size_t n, N z, Op op) {
+				using Acc = typename fold_accumulator<N>::type;
+
+				Acc lanes[fold_lanes];
+				for(auto& l : lanes)
+					l = Acc(z);
+
+				size_t i = 0;
+				for(; i + fold_lanes <= n; i += fold_lanes) {
+					for(size_t j = 0; j < fold_lanes; ++j)
+						lanes[j] = op(lanes[j], Acc(p[i+j].n));
+				}
+
+				Acc acc = Acc(z);
+				for(auto l : lanes)
+					acc = op(acc, l);
+
+				for(; i < n; ++i)
+					acc = op(acc, Acc(p[i].n));
+
+				return M(N(acc));
+			}
+		};
+
+		struct fold_plus {
+			template<typename N>
+			constexpr N operator() (N a, N b) const noexcept {
+				return a + b;
+			}
+		};
+
+		struct fold_times {
+			template<typename N>
+			constexpr N operator() (N a, N b) const noexcept {
+				return a * b;
+			}
+		};
+
+		template<typename N>
+		struct contiguous_fold<
+			sum_monoid<N>,
+			typename std::enable_if<std::is_arithmetic<N>::value>::type
+		> {
+			static sum_monoid<N> fold(const sum_monoid<N>* p, size_t n) {
+				return lane_fold<sum_monoid<N>,N,fold_plus>::fold(
+					p, n, N(0), fold_plus()
+				);
+			}
+		};
+
+		template<typename N>
+		struct contiguous_fold<
+			prod_monoid<N>,
+			typename std::enable_if<std::is_arithmetic<N>::value>::type
+		> {
+			static prod_monoid<N> fold(const prod_monoid<N>* p, size_t n) {
+				return lane_fold<prod_monoid<N>,N,fold_times>::fold(
+					p, n, N(1), fold_times()
+				);
+			}
+		};
+
+		/* any and all are folded a block at a time, without branching inside
+		 * a block, and stop at the first block that settles the result.
+		 */
+		template<typename B, bool Absorbing>
+		struct bool_fold {
+			static B fold(const B* p, size_t n) {
+				size_t i = 0;
+				for(; i + fold_block <= n; i += fold_block) {
+					bool r = !Absorbing;
+					for(size_t j = 0; j < fold_block; ++j) {
+						if(Absorbing)
+							r |= p[i+j].b;
+						else
+							r &= p[i+j].b;
+					}
+
+					if(r == Absorbing)
+						return Absorbing;
+				}
+
+				for(; i < n; ++i) {
+					if(p[i].b == Absorbing)
+						return Absorbing;
+				}
+
+				return !Absorbing;
+			}
+		};
+
+		template<>
+		struct contiguous_fold<any> {
+			static any fold(const any* p, size_t n) {
+				return bool_fold<any,true>::fold(p, n);
+			}
+		};
+
+		template<>
+		struct contiguous_fold<all> {
+			static all fold(const all* p, size_t n) {
+				return bool_fold<all,false>::fold(p, n);
+			}
+		};
+	}
+}
+
+#endif
+
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CONTIGUOUS_MAP_H
+#define FTL_CONTIGUOUS_MAP_H
+
+#include <type_traits>
+#include <cstddef>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define FTL_RESTRICT __restrict
+#else
+#define FTL_RESTRICT
+#endif
+
+namespace ftl {
+	namespace _dtl {
+		// Elements per step of the blocked loops below
+		constexpr size_t map_block = 8;
+
+		template<bool Move, typename T>
+		using map_elem_ref = typename std::conditional<Move,T&&,T&>::type;
+
+		/* Writes f(in[i]) to out[i], for every i below n.
+		 *
+		 * The bulk of the work is done in blocks of a fixed number of
+		 * elements. Loops of a known trip count are vectorised even by the
+		 * cheapest cost models (such as GCC's at -O2), which leave loops of
+		 * unknown length alone. out is never one of the inputs, which the
+		 * restrict qualifiers pass on, so no runtime overlap check is
+		 * needed either.
+		 */
+		template<bool Move, typename U, typename T, typename F>
+		void contiguous_map(
+				U* FTL_RESTRICT out, T* FTL_RESTRICT in, size_t n, F& f) {
+			size_t i = 0;
+			for(; i + map_block <= n; i += map_block) {
+				for(size_t j = 0; j < map_block; ++j) {
+					out[i+j] = f(static_cast<map_elem_ref<Move,T>>(in[i+j]));
+				}
+			}
+
+			for(; i < n; ++i) {
+				out[i] = f(static_cast<map_elem_ref<Move,T>>(in[i]));
+			}
+		}
+
+		// As contiguous_map, but with pairs of elements from a and b
+		template<
+				bool MoveA, bool MoveB,
+				typename U, typename A, typename B, typename F
+		>
+		void contiguous_zip(
+				U* FTL_RESTRICT out, A* FTL_RESTRICT a, B* FTL_RESTRICT b,
+				size_t n, F& f) {
+			size_t i = 0;
+			for(; i + map_block <= n; i += map_block) {
+				for(size_t j = 0; j < map_block; ++j) {
+					out[i+j] = f(
+						static_cast<map_elem_ref<MoveA,A>>(a[i+j]),
+						static_cast<map_elem_ref<MoveB,B>>(b[i+j])
+					);
+				}
+			}
+
+			for(; i < n; ++i) {
+				out[i] = f(
+					static_cast<map_elem_ref<MoveA,A>>(a[i]),
+					static_cast<map_elem_ref<MoveB,B>>(b[i])
+				);
+			}
+		}
+	}
+}
+
+#endif
+
@@ -37,10 +37,11 @@ namespace ftl {
 		private:
 			template<typename P>
 			struct curried {
-				curried(const F& f, const P& p) : f(f), p(p) {}
-				curried(const F& f, P&& p) : f(f), p(std::move(p)) {}
-				curried(F&& f, const P& p) : f(std::move(f)), p(p) {}
-				curried(F&& f, P&& p) : f(std::move(f)), p(std::move(p)) {}
+				template<typename G, typename Q>
+				curried(G&& g, Q&& q)
+				noexcept(std::is_nothrow_constructible<F,G>::value
+						&& std::is_nothrow_constructible<P,Q>::value)
+				: f(std::forward<G>(g)), p(std::forward<Q>(q)) {}
 
 				F f;
 				P p;
@@ -86,29 +87,14 @@ namespace ftl {
 			private:
 				template<typename P2>
 				struct curried {
-					curried(const F& f, const P1& p1, const P2& p2)
-					: f(f), p1(p1), p2(p2) {}
-
-					curried(const F& f, const P1& p1, P2&& p2)
-					: f(f), p1(p1), p2(std::move(p2)) {}
-
-					curried(const F& f, P1&& p1, const P2& p2)
-					: f(f), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, const P1& p1, const P2& p2)
-					: f(std::move(f)), p1(p1), p2(p2) {}
-
-					curried(const F& f, P1&& p1, P2&& p2)
-					: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-					curried(F&& f, const P1& p1, P2&& p2)
-					: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-					curried(F&& f, P1&& p1, const P2& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, P1&& p1, P2&& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
+					template<typename G, typename Q1, typename Q2>
+					curried(G&& g, Q1&& q1, Q2&& q2)
+					noexcept(std::is_nothrow_constructible<F,G>::value
+							&& std::is_nothrow_constructible<P1,Q1>::value
+							&& std::is_nothrow_constructible<P2,Q2>::value)
+					: f(std::forward<G>(g))
+					, p1(std::forward<Q1>(q1))
+					, p2(std::forward<Q2>(q2)) {}
 
 					F f;
 					P1 p1;
@@ -132,10 +118,11 @@ namespace ftl {
 				};
 
 			public:
-				curried1(const F& f, const P1& p) : f(f), p(p) {}
-				curried1(const F& f, P1&& p) : f(f), p(std::move(p)) {}
-				curried1(F&& f, const P1& p) : f(std::move(f)), p(p) {}
-				curried1(F&& f, P1&& p) : f(std::move(f)), p(std::move(p)) {}
+				template<typename G, typename Q>
+				curried1(G&& g, Q&& q)
+				noexcept(std::is_nothrow_constructible<F,G>::value
+						&& std::is_nothrow_constructible<P1,Q>::value)
+				: f(std::forward<G>(g)), p(std::forward<Q>(q)) {}
 
 				F f;
 				P1 p;
@@ -175,53 +162,14 @@ namespace ftl {
 				P1 p1;
 				P2 p2;
 
-				curried2(const F& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(p1), p2(p2) {}
-
-				curried2(const F& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(p1), p2(std::move(p2)) {}
-
-				curried2(const F& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(p2) {}
-
-				curried2(const F& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-				curried2(F&& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-				curried2(F&& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
+				template<typename G, typename Q1, typename Q2>
+				curried2(G&& g, Q1&& q1, Q2&& q2)
+				noexcept(std::is_nothrow_constructible<F,G>::value
+						&& std::is_nothrow_constructible<P1,Q1>::value
+						&& std::is_nothrow_constructible<P2,Q2>::value)
+				: f(std::forward<G>(g))
+				, p1(std::forward<Q1>(q1))
+				, p2(std::forward<Q2>(q2)) {}
 
 				template<typename P3>
 				auto operator() (P3&& p3) const &
@@ -282,17 +230,11 @@ namespace ftl {
 			std::tuple<Args1...> args1;
 
 		public:
-			curried_fn(const F& f, const std::tuple<Args1...>& args)
-			: f(f), args1(args) {}
-
-			curried_fn(F&& f, const std::tuple<Args1...>& args)
-			: f(std::move(f)), args1(args) {}
-
-			curried_fn(const F& f, std::tuple<Args1...>&& args)
-			: f(f), args1(std::move(args)) {}
-
-			curried_fn(F&& f, std::tuple<Args1...>&& args)
-			: f(std::move(f)), args1(std::move(args)) {}
+			template<typename G, typename Tuple>
+			curried_fn(G&& g, Tuple&& args)
+			noexcept(std::is_nothrow_constructible<F,G>::value
+					&& std::is_nothrow_constructible<std::tuple<Args1...>,Tuple>::value)
+			: f(std::forward<G>(g)), args1(std::forward<Tuple>(args)) {}
 
 			template<
 					typename...Args2,
@@ -300,7 +242,7 @@ namespace ftl {
 						is_callable<F,Args1...,Args2...>::value
 					>::type
 			>
-			auto operator() (Args2&&...args2) const
+			auto operator() (Args2&&...args2) const &
 			-> typename std::result_of<F(Args1...,Args2...)>::type {
 				return tup_apply(
 					f,
@@ -311,15 +253,32 @@ namespace ftl {
 				);
 			}
 
+			template<
+					typename...Args2,
+					typename = typename std::enable_if<
+						is_callable<F,Args1...,Args2...>::value
+					>::type
+			>
+			auto operator() (Args2&&...args2) &&
+			-> typename std::result_of<F(Args1...,Args2...)>::type {
+				return tup_apply(
+					std::move(f),
+					std::tuple_cat(
+						std::move(args1),
+						std::forward_as_tuple(std::forward<Args2>(args2)...)
+					)
+				);
+			}
+
 			template<
 					typename...Args2,
 					typename = typename std::enable_if<
 						!is_callable<F,Args1...,Args2...>::value
 					>::type
 			>
-			auto operator() (Args2&&...args2) const
-			-> curried_fn<F,Args1...,Args2...> {
-				return curried_fn<F,Args1...,Args2...>{
+			auto operator() (Args2&&...args2) const &
+			-> curried_fn<F,Args1...,plain_type<Args2>...> {
+				return curried_fn<F,Args1...,plain_type<Args2>...>{
 					f,
 					std::tuple_cat(
 						args1,
@@ -328,6 +287,22 @@ namespace ftl {
 				};
 			}
 
+			template<
+					typename...Args2,
+					typename = typename std::enable_if<
+						!is_callable<F,Args1...,Args2...>::value
+					>::type
+			>
+			auto operator() (Args2&&...args2) &&
+			-> curried_fn<F,Args1...,plain_type<Args2>...> {
+				return curried_fn<F,Args1...,plain_type<Args2>...>{
+					std::move(f),
+					std::tuple_cat(
+						std::move(args1),
+						std::make_tuple(std::forward<Args2>(args2)...)
+					)
+				};
+			}
 		};
 
 		template<typename F>
@@ -388,7 +363,7 @@ namespace ftl {
 			template<typename...Args>
 			auto operator()(Args&&...args) &&
 			-> result_of<F(Arg,Args...)> {
-				return std::move(f)(arg, std::forward<Args>(args)...);
+				return std::move(f)(std::move(arg), std::forward<Args>(args)...);
 			}
 		};
 
@@ -465,7 +440,69 @@ namespace ftl {
 				return part(f,std::forward<Args>(args)...);
 			}
 		};
+
+		template<typename F, typename R, typename...Ps>
+		class monomorphic_curried;
+
+		template<typename F, typename R, typename Seq>
+		struct monomorphic_curried_of {};
+
+		template<typename F, typename R, typename...Ps>
+		struct monomorphic_curried_of<F,R,type_seq<Ps...>> {
+			using type = monomorphic_curried<F,R,Ps...>;
+		};
+
+		// Curried calling of some F with a known signature, R(Ps...).
+		// Partial application is done at compile time, in terms of part.
+		template<typename F, typename R, typename...Ps>
+		class monomorphic_curried {
+			F f;
+
+			// The type of f after applying Args.
+			template<typename...Args>
+			using applied_type = typename monomorphic_curried_of<
+				decltype(part(std::declval<F>(),std::declval<plain_type<Args>>()...)),
+				R,
+				typename drop_types<sizeof...(Args),Ps...>::type
+			>::type;
+
+			template<typename...Args>
+			using EnableCurry = typename std::enable_if<
+				(sizeof...(Args) > 0 && sizeof...(Args) < sizeof...(Ps))
+			>::type;
+
+		public:
+			using result_type = R;
+			using parameter_types = type_seq<Ps...>;
+
+			constexpr monomorphic_curried(F f) : f(std::move(f)) { }
+
+			// Call f.
+			R operator()(Ps...ps) const & {
+				return f(std::forward<Ps>(ps)...);
+			}
+
+			R operator()(Ps...ps) && {
+				return std::move(f)(std::forward<Ps>(ps)...);
+			}
+
+			// Curry f.
+			template<typename...Args, typename = EnableCurry<Args...>>
+			constexpr applied_type<Args...> operator()(Args&&...args) const & {
+				return part(f,std::forward<Args>(args)...);
+			}
+
+			template<typename...Args, typename = EnableCurry<Args...>>
+			applied_type<Args...> operator()(Args&&...args) && {
+				return part(std::move(f),std::forward<Args>(args)...);
+			}
+		};
 	}
+
+	template<typename F, typename R, typename...Ps>
+	struct is_monomorphic<_dtl::monomorphic_curried<F,R,Ps...>> {
+		static constexpr bool value = true;
+	};
 }
 #endif
 
@@ -34,12 +34,23 @@
 #include <stdexcept>
 #include <functional>
 #include "../type_functions.h"
+#include "../alloc_stats.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #endif
 
+/* Size, in bytes, of the inline buffer of ftl::function. Function objects
+ * no larger than this (and suitably aligned) are stored in place, anything
+ * else is allocated on the heap. Rounded up to a whole number of size_t.
+ *
+ * Must be defined to the same value in every translation unit of a program.
+ */
+#ifndef FTL_FUNCTION_INLINE_SIZE
+#define FTL_FUNCTION_INLINE_SIZE (2*sizeof(size_t))
+#endif
+
 namespace ftl {
 
 	template<typename> class function;
@@ -52,9 +63,16 @@ namespace ftl {
 		struct manager_storage_type;
 
 		struct functor_padding {
+			static constexpr size_t words =
+				(FTL_FUNCTION_INLINE_SIZE + sizeof(size_t) - 1) / sizeof(size_t);
+
+			static_assert(
+				words * sizeof(size_t) >= sizeof(void*),
+				"FTL_FUNCTION_INLINE_SIZE must fit at least a pointer"
+			);
+
 		protected:
-			size_t padding_fst;
-			size_t padding_snd;
+			size_t padding[words];
 		};
 
 		struct empty_struct {};
@@ -78,7 +96,11 @@ namespace ftl {
 				&& std::is_nothrow_move_constructible<T>::value
 
 				// so that the user can override it
-				&& !force_function_heap_allocation<T>::value;
+				&& !force_function_heap_allocation<T>::value
+
+				// there is nowhere to put a stateful allocator, and such an
+				// allocator is presumably given for a reason
+				&& std::is_empty<Alloc>::value;
 		};
 
 		template<typename T>
@@ -145,6 +167,26 @@ namespace ftl {
 				= std::is_convertible<decltype(check<T>(nullptr)), R>::value;
 		};
 
+		// Checks if an lvalue of type F can be called as an R(Ps...)
+		template<typename, typename>
+		struct is_callable_as {
+			static constexpr bool value = false;
+		};
+
+		template<typename F, typename R, typename...Ps>
+		struct is_callable_as<F, R (Ps...)> {
+
+			template<typename U>
+			static decltype(std::declval<U&>()(std::declval<Ps>()...))
+			check(U *);
+
+			template<typename>
+			static empty_struct check(...);
+
+			static constexpr bool value
+				= std::is_convertible<decltype(check<F>(nullptr)), R>::value;
+		};
+
 		enum function_manager_calls
 		{
 			call_move_and_destroy,
@@ -219,7 +261,8 @@ namespace ftl {
 					T,
 					Allocator,
 					typename std::enable_if<
-						!is_inplace_allocated<T, Allocator>::value>::type> {
+						!is_inplace_allocated<T, Allocator>::value
+						&& std::is_empty<Allocator>::value>::type> {
 
 			using alloc_traits = std::allocator_traits<Allocator>;
 			using ptr_t = typename alloc_traits::pointer;
@@ -247,6 +290,7 @@ namespace ftl {
 				);
 
 				alloc_traits::construct(allocator, *ptr, std::forward<T>(to_store));
+				note_alloc(alloc_site::function);
 			}
 
 			static void move_functor(
@@ -293,6 +337,118 @@ namespace ftl {
 			}
 		};
 
+		/* Stateful allocators do not fit next to the manager, so they are
+		 * stored in the same heap block as the functor they allocated.
+		 */
+		template<typename T, typename Allocator>
+		struct function_manager_inplace_specialisation<
+					T,
+					Allocator,
+					typename std::enable_if<
+						!std::is_empty<Allocator>::value>::type> {
+
+			struct node {
+				template<typename...Args>
+				node(const Allocator& a, Args&&...args)
+				: allocator(a), functor(std::forward<Args>(args)...) {}
+
+				Allocator allocator;
+				T functor;
+			};
+
+			using node_alloc =
+				typename std::allocator_traits<Allocator>
+					::template rebind_alloc<node>;
+
+			using alloc_traits = std::allocator_traits<node_alloc>;
+			using ptr_t = typename alloc_traits::pointer;
+
+			template<typename R, typename...Ps>
+			static R call(const functor_padding& storage, Ps... ps) {
+				return
+					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding&>(storage)))
+						.functor(std::forward<Ps>(ps)...);
+			}
+
+			template<typename U>
+			static void store_functor(
+					manager_storage_type& self, const Allocator& a, U&& to_store
+			) {
+				static_assert(
+						sizeof(ptr_t) <= sizeof(self.functor),
+						"The allocator's pointer type is too big"
+				);
+
+				node_alloc allocator(a);
+				ptr_t ptr = alloc_traits::allocate(allocator, 1);
+
+				try {
+					alloc_traits::construct(
+						allocator, std::addressof(*ptr), a, std::forward<U>(to_store)
+					);
+				}
+				catch(...) {
+					alloc_traits::deallocate(allocator, ptr, 1);
+					throw;
+				}
+
+				new (&get_functor_ptr_ref(self)) ptr_t(std::move(ptr));
+				note_alloc(alloc_site::function);
+			}
+
+			static void move_functor(
+					manager_storage_type& lhs, manager_storage_type&& rhs
+			)
+			noexcept {
+
+				static_assert(
+					std::is_nothrow_move_constructible<ptr_t>::value,
+					"Cannot offer noexcept swap if the pointer type is "
+					"not nothrow move constructible"
+				);
+
+				new (&get_functor_ptr_ref(lhs)) ptr_t(
+						std::move(get_functor_ptr_ref(rhs))
+				);
+
+				get_functor_ptr_ref(rhs) = nullptr;
+			}
+
+			static void destroy_functor(manager_storage_type& storage) noexcept {
+
+				ptr_t& pointer = get_functor_ptr_ref(storage);
+				if (!pointer)
+					return;
+
+				node_alloc allocator(pointer->allocator);
+				alloc_traits::destroy(allocator, std::addressof(*pointer));
+				alloc_traits::deallocate(allocator, pointer, 1);
+			}
+
+			static const Allocator& get_allocator(
+					const manager_storage_type& storage
+			) noexcept {
+				return get_functor_ptr_ref(storage)->allocator;
+			}
+
+			static T& get_functor_ref(const manager_storage_type& storage) noexcept {
+				return get_functor_ptr_ref(storage)->functor;
+			}
+
+			static ptr_t& get_functor_ptr_ref(const manager_storage_type& storage)
+			noexcept {
+				return reinterpret_cast<ptr_t&>(
+						const_cast<functor_padding&>(storage.functor)
+				);
+			}
+		};
+
+		template<typename T, typename Allocator>
+		void* move_only_function_manager(
+				void* first_arg,
+				void* second_arg,
+				function_manager_calls call_type);
+
 		template<typename T, typename Allocator>
 		static void create_manager(manager_storage_type& storage, Allocator&& allocator)
 		{
@@ -300,10 +456,19 @@ namespace ftl {
 			storage.manager = &function_manager<T, Allocator>;
 		}
 
-		// this function acts as a vtable. it is an optimization to prevent
-		// code-bloat from rtti. see the documentation of boost::function
 		template<typename T, typename Allocator>
-		void* function_manager(
+		static void create_move_only_manager(
+				manager_storage_type& storage, Allocator&& allocator
+		)
+		{
+			new (&storage.get_allocator<Allocator>()) Allocator(std::move(allocator));
+			storage.manager = &move_only_function_manager<T, Allocator>;
+		}
+
+		// The subset of function_manager that does not require T to be
+		// copyable. Used as is by unique_function.
+		template<typename T, typename Allocator>
+		void* move_only_function_manager(
 				void* first_arg, void* second_arg,
 				function_manager_calls call_type
 		)
@@ -329,15 +494,49 @@ namespace ftl {
 				specialisation::move_functor(lhs, std::move(rhs));
 				specialisation::destroy_functor(rhs.get_allocator<Allocator>(), rhs);
 
-				create_manager<T,Allocator>(
-						lhs, std::move(rhs.get_allocator<Allocator>())
-				);
+				// Whichever manager rhs had, copying or not, so does lhs now
+				manager_type manager = rhs.manager;
+
+				new (&lhs.get_allocator<Allocator>())
+					Allocator(std::move(rhs.get_allocator<Allocator>()));
+
+				lhs.manager = manager;
 
 				rhs.get_allocator<Allocator>().~Allocator();
 
 				return nullptr;
 			}
 
+			case call_destroy: {
+
+				manager_storage_type& self =
+					*static_cast<manager_storage_type *>(first_arg);
+
+				specialisation::destroy_functor(self.get_allocator<Allocator>(), self);
+
+				self.get_allocator<Allocator>().~Allocator();
+
+				return nullptr;
+			}
+
+			default:
+				return nullptr;
+			}
+		}
+
+		// this function acts as a vtable. it is an optimization to prevent
+		// code-bloat from rtti. see the documentation of boost::function
+		template<typename T, typename Allocator>
+		void* function_manager(
+				void* first_arg, void* second_arg,
+				function_manager_calls call_type
+		)
+		{
+			using specialisation
+				= function_manager_inplace_specialisation<T,Allocator>;
+
+			switch(call_type) {
+
 			case call_copy: {
 
 				manager_storage_type& lhs =
@@ -357,18 +556,6 @@ namespace ftl {
 				return nullptr;
 			}
 
-			case call_destroy: {
-
-				manager_storage_type& self =
-					*static_cast<manager_storage_type *>(first_arg);
-
-				specialisation::destroy_functor(self.get_allocator<Allocator>(), self);
-
-				self.get_allocator<Allocator>().~Allocator();
-
-				return nullptr;
-			}
-
 			case call_copy_functor_only:
 
 				specialisation::store_functor(
@@ -382,36 +569,136 @@ namespace ftl {
 
 				return nullptr;
 
+			default:
+				return move_only_function_manager<T,Allocator>(
+						first_arg, second_arg, call_type
+				);
+			}
+		}
+
+		// Manager of functors allocated with stateful allocators
+		template<typename T, typename Allocator>
+		void* stateful_function_manager(
+				void* first_arg, void* second_arg,
+				function_manager_calls call_type
+		)
+		{
+			using specialisation
+				= function_manager_inplace_specialisation<T,Allocator>;
+
+			switch(call_type) {
+
+			case call_move_and_destroy: {
+
+				manager_storage_type& lhs =
+					*static_cast<manager_storage_type*>(first_arg);
+
+				manager_storage_type& rhs =
+					*static_cast<manager_storage_type*>(second_arg);
+
+				specialisation::move_functor(lhs, std::move(rhs));
+				lhs.manager = rhs.manager;
+
+				return nullptr;
+			}
+
+			case call_copy:
+			case call_copy_functor_only: {
+
+				manager_storage_type& lhs =
+					*static_cast<manager_storage_type*>(first_arg);
+
+				const manager_storage_type& rhs =
+					*static_cast<const manager_storage_type*>(second_arg);
+
+				specialisation::store_functor(
+						lhs,
+						specialisation::get_allocator(rhs),
+						const_cast<const T&>(specialisation::get_functor_ref(rhs))
+				);
+
+				lhs.manager = rhs.manager;
+
+				return nullptr;
+			}
+
+			case call_destroy:
+
+				specialisation::destroy_functor(
+						*static_cast<manager_storage_type *>(first_arg)
+				);
+
+				return nullptr;
+
 			default:
 				return nullptr;
 			}
 		}
 
+		// Set up storage to manage functor f, allocated using alloc if need be
+		template<typename T, typename Allocator>
+		void initialise_manager(
+				manager_storage_type& storage, Allocator&& alloc, T&& f,
+				typename std::enable_if<
+					std::is_empty<plain_type<Allocator>>::value
+				>::type* = nullptr
+		)
+		{
+			using A = plain_type<Allocator>;
+			using F = plain_type<T>;
+
+			create_manager<F,A>(storage, std::forward<Allocator>(alloc));
+
+			function_manager_inplace_specialisation<F,A>
+				::store_functor(storage, std::forward<T>(f));
+		}
+
+		template<typename T, typename Allocator>
+		void initialise_manager(
+				manager_storage_type& storage, Allocator&& alloc, T&& f,
+				typename std::enable_if<
+					!std::is_empty<plain_type<Allocator>>::value
+				>::type* = nullptr
+		)
+		{
+			using A = plain_type<Allocator>;
+			using F = plain_type<T>;
+
+			function_manager_inplace_specialisation<F,A>
+				::store_functor(storage, alloc, std::forward<T>(f));
+
+			storage.manager = &stateful_function_manager<F,A>;
+		}
+
+		/* Curried call operators of a function wrapper Self, which must
+		 * derive from the appropriate curried<Self,R,Ps...> as its first
+		 * (empty) base.
+		 */
 		template<typename...>
 		struct curried {};
 
-		template<typename R>
-		struct curried<R> {
+		template<typename Self, typename R>
+		struct curried<Self,R> {
 			R operator()() const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P>
-		struct curried<R,P> {
+		template<typename Self, typename R, typename P>
+		struct curried<Self,R,P> {
 			function<R()> operator()(P) const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P1, typename P2, typename...Ps>
-		struct curried<R,P1,P2,Ps...> {
-        private:
-            using applied_type = function<R(P2,Ps...)>;
+		template<typename Self, typename R, typename P1, typename P2, typename...Ps>
+		struct curried<Self,R,P1,P2,Ps...> {
+		private:
+			using applied_type = function<R(P2,Ps...)>;
 
-            // Apply one argument.
-            applied_type apply_one(P1 p1) const {
-				auto self = *reinterpret_cast<const function<R(P1,P2,Ps...)>*>(this);
+			// Apply one argument.
+			applied_type apply_one(P1 p1) const {
+				auto self = *reinterpret_cast<const Self*>(this);
 				return [self,p1] (P2 p2, Ps...ps) {
 					return self.operator()(
 							p1, std::forward<P2>(p2), std::forward<Ps>(ps)...
@@ -425,7 +712,7 @@ namespace ftl {
 
 			// Apply each argument, return a new function.
 			// If the number of arguments equals the function's arity,
-			// ftl::function::operator() will be called instead.
+			// Self::operator() will be called instead.
 			template<typename...Ps2>
 			auto operator()(P1 p1, P2 p2, Ps2&&...ps2) const
 			-> typename std::result_of<applied_type(P2,Ps2...)>::type
@@ -23,120 +23,66 @@
 #ifndef FTL_MAYBE_ITERATOR_H
 #define FTL_MAYBE_ITERATOR_H
 
-#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "../type_functions.h"
 
 namespace ftl {
-	template<typename...Ts>
-	class sum_type;
-
-	struct Nothing;
-
-	template<typename T, typename...Ts>
-	constexpr T& get(sum_type<Ts...>&);
-
-	template<typename T, typename...Ts>
-	constexpr const T& get(const sum_type<Ts...>&);
-
 	namespace _dtl {
 
+		/* Points straight at the value of a maybe, or is null for nothing
+		 * and for the end. Range-for over a maybe thus reduces to a single
+		 * null check, with no access to the maybe itself.
+		 */
 		template<typename T>
-		class maybe_iterator
-		: public std::iterator<std::forward_iterator_tag,T> {
+		class maybe_iterator {
 		public:
-			maybe_iterator() = default;
-			maybe_iterator(const maybe_iterator&) = default;
-			maybe_iterator(maybe_iterator&&) = default;
-			~maybe_iterator() = default;
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename std::remove_const<T>::type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
 
-			explicit constexpr maybe_iterator(sum_type<T,Nothing>* m) noexcept
-			: ref{m && m->template is<T>() ? m : nullptr} {}
+			constexpr maybe_iterator() noexcept = default;
 
-			maybe_iterator& operator++ () noexcept {
-				this->ref = nullptr;
+			explicit constexpr maybe_iterator(T* p) noexcept : ptr{p} {}
+
+			FTL_CONSTEXPR14 maybe_iterator& operator++ () noexcept {
+				ptr = nullptr;
 				return *this;
 			}
 
-			maybe_iterator operator++ (int) noexcept {
+			FTL_CONSTEXPR14 maybe_iterator operator++ (int) noexcept {
 				auto it = *this;
-				this->ref = nullptr;
+				ptr = nullptr;
 				return it;
 			}
 
-			constexpr T& operator* () const {
-				return get<T>(*this->ref);
+			constexpr T& operator* () const noexcept {
+				return *ptr;
 			}
 
-			constexpr T* operator-> () const {
-				return std::addressof(get<T>(*this->ref));
+			constexpr T* operator-> () const noexcept {
+				return ptr;
 			}
 
-			maybe_iterator& operator= (const maybe_iterator&) = default;
-			maybe_iterator& operator= (maybe_iterator&&) = default;
-
-			constexpr bool operator== (const maybe_iterator& m) const noexcept {
-				return ref == m.ref;
+			constexpr bool operator== (const maybe_iterator& it) const noexcept {
+				return ptr == it.ptr;
 			}
 
-			constexpr bool operator!= (const maybe_iterator& m) const noexcept {
-				return ref != m.ref;
+			constexpr bool operator!= (const maybe_iterator& it) const noexcept {
+				return ptr != it.ptr;
 			}
 
 		private:
-			sum_type<T,Nothing>* ref = nullptr;
+			T* ptr = nullptr;
 		};
 
 		template<typename T>
-		class const_maybe_iterator
-		: public std::iterator<std::forward_iterator_tag,T> {
-		public:
-			const_maybe_iterator() = default;
-			const_maybe_iterator(const const_maybe_iterator&) = default;
-			const_maybe_iterator(const_maybe_iterator&&) = default;
-			~const_maybe_iterator() = default;
-
-			explicit constexpr
-			const_maybe_iterator(const sum_type<T,Nothing>* m) noexcept
-			: ref{m && m->template is<T>() ? m : nullptr} {}
-
-			const_maybe_iterator& operator++ () noexcept {
-				this->ref = nullptr;
-				return *this;
-			}
-
-			const_maybe_iterator operator++ (int) noexcept {
-				auto it = *this;
-				this->ref = nullptr;
-				return it;
-			}
-
-			constexpr const T& operator* () const {
-				return get<T>(*this->ref);
-			}
-
-			constexpr const T* operator-> () const {
-				return std::addressof(get<T>(*this->ref));
-			}
-
-			const_maybe_iterator& operator= (const const_maybe_iterator&)
-			   	= default;
-			const_maybe_iterator& operator= (const_maybe_iterator&&) = default;
-		
-			constexpr bool operator== (const const_maybe_iterator& m)
-			const noexcept {
-				return ref == m.ref;
-			}
-
-			constexpr bool operator!= (const const_maybe_iterator& m)
-			const noexcept {
-				return ref != m.ref;
-			}
-
-		private:
-			const sum_type<T,Nothing>* ref = nullptr;
-		};
+		using const_maybe_iterator = maybe_iterator<const T>;
 	}
 }
 
 #endif
 
-
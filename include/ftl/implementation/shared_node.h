@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SHARED_NODE_H
+#define FTL_SHARED_NODE_H
+
+#include <memory>
+#include <atomic>
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Copy-on-write access to a node of a persistent data structure.
+		 *
+		 * Makes sure n is not shared with anyone else, copying the node (but
+		 * not what it points to) if it is. A count of one means no other
+		 * container can reach the node; the fence orders our writes after
+		 * whatever the last owner to let go of it did to it.
+		 */
+		template<typename N>
+		N& own_node(std::shared_ptr<N>& n) {
+			if(n.use_count() != 1)
+				n = std::make_shared<N>(*n);
+			else
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+			return *n;
+		}
+	}
+}
+
+#endif
+
@@ -29,6 +29,11 @@
 namespace ftl {
 	// A number of helpers for tuple_apply
 	namespace _dtl {
+		template<size_t N>
+		struct tup_indices {
+			using type = typename make_seq<N>::type;
+		};
+
 		template<typename F, typename...Ts, size_t...S>
 		constexpr auto tup_apply_helper(seq<S...>, F&& f, const std::tuple<Ts...>& t)
 		-> typename std::result_of<F(Ts...)>::type {
@@ -45,13 +50,17 @@ namespace ftl {
 		constexpr auto tup_apply(F&& f, Tuple&& tuple)
 		-> decltype(
 				tup_apply_helper(
-					gen_seq<0,std::tuple_size<plain_type<Tuple>>::value-1>{},
+					typename tup_indices<
+						std::tuple_size<plain_type<Tuple>>::value
+					>::type{},
 					std::forward<F>(f),
 					std::forward<Tuple>(tuple)
 				)
 		) {
 			return tup_apply_helper(
-				gen_seq<0,std::tuple_size<plain_type<Tuple>>::value-1>{},
+				typename tup_indices<
+						std::tuple_size<plain_type<Tuple>>::value
+					>::type{},
 				std::forward<F>(f),
 				std::forward<Tuple>(tuple)
 			);
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_INTERN_H
+#define FTL_INTERN_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "concepts/orderable.h"
+#include "ord.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup intern Intern
+	 *
+	 * Hash-consing: one shared copy of each distinct immutable value.
+	 *
+	 * \code
+	 *   #include <ftl/intern.h>
+	 * \endcode
+	 *
+	 * An `intern_table` hands out `interned` handles. Any two handles it
+	 * gives for equal values point to the same copy, so they compare equal
+	 * by address alone, without looking at the values. Each copy also keeps
+	 * the hash it was looked up by, for unordered containers to reuse.
+	 *
+	 * \par Dependencies
+	 * - `<functional>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<unordered_map>`
+	 * - `<vector>`
+	 * - \ref orderable
+	 * - \ref ord
+	 */
+
+	template<typename T, typename H, typename E>
+	class intern_table;
+
+	namespace _dtl {
+		template<typename T>
+		struct interned_node {
+			template<typename U>
+			interned_node(size_t hash, U&& u)
+			: hash(hash), value(std::forward<U>(u)) {}
+
+			size_t hash;
+			T value;
+
+			// Set once the node is in its table, under the shard's lock
+			mutable bool listed = false;
+		};
+
+		template<typename T>
+		class intern_shards {
+			using node = interned_node<T>;
+
+			struct entry {
+				const node* p;
+				std::weak_ptr<const node> w;
+			};
+
+		public:
+			struct shard {
+				mutable std::mutex m;
+				std::unordered_multimap<size_t,entry> entries;
+			};
+
+			explicit intern_shards(size_t n) {
+				shards.reserve(n);
+				for(size_t i = 0; i < n; ++i) {
+					shards.emplace_back(new shard);
+				}
+			}
+
+			shard& of(size_t hash) {
+				return *shards[hash % shards.size()];
+			}
+
+			// A live node in s holding a value equal to x. s must be locked.
+			template<typename E>
+			static std::shared_ptr<const node> find(
+					const shard& s, size_t hash, const T& x, E& eq) {
+
+				/*
+				 * Nodes are not freed before they are erased, which takes
+				 * the lock, so they can be looked at through p. Only a match
+				 * is locked, as a handle released here could be the last one,
+				 * whose deleter would wait for the lock.
+				 */
+				auto r = s.entries.equal_range(hash);
+				for(auto it = r.first; it != r.second; ++it) {
+					if(eq(it->second.p->value, x)) {
+						if(auto p = it->second.w.lock())
+							return p;
+					}
+				}
+
+				return nullptr;
+			}
+
+			static void insert(shard& s, const std::shared_ptr<const node>& p) {
+				s.entries.emplace(p->hash, entry{p.get(), p});
+				p->listed = true;
+			}
+
+			void erase(const node* p) {
+				auto& s = of(p->hash);
+				std::lock_guard<std::mutex> lock(s.m);
+
+				auto r = s.entries.equal_range(p->hash);
+				for(auto it = r.first; it != r.second; ++it) {
+					if(it->second.p == p) {
+						s.entries.erase(it);
+						return;
+					}
+				}
+			}
+
+			size_t size() const {
+				size_t n = 0;
+				for(auto& s : shards) {
+					std::lock_guard<std::mutex> lock(s->m);
+					n += s->entries.size();
+				}
+
+				return n;
+			}
+
+		private:
+			std::vector<std::unique_ptr<shard>> shards;
+		};
+
+		// Takes a node out of its table when the last handle to it goes
+		template<typename T>
+		struct intern_deleter {
+			std::weak_ptr<intern_shards<T>> table;
+
+			void operator() (const interned_node<T>* p) const {
+				if(p->listed) {
+					if(auto t = table.lock())
+						t->erase(p);
+				}
+
+				delete p;
+			}
+		};
+	}
+
+	/**
+	 * Handle to the one shared copy of a value in an `intern_table`.
+	 *
+	 * Cheap to copy, and keeps its value alive, even past the end of the
+	 * table it came from. Handles from one table are equal exactly when
+	 * they point to the same copy. Values of handles from different tables
+	 * are compared only when the addresses and hashes alone do not tell.
+	 *
+	 * Is \ref eq and \ref orderablepg whenever `T` is. Equal handles are
+	 * recognised by address before any values are compared.
+	 *
+	 * \ingroup intern
+	 */
+	template<typename T>
+	class interned {
+	public:
+		/// The value handled.
+		const T& operator* () const noexcept {
+			return p->value;
+		}
+
+		const T* operator-> () const noexcept {
+			return &p->value;
+		}
+
+		const T& get() const noexcept {
+			return p->value;
+		}
+
+		/// The hash the value was interned by.
+		size_t hash() const noexcept {
+			return p->hash;
+		}
+
+		/// Whether `a` and `b` point to the very same copy.
+		friend bool same(const interned& a, const interned& b) noexcept {
+			return a.p == b.p;
+		}
+
+	private:
+		template<typename, typename, typename>
+		friend class intern_table;
+
+		explicit interned(std::shared_ptr<const _dtl::interned_node<T>> p)
+		: p(std::move(p)) {}
+
+		std::shared_ptr<const _dtl::interned_node<T>> p;
+	};
+
+	/**
+	 * Equality, by address first, then by hash, then by value.
+	 *
+	 * \ingroup intern
+	 */
+	template<typename T, typename = Requires<Eq<T>{}>>
+	bool operator== (const interned<T>& a, const interned<T>& b) {
+		return same(a, b) || (a.hash() == b.hash() && *a == *b);
+	}
+
+	/// \ingroup intern
+	template<typename T, typename = Requires<Eq<T>{}>>
+	bool operator!= (const interned<T>& a, const interned<T>& b) {
+		return !(a == b);
+	}
+
+	/**
+	 * Orders handles by their values.
+	 *
+	 * Handles to the same copy are never compared by value.
+	 *
+	 * \ingroup intern
+	 */
+	template<typename T, typename = Requires<Orderable<T>{}>>
+	bool operator< (const interned<T>& a, const interned<T>& b) {
+		return !same(a, b) && *a < *b;
+	}
+
+	/// \ingroup intern
+	template<typename T, typename = Requires<Orderable<T>{}>>
+	bool operator> (const interned<T>& a, const interned<T>& b) {
+		return !same(a, b) && *a > *b;
+	}
+
+	/// \ingroup intern
+	template<typename T, typename = Requires<Orderable<T>{}>>
+	bool operator<= (const interned<T>& a, const interned<T>& b) {
+		return !(a > b);
+	}
+
+	/// \ingroup intern
+	template<typename T, typename = Requires<Orderable<T>{}>>
+	bool operator>= (const interned<T>& a, const interned<T>& b) {
+		return !(a < b);
+	}
+
+	/**
+	 * Three way comparison of interned values.
+	 *
+	 * Gives `ord::Eq` for handles to the same copy without comparing values.
+	 *
+	 * \ingroup intern
+	 */
+	template<typename T, typename = Requires<Orderable<T>{}>>
+	ord compare(const interned<T>& a, const interned<T>& b) {
+		return same(a, b) ? ord::Eq : compare(*a, *b);
+	}
+
+	/**
+	 * A concurrent table of interned values.
+	 *
+	 * Interning a value equal to one that is already in the table gives a
+	 * handle to the copy in the table, otherwise the value is copied or
+	 * moved in. Entries are removed as soon as the last handle to them is
+	 * gone, so the table only ever holds values that are in use.
+	 *
+	 * The table is split into `shards` parts by hash, each with its own
+	 * lock. Values are hashed and copied outside of any lock, which is only
+	 * held while looking them up. Copies of a table share its entries.
+	 *
+	 * \tparam H Hash function for `T`, like `std::hash`
+	 * \tparam E Equality for `T`, like `std::equal_to`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::intern_table<std::string> names;
+	 *
+	 *   auto a = names.intern(std::string(1000, 'x'));
+	 *   auto b = names.intern(std::string(1000, 'x'));
+	 *
+	 *   // a and b share one string, and compare equal by address
+	 * \endcode
+	 *
+	 * \ingroup intern
+	 */
+	template<
+			typename T,
+			typename H = std::hash<T>,
+			typename E = std::equal_to<T>
+	>
+	class intern_table {
+		using node = _dtl::interned_node<T>;
+		using shards = _dtl::intern_shards<T>;
+
+	public:
+		/// `n` must be at least 1.
+		explicit intern_table(size_t n = 16, H h = H(), E eq = E())
+		: table(std::make_shared<shards>(n)), h(std::move(h)), eq(std::move(eq))
+		{}
+
+		/// The canonical handle for `x`.
+		interned<T> intern(const T& x) {
+			return intern_as(h(x), x);
+		}
+
+		/// \overload
+		interned<T> intern(T&& x) {
+			size_t hash = h(x);
+			return intern_as(hash, std::move(x));
+		}
+
+		/// Number of distinct values in use.
+		size_t size() const {
+			return table->size();
+		}
+
+	private:
+		template<typename U>
+		interned<T> intern_as(size_t hash, U&& x) {
+			auto& s = table->of(hash);
+
+			{
+				std::lock_guard<std::mutex> lock(s.m);
+				if(auto p = shards::find(s, hash, x, eq))
+					return interned<T>(std::move(p));
+			}
+
+			// Outlives the lock below, in case it is not needed after all
+			std::shared_ptr<const node> n(
+				new node(hash, std::forward<U>(x)),
+				_dtl::intern_deleter<T>{table}
+			);
+
+			std::lock_guard<std::mutex> lock(s.m);
+			if(auto p = shards::find(s, hash, n->value, eq))
+				return interned<T>(std::move(p));
+
+			shards::insert(s, n);
+
+			return interned<T>(n);
+		}
+
+		std::shared_ptr<shards> table;
+		H h;
+		E eq;
+	};
+
+}
+
+namespace std {
+	/// Reuses the hash each interned value was stored by.
+	template<typename T>
+	struct hash<ftl::interned<T>> {
+		size_t operator() (const ftl::interned<T>& x) const noexcept {
+			return x.hash();
+		}
+	};
+}
+
+#endif
+
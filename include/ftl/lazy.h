@@ -24,9 +24,19 @@
 #define FTL_LAZY_H
 
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 #include "prelude.h"
 #include "concepts/monoid.h"
 #include "either.h"
+#include "alloc_stats.h"
+
+#ifdef FTL_LAZY_SINGLE_THREADED
+#include "rc.h"
+#endif
 
 namespace ftl {
 	/**
@@ -39,9 +49,15 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<atomic>`
+	 * - `<vector>`
 	 * - \ref prelude
 	 * - \ref monoid
 	 * - \ref either
+	 * - \ref alloc_stats
+	 * - \ref rc, if `FTL_LAZY_SINGLE_THREADED` is defined
 	 */
 
 	/**
@@ -58,6 +74,432 @@ namespace ftl {
 		ready
 	};
 
+#ifdef FTL_LAZY_STATS
+	/**
+	 * Snapshot of the lazy computations currently alive.
+	 *
+	 * Only available if `FTL_LAZY_STATS` is defined (which must then be the
+	 * case in every translation unit of the program). Meant for tracking
+	 * down space leaks in long lived caches of lazy values.
+	 *
+	 * \see lazy_stats
+	 *
+	 * \ingroup lazy
+	 */
+	struct lazy_statistics {
+		/// Number of computations not yet forced
+		size_t deferred;
+
+		/// Number of computations that are forced, and hold a value
+		size_t ready;
+
+		/**
+		 * Total size of the thunks held by deferred computations.
+		 *
+		 * This is the size of the function objects themselves (including
+		 * their captures), but not of anything they in turn allocate.
+		 */
+		size_t thunk_bytes;
+	};
+#endif
+
+	namespace _dtl {
+#ifdef FTL_LAZY_STATS
+		struct lazy_counters {
+			std::atomic<size_t> deferred{0};
+			std::atomic<size_t> ready{0};
+			std::atomic<size_t> thunk_bytes{0};
+		};
+
+		inline lazy_counters& lazy_stats_counters() noexcept {
+			static lazy_counters counters;
+			return counters;
+		}
+
+		inline void lazy_stats_note_deferred(size_t bytes) noexcept {
+			auto& c = lazy_stats_counters();
+			c.deferred.fetch_add(1, std::memory_order_relaxed);
+			c.thunk_bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		inline void lazy_stats_note_forced(size_t bytes) noexcept {
+			auto& c = lazy_stats_counters();
+			c.ready.fetch_add(1, std::memory_order_relaxed);
+			c.deferred.fetch_sub(1, std::memory_order_relaxed);
+			c.thunk_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		inline void lazy_stats_note_deferred_destroyed(size_t bytes) noexcept {
+			auto& c = lazy_stats_counters();
+			c.deferred.fetch_sub(1, std::memory_order_relaxed);
+			c.thunk_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		inline void lazy_stats_note_ready_destroyed() noexcept {
+			lazy_stats_counters().ready.fetch_sub(1, std::memory_order_relaxed);
+		}
+#else
+		inline void lazy_stats_note_deferred(size_t) noexcept {}
+		inline void lazy_stats_note_forced(size_t) noexcept {}
+		inline void lazy_stats_note_deferred_destroyed(size_t) noexcept {}
+		inline void lazy_stats_note_ready_destroyed() noexcept {}
+#endif
+	}
+
+#ifdef FTL_LAZY_STATS
+	/**
+	 * Get the current counts of deferred and ready lazy computations.
+	 *
+	 * Counts are updated without synchronisation, so while other threads
+	 * create or force lazy values, the fields may not be consistent with one
+	 * another.
+	 *
+	 * \ingroup lazy
+	 */
+	inline lazy_statistics lazy_stats() noexcept {
+		auto& c = _dtl::lazy_stats_counters();
+		return lazy_statistics{
+			c.deferred.load(std::memory_order_relaxed),
+			c.ready.load(std::memory_order_relaxed),
+			c.thunk_bytes.load(std::memory_order_relaxed)
+		};
+	}
+#endif
+
+	namespace _dtl {
+		/* The pointer that shares the state of a lazy computation, and how
+		 * to make one, or access one that other threads may access.
+		 */
+#ifdef FTL_LAZY_SINGLE_THREADED
+		template<typename T>
+		using lazy_ptr = rc<T>;
+
+		template<typename T, typename...Args>
+		lazy_ptr<T> make_lazy_ptr(Args&&...args) {
+			auto p = make_rc<T>(std::forward<Args>(args)...);
+			note_alloc(alloc_site::lazy);
+			return p;
+		}
+
+		template<typename T, typename A, typename...Args>
+		lazy_ptr<T> allocate_lazy_ptr(const A& alloc, Args&&...args) {
+			auto p = allocate_rc<T>(alloc, std::forward<Args>(args)...);
+			note_alloc(alloc_site::lazy);
+			return p;
+		}
+
+		template<typename T>
+		lazy_ptr<T> load_lazy_ptr(const lazy_ptr<T>* p) noexcept {
+			return *p;
+		}
+
+		template<typename T>
+		void store_lazy_ptr(lazy_ptr<T>* p, lazy_ptr<T> q) noexcept {
+			*p = std::move(q);
+		}
+#else
+		template<typename T>
+		using lazy_ptr = std::shared_ptr<T>;
+
+		template<typename T, typename...Args>
+		lazy_ptr<T> make_lazy_ptr(Args&&...args) {
+			auto p = std::make_shared<T>(std::forward<Args>(args)...);
+			note_alloc(alloc_site::lazy);
+			return p;
+		}
+
+		template<typename T, typename A, typename...Args>
+		lazy_ptr<T> allocate_lazy_ptr(const A& alloc, Args&&...args) {
+			auto p = std::allocate_shared<T>(alloc, std::forward<Args>(args)...);
+			note_alloc(alloc_site::lazy);
+			return p;
+		}
+
+		template<typename T>
+		lazy_ptr<T> load_lazy_ptr(const lazy_ptr<T>* p) noexcept {
+			return std::atomic_load(p);
+		}
+
+		template<typename T>
+		void store_lazy_ptr(lazy_ptr<T>* p, lazy_ptr<T> q) noexcept {
+			std::atomic_store(p, std::move(q));
+		}
+#endif
+
+		/* The part of a lazy computation's state that does not depend on the
+		 * type of its value.
+		 *
+		 * Forcing moves the node from deferred to running and on to ready,
+		 * so that concurrent forcings run the computation once, and all but
+		 * one wait for it to finish. Once ready, forcing costs a single
+		 * acquire load. Only waiting takes a lock, one of a few that all
+		 * nodes share. If the computation throws, the node goes back to
+		 * deferred, and is run again by the next forcing, or a waiting one.
+		 *
+		 * A node may name another node, dep, that its computation forces
+		 * first (as with the results of map and bind). Before running its own
+		 * computation, a node walks the chain of such dependencies that are
+		 * still deferred and forces them from the far end, in a loop. Each
+		 * computation then finds its dependency ready, so a chain of any
+		 * length is forced in constant stack.
+		 *
+		 * dep is reset when the node is ready, and may be read concurrently by
+		 * some other node's walk, so it is only written atomically. A node
+		 * that solely owns its dependency unlinks the chain on destruction, for
+		 * the same reason.
+		 */
+#ifndef FTL_LAZY_SINGLE_THREADED
+		// Where forcings wait for a node that is running
+		struct lazy_parking {
+			std::mutex m;
+			std::condition_variable cv;
+		};
+
+		inline lazy_parking& lazy_parking_for(const void* p) noexcept {
+			static lazy_parking lots[16];
+			return lots[(reinterpret_cast<std::uintptr_t>(p) >> 6) % 16];
+		}
+#endif
+
+		class lazy_node {
+		public:
+			lazy_node(const lazy_node&) = delete;
+			lazy_node& operator= (const lazy_node&) = delete;
+
+			bool is_ready() const noexcept {
+#ifdef FTL_LAZY_SINGLE_THREADED
+				return ready;
+#else
+				return state.load(std::memory_order_acquire) == node_ready;
+#endif
+			}
+
+		protected:
+			using run_type = void (*)(lazy_node&);
+
+			lazy_node(run_type r, lazy_ptr<lazy_node> d) noexcept
+			: run(r), dep(std::move(d))
+			{}
+
+			~lazy_node() {
+				auto d = std::move(dep);
+				while(d && d.use_count() == 1) {
+					auto next = std::move(d->dep);
+					d = std::move(next);
+				}
+			}
+
+			// Only valid while running, before dep is reset
+			lazy_node& dependency() const noexcept {
+				return *dep;
+			}
+
+			void force() {
+				if(!is_ready()) {
+					force_dependencies();
+					force_once();
+				}
+			}
+
+		private:
+			void force_once() {
+#ifdef FTL_LAZY_SINGLE_THREADED
+				if(!ready) {
+					run(*this);
+					dep.reset();
+					ready = true;
+				}
+#else
+				for(;;) {
+					unsigned char s = node_deferred;
+					if(state.compare_exchange_strong(
+							s, node_running, std::memory_order_acquire)) {
+						try {
+							run(*this);
+						}
+						catch(...) {
+							leave_running(node_deferred);
+							throw;
+						}
+
+						store_lazy_ptr(&dep, lazy_ptr<lazy_node>());
+						leave_running(node_ready);
+						return;
+					}
+
+					if(s == node_ready)
+						return;
+
+					auto& p = lazy_parking_for(this);
+					std::unique_lock<std::mutex> lock(p.m);
+					p.cv.wait(lock, [this]() {
+						return state.load(std::memory_order_acquire)
+							!= node_running;
+					});
+				}
+#endif
+			}
+
+#ifndef FTL_LAZY_SINGLE_THREADED
+			void leave_running(unsigned char s) noexcept {
+				auto& p = lazy_parking_for(this);
+				state.store(s, std::memory_order_release);
+
+				// Waiters check state under the lock, so none can miss this
+				{ std::lock_guard<std::mutex> lock(p.m); }
+				p.cv.notify_all();
+			}
+#endif
+
+			void force_dependencies() {
+				auto n = load_lazy_ptr(&dep);
+				if(!n)
+					return;
+
+				std::vector<lazy_ptr<lazy_node>> chain;
+				while(n && !n->is_ready()) {
+					auto next = load_lazy_ptr(&n->dep);
+					chain.push_back(std::move(n));
+					n = std::move(next);
+				}
+
+				for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+					(*it)->force_once();
+			}
+
+			run_type run;
+			lazy_ptr<lazy_node> dep;
+#ifdef FTL_LAZY_SINGLE_THREADED
+			bool ready = false;
+#else
+			enum : unsigned char { node_deferred, node_running, node_ready };
+
+			std::atomic<unsigned char> state{node_deferred};
+#endif
+		};
+
+		/* The state shared by all copies of a lazy computation.
+		 *
+		 * The thunk itself lives in a derived lazy_thunk, which knows its
+		 * concrete type. lazy_state only keeps a pointer to a function that
+		 * computes the value into storage and destroys the thunk.
+		 */
+		template<typename T>
+		class lazy_state : public lazy_node {
+		public:
+			~lazy_state() {
+				if(is_ready())
+					value().~T();
+			}
+
+			const T& force() {
+				lazy_node::force();
+				return value();
+			}
+
+		protected:
+			lazy_state(run_type r, lazy_ptr<lazy_node> d) noexcept
+			: lazy_node(r, std::move(d))
+			{}
+
+			void* raw_storage() noexcept {
+				return &storage;
+			}
+
+		private:
+			const T& value() const noexcept {
+				return *reinterpret_cast<const T*>(&storage);
+			}
+
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		};
+
+		/* A lazy_state together with a thunk of concrete type F.
+		 *
+		 * The thunk is kept in a union, so that it can be destroyed as soon as
+		 * the value is computed (see release), rather than when the last copy
+		 * of the lazy goes away.
+		 */
+		template<typename T, typename F>
+		class lazy_closure : public lazy_state<T> {
+		protected:
+			lazy_closure(
+					lazy_node::run_type r,
+					F f,
+					lazy_ptr<lazy_node> d = nullptr
+			)
+			: lazy_state<T>(r, std::move(d)), fn(std::move(f)) {
+				lazy_stats_note_deferred(sizeof(F));
+			}
+
+			~lazy_closure() {
+				if(this->is_ready()) {
+					lazy_stats_note_ready_destroyed();
+				}
+				else {
+					fn.~F();
+					lazy_stats_note_deferred_destroyed(sizeof(F));
+				}
+			}
+
+			F& thunk() noexcept {
+				return fn;
+			}
+
+			// Called by run, once the value is constructed
+			void release() noexcept {
+				fn.~F();
+				lazy_stats_note_forced(sizeof(F));
+			}
+
+		private:
+			union {
+				F fn;
+			};
+		};
+
+		template<typename T, typename F>
+		class lazy_thunk : public lazy_closure<T,F> {
+		public:
+			explicit lazy_thunk(F f)
+			: lazy_closure<T,F>(&lazy_thunk::run, std::move(f))
+			{}
+
+		private:
+			static void run(lazy_node& s) {
+				auto& self = static_cast<lazy_thunk&>(s);
+
+				new (self.raw_storage()) T(self.thunk()());
+				self.release();
+			}
+		};
+
+		/* As lazy_thunk, but with a dependency, the value of which is passed
+		 * to the thunk.
+		 *
+		 * The dependency is owned by the node only, so that it can be released
+		 * along with the thunk.
+		 */
+		template<typename T, typename V, typename F>
+		class lazy_after : public lazy_closure<T,F> {
+		public:
+			lazy_after(F f, lazy_ptr<lazy_state<V>> d)
+			: lazy_closure<T,F>(&lazy_after::run, std::move(f), std::move(d))
+			{}
+
+		private:
+			static void run(lazy_node& s) {
+				auto& self = static_cast<lazy_after&>(s);
+				auto& d = static_cast<lazy_state<V>&>(self.dependency());
+
+				new (self.raw_storage()) T(self.thunk()(d.force()));
+				self.release();
+			}
+		};
+
+		struct lazy_access;
+	}
+
 	/**
 	 * The lazy data type.
 	 *
@@ -74,6 +516,26 @@ namespace ftl {
 	 * If no instance of a particular computation ever forces it, then it simply
 	 * won't be evaluated at all.
 	 *
+	 * As soon as a computation is forced, the function object that performed
+	 * it is destroyed, along with any captures (such as the arguments given to
+	 * `defer`), regardless of how many copies of the `lazy` remain. Define
+	 * `FTL_LAZY_STATS` to have the library keep count of live deferred and
+	 * ready computations, see `lazy_stats`.
+	 *
+	 * Forcing is thread safe: copies of a `lazy` may be forced concurrently,
+	 * in which case the computation is still run only once, and the other
+	 * threads block until it is done. Forcing an already computed value does
+	 * not lock anything. If the computation throws, the `lazy` remains
+	 * deferred, and the next forcing tries again.
+	 *
+	 * Programs that never share lazy values between threads may define
+	 * `FTL_LAZY_SINGLE_THREADED` (in every translation unit, as with
+	 * `FTL_LAZY_STATS`). The state of a computation is then held by an
+	 * `ftl::rc` rather than a `std::shared_ptr`, so its reference count is
+	 * not atomic, and forcing checks a plain flag rather than moving an
+	 * atomic state from deferred to running to ready. Neither copying nor
+	 * forcing a `lazy` then does any atomic operations.
+	 *
 	 * As a convenience, there is a specialisation of `lazy` for `bool` that
 	 * allows contextual conversions of `lazy<bool>` to `bool`, allowing
 	 * expressions such as `if(lazyBool) doSomething();`. This will force
@@ -114,8 +576,30 @@ namespace ftl {
 		 * that would normally force evaluation will simply use the now computed
 		 * value.
 		 */
-		explicit lazy(const function<T()>& f)
-		: val(new either<function<T()>,T>(make_left<T>(f)))
+		template<
+				typename F,
+				typename = Requires<_dtl::is_callable_as<F, T()>::value>
+		>
+		explicit lazy(F f)
+		: val(_dtl::make_lazy_ptr<_dtl::lazy_thunk<T,F>>(std::move(f)))
+		{}
+
+		/**
+		 * Construct from a function object, allocating with `alloc`.
+		 *
+		 * The shared state, including the function object and the room for
+		 * the value, is allocated in one go using `std::allocate_shared`
+		 * (or `ftl::allocate_rc`, see `FTL_LAZY_SINGLE_THREADED`).
+		 */
+		template<
+				typename Allocator,
+				typename F,
+				typename = Requires<_dtl::is_callable_as<F, T()>::value>
+		>
+		lazy(std::allocator_arg_t, const Allocator& alloc, F f)
+		: val(_dtl::allocate_lazy_ptr<_dtl::lazy_thunk<T,F>>(
+			alloc, std::move(f)
+		))
 		{}
 
 		/**
@@ -124,8 +608,7 @@ namespace ftl {
 		 * This method forces evaluation.
 		 */
 		const T& operator*() const {
-			force();
-			return *get<1>(*val);
+			return val->force();
 		}
 
 		/**
@@ -134,11 +617,7 @@ namespace ftl {
 		 * This method forces evaluation.
 		 */
 		const T* operator->() const {
-			if(val->template is<Right<T>>())
-				return std::addressof(*get<1>(*val));
-
-			force();
-			return std::addressof(*get<1>(*val));
+			return std::addressof(val->force());
 		}
 
 		lazy& operator= (const lazy&) = default;
@@ -151,21 +630,20 @@ namespace ftl {
 		 *         and value_status::ready if it has.
 		 */
 		value_status status() const {
-			if(val->template is<Right<T>>())
+			if(val->is_ready())
 				return value_status::ready;
 
 			return value_status::deferred;
 		}
 
 	private:
-		void force() const {
-			if(val->template is<Right<T>>())
-				return;
+		friend struct ::ftl::_dtl::lazy_access;
 
-			*val = make_right<function<T()>>((*get<0>(*val))());
-		}
+		explicit lazy(_dtl::lazy_ptr<_dtl::lazy_state<T>> s) noexcept
+		: val(std::move(s))
+		{}
 
-		mutable std::shared_ptr<either<function<T()>,T>> val;
+		_dtl::lazy_ptr<_dtl::lazy_state<T>> val;
 	};
 
 	// Bool specialisation to allow contextual conversion
@@ -177,52 +655,143 @@ namespace ftl {
 		lazy(lazy&&) = default;
 		~lazy() = default;
 
-		explicit lazy(const function<bool()>& f)
-		: val(new either<function<bool()>,bool>(make_left<bool>(f)))
+		template<
+				typename F,
+				typename = Requires<_dtl::is_callable_as<F, bool()>::value>
+		>
+		explicit lazy(F f)
+		: val(_dtl::make_lazy_ptr<_dtl::lazy_thunk<bool,F>>(std::move(f)))
+		{}
+
+		template<
+				typename Allocator,
+				typename F,
+				typename = Requires<_dtl::is_callable_as<F, bool()>::value>
+		>
+		lazy(std::allocator_arg_t, const Allocator& alloc, F f)
+		: val(_dtl::allocate_lazy_ptr<_dtl::lazy_thunk<bool,F>>(
+			alloc, std::move(f)
+		))
 		{}
 
 		const bool& operator*() const {
-			force();
-			return *get<Right<bool>>(*val);
+			return val->force();
 		}
 
 		lazy& operator= (const lazy&) = default;
 		lazy& operator= (lazy&&) = default;
 
 		explicit operator bool() {
-			force();
-			return *get<Right<bool>>(*val);
+			return val->force();
 		}
 
 		value_status status() const {
-			if(val->is<Right<bool>>())
+			if(val->is_ready())
 				return value_status::ready;
 
 			return value_status::deferred;
 		}
 
 	private:
-		void force() const {
-			if(val->is<Right<bool>>())
-				return;
+		friend struct ::ftl::_dtl::lazy_access;
 
-			*val = make_right<function<bool()>>((*get<0>(*val))());
-		}
+		explicit lazy(_dtl::lazy_ptr<_dtl::lazy_state<bool>> s) noexcept
+		: val(std::move(s))
+		{}
 
-		mutable std::shared_ptr<either<function<bool()>,bool>> val;
+		_dtl::lazy_ptr<_dtl::lazy_state<bool>> val;
 	};
 
+	namespace _dtl {
+		struct lazy_access {
+			/* Create a lazy<U> computed by applying f to the value of dep.
+			 *
+			 * Naming dep, rather than capturing it in f, allows chains of
+			 * dependencies to be forced iteratively, see lazy_node.
+			 */
+			template<typename U, typename V, typename F>
+			static lazy<U> after(const lazy<V>& dep, F f) {
+				return lazy<U>{make_lazy_ptr<lazy_after<U,V,F>>(
+					std::move(f), dep.val
+				)};
+			}
+		};
+	}
+
+	/**
+	 * Create a lazy computation from a no-argument function object.
+	 *
+	 * Equivalent to invoking `lazy`'s constructor, except that the type
+	 * of the value is deduced.
+	 *
+	 * In either case, the function object is stored by its concrete type,
+	 * next to the value and the reference count, in a single allocation.
+	 * Only forcing a not yet computed value goes through an indirect call.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto l = make_lazy([](){ return expensive(); });
+	 * \endcode
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename F, typename T = result_of<F()>>
+	lazy<T> make_lazy(F f) {
+		return lazy<T>{std::move(f)};
+	}
+
+	/**
+	 * Create a lazy computation, allocating its state with `alloc`.
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename Allocator, typename F, typename T = result_of<F()>>
+	lazy<T> make_lazy(std::allocator_arg_t, const Allocator& alloc, F f) {
+		return lazy<T>{std::allocator_arg, alloc, std::move(f)};
+	}
+
+	namespace _dtl {
+		/* The thunk of a deferred function call.
+		 *
+		 * A thunk is invoked at most once, after which it is destroyed, so the
+		 * arguments are moved into the call.
+		 */
+		template<typename F, typename Tuple>
+		struct deferred_call {
+			F f;
+			Tuple args;
+
+			auto operator() ()
+			-> decltype(tup_apply(std::move(f), std::move(args))) {
+				return tup_apply(std::move(f), std::move(args));
+			}
+		};
+	}
+
 	/**
 	 * Create a lazy computation from an arbitrary function.
 	 *
-	 * Currently, all parameters are _copied_ when `defer` is called. If you
-	 * want to call by reference on some parameter, you should use `std::cref`
-	 * (the use of `std::ref` is not encouraged, because it allows mutation
-	 * of the parameter and all lazy computations are assumed to be pure, in
-	 * the sense that they should have no side effects, nor contain any state).
+	 * All arguments are moved or copied into the computation when `defer` is
+	 * called, and moved on to `f` when it is eventually forced. Hence, move
+	 * only arguments are fine, and a large argument passed as an rvalue is
+	 * never copied. `f` may also take no arguments at all.
+	 *
+	 * If you want to call by reference on some parameter, you should use
+	 * `std::cref` (the use of `std::ref` is not encouraged, because it allows
+	 * mutation of the parameter and all lazy computations are assumed to be
+	 * pure, in the sense that they should have no side effects, nor contain
+	 * any state).
+	 *
+	 * \par Examples
 	 *
-	 * \note `f` is assumed to be of unary or greater arity. If a deferred zero
-	 *       argument computation is desired, use lazy's constructor directly.
+	 * \code
+	 *   std::vector<int> v = ...;
+	 *   auto l = defer(
+	 *       [](std::vector<int> xs){ return sum(xs); },
+	 *       std::move(v)
+	 *   );
+	 * \endcode
 	 *
 	 * \ingroup lazy
 	 */
@@ -232,11 +801,11 @@ namespace ftl {
 			typename T = result_of<F(Args...)>
 	>
 	lazy<T> defer(F f, Args&&...args) {
-		// TODO: C++14: _move_ tuple of args into lambda
-		// TODO: Make this work with zero-argument fs
-		auto t = std::make_tuple(std::forward<Args>(args)...);
-		return lazy<T>{[f,t]() {
-				return tuple_apply(f, t);
+		using tuple_type
+			= decltype(std::make_tuple(std::forward<Args>(args)...));
+
+		return lazy<T>{_dtl::deferred_call<F,tuple_type>{
+			std::move(f), std::make_tuple(std::forward<Args>(args)...)
 		}};
 	}
 
@@ -314,6 +883,11 @@ namespace ftl {
 	 * Allows users to build "thunks" of computations, all left uncomputed until
 	 * forced.
 	 *
+	 * Results of `map` and `bind` remember the computation they depend on,
+	 * and forcing one forces that whole chain in a loop rather than by
+	 * recursion. A pipeline built by, say, 100000 iterations of
+	 * `l = l >>= f` can thus be forced (and destroyed) in constant stack.
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
@@ -343,7 +917,7 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static lazy<U> map(F f, lazy<T> l) {
-			return lazy<U>{function<U()>{[f,l]() { return f(*l); }}};
+			return _dtl::lazy_access::after<U>(l, std::move(f));
 		}
 
 		/**
@@ -362,9 +936,9 @@ namespace ftl {
 				typename U = Value_type<result_of<F(T)>>
 		>
 		static lazy<U> bind(lazy<T> l, F f) {
-			return lazy<U>{[f,l]() {
-				return *(f(*l));
-			}};
+			return _dtl::lazy_access::after<U>(l, [f](const T& t) {
+				return *(f(t));
+			});
 		}
 
 		static constexpr bool instance = true;
@@ -397,7 +971,9 @@ namespace ftl {
 		 * They are, of course, forced when the result of this computation is.
 		 */
 		static lazy<T> append(lazy<T> l1, lazy<T> l2) {
-			return lazy<T>([l1,l2](){ return monoid<T>::append(*l1, *l2); });
+			return _dtl::lazy_access::after<T>(l1, [l2](const T& t){
+				return monoid<T>::append(t, *l2);
+			});
 		}
 
 		static constexpr bool instance = monoid<T>::instance;
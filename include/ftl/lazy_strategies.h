@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_LAZY_STRATEGIES_H
+#define FTL_LAZY_STRATEGIES_H
+
+#include "executor.h"
+#include "lazy.h"
+#include "lazy_trans.h"
+
+namespace ftl {
+	/**
+	 * \defgroup lazy_strategies Lazy Evaluation Strategies
+	 *
+	 * Parallel and speculative evaluation of lazy computations.
+	 *
+	 * \code
+	 *   #include <ftl/lazy_strategies.h>
+	 * \endcode
+	 *
+	 * Lazy values are normally computed by whichever thread first forces
+	 * them. The strategies in this module instead hand computations to an
+	 * \ref executorpg (by default, a `thread_pool` private to the library),
+	 * similar in spirit to Haskell's `par`.
+	 * Forcing is thread safe, so a computation that has already been started
+	 * by the pool is waited for rather than run again, and one that the pool
+	 * has not yet reached is simply run by the forcing thread.
+	 *
+	 * \par Dependencies
+	 * - \ref executor
+	 * - \ref lazy
+	 * - \ref lazyT
+	 */
+
+	namespace _dtl {
+		/* The pool used by the strategies that are not given an executor.
+		 *
+		 * Like any thread_pool, it finishes the sparks it has been given
+		 * before it is destroyed, at exit.
+		 */
+		inline thread_pool& spark_pool() {
+			static thread_pool pool;
+			return pool;
+		}
+
+		template<typename T>
+		struct spark_task {
+			// Sparks are speculative: if forcing throws, it will throw again
+			// when someone forces l for real.
+			void operator() () noexcept {
+				try {
+					(void)*l;
+				}
+				catch(...) {
+				}
+			}
+
+			lazy<T> l;
+		};
+	}
+
+	/**
+	 * Start computing `l` in the background.
+	 *
+	 * Queues `l` to be forced by a pool of background threads, and returns
+	 * right away. Forcing `l`, or any copy of it, later on either finds the
+	 * value ready, waits for the pool to finish computing it, or computes it
+	 * on the spot if the pool has not got to it yet. In no case is the
+	 * computation run more than once.
+	 *
+	 * If `l` is already computed, nothing is queued.
+	 *
+	 * \return `l`, to allow e.g. `auto x = spark(defer(f, y));`
+	 *
+	 * \ingroup lazy_strategies
+	 */
+	template<typename T>
+	lazy<T> spark(const lazy<T>& l) {
+		return spark(_dtl::spark_pool(), l);
+	}
+
+	/**
+	 * Start computing `l` on the executor `ex`.
+	 *
+	 * As the other `spark`, but using `ex` instead of the library's own pool.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \ingroup lazy_strategies
+	 */
+	template<
+			typename Executor,
+			typename T,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	lazy<T> spark(Executor& ex, const lazy<T>& l) {
+		if(l.status() == value_status::deferred)
+			ex.execute(_dtl::spark_task<T>{l});
+
+		return l;
+	}
+
+	/**
+	 * Force every lazy computation in a container, in parallel.
+	 *
+	 * All elements of `c` are sparked, after which the calling thread forces
+	 * them in order, doing whatever work the pool has not yet started, so
+	 * the call returns once every element is ready. The computations must be
+	 * independent of one another for this to pay off.
+	 *
+	 * If forcing an element throws, the exception propagates, and elements
+	 * after it may or may not have been computed.
+	 *
+	 * \tparam Container must be iterable, with `lazy` elements.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<lazy<report>> rows = ...;
+	 *   parallel_force(rows);
+	 * \endcode
+	 *
+	 * \ingroup lazy_strategies
+	 */
+	template<typename Container>
+	void parallel_force(const Container& c) {
+		parallel_force(_dtl::spark_pool(), c);
+	}
+
+	/**
+	 * Force every lazy computation in a container, using `ex`.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \ingroup lazy_strategies
+	 */
+	template<
+			typename Executor,
+			typename Container,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	void parallel_force(Executor& ex, const Container& c) {
+		for(const auto& l : c)
+			spark(ex, l);
+
+		for(const auto& l : c)
+			(void)*l;
+	}
+
+	/**
+	 * Force every lazy computation in a lazy transformer, in parallel.
+	 *
+	 * Equivalent to `parallel_force(*l)`, and hence only applicable if the
+	 * underlying monad is an iterable container, such as a `std::vector`.
+	 *
+	 * \ingroup lazy_strategies
+	 */
+	template<typename M>
+	void parallel_force(const lazyT<M>& l) {
+		parallel_force(*l);
+	}
+
+	/// \overload
+	template<
+			typename Executor,
+			typename M,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	void parallel_force(Executor& ex, const lazyT<M>& l) {
+		parallel_force(ex, *l);
+	}
+}
+
+#endif
+
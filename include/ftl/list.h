@@ -24,6 +24,7 @@
 #define FTL_LIST_H
 
 #include <list>
+#include <utility>
 #include "concepts/foldable.h"
 #include "concepts/monad.h"
 #include "concepts/zippable.h"
@@ -49,6 +50,7 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <list>
+	 * - <utility>
 	 * - \ref foldable
 	 * - \ref monad
 	 * - \ref zippable
@@ -68,6 +70,41 @@ namespace ftl {
 		using rebind = std::list<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		/*
+		 * Append one of the results of a bind to r. Lists we own are spliced
+		 * in, anything else is copied or moved element by element.
+		 */
+		template<typename U, typename A>
+		void list_append(std::list<U,A>& r, std::list<U,A>&& l) {
+			if(r.get_allocator() == l.get_allocator())
+				r.splice(r.end(), l);
+			else
+				r.insert(
+					r.end(),
+					std::make_move_iterator(l.begin()),
+					std::make_move_iterator(l.end())
+				);
+		}
+
+		template<typename U, typename A, typename C>
+		void list_append(std::list<U,A>& r, const C& c) {
+			for(auto& e : c) {
+				r.push_back(e);
+			}
+		}
+
+		template<
+				typename U, typename A, typename C,
+				typename = Requires<!std::is_lvalue_reference<C>::value>
+		>
+		void list_append(std::list<U,A>& r, C&& c) {
+			for(auto& e : c) {
+				r.push_back(std::move(e));
+			}
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
@@ -117,6 +154,8 @@ namespace ftl {
 	 *
 	 * The identity element is (naturally) the empty list, and the append
 	 * operation is (again, naturally) to append the second list to the first.
+	 * When both lists are temporaries, this is a constant time splice, with
+	 * no elements copied or allocated.
 	 *
 	 * \ingroup list
 	 */
@@ -140,14 +179,14 @@ namespace ftl {
 				std::list<Ts...>&& l1,
 				const std::list<Ts...>& l2) {
 			l1.insert(l1.end(), l2.begin(), l2.end());
-			return l1;
+			return std::move(l1);
 		}
 
 		static std::list<Ts...> append(
 				const std::list<Ts...>& l1,
 				std::list<Ts...>&& l2) {
 			l2.insert(l2.begin(), l1.begin(), l1.end());
-			return l2;
+			return std::move(l2);
 		}
 
 		static std::list<Ts...> append(
@@ -161,7 +200,7 @@ namespace ftl {
 				std::move(l2.begin(), l2.end(), std::back_inserter(l1));
 			}
 
-			return l1;
+			return std::move(l1);
 		}
 
 		static constexpr bool instance = true;
@@ -177,13 +216,16 @@ namespace ftl {
 	 */
 	template<typename T, typename A>
 	struct monad<std::list<T,A>>
-	: deriving_monad<back_insertable_container<std::list<T,A>>> {
+	: deriving_pure<std::list<T,A>>
+	, deriving_map<back_insertable_container<std::list<T,A>>>
+	, deriving_apply<in_terms_of_bind<std::list<T,A>>> {
 
-#ifdef DOCUMENTATION_GENERATOR
 		/// Alias to make type signatures cleaner
 		template<typename U>
 		using list = Rebind<std::list<T,A>,U>;
 
+#ifdef DOCUMENTATION_GENERATOR
+
 		/**
 		 * Produces a singleton list.
 		 *
@@ -218,17 +260,36 @@ namespace ftl {
 		template<typename F, typename U = result_of<F(T)>>
 		static list<U> map(F&& f, list<T>&& l);
 
+#endif
+
 		/**
 		 * Joins nested lists by way of concatenation.
 		 *
 		 * The resulting list contains every element of every list contained
 		 * in the original list. Relative order is preserved (from the
 		 * perspective of depth first iteration).
+		 *
+		 * If `l` is a temporary, its lists are spliced together, without
+		 * copying or allocating anything.
 		 */
-		static list<T> join(const list<list<T>>& l);
+		static list<T> join(const list<list<T>>& l) {
+			list<T> r;
+			for(auto& e : l) {
+				r.insert(r.end(), e.begin(), e.end());
+			}
+
+			return r;
+		}
 
 		/// \overload
-		static list<T> join(list<list<T>>&& l);
+		static list<T> join(list<list<T>>&& l) {
+			list<T> r;
+			for(auto& e : l) {
+				_dtl::list_append(r, std::move(e));
+			}
+
+			return r;
+		}
 
 		/**
 		 * Monad bind operation.
@@ -240,7 +301,9 @@ namespace ftl {
 		 * list.
 		 *
 		 * \note `f` is allowed to return _any_ \ref fwditerable, not only
-		 *       lists. The final result, however, is always a list.
+		 *       lists. The final result, however, is always a list. When `f`
+		 *       does return lists by value, they are spliced into the result
+		 *       rather than copied.
 		 *
 		 * Example:
 		 * \code
@@ -258,17 +321,32 @@ namespace ftl {
 				typename U = Value_type<Cu>,
 				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static list<U> bind(const list<T>& l, F&& f);
+		static list<U> bind(const list<T>& l, F&& f) {
+			list<U> r;
+			for(auto& e : l) {
+				_dtl::list_append(r, f(e));
+			}
+
+			return r;
+		}
 
 		/// \overload
 		template<
 				typename F,
 				typename Cu = result_of<F(T)>,
 				typename U = Value_type<Cu>,
-				typename = Requries<ForwardIterable<Cu>()>
+				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static list<U> bind(list<T>&& l, F&& f);
-#endif
+		static list<U> bind(list<T>&& l, F&& f) {
+			list<U> r;
+			for(auto& e : l) {
+				_dtl::list_append(r, f(std::move(e)));
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
 	};
 
 	/**
@@ -321,6 +399,55 @@ namespace ftl {
 		);
 	}
 
+	/**
+	 * Split a list into the elements that satisfy `p`, and those that don't.
+	 *
+	 * Both halves keep the order of `l`, which is traversed once.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(const T&)>`
+	 *
+	 * \ingroup list
+	 */
+	template<typename P, typename T, typename A>
+	std::pair<std::list<T,A>,std::list<T,A>> partition(
+			P&& p, const std::list<T,A>& l) {
+		std::pair<std::list<T,A>,std::list<T,A>> r{
+			std::list<T,A>(l.get_allocator()), std::list<T,A>(l.get_allocator())
+		};
+
+		for(auto& x : l) {
+			if(p(x))
+				r.first.push_back(x);
+			else
+				r.second.push_back(x);
+		}
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Relinks the nodes of `l` into the halves, copying and allocating
+	 * nothing.
+	 *
+	 * \ingroup list
+	 */
+	template<typename P, typename T, typename A>
+	std::pair<std::list<T,A>,std::list<T,A>> partition(
+			P&& p, std::list<T,A>&& l) {
+		std::pair<std::list<T,A>,std::list<T,A>> r{
+			std::list<T,A>(l.get_allocator()), std::list<T,A>(l.get_allocator())
+		};
+
+		while(!l.empty()) {
+			auto& half = p(static_cast<const T&>(l.front())) ? r.first : r.second;
+			half.splice(half.end(), l, l.begin());
+		}
+
+		return r;
+	}
+
 }
 
 #endif
@@ -63,6 +63,10 @@ namespace ftl {
 	/**
 	 * Functor instance for std::map.
 	 *
+	 * Keys are not changed, so the result is built in the order of `m`,
+	 * each pair inserted at the end with a hint. Mapping is thus linear,
+	 * rather than \f$ O(n\log(n)) \f$.
+	 *
 	 * \ingroup map
 	 */
 	template<typename K, typename T, typename C, typename A>
@@ -77,9 +81,9 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static Map<U> map(F&& f, const Map<T>& m) {
-			Map<U> rm;
+			Map<U> rm(m.key_comp());
 			for(const auto& kv : m) {
-				rm.insert(std::make_pair(kv.first, f(kv.second)));
+				rm.emplace_hint(rm.end(), kv.first, f(kv.second));
 			}
 
 			return rm;
@@ -96,9 +100,11 @@ namespace ftl {
 				typename = Requires<!std::is_same<T,U>::value>
 		>
 		static Map<U> map(F&& f, Map<T>&& m) {
-			Map<U> rm;
+			Map<U> rm(m.key_comp());
 			for(auto& kv : m) {
-				rm.emplace(std::move(kv.first), f(std::move(kv.second)));
+				rm.emplace_hint(
+						rm.end(), std::move(kv.first), f(std::move(kv.second))
+				);
 			}
 
 			return rm;
@@ -117,10 +123,10 @@ namespace ftl {
 		>
 		static Map<T> map(F&& f, Map<T>&& m) {
 			for(auto& kv : m) {
-				m[kv.first] = f(std::move(kv.second));
+				kv.second = f(std::move(kv.second));
 			}
 
-			return m;
+			return std::move(m);
 		}
 
 		static constexpr bool instance = true;
@@ -144,7 +150,7 @@ namespace ftl {
 		>
 		static U foldl(F&& f, U z, const std::map<K,T,C,A>& m) {
 			for(auto& kv : m) {
-				z = f(z, kv.second);
+				z = f(std::move(z), kv.second);
 			}
 
 			return z;
@@ -159,7 +165,7 @@ namespace ftl {
 		>
 		static U foldr(F&& f, U z, const std::map<K,T,C,A>& m) {
 			for(auto it = m.rbegin(); it != m.rend(); ++it) {
-				z = f(it->second, z);
+				z = f(it->second, std::move(z));
 			}
 
 			return z;
@@ -168,6 +174,25 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	namespace _dtl {
+		// The hint from lower_bound lets a new key go in without a search
+		template<typename K, typename V, typename C, typename A>
+		struct keyed_append<std::map<K,V,C,A>> {
+			template<typename K2>
+			static void append(std::map<K,V,C,A>& m, K2&& k, V&& v) {
+				auto it = m.lower_bound(k);
+				if(it != m.end() && !m.key_comp()(k, it->first)) {
+					it->second = monoid<V>::append(
+						std::move(it->second), std::move(v)
+					);
+				}
+				else {
+					m.emplace_hint(it, std::forward<K2>(k), std::move(v));
+				}
+			}
+		};
+	}
+
 }
 
 #endif
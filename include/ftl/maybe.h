@@ -23,6 +23,7 @@
 #ifndef FTL_MAYBE_H
 #define FTL_MAYBE_H
 
+#include <vector>
 #include "implementation/maybe_iterator.h"
 #include "sum_type.h"
 #include "prelude.h"
@@ -42,6 +43,7 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<vector>`
 	 * - \ref sum_type
 	 * - \ref prelude
 	 * - \ref monoid
@@ -86,6 +88,12 @@ namespace ftl {
 	 * Note that all iterators referencing a `just` instance of `maybe` are
 	 * rendered invalid if it is changed to `Nothing`.
 	 *
+	 * If `T` specialises `ftl::niche_traits`, `Nothing` is stored in a niche
+	 * of `T` and `maybe<T>` is no larger than `T` itself.
+	 *
+	 * To reset a `maybe` to a new value or to `Nothing` without building a
+	 * temporary, use `m.emplace<T>(args...)` or `m.emplace<Nothing>()`.
+	 *
 	 * \see sum_type
 	 *
 	 * \ingroup maybe
@@ -159,8 +167,12 @@ namespace ftl {
 	}
 
 	template<typename T>
-	constexpr ::ftl::_dtl::maybe_iterator<T> begin(maybe<T>& m) noexcept {
-		return ::ftl::_dtl::maybe_iterator<T>{&m};
+	FTL_CONSTEXPR14 ::ftl::_dtl::maybe_iterator<T> begin(maybe<T>& m) noexcept {
+		return ::ftl::_dtl::maybe_iterator<T>{
+			m.template is<T>()
+			? std::addressof(::ftl::_dtl::sum_type_accessor::ref<0>(m))
+			: nullptr
+		};
 	}
 
 	template<typename T>
@@ -170,7 +182,11 @@ namespace ftl {
 
 	template<typename T>
 	constexpr ::ftl::_dtl::const_maybe_iterator<T> begin(const maybe<T>& m) noexcept {
-		return ::ftl::_dtl::const_maybe_iterator<T>{&m};
+		return ::ftl::_dtl::const_maybe_iterator<T>{
+			m.template is<T>()
+			? std::addressof(::ftl::_dtl::sum_type_accessor::ref<0>(m))
+			: nullptr
+		};
 	}
 
 	template<typename T>
@@ -295,12 +311,12 @@ namespace ftl {
 			);
 		}
 
-		// TODO: C++14: capture m by copy/move as appropriate
 		/**
 		 * Apply a contained function to a contained value and embed the result.
 		 *
 		 * Very similar to `map`, except this time the function is embedded in a
-		 * `maybe` as well.
+		 * `maybe` as well. Temporary operands are moved from: the function
+		 * into the call, and the value into the function.
 		 *
 		 * \par Examples
 		 *
@@ -321,18 +337,37 @@ namespace ftl {
 		 * \endcode
 		 */
 		template<typename F, typename U = result_of<F(T)>>
-		static constexpr maybe<U> apply(const maybe<F>& mf, maybe<T> m) {
+		static constexpr maybe<U> apply(
+				const maybe<F>& mf, const maybe<T>& m) {
+			return mf.match(
+				[&m](const F& f){ return fmap(f, m); },
+				[](Nothing){ return Nothing{}; }
+			);
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static constexpr maybe<U> apply(const maybe<F>& mf, maybe<T>&& m) {
 			return mf.match(
-				[m](const F& f){ return fmap(f, m); },
+				[&m](const F& f){ return fmap(f, std::move(m)); },
 				[](Nothing){ return Nothing{}; }
 			);
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
-		static constexpr maybe<U> apply(maybe<F>&& mf, maybe<T> m) {
+		static constexpr maybe<U> apply(maybe<F>&& mf, const maybe<T>& m) {
 			return mf.match(
-				[m](F& f){ return fmap(std::move(f), m); },
+				[&m](F& f){ return fmap(std::move(f), m); },
+				[](Nothing){ return Nothing{}; }
+			);
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static constexpr maybe<U> apply(maybe<F>&& mf, maybe<T>&& m) {
+			return mf.match(
+				[&m](F& f){ return fmap(std::move(f), std::move(m)); },
 				[](Nothing){ return Nothing{}; }
 			);
 		}
@@ -464,6 +499,8 @@ namespace ftl {
 	 * `value_type` of the maybe and all nothings are ignored (unless
 	 * everything is nothing).
 	 *
+	 * If `T`'s monoid instance has absorbing elements, so does this one.
+	 *
 	 * \tparam T must be a \ref monoidpg
 	 *
 	 * \ingroup maybe
@@ -519,6 +556,15 @@ namespace ftl {
 				: std::move(m2);
 		}
 
+		/// A value absorbs everything if it is absorbing in `T`
+		template<
+				typename U = T,
+				typename = Requires<_dtl::has_absorbing<U>::value>
+		>
+		static constexpr bool absorbing(const maybe<T>& m) {
+			return m.template is<T>() && monoid<U>::absorbing(get<T>(m));
+		}
+
 		static constexpr bool instance = true;
 	};
 
@@ -544,6 +590,103 @@ namespace ftl {
 		using Fm = Rebind<F,maybe<T>>;
 		return just % f | applicative<Fm>::pure(nothing<T>());
 	}
+
+	/**
+	 * Turn a vector of `maybe`s into a `maybe` vector.
+	 *
+	 * The result is `Nothing` if any element of `v` is; otherwise, it holds
+	 * all the values of `v`, in order. Stops at the first `Nothing`, and
+	 * reserves the resulting vector only once.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<maybe<int>> v{just(1), just(2)};
+	 *   auto m = sequence(v);
+	 *   // m == just(std::vector<int>{1, 2})
+	 * \endcode
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T, typename A>
+	maybe<std::vector<T>> sequence(const std::vector<maybe<T>,A>& v) {
+		std::vector<T> r;
+		r.reserve(v.size());
+
+		for(auto& m : v) {
+			if(!m.template is<T>())
+				return nothing<std::vector<T>>();
+
+			r.push_back(get<T>(m));
+		}
+
+		return just(std::move(r));
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Moves the values out of `v`.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T, typename A>
+	maybe<std::vector<T>> sequence(std::vector<maybe<T>,A>&& v) {
+		std::vector<T> r;
+		r.reserve(v.size());
+
+		for(auto& m : v) {
+			if(!m.template is<T>())
+				return nothing<std::vector<T>>();
+
+			r.push_back(std::move(get<T>(m)));
+		}
+
+		return just(std::move(r));
+	}
+
+	/**
+	 * Map `f` over a vector, collecting the results if none is `Nothing`.
+	 *
+	 * Equivalent to `sequence(f % v)`, but without the intermediate vector.
+	 * `f` is invoked on the elements in order, and not at all on those after
+	 * the first `Nothing` it returns.
+	 *
+	 * \tparam F must be callable with `const T&`, returning a `maybe`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto parse = [](const std::string& s){ ... return maybe<int>... };
+	 *
+	 *   maybe<std::vector<int>> ns = traverse(parse, strings);
+	 * \endcode
+	 *
+	 * \ingroup maybe
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(const T&)>>,
+			typename = Requires<
+				std::is_same<result_of<F(const T&)>, maybe<U>>::value
+			>
+	>
+	maybe<std::vector<U>> traverse(F f, const std::vector<T,A>& v) {
+		std::vector<U> r;
+		r.reserve(v.size());
+
+		for(auto& x : v) {
+			auto m = f(x);
+			if(!m.template is<U>())
+				return nothing<std::vector<U>>();
+
+			r.push_back(std::move(get<U>(m)));
+		}
+
+		return just(std::move(r));
+	}
 }
 
 #endif
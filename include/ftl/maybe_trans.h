@@ -23,6 +23,7 @@
 #ifndef FTL_MAYBE_TRANS_H
 #define FTL_MAYBE_TRANS_H
 
+#include <vector>
 #include "maybe.h"
 
 namespace ftl {
@@ -124,11 +125,105 @@ namespace ftl {
 		using rebind = maybeT<Rebind<M,T>>;
 	};
 
+	namespace _dtl {
+		/*
+		 * Binds of maybeT over Mmt that skip Mmt's own bind, so that each
+		 * bind costs a single continuation. Only specialised for base monads
+		 * where that makes a difference.
+		 */
+		template<typename Mmt>
+		struct fused_maybeT : std::false_type {};
+
+		/*
+		 * Going through function's bind would wrap every step in two
+		 * closures, allocate a pure function for every nothing, and copy the
+		 * function of the continuation before running it.
+		 */
+		template<typename T, typename...Ps>
+		struct fused_maybeT<function<maybe<T>(Ps...)>> : std::true_type {
+			template<typename U>
+			using Fn = function<maybe<U>(Ps...)>;
+
+			// f returns a maybeT
+			template<typename U, typename F>
+			static Fn<U> bind(Fn<T> m, F f) {
+				return [m,f](Ps...ps) -> maybe<U> {
+					auto r = m(ps...);
+					if(!r.template is<T>())
+						return nothing<U>();
+
+					return (*f(std::move(get<T>(r))))(ps...);
+				};
+			}
+
+			// f returns a function, lifted into maybeT
+			template<typename U, typename F>
+			static Fn<U> lift(Fn<T> m, F f) {
+				return [m,f](Ps...ps) -> maybe<U> {
+					auto r = m(ps...);
+					if(!r.template is<T>())
+						return nothing<U>();
+
+					return just(f(std::move(get<T>(r)))(ps...));
+				};
+			}
+
+			// Computations tried in order until one returns a value
+			struct alternatives {
+				std::vector<Fn<T>> fs;
+
+				maybe<T> operator() (Ps...ps) const {
+					for(auto& f : fs) {
+						auto r = f(ps...);
+						if(r.template is<T>())
+							return r;
+					}
+
+					return nothing<T>();
+				}
+			};
+
+			/*
+			 * Chains of orDo all end up in the same list of alternatives,
+			 * which is reused outright when the left-hand chain is a temporary.
+			 */
+			static Fn<T> orDo(Fn<T>&& m1, const Fn<T>& m2) {
+				if(auto alts = m1.template target<alternatives>()) {
+					push(*alts, m2);
+					return std::move(m1);
+				}
+
+				return orDo(static_cast<const Fn<T>&>(m1), m2);
+			}
+
+			static Fn<T> orDo(const Fn<T>& m1, const Fn<T>& m2) {
+				alternatives alts;
+				push(alts, m1);
+				push(alts, m2);
+
+				return alts;
+			}
+
+		private:
+			static void push(alternatives& alts, const Fn<T>& m) {
+				if(auto ms = m.template target<alternatives>())
+					alts.fs.insert(alts.fs.end(), ms->fs.begin(), ms->fs.end());
+
+				else
+					alts.fs.push_back(m);
+			}
+		};
+	}
+
 	/**
 	 * `maybeT`'s monad instance.
 	 *
 	 * "Stacks" `M` on top of `maybe`.
 	 *
+	 * Where `M` is an `ftl::function`, binds do not go through the function
+	 * monad. Instead, each bind makes a single function that runs the
+	 * computation, and the continuation only on values.
+	 *
 	 * \ingroup maybeT
 	 */
 	template<typename M>
@@ -208,6 +303,8 @@ namespace ftl {
 		static constexpr bool instance = true;
 
 	private:
+		using fused = _dtl::fused_maybeT<M_<maybe<T>>>;
+
 		template<typename M2>
 		struct bind_helper {
 			
@@ -218,6 +315,31 @@ namespace ftl {
 					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
 			>
 			static mT<U> bind(const mT<T>& m, F f) {
+				return bind(m, std::move(f), fused{});
+			}
+
+			template<
+					typename F,
+					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
+			>
+			static mT<U> bind(mT<T>&& m, F f) {
+				return bind(std::move(m), std::move(f), fused{});
+			}
+
+			template<typename F>
+			static mT<U> bind(const mT<T>& m, F f, std::true_type) {
+				return mT<U>{fused::template lift<U>(*m, std::move(f))};
+			}
+
+			template<typename F>
+			static mT<U> bind(mT<T>&& m, F f, std::true_type) {
+				return mT<U>{
+					fused::template lift<U>(std::move(*m), std::move(f))
+				};
+			}
+
+			template<typename F>
+			static mT<U> bind(const mT<T>& m, F f, std::false_type) {
 				return mT<U>{
 					*m >>= [f](const maybe<T>& m) {
 						if(m.template is<T>())
@@ -228,11 +350,8 @@ namespace ftl {
 				};
 			}
 
-			template<
-					typename F,
-					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
-			>
-			static mT<U> bind(mT<T>&& m, F f) {
+			template<typename F>
+			static mT<U> bind(mT<T>&& m, F f, std::false_type) {
 				return mT<U>{
 					std::move(*m) >>= [f](maybe<T>&& m) {
 						if(m.template is<T>())
@@ -250,6 +369,28 @@ namespace ftl {
 
 			template<typename F>
 			static mT<U> bind(const mT<T>& m, F f) {
+				return bind(m, std::move(f), fused{});
+			}
+
+			template<typename F>
+			static mT<U> bind(mT<T>&& m, F f) {
+				return bind(std::move(m), std::move(f), fused{});
+			}
+
+			template<typename F>
+			static mT<U> bind(const mT<T>& m, F f, std::true_type) {
+				return mT<U>{fused::template bind<U>(*m, std::move(f))};
+			}
+
+			template<typename F>
+			static mT<U> bind(mT<T>&& m, F f, std::true_type) {
+				return mT<U>{
+					fused::template bind<U>(std::move(*m), std::move(f))
+				};
+			}
+
+			template<typename F>
+			static mT<U> bind(const mT<T>& m, F f, std::false_type) {
 				return mT<U>{
 					*m >>= [f](const maybe<T>& m) {
 						if(m.template is<T>())
@@ -261,7 +402,7 @@ namespace ftl {
 			}
 
 			template<typename F>
-			static mT<U> bind(mT<T>&& m, F f) {
+			static mT<U> bind(mT<T>&& m, F f, std::false_type) {
 				return mT<U>{
 					std::move(*m) >>= [f](maybe<T>&& m) {
 						if(m.template is<T>())
@@ -294,12 +435,36 @@ namespace ftl {
 		/**
 		 * Performs the monadic computation `mm1`. If it fails, `mm2` is
 		 * returned, otherwise the result is (re-wrapped).
+		 *
+		 * Where `M` is an `ftl::function`, a chain such as `a | b | c` is
+		 * kept as one flat list of alternatives, run in a single loop.
 		 */
 		static maybeT<M> orDo(const maybeT<M>& mm1, maybeT<M> mm2) {
+			return orDo(mm1, std::move(mm2), fused{});
+		}
 
-			using T = Value_type<M>;
-			using Mmt = typename maybeT<M>::Mmt;
+		static maybeT<M> orDo(maybeT<M>&& mm1, maybeT<M> mm2) {
+			return orDo(std::move(mm1), std::move(mm2), fused{});
+		}
+
+		static constexpr bool instance = monad<M>::instance;
 
+	private:
+		using T = Value_type<M>;
+		using Mmt = typename maybeT<M>::Mmt;
+		using fused = _dtl::fused_maybeT<Mmt>;
+
+		static maybeT<M> orDo(
+				const maybeT<M>& mm1, maybeT<M> mm2, std::true_type) {
+			return maybeT<M>{fused::orDo(*mm1, *mm2)};
+		}
+
+		static maybeT<M> orDo(maybeT<M>&& mm1, maybeT<M> mm2, std::true_type) {
+			return maybeT<M>{fused::orDo(std::move(*mm1), *mm2)};
+		}
+
+		static maybeT<M> orDo(
+				const maybeT<M>& mm1, maybeT<M> mm2, std::false_type) {
 			return maybeT<M> {
 				*mm1 >>= [mm2](const maybe<T>& m) -> Mmt {
 					if(!m.template is<Nothing>())
@@ -310,8 +475,6 @@ namespace ftl {
 				}
 			};
 		}
-
-		static constexpr bool instance = monad<M>::instance;
 	};
 
 	// Forward declarations
@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MAYBE_VECTOR_H
+#define FTL_MAYBE_VECTOR_H
+
+#include <vector>
+#include <cstdint>
+#include "maybe.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+#include "implementation/contiguous_fold.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup maybe_vector Maybe Vector
+	 *
+	 * A sequence of `maybe`s, stored as a bitmap and the values present.
+	 *
+	 * \code
+	 *   #include <ftl/maybe_vector.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<vector>`
+	 * - `<cstdint>`
+	 * - \ref maybe
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref zippable
+	 */
+
+	namespace _dtl {
+		using mv_word = std::uint64_t;
+
+		constexpr size_t mv_word_bits = 64;
+
+		inline unsigned mv_popcount(mv_word w) noexcept {
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+			unsigned n = 0;
+			for(; w; w &= w - 1)
+				++n;
+
+			return n;
+#endif
+		}
+
+		inline unsigned mv_lowest(mv_word w) noexcept {
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+			unsigned i = 0;
+			while(!(w & 1u)) {
+				w >>= 1;
+				++i;
+			}
+
+			return i;
+#endif
+		}
+
+		// Bits below position i
+		inline mv_word mv_below(unsigned i) noexcept {
+			return (mv_word(1) << i) - 1;
+		}
+	}
+
+	/**
+	 * Sequence container of `maybe<T>`, stored as a validity bitmap and a
+	 * packed array of the values present.
+	 *
+	 * A `std::vector<maybe<T>>` spends room on a tag and padding in every
+	 * element, and room for a whole `T` in every `nothing`. A `maybe_vector`
+	 * instead keeps one bit per element, saying whether it holds a value,
+	 * and the values themselves in a `std::vector<T>`, one after the other.
+	 * With a running count of the values before every 64 elements, reading
+	 * an element is still constant time. The fewer values there are, the
+	 * more it saves: a `maybe_vector<int>` where nine in ten elements are
+	 * `nothing` takes less than a byte per element, against eight.
+	 *
+	 * The concept instances treat it as a sequence of optional `T`s, as
+	 * `ftl::maybe` is treated on its own: `fmap` applies a function to every
+	 * value, keeping every `nothing` in place; folds visit only the values,
+	 * as a tight loop over the packed array; and `zipWith` combines the
+	 * elements where both sequences hold a value, finding them a word of
+	 * the bitmaps at a time.
+	 *
+	 * Elements can be appended and read (by value), but not modified in
+	 * place, other than through `fmap` on a temporary.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref eq, if `T` is
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   maybe_vector<double> readings(sensor_log);  // std::vector<maybe<double>>
+	 *
+	 *   auto total = ftl::foldl(std::plus<double>(), 0., readings);
+	 *   auto calibrated = [](double x){ return 1.02 * x; } % readings;
+	 * \endcode
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	class maybe_vector {
+		template<typename>
+		friend class maybe_vector;
+
+		template<typename>
+		friend struct functor;
+
+		template<typename>
+		friend struct zippable;
+
+	public:
+		/// The type of the elements of the sequence.
+		using value_type = maybe<T>;
+
+		using size_type = size_t;
+
+		maybe_vector() = default;
+
+		/// Convert from a vector of `maybe`s.
+		explicit maybe_vector(const std::vector<maybe<T>>& v) {
+			reserve(v.size());
+			for(auto& m : v)
+				push_back(m);
+		}
+
+		/// \overload
+		explicit maybe_vector(std::vector<maybe<T>>&& v) {
+			reserve(v.size());
+			for(auto& m : v)
+				push_back(std::move(m));
+		}
+
+		/// Number of elements, values or not.
+		size_type size() const noexcept {
+			return n;
+		}
+
+		bool empty() const noexcept {
+			return n == 0;
+		}
+
+		/// Number of elements holding a value.
+		size_type count() const noexcept {
+			return vals.size();
+		}
+
+		/**
+		 * Reserve room for `n` elements.
+		 *
+		 * As it is not known how many of them will hold values, only the
+		 * bitmap is affected. Use `reserve_values` for the values.
+		 */
+		void reserve(size_type n) {
+			auto words = (n + _dtl::mv_word_bits - 1) / _dtl::mv_word_bits;
+			bits.reserve(words);
+			ranks.reserve(words);
+		}
+
+		/// Reserve room for `n` values.
+		void reserve_values(size_type n) {
+			vals.reserve(n);
+		}
+
+		void clear() noexcept {
+			bits.clear();
+			ranks.clear();
+			vals.clear();
+			n = 0;
+		}
+
+		void push_back(const maybe<T>& m) {
+			if(m.template is<T>())
+				emplace_back(get<T>(m));
+			else
+				push_back(Nothing{});
+		}
+
+		/// \overload
+		void push_back(maybe<T>&& m) {
+			if(m.template is<T>())
+				emplace_back(std::move(get<T>(m)));
+			else
+				push_back(Nothing{});
+		}
+
+		/// Append an element without a value.
+		void push_back(Nothing) {
+			open_bit();
+			++n;
+		}
+
+		/// Append a value, constructed from `args`.
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			auto& w = open_bit();
+			vals.emplace_back(std::forward<Args>(args)...);
+			w |= mv_bit(n);
+			++n;
+		}
+
+		/// Whether the element at position `i` holds a value.
+		bool has_value(size_type i) const noexcept {
+			return (bits[i / _dtl::mv_word_bits] & mv_bit(i)) != 0;
+		}
+
+		/**
+		 * Copy the element at position `i`.
+		 *
+		 * As elements are not stored as `maybe`s, the returned value is
+		 * constructed on demand.
+		 */
+		maybe<T> operator[] (size_type i) const {
+			auto k = i / _dtl::mv_word_bits;
+			auto w = bits[k];
+
+			if(!(w & mv_bit(i)))
+				return nothing<T>();
+
+			unsigned b = i % _dtl::mv_word_bits;
+			return just(vals[ranks[k] + _dtl::mv_popcount(w & _dtl::mv_below(b))]);
+		}
+
+		/// The values present, in order.
+		const std::vector<T>& values() const noexcept {
+			return vals;
+		}
+
+		/// Convert to a vector of `maybe`s.
+		std::vector<maybe<T>> to_vector() const {
+			std::vector<maybe<T>> r;
+			r.reserve(n);
+
+			size_type v = 0;
+			for(size_type i = 0; i < n; ++i) {
+				if(has_value(i))
+					r.push_back(just(vals[v++]));
+				else
+					r.push_back(nothing<T>());
+			}
+
+			return r;
+		}
+
+		bool operator== (const maybe_vector& v) const {
+			return n == v.n && bits == v.bits && vals == v.vals;
+		}
+
+		bool operator!= (const maybe_vector& v) const {
+			return !(*this == v);
+		}
+
+	private:
+		static _dtl::mv_word mv_bit(size_type i) noexcept {
+			return _dtl::mv_word(1) << (i % _dtl::mv_word_bits);
+		}
+
+		// The word holding the bit of the next element
+		_dtl::mv_word& open_bit() {
+			if(n == bits.size() * _dtl::mv_word_bits) {
+				bits.push_back(0);
+				ranks.push_back(vals.size());
+			}
+
+			return bits.back();
+		}
+
+		// Bit i is set if element i holds a value, bits past n are never set
+		std::vector<_dtl::mv_word> bits;
+
+		// Number of values before each word of bits
+		std::vector<size_type> ranks;
+
+		std::vector<T> vals;
+		size_type n = 0;
+	};
+
+	/**
+	 * Parametric type traits for maybe_vector.
+	 *
+	 * The concept instances work on the values, so the value type is `T`,
+	 * rather than `maybe<T>`.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	struct parametric_type_traits<maybe_vector<T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = maybe_vector<U>;
+	};
+
+	/**
+	 * Functor instance for maybe_vector.
+	 *
+	 * Maps over the values, in one loop over the packed array. The bitmap
+	 * is copied as is, so every `nothing` stays where it was.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	struct functor<maybe_vector<T>> {
+		template<typename Fn, typename U = result_of<Fn(T)>>
+		static maybe_vector<U> map(Fn&& fn, const maybe_vector<T>& v) {
+			auto r = like<U>(v);
+			for(auto& x : v.vals)
+				r.vals.push_back(fn(x));
+
+			return r;
+		}
+
+		/// \overload
+		template<
+				typename Fn,
+				typename U = result_of<Fn(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static maybe_vector<U> map(Fn&& fn, maybe_vector<T>&& v) {
+			auto r = like<U>(v);
+			for(auto& x : v.vals)
+				r.vals.push_back(fn(std::move(x)));
+
+			v.clear();
+			return r;
+		}
+
+		/// Endofunction mapped over a temporary, in place.
+		template<
+				typename Fn,
+				typename = Requires<std::is_same<T, result_of<Fn(T)>>::value>
+		>
+		static maybe_vector<T> map(Fn&& fn, maybe_vector<T>&& v) {
+			for(auto& x : v.vals)
+				x = fn(std::move(x));
+
+			return std::move(v);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		// Same bitmap as v, with room for its values
+		template<typename U>
+		static maybe_vector<U> like(const maybe_vector<T>& v) {
+			maybe_vector<U> r;
+			r.bits = v.bits;
+			r.ranks = v.ranks;
+			r.n = v.n;
+			r.vals.reserve(v.vals.size());
+
+			return r;
+		}
+	};
+
+	/**
+	 * Foldable instance for maybe_vector.
+	 *
+	 * Folds over the values present, skipping every `nothing` without
+	 * looking at the bitmap. `fold` takes the faster paths `std::vector`
+	 * has for sums, products, `any` and `all`.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	struct foldable<maybe_vector<T>> {
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const maybe_vector<T>& v) {
+			for(auto& x : v.values())
+				z = fn(std::move(z), x);
+
+			return z;
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const maybe_vector<T>& v) {
+			auto& xs = v.values();
+			for(auto it = xs.rbegin(); it != xs.rend(); ++it)
+				z = fn(*it, std::move(z));
+
+			return z;
+		}
+
+		template<typename Fn, typename M = result_of<Fn(T)>>
+		static M foldMap(Fn&& fn, const maybe_vector<T>& v) {
+			static_assert(
+				Monoid<M>(),
+				"The result of Fn(T) is not an instance of Monoid."
+			);
+
+			M acc = monoid<M>::id();
+			for(auto& x : v.values()) {
+				acc = monoid<M>::append(std::move(acc), fn(x));
+
+				if(_dtl::is_absorbing(acc))
+					break;
+			}
+
+			return acc;
+		}
+
+		template<typename M = T>
+		static M fold(const maybe_vector<T>& v) {
+			static_assert(Monoid<M>(), "M must satisfy Monoid");
+
+			auto& xs = v.values();
+			return _dtl::contiguous_fold<T>::fold(xs.data(), xs.size());
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for maybe_vector.
+	 *
+	 * An element of the result holds a value where the elements of both
+	 * operands do, and `f` is applied only there. The bitmaps are combined
+	 * a 64 bit word at a time, so long runs of `nothing` cost next to
+	 * nothing. As always, the result is as long as the shorter operand.
+	 *
+	 * \ingroup maybe_vector
+	 */
+	template<typename T>
+	struct zippable<maybe_vector<T>> {
+		template<typename Fn, typename U, typename V = result_of<Fn(T,U)>>
+		static maybe_vector<V> zipWith(
+				Fn&& fn, const maybe_vector<T>& a, const maybe_vector<U>& b) {
+
+			maybe_vector<V> r;
+			r.n = a.n < b.n ? a.n : b.n;
+
+			auto words = (r.n + _dtl::mv_word_bits - 1) / _dtl::mv_word_bits;
+			r.bits.reserve(words);
+			r.ranks.reserve(words);
+
+			for(size_t k = 0; k < words; ++k) {
+				auto wa = a.bits[k];
+				auto wb = b.bits[k];
+				auto w = wa & wb;
+
+				r.bits.push_back(w);
+				r.ranks.push_back(r.vals.size());
+
+				for(; w; w &= w - 1) {
+					auto below = _dtl::mv_below(_dtl::mv_lowest(w));
+					r.vals.push_back(fn(
+						a.vals[a.ranks[k] + _dtl::mv_popcount(wa & below)],
+						b.vals[b.ranks[k] + _dtl::mv_popcount(wb & below)]
+					));
+				}
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
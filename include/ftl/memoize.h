@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MEMOIZE_H
+#define FTL_MEMOIZE_H
+
+#include <memory>
+#include <mutex>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "function.h"
+#include "tuple.h"
+
+namespace ftl {
+	/**
+	 * \defgroup memoize Memoize
+	 *
+	 * Function wrappers that cache their results.
+	 *
+	 * \code
+	 *   #include <ftl/memoize.h>
+	 * \endcode
+	 *
+	 * `memoize`, `memoize_lru` and `memoize_concurrent` wrap a pure function
+	 * in a `memoized` function, which computes the result for some arguments
+	 * only the first time it is called with them. Results are kept in a
+	 * hash table keyed on the tuple of arguments, hashed with `tuple_hash`,
+	 * so every parameter type needs `std::hash` and `operator==`, and the
+	 * result type must be copyable.
+	 *
+	 * Copies of a `memoized` function share their cache, and so do the
+	 * functions made by applying it to only some of its arguments.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::memoized<int(int,int)> cost = ftl::memoize(
+	 *       ftl::function<int(int,int)>(expensive)
+	 *   );
+	 *
+	 *   auto from_home = cost(home); // Curried, shares the cache of cost
+	 *   from_home(work);             // Computed
+	 *   cost(home, work);            // Cached
+	 *   cost.stats().hits;           // 1
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<list>`
+	 * - `<vector>`
+	 * - `<unordered_map>`
+	 * - \ref function
+	 * - \ref tuple
+	 */
+
+	/**
+	 * Counts of the calls of a memoized function, and of its cached results.
+	 *
+	 * \ingroup memoize
+	 */
+	struct memo_stats {
+		/// Calls answered from the cache
+		size_t hits;
+
+		/// Calls that computed their result
+		size_t misses;
+
+		/// Results currently cached
+		size_t size;
+	};
+
+	namespace _dtl {
+		// Every result ever computed
+		template<typename K, typename V>
+		class memo_map {
+		public:
+			explicit memo_map(size_t) {}
+
+			const V* find(const K& k) const {
+				auto it = m.find(k);
+				return it == m.end() ? nullptr : &it->second;
+			}
+
+			void insert(K&& k, const V& v) {
+				m.emplace(std::move(k), v);
+			}
+
+			size_t size() const noexcept {
+				return m.size();
+			}
+
+			void clear() noexcept {
+				m.clear();
+			}
+
+		private:
+			std::unordered_map<K,V,tuple_hash<K>> m;
+		};
+
+		// The most recently used results, up to a capacity
+		template<typename K, typename V>
+		class lru_map {
+			using entries = std::list<std::pair<K,V>>;
+
+		public:
+			explicit lru_map(size_t capacity) : capacity(capacity) {
+				m.reserve(capacity);
+			}
+
+			const V* find(const K& k) {
+				auto it = m.find(k);
+				if(it == m.end())
+					return nullptr;
+
+				es.splice(es.begin(), es, it->second);
+				return &it->second->second;
+			}
+
+			void insert(K&& k, const V& v) {
+				if(m.find(k) != m.end())
+					return;
+
+				// The least recently used entry's node is reused for the new one
+				if(m.size() == capacity) {
+					auto last = std::prev(es.end());
+					m.erase(last->first);
+					es.splice(es.begin(), es, last);
+					es.front().first = std::move(k);
+					es.front().second = v;
+				}
+				else {
+					es.emplace_front(std::move(k), v);
+				}
+
+				m.emplace(es.front().first, es.begin());
+			}
+
+			size_t size() const noexcept {
+				return m.size();
+			}
+
+			void clear() noexcept {
+				m.clear();
+				es.clear();
+			}
+
+		private:
+			size_t capacity;
+			entries es;
+			std::unordered_map<
+				K, typename entries::iterator, tuple_hash<K>
+			> m;
+		};
+
+		template<typename R, typename...Ps>
+		struct memo_state {
+			virtual ~memo_state() = default;
+
+			virtual R call(Ps...ps) = 0;
+			virtual memo_stats stats() const = 0;
+			virtual void clear() = 0;
+		};
+
+		template<template<typename,typename> class Map, typename R, typename...Ps>
+		class local_memo : public memo_state<R,Ps...> {
+			using key = std::tuple<plain_type<Ps>...>;
+
+		public:
+			local_memo(function<R(Ps...)> f, size_t capacity)
+			: f(std::move(f)), results(capacity) {}
+
+			R call(Ps...ps) override {
+				key k(ps...);
+				if(auto r = results.find(k)) {
+					++hits;
+					return *r;
+				}
+
+				++misses;
+
+				// f may call this memoized function again, so nothing of the
+				// cache is held on to while it runs
+				R r = f(std::forward<Ps>(ps)...);
+				results.insert(std::move(k), r);
+
+				return r;
+			}
+
+			memo_stats stats() const override {
+				return memo_stats{hits, misses, results.size()};
+			}
+
+			void clear() override {
+				results.clear();
+				hits = misses = 0;
+			}
+
+		private:
+			function<R(Ps...)> f;
+			Map<key,R> results;
+			size_t hits = 0;
+			size_t misses = 0;
+		};
+
+		template<template<typename,typename> class Map, typename R, typename...Ps>
+		class sharded_memo : public memo_state<R,Ps...> {
+			using key = std::tuple<plain_type<Ps>...>;
+
+			struct shard {
+				explicit shard(size_t capacity) : results(capacity) {}
+
+				mutable std::mutex m;
+				Map<key,R> results;
+				size_t hits = 0;
+				size_t misses = 0;
+			};
+
+		public:
+			sharded_memo(function<R(Ps...)> f, size_t capacity, size_t n)
+			: f(std::move(f)) {
+				shards.reserve(n);
+				for(size_t i = 0; i < n; ++i) {
+					shards.emplace_back(new shard((capacity + n - 1) / n));
+				}
+			}
+
+			R call(Ps...ps) override {
+				key k(ps...);
+				auto& s = *shards[tuple_hash<key>()(k) % shards.size()];
+
+				{
+					std::lock_guard<std::mutex> lock(s.m);
+					if(auto r = s.results.find(k)) {
+						++s.hits;
+						return *r;
+					}
+
+					++s.misses;
+				}
+
+				// Not locked, so that other callers, and f itself, may use
+				// the shard. Concurrent misses of one key may compute it twice.
+				R r = f(std::forward<Ps>(ps)...);
+
+				std::lock_guard<std::mutex> lock(s.m);
+				s.results.insert(std::move(k), r);
+
+				return r;
+			}
+
+			memo_stats stats() const override {
+				memo_stats st{0, 0, 0};
+				for(auto& s : shards) {
+					std::lock_guard<std::mutex> lock(s->m);
+					st.hits += s->hits;
+					st.misses += s->misses;
+					st.size += s->results.size();
+				}
+
+				return st;
+			}
+
+			void clear() override {
+				for(auto& s : shards) {
+					std::lock_guard<std::mutex> lock(s->m);
+					s->results.clear();
+					s->hits = s->misses = 0;
+				}
+			}
+
+		private:
+			function<R(Ps...)> f;
+			std::vector<std::unique_ptr<shard>> shards;
+		};
+	}
+
+	/**
+	 * A function that caches its results.
+	 *
+	 * Made by `memoize`, `memoize_lru` or `memoize_concurrent`. Copies share
+	 * one cache.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref assignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \ingroup memoize
+	 */
+	template<typename>
+	class memoized {};
+
+	template<typename R, typename...Ps>
+	class memoized<R(Ps...)>
+	: private ::ftl::_dtl::curried<memoized<R(Ps...)>,R,Ps...> {
+	public:
+		/// \copydoc function::parameter_types
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the function.
+		using result_type = R;
+
+		explicit memoized(std::shared_ptr<_dtl::memo_state<R,Ps...>> s) noexcept
+		: state(std::move(s)) {}
+
+		// Inherit the curried function call operator(s)
+		using ::ftl::_dtl::curried<memoized,R,Ps...>::operator();
+
+		/// The cached result for `ps`, computing it if there is none
+		R operator()(Ps...ps) const {
+			return state->call(std::forward<Ps>(ps)...);
+		}
+
+		/// Calls so far, and results cached
+		memo_stats stats() const {
+			return state->stats();
+		}
+
+		/// Forget every cached result, and reset the counts
+		void clear() {
+			state->clear();
+		}
+
+	private:
+		std::shared_ptr<_dtl::memo_state<R,Ps...>> state;
+	};
+
+	/**
+	 * Cache every result of `f`.
+	 *
+	 * The cache grows without bound, and is not safe to use from several
+	 * threads at once. `f` may call the memoized function, for instance to
+	 * memoize a recursive function.
+	 *
+	 * \ingroup memoize
+	 */
+	template<typename R, typename...Ps>
+	memoized<R(Ps...)> memoize(function<R(Ps...)> f) {
+		return memoized<R(Ps...)>(
+			std::make_shared<_dtl::local_memo<_dtl::memo_map,R,Ps...>>(
+				std::move(f), 0
+			)
+		);
+	}
+
+	/**
+	 * Cache the `capacity` most recently used results of `f`.
+	 *
+	 * Once full, each new result replaces the least recently used one. As
+	 * with `memoize`, not safe to use from several threads at once.
+	 * `capacity` must be at least 1.
+	 *
+	 * \ingroup memoize
+	 */
+	template<typename R, typename...Ps>
+	memoized<R(Ps...)> memoize_lru(function<R(Ps...)> f, size_t capacity) {
+		return memoized<R(Ps...)>(
+			std::make_shared<_dtl::local_memo<_dtl::lru_map,R,Ps...>>(
+				std::move(f), capacity
+			)
+		);
+	}
+
+	/**
+	 * Cache results of `f` for concurrent callers.
+	 *
+	 * The cache is split into `shards` parts by the hash of the arguments,
+	 * each with its own lock, so that callers with different arguments seldom
+	 * wait for one another. `f` runs without any lock held, so two threads
+	 * that miss on the same arguments at once may both compute the result.
+	 *
+	 * With a `capacity` other than 0, each shard keeps its share of the
+	 * capacity of most recently used results (rounded up), and the cache
+	 * holds up to `capacity` in all only if arguments spread evenly.
+	 * Otherwise every result is kept. `shards` must be at least 1.
+	 *
+	 * \ingroup memoize
+	 */
+	template<typename R, typename...Ps>
+	memoized<R(Ps...)> memoize_concurrent(
+			function<R(Ps...)> f, size_t capacity = 0, size_t shards = 16) {
+		if(capacity) {
+			return memoized<R(Ps...)>(
+				std::make_shared<_dtl::sharded_memo<_dtl::lru_map,R,Ps...>>(
+					std::move(f), capacity, shards
+				)
+			);
+		}
+
+		return memoized<R(Ps...)>(
+			std::make_shared<_dtl::sharded_memo<_dtl::memo_map,R,Ps...>>(
+				std::move(f), 0, shards
+			)
+		);
+	}
+}
+
+#endif
+
@@ -24,9 +24,11 @@
 #define FTL_MEMORY_H
 
 #include <memory>
+#include <functional>
 #include "concepts/monoid.h"
 #include "concepts/monad.h"
 #include "concepts/foldable.h"
+#include "alloc_stats.h"
 
 namespace ftl {
 
@@ -50,6 +52,7 @@ namespace ftl {
 	 * - \ref monoid
 	 * - \ref monad
 	 * - \ref foldable
+	 * - \ref alloc_stats
 	 */
 
 	/**
@@ -90,8 +93,10 @@ namespace ftl {
 				monoid<T>::instance,
 				std::shared_ptr<T>>::type {
 			if(a) {
-				if(b)
+				if(b) {
+					_dtl::note_alloc(_dtl::alloc_site::shared_ptr);
 					return std::make_shared<T>(monoid<T>::append(*a, *b));
+				}
 
 				else
 					return a;
@@ -121,13 +126,24 @@ namespace ftl {
 	, deriving_apply<in_terms_of_bind<std::shared_ptr<T>>> {
 
 		static std::shared_ptr<T> pure(T&& a) {
+			_dtl::note_alloc(_dtl::alloc_site::shared_ptr);
 			return std::make_shared<T>(std::forward<T>(a));
 		}
 
+		/**
+		 * Maps `f` over the value, if any.
+		 *
+		 * `p` is not copied, so mapping costs no reference count updates
+		 * beyond those of the result. See `allocate_fmap` to choose how the
+		 * result is allocated, and `project` for a result that needs no
+		 * allocation at all.
+		 */
 		template<typename F, typename U = result_of<F(T)>>
-		static std::shared_ptr<U> map(F f, std::shared_ptr<T> p) {
-			if(p)
+		static std::shared_ptr<U> map(F f, const std::shared_ptr<T>& p) {
+			if(p) {
+				_dtl::note_alloc(_dtl::alloc_site::shared_ptr);
 				return std::make_shared<U>(f(*p));
+			}
 
 			else
 				return std::shared_ptr<U>();
@@ -137,7 +153,7 @@ namespace ftl {
 				typename F,
 				typename U = typename result_of<F(T)>::element_type
 		>
-		static std::shared_ptr<U> bind(std::shared_ptr<T> a, F f) {
+		static std::shared_ptr<U> bind(const std::shared_ptr<T>& a, F f) {
 			if(a)
 				return f(*a);
 
@@ -147,6 +163,100 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Map `f` over the value of `p`, allocating the result with `alloc`.
+	 *
+	 * As `fmap(f, p)`, except the result, along with its control block, is
+	 * made by `std::allocate_shared`. Suits pool or arena allocators, for
+	 * results made often and dropped soon.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::arena a;
+	 *   auto port = allocate_fmap(
+	 *       ftl::arena_allocator<int>(&a),
+	 *       [](const config& c){ return c.port; },
+	 *       cfg
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<
+			typename A,
+			typename F,
+			typename T,
+			typename U = result_of<F(T)>
+	>
+	std::shared_ptr<U> allocate_fmap(
+			const A& alloc, F&& f, const std::shared_ptr<T>& p) {
+		if(p) {
+			_dtl::note_alloc(_dtl::alloc_site::shared_ptr);
+			return std::allocate_shared<U>(alloc, f(*p));
+		}
+
+		return std::shared_ptr<U>();
+	}
+
+	/**
+	 * Get a pointer to a part of the value of `p`, without allocating.
+	 *
+	 * `f` must return a reference into `*p`, such as one of its members.
+	 * The result is an aliasing `shared_ptr`: it points to what `f` referred
+	 * to, but shares ownership of all of `*p`, which is thus kept alive for
+	 * as long as the result is. Nothing is copied or allocated, and the only
+	 * cost beyond calling `f` is one reference count increment.
+	 *
+	 * If `p` is empty, so is the result.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::shared_ptr<config> cfg = load();
+	 *
+	 *   std::shared_ptr<const std::string> host
+	 *       = project(cfg, &config::host);
+	 *   std::shared_ptr<const limits> lim
+	 *       = project(cfg, [](const config& c) -> const limits& {
+	 *           return c.limits_for("default");
+	 *       });
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<
+			typename T,
+			typename F,
+			typename R = typename std::result_of<F(T&)>::type,
+			typename = Requires<
+				std::is_lvalue_reference<R>::value
+				&& !std::is_member_pointer<plain_type<F>>::value
+			>
+	>
+	std::shared_ptr<typename std::remove_reference<R>::type> project(
+			const std::shared_ptr<T>& p, F&& f) {
+		using U = typename std::remove_reference<R>::type;
+
+		if(p)
+			return std::shared_ptr<U>(p, std::addressof(f(*p)));
+
+		return std::shared_ptr<U>();
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Projects a data member of `*p`.
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T, typename U, typename C>
+	auto project(const std::shared_ptr<T>& p, U C::*m)
+	-> decltype(project(p, std::mem_fn(m))) {
+		return project(p, std::mem_fn(m));
+	}
+
 	/**
 	 * Foldable instance for shared_ptr
 	 *
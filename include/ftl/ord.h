@@ -23,8 +23,19 @@
 #ifndef FTL_ORD_H
 #define FTL_ORD_H
 
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cstdint>
+#include <cstring>
 #include "concepts/orderable.h"
 #include "concepts/monoid.h"
+#include "sum_type.h"
+
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
 
 namespace ftl {
 	/**
@@ -42,6 +53,7 @@ namespace ftl {
 	 * \par Dependencies
 	 * - \ref orderable
 	 * - \ref monoid
+	 * - \ref sum_type
 	 */
 
 	/**
@@ -91,10 +103,23 @@ namespace ftl {
 		 */
 		explicit constexpr ord(int n) noexcept : o(n < 0 ? Lt : (n > 0 ? Gt : Eq)) {}
 
-		constexpr ord(const ord& order) noexcept : o(order.o) {}
+#if defined(__cpp_lib_three_way_comparison)
+		/**
+		 * Construct from the result of `operator<=>`.
+		 *
+		 * A `std::partial_ordering` is not accepted, as "unordered" has no
+		 * equivalent.
+		 */
+		constexpr ord(std::strong_ordering c) noexcept
+		: o(c < 0 ? Lt : (c > 0 ? Gt : Eq)) {}
+
+		/// \overload
+		constexpr ord(std::weak_ordering c) noexcept
+		: o(c < 0 ? Lt : (c > 0 ? Gt : Eq)) {}
+#endif
 
-		// TODO: constexpr in c++14
-		ord(ord&& order) noexcept : o(std::move(order.o)) {}
+		constexpr ord(const ord&) noexcept = default;
+		constexpr ord(ord&&) noexcept = default;
 
 		constexpr ord(const ordering& order) noexcept : o(order) {}
 
@@ -135,23 +160,43 @@ namespace ftl {
 			return o >= order.o;
 		}
 
-		ord& operator= (const ord& order) noexcept {
-			o = order.o;
-			return *this;
+		ord& operator= (const ord&) noexcept = default;
+		ord& operator= (ord&&) noexcept = default;
+
+	private:
+		friend struct niche_traits<ord>;
+
+		ordering o = Eq;
+	};
+
+	/**
+	 * Niche of ord.
+	 *
+	 * `ordering` can represent one value beyond `Gt`, which `ord` itself can
+	 * never take on. Hence `maybe<ord>` is no larger than `ord`.
+	 *
+	 * \ingroup ord
+	 */
+	template<>
+	struct niche_traits<ord> {
+		static void set_niche(ord* p) noexcept {
+			new (static_cast<void*>(p)) ord();
+			p->o = static_cast<ord::ordering>(ord::Gt + 1);
 		}
 
-		ord& operator= (ord&& order) noexcept {
-			o = std::move(order.o);
-			return *this;
+		static bool is_niche(const ord* p) noexcept {
+			return p->o == ord::Gt + 1;
 		}
 
-	private:
-		ordering o = Eq;
+		static constexpr bool instance = true;
 	};
 
 	/**
 	 * Comparison function for \ref orderablepg objects.
 	 *
+	 * Where `Ord` has an `operator<=>` that gives a total order, it is used
+	 * instead, for one comparison rather than two.
+	 *
 	 * \ingroup ord
 	 */
 	template<
@@ -159,6 +204,10 @@ namespace ftl {
 			typename = Requires<Orderable<Ord>{}>
 	>
 	ord compare(const Ord& lhs, const Ord& rhs) {
+#if defined(__cpp_lib_three_way_comparison)
+		if constexpr(std::three_way_comparable<Ord,std::weak_ordering>)
+			return lhs <=> rhs;
+#endif
 		return lhs < rhs ? ord::Lt : (lhs == rhs ? ord::Eq : ord::Gt);
 	}
 
@@ -210,6 +259,11 @@ namespace ftl {
 			return (o1 == ord::Lt) ? o1 : (o1 == ord::Eq ? o2 : o1);
 		}
 
+		/// Anything but `Eq` decides a comparison
+		static constexpr bool absorbing(ord o) noexcept {
+			return o != ord::Eq;
+		}
+
 		static constexpr bool instance = true;
 	};
 
@@ -279,6 +333,448 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * The function referred to by `f` must outlive the returned comparator.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename A,
+			typename B,
+			typename = Requires<Orderable<B>{}>
+	>
+	function<ord(A,A)> comparing(function_ref<B(A)> f) {
+		return [=] (A a, A b) {
+			return compare(f(a), f(b));
+		};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Where `f` takes its argument by reference, so does the comparator,
+	 * and no element is copied to compare it.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename A,
+			typename B,
+			typename = Requires<Orderable<B>{}>
+	>
+	function<ord(const A&,const A&)> comparing(function<B(const A&)> f) {
+		return [=] (const A& a, const A& b) {
+			return compare(f(a), f(b));
+		};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * The function referred to by `f` must outlive the returned comparator.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename A,
+			typename B,
+			typename = Requires<Orderable<B>{}>
+	>
+	function<ord(const A&,const A&)> comparing(function_ref<B(const A&)> f) {
+		return [=] (const A& a, const A& b) {
+			return compare(f(a), f(b));
+		};
+	}
+
+	namespace _dtl {
+		/*
+		 * Move the element at keys[i].second to position i, for every i.
+		 *
+		 * Each cycle of the permutation is rotated through a single
+		 * temporary. Positions are overwritten in keys as they are settled.
+		 */
+		template<typename C, typename K>
+		void permute(C& c, std::vector<std::pair<K,size_t>>& keys) {
+			using T = typename C::value_type;
+
+			for(size_t i = 0; i < keys.size(); ++i) {
+				if(keys[i].second == i)
+					continue;
+
+				T t = std::move(c[i]);
+				size_t j = i;
+				while(keys[j].second != i) {
+					size_t k = keys[j].second;
+					c[j] = std::move(c[k]);
+					keys[j].second = j;
+					j = k;
+				}
+
+				c[j] = std::move(t);
+				keys[j].second = j;
+			}
+		}
+	}
+
+	/**
+	 * Sort a container by a key computed from each element.
+	 *
+	 * Equivalent to sorting with `asc(comparing(f))`, except `f` is applied
+	 * exactly once per element, rather than twice per comparison. The keys
+	 * are computed up front, sorted along with the position of their
+	 * element, and the elements then moved into place. Worth it where `f`
+	 * is anything more expensive than a member access.
+	 *
+	 * The sort is stable, elements with equal keys keep their order.
+	 *
+	 * \tparam F Must satisfy \ref fn`<`\ref orderablepg`(const T&)>`
+	 * \tparam C A random access container of `T`, such as `std::vector` or
+	 *           `std::deque`. Its elements must be \ref moveassignable.
+	 *
+	 * Example:
+	 * \code
+	 *   std::vector<string> v{"10", "5", "200"};
+	 *
+	 *   v = sort_on([](const string& s){ return std::stoi(s); }, std::move(v));
+	 * \endcode
+	 * Resulting vector: `{"5", "10", "200"}`
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename F,
+			typename C,
+			typename T = typename C::value_type,
+			typename B = result_of<F(const T&)>,
+			typename = Requires<Orderable<B>{}>
+	>
+	C sort_on(F&& f, C c) {
+		const size_t n = c.size();
+
+		std::vector<std::pair<B,size_t>> keys;
+		keys.reserve(n);
+		for(size_t i = 0; i < n; ++i)
+			keys.emplace_back(f(c[i]), i);
+
+		std::stable_sort(
+			keys.begin(), keys.end(),
+			[](const std::pair<B,size_t>& a, const std::pair<B,size_t>& b) {
+				return compare(a.first, b.first) == ord::Lt;
+			}
+		);
+
+		_dtl::permute(c, keys);
+
+		return c;
+	}
+
+	namespace _dtl {
+		/*
+		 * Unsigned integers that order like keys of type K.
+		 *
+		 * Signed integers have their sign bit flipped. Floating point numbers
+		 * have all their bits flipped if negative, or else only the sign bit.
+		 */
+		template<typename K, typename = void>
+		struct radix_key : std::false_type {};
+
+		template<typename K>
+		struct radix_key<
+			K,
+			Requires<std::is_integral<K>::value && !std::is_same<K,bool>::value>
+		> : std::true_type {
+			using type = typename std::make_unsigned<K>::type;
+
+			static constexpr type sign = std::is_signed<K>::value
+				? type(1) << (sizeof(type) * 8 - 1) : 0;
+
+			static type get(K k) noexcept {
+				return type(k) ^ sign;
+			}
+		};
+
+		template<typename K>
+		struct radix_key<
+			K,
+			Requires<
+				std::is_floating_point<K>::value
+				&& std::numeric_limits<K>::is_iec559
+				&& (sizeof(K) == 4 || sizeof(K) == 8)
+			>
+		> : std::true_type {
+			using type = typename std::conditional<
+				sizeof(K) == 4, uint32_t, uint64_t
+			>::type;
+
+			static constexpr type sign = type(1) << (sizeof(type) * 8 - 1);
+
+			static type get(K k) noexcept {
+				type u;
+				std::memcpy(&u, &k, sizeof(u));
+
+				return (u & sign) ? ~u : u | sign;
+			}
+		};
+
+		// Least significant digit first, a byte at a time
+		template<typename U>
+		void radix_sort(std::vector<std::pair<U,size_t>>& keys) {
+			constexpr size_t digits = sizeof(U);
+			const size_t n = keys.size();
+
+			// Counts of every digit are taken in a single pass
+			std::vector<size_t> counts(digits * 256, 0);
+			for(auto& k : keys) {
+				for(size_t d = 0; d < digits; ++d)
+					++counts[d * 256 + ((k.first >> (d * 8)) & 0xff)];
+			}
+
+			std::vector<std::pair<U,size_t>> buf(n);
+			for(size_t d = 0; d < digits; ++d) {
+				size_t* count = &counts[d * 256];
+
+				// A digit all keys share would not move anything
+				if(count[(keys[0].first >> (d * 8)) & 0xff] == n)
+					continue;
+
+				size_t offset = 0;
+				for(size_t b = 0; b < 256; ++b) {
+					size_t m = count[b];
+					count[b] = offset;
+					offset += m;
+				}
+
+				for(auto& k : keys)
+					buf[count[(k.first >> (d * 8)) & 0xff]++] = k;
+
+				keys.swap(buf);
+			}
+		}
+
+		template<typename F, typename C, typename K>
+		C radix_sort_on(F& f, C c, std::true_type) {
+			using U = typename radix_key<K>::type;
+
+			const size_t n = c.size();
+			if(n == 0)
+				return c;
+
+			std::vector<std::pair<U,size_t>> keys;
+			keys.reserve(n);
+			for(size_t i = 0; i < n; ++i)
+				keys.emplace_back(radix_key<K>::get(f(c[i])), i);
+
+			radix_sort(keys);
+			permute(c, keys);
+
+			return c;
+		}
+
+		template<typename F, typename C, typename K>
+		C radix_sort_on(F& f, C c, std::false_type) {
+			return sort_on(f, std::move(c));
+		}
+	}
+
+	/**
+	 * Sort a container by an integral or floating point key, in linear time.
+	 *
+	 * Like `sort_on`, computes every key once and sorts stably, but sorts
+	 * the keys with an LSD radix sort rather than by comparison. Takes one
+	 * pass over the keys to count digits, and one more per byte of the key
+	 * type, skipping bytes that every key has in common. Well worth it for
+	 * large containers, where \f$ O(n\log(n)) \f$ comparisons dominate.
+	 *
+	 * Other key types, such as strings, are sorted by `sort_on` instead.
+	 *
+	 * \note Floating point keys are ordered by their bit patterns, so
+	 *       `-0.0` comes before `0.0`, and NaNs go to either end, depending
+	 *       on their sign.
+	 *
+	 * \tparam F Must satisfy \ref fn`<`\ref orderablepg`(const T&)>`
+	 * \tparam C As for `sort_on`.
+	 *
+	 * Example:
+	 * \code
+	 *   records = radix_sort_on(
+	 *       [](const record& r){ return r.timestamp; }, std::move(records)
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename F,
+			typename C,
+			typename T = typename C::value_type,
+			typename K = result_of<F(const T&)>,
+			typename = Requires<Orderable<K>{}>
+	>
+	C radix_sort_on(F&& f, C c) {
+		return _dtl::radix_sort_on<F,C,K>(
+			f, std::move(c), _dtl::radix_key<K>{}
+		);
+	}
+
+	namespace _dtl {
+		// Member pointers are called through mem_fn, anything else as is
+		template<typename K>
+		K as_key(K k) {
+			return k;
+		}
+
+		template<typename R, typename C>
+		auto as_key(R C::*m) -> decltype(std::mem_fn(m)) {
+			return std::mem_fn(m);
+		}
+
+		template<typename K>
+		using key_type = decltype(as_key(std::declval<K>()));
+
+		template<typename...Ks>
+		struct lexicographic_order {
+			template<typename A>
+			constexpr bool operator() (const A&, const A&) const noexcept {
+				return false;
+			}
+
+			template<typename A>
+			ord compare(const A&, const A&) const noexcept {
+				return ord::Eq;
+			}
+		};
+
+		template<typename K, typename...Ks>
+		struct lexicographic_order<K,Ks...> {
+			using rest = lexicographic_order<Ks...>;
+
+			constexpr lexicographic_order(K k, Ks...ks)
+			: key(std::move(k)), next(std::move(ks)...) {}
+
+			template<typename A>
+			bool operator() (const A& a, const A& b) const {
+				auto&& ka = key(a);
+				auto&& kb = key(b);
+
+				if(ka < kb)
+					return true;
+				if(kb < ka)
+					return false;
+
+				return next(a, b);
+			}
+
+			template<typename A>
+			ord compare(const A& a, const A& b) const {
+				ord o = ftl::compare(key(a), key(b));
+
+				return o != ord::Eq ? o : next.compare(a, b);
+			}
+
+			K key;
+			rest next;
+		};
+	}
+
+	/**
+	 * Order objects by a sequence of keys.
+	 *
+	 * Returns a "less than" predicate, fit for `std::sort` and the like as
+	 * it is. Two objects are ordered by the first key on which they differ.
+	 * Later keys are only computed if all earlier ones are equal, which,
+	 * unlike with `comparing(k1) ^ comparing(k2)`, is usually not the case.
+	 *
+	 * Keys may be any function objects or pointers to member functions, or
+	 * to data members. None of them is type erased, so every key can be
+	 * inlined into the comparison. Their results must satisfy
+	 * \ref orderablepg.
+	 *
+	 * The predicate also has a `compare(a, b)` member, for when an `ord` is
+	 * called for.
+	 *
+	 * Example:
+	 * \code
+	 *   struct person {
+	 *       std::string last, first;
+	 *       int age;
+	 *   };
+	 *
+	 *   std::sort(people.begin(), people.end(), lexicographic(
+	 *       &person::last, &person::first,
+	 *       [](const person& p){ return -p.age; }
+	 *   ));
+	 * \endcode
+	 * The above sorts `people` by name, and the oldest first among those
+	 * of the same name.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename...Ks>
+	_dtl::lexicographic_order<_dtl::key_type<Ks>...> lexicographic(Ks...ks) {
+		return _dtl::lexicographic_order<_dtl::key_type<Ks>...>(
+			_dtl::as_key(std::move(ks))...
+		);
+	}
+
+	/**
+	 * Transparent function object giving the `ord` of two objects.
+	 *
+	 * Two objects of one type are compared by `compare`. Objects of
+	 * different types, such as a `std::string` and a `string_view`, are
+	 * compared with `<` both ways, so that neither is converted to the
+	 * other's type.
+	 *
+	 * \ingroup ord
+	 */
+	struct comparator {
+		using is_transparent = void;
+
+		template<typename A>
+		ord operator() (const A& a, const A& b) const {
+			return compare(a, b);
+		}
+
+		template<typename A, typename B>
+		ord operator() (const A& a, const B& b) const {
+			return a < b ? ord::Lt : (b < a ? ord::Gt : ord::Eq);
+		}
+	};
+
+	namespace _dtl {
+		template<bool>
+		struct transparency {};
+
+		template<>
+		struct transparency<true> {
+			using is_transparent = void;
+		};
+
+		template<typename F, ord::ordering O>
+		struct ordered_by
+		: transparency<decltype(test_transparent<F>(nullptr))::value> {
+			ordered_by() = default;
+			explicit ordered_by(F cmp) : cmp(std::move(cmp)) {}
+
+			template<typename A, typename B>
+			bool operator() (const A& a, const B& b) const {
+				return cmp(a, b) == O;
+			}
+
+			F cmp;
+		};
+
+		template<typename A, ord::ordering O>
+		struct ordering_predicate {
+			function_ref<ord(const A&,const A&)> cmp;
+
+			bool operator() (const A& a, const A& b) const {
+				return cmp(a, b) == O;
+			}
+		};
+	}
+
 	/**
 	 * Convenience function to ease integration with stdlib's sort.
 	 *
@@ -297,6 +793,51 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Rather than another `ftl::function`, returns a lightweight predicate
+	 * that refers to `cmp`, saving one level of type erasure per comparison.
+	 * The function referred to by `cmp` must outlive the predicate.
+	 *
+	 * Example:
+	 * \code
+	 *   auto cmp = comparing(&string::size);
+	 *   sort(l.begin(), l.end(),
+	 *       asc(function_ref<ord(const string&,const string&)>(cmp)));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_predicate<A,ord::Lt> asc(
+			function_ref<ord(const A&,const A&)> cmp) {
+		return _dtl::ordering_predicate<A,ord::Lt>{cmp};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * For any other compare function, including none at all, returns a
+	 * predicate of a type of its own, with no type erasure. Where `cmp` is
+	 * transparent, so is the predicate, making it fit for heterogeneous
+	 * lookups in ordered containers.
+	 *
+	 * Example:
+	 * \code
+	 *   std::map<std::string,int,decltype(asc())> m{{"a", 1}};
+	 *
+	 *   // Finds "a" without making a std::string of it
+	 *   auto it = m.find("a");
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename F = comparator>
+	_dtl::ordered_by<F,ord::Lt> asc(F cmp = F()) {
+		return _dtl::ordered_by<F,ord::Lt>(std::move(cmp));
+	}
+
 	/**
 	 * Convenience function to ease integration with stdlib's sort.
 	 *
@@ -315,6 +856,32 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * As with `asc`, the returned predicate refers to `cmp`.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_predicate<A,ord::Gt> desc(
+			function_ref<ord(const A&,const A&)> cmp) {
+		return _dtl::ordering_predicate<A,ord::Gt>{cmp};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * As with `asc`, works with any compare function, and is transparent
+	 * when `cmp` is.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename F = comparator>
+	_dtl::ordered_by<F,ord::Gt> desc(F cmp = F()) {
+		return _dtl::ordered_by<F,ord::Gt>(std::move(cmp));
+	}
+
 	/**
 	 * Convenience function to ease integration with stdlib's sort.
 	 *
@@ -332,6 +899,19 @@ namespace ftl {
 			return cmp(a, b) == ord::Eq;
 		};
 	}
+
+	/**
+	 * \overload
+	 *
+	 * As with `asc`, the returned predicate refers to `cmp`.
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_predicate<A,ord::Eq> equal(
+			function_ref<ord(const A&,const A&)> cmp) {
+		return _dtl::ordering_predicate<A,ord::Eq>{cmp};
+	}
 }
 
 #endif
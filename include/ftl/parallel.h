@@ -0,0 +1,569 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PARALLEL_H
+#define FTL_PARALLEL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <algorithm>
+#include "executor.h"
+#include "concepts/monoid.h"
+#include "concepts/foldable.h"
+#include "chunked_seq.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup parallel Parallel
+	 *
+	 * Data parallel maps and folds over random access containers.
+	 *
+	 * \code
+	 *   #include <ftl/parallel.h>
+	 * \endcode
+	 *
+	 * The functions in this module split a `std::vector` or `std::deque`
+	 * into contiguous chunks, and process the chunks as tasks on an
+	 * \ref executorpg. The calling thread takes part as well: it works
+	 * through every chunk no task has started on yet, and then waits for the
+	 * rest. Because of this, the functions may safely be called from within
+	 * a task running on the same executor.
+	 *
+	 * Folds combine the partial result of each chunk, in order, using
+	 * `monoid::append`. As append is associative, this gives the same result
+	 * as a sequential fold, though the monoid need not be commutative. Each
+	 * chunk is itself reduced as a balanced tree, as by `tree_foldMap`, and
+	 * skips the rest of its elements once part of it is absorbing.
+	 *
+	 * Containers with fewer elements than make a chunk are processed
+	 * entirely on the calling thread.
+	 *
+	 * A `chunked_seq` is split along its own chunks instead, each task
+	 * taking a run of consecutive ones, so no chunk is shared by two tasks.
+	 *
+	 * \par Dependencies
+	 * - `<vector>`
+	 * - `<deque>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<condition_variable>`
+	 * - `<atomic>`
+	 * - `<exception>`
+	 * - `<thread>`
+	 * - `<algorithm>`
+	 * - \ref executor
+	 * - \ref monoid
+	 * - \ref foldable
+	 * - \ref chunked_seq
+	 */
+
+	namespace _dtl {
+		// Smallest number of elements worth a task of its own
+		constexpr size_t par_grain = 2048;
+
+		inline size_t par_chunks(size_t n) {
+			size_t cap = 4 * std::max(std::thread::hardware_concurrency(), 1u);
+			return std::max(std::min(n / par_grain, size_t(cap)), size_t(1));
+		}
+
+		/* Book-keeping of one parallel call.
+		 *
+		 * Each chunk is run by whoever claims it first, the task queued for it
+		 * or the calling thread. Tasks that come too late find their chunk
+		 * claimed and do nothing, which is why the state is shared.
+		 */
+		template<typename F>
+		struct par_state {
+			par_state(size_t n, F& work)
+			: claimed(new std::atomic<bool>[n]), errors(n), remaining(n)
+			, work(&work) {
+				for(size_t i = 0; i < n; ++i)
+					claimed[i] = false;
+			}
+
+			void run(size_t i) noexcept {
+				if(claimed[i].exchange(true))
+					return;
+
+				try {
+					(*work)(i);
+				}
+				catch(...) {
+					errors[i] = std::current_exception();
+				}
+
+				if(--remaining == 0) {
+					std::lock_guard<std::mutex> lock(m);
+					cv.notify_all();
+				}
+			}
+
+			void wait() {
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [this](){ return remaining == 0; });
+
+				for(auto& e : errors) {
+					if(e)
+						std::rethrow_exception(e);
+				}
+			}
+
+			std::unique_ptr<std::atomic<bool>[]> claimed;
+			std::vector<std::exception_ptr> errors;
+			std::atomic<size_t> remaining;
+			std::mutex m;
+			std::condition_variable cv;
+
+			// Only called while the caller is waiting, so a pointer suffices
+			F* work;
+		};
+
+		// Run work(0) ... work(n-1), in parallel, and wait for all of them
+		template<typename Executor, typename F>
+		void par_run(Executor& ex, size_t n, F work) {
+			auto s = std::make_shared<par_state<F>>(n, work);
+
+			for(size_t i = 1; i < n; ++i)
+				ex.execute([s,i](){ s->run(i); });
+
+			for(size_t i = 0; i < n; ++i)
+				s->run(i);
+
+			s->wait();
+		}
+
+		inline size_t par_begin(size_t n, size_t chunks, size_t i) {
+			return n * i / chunks;
+		}
+
+		template<typename Executor, typename Fn, typename C, typename M>
+		M par_foldMap(Executor& ex, Fn& fn, const C& c) {
+			const size_t n = c.size();
+			const size_t k = par_chunks(n);
+
+			if(k == 1)
+				return tree_foldMap<M>(fn, c, 0, n);
+
+			std::vector<M> partial(k, monoid<M>::id());
+
+			par_run(ex, k, [&](size_t i) {
+				partial[i] = tree_foldMap<M>(
+					fn, c, par_begin(n, k, i), par_begin(n, k, i+1)
+				);
+			});
+
+			M r = std::move(partial[0]);
+			for(size_t i = 1; i < k; ++i)
+				r = monoid<M>::append(std::move(r), std::move(partial[i]));
+
+			return r;
+		}
+
+		// Tasks take whole chunks, which are contiguous and balanced enough
+		template<typename Executor, typename Fn, typename T, size_t N, typename M>
+		M par_foldMap_chunks(Executor& ex, Fn& fn, const chunked_seq<T,N>& s) {
+			std::vector<const std::vector<T>*> cs;
+			cs.reserve(s.chunk_count());
+			for(auto& c : s.chunks())
+				cs.push_back(&c);
+
+			const size_t n = cs.size();
+			const size_t k = std::min(par_chunks(s.size()), n);
+
+			auto fold_run = [&](size_t first, size_t last) {
+				M acc = monoid<M>::id();
+				for(size_t j = first; j < last; ++j) {
+					acc = monoid<M>::append(
+						std::move(acc),
+						tree_foldMap<M>(fn, *cs[j], 0, cs[j]->size())
+					);
+
+					if(is_absorbing(acc))
+						break;
+				}
+
+				return acc;
+			};
+
+			if(k <= 1)
+				return fold_run(0, n);
+
+			std::vector<M> partial(k, monoid<M>::id());
+
+			par_run(ex, k, [&](size_t i) {
+				partial[i] = fold_run(par_begin(n, k, i), par_begin(n, k, i+1));
+			});
+
+			M r = std::move(partial[0]);
+			for(size_t i = 1; i < k; ++i)
+				r = monoid<M>::append(std::move(r), std::move(partial[i]));
+
+			return r;
+		}
+
+		template<typename Map, typename Executor, typename KFn, typename VFn,
+			typename C>
+		Map par_foldMapByKey(Executor& ex, KFn& kf, VFn& vf, const C& c) {
+			const size_t n = c.size();
+			const size_t k = par_chunks(n);
+
+			std::vector<Map> partial(k);
+
+			par_run(ex, k, [&](size_t i) {
+				auto last = par_begin(n, k, i+1);
+				for(auto j = par_begin(n, k, i); j < last; ++j) {
+					keyed_append<Map>::append(partial[i], kf(c[j]), vf(c[j]));
+				}
+			});
+
+			// Later chunks are appended to earlier ones, key by key
+			Map r = std::move(partial[0]);
+			for(size_t i = 1; i < k; ++i) {
+				for(auto& kv : partial[i]) {
+					keyed_append<Map>::append(
+						r, kv.first, std::move(kv.second)
+					);
+				}
+			}
+
+			return r;
+		}
+
+		/*
+		 * Results can be written in place, if they can be default constructed
+		 * and R hands out real references. Proxies, like std::vector<bool>'s,
+		 * may share a word between neighbouring elements, and thus chunks.
+		 */
+		template<typename R, typename Executor, typename Fn, typename C>
+		R par_fmap(Executor& ex, Fn& fn, const C& c, std::true_type) {
+			const size_t n = c.size();
+			const size_t k = par_chunks(n);
+
+			R r(n);
+
+			par_run(ex, k, [&](size_t i) {
+				auto last = par_begin(n, k, i+1);
+				for(auto j = par_begin(n, k, i); j < last; ++j)
+					r[j] = fn(c[j]);
+			});
+
+			return r;
+		}
+
+		// Otherwise, each chunk is mapped separately, then concatenated
+		template<typename R, typename Executor, typename Fn, typename C>
+		R par_fmap(Executor& ex, Fn& fn, const C& c, std::false_type) {
+			const size_t n = c.size();
+			const size_t k = par_chunks(n);
+
+			std::vector<R> parts(k);
+
+			par_run(ex, k, [&](size_t i) {
+				auto last = par_begin(n, k, i+1);
+				for(auto j = par_begin(n, k, i); j < last; ++j)
+					parts[i].push_back(fn(c[j]));
+			});
+
+			R r = std::move(parts[0]);
+			for(size_t i = 1; i < k; ++i) {
+				r.insert(
+					r.end(),
+					std::make_move_iterator(parts[i].begin()),
+					std::make_move_iterator(parts[i].end())
+				);
+			}
+
+			return r;
+		}
+
+		template<typename Executor, typename Fn, typename R, typename C>
+		R par_fmap(Executor& ex, Fn& fn, const C& c) {
+			using U = typename R::value_type;
+
+			return par_fmap<R>(
+				ex, fn, c,
+				std::integral_constant<bool,
+					std::is_default_constructible<U>::value
+					&& std::is_move_assignable<U>::value
+					&& std::is_same<typename R::reference, U&>::value
+				>()
+			);
+		}
+	}
+
+	/**
+	 * Map `fn` over a vector, in parallel.
+	 *
+	 * Equivalent to `fmap(fn, v)`, except the elements are mapped by tasks
+	 * on `ex`. `fn` may be called concurrently, and in any order.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto squares = par_fmap(pool, [](int x){ return x*x; }, v);
+	 * \endcode
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename Fn,
+			typename T,
+			typename A,
+			typename U = result_of<Fn(const T&)>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	std::vector<U,Rebind<A,U>> par_fmap(
+			Executor& ex, Fn fn, const std::vector<T,A>& v) {
+		return _dtl::par_fmap<Executor,Fn,std::vector<U,Rebind<A,U>>>(
+			ex, fn, v
+		);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename Fn,
+			typename T,
+			typename A,
+			typename U = result_of<Fn(const T&)>,
+			typename Au
+				= typename std::allocator_traits<A>::template rebind_alloc<U>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	std::deque<U,Au> par_fmap(Executor& ex, Fn fn, const std::deque<T,A>& d) {
+		return _dtl::par_fmap<Executor,Fn,std::deque<U,Au>>(ex, fn, d);
+	}
+
+	/**
+	 * Map every element of a vector to a monoid and fold, in parallel.
+	 *
+	 * Gives the same result as `foldMap(fn, v)`. `fn` may be called
+	 * concurrently, and in any order, but the results are combined in the
+	 * order of the elements.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto total = par_foldMap(pool, ftl::sum<int>, v);
+	 * \endcode
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename Fn,
+			typename T,
+			typename A,
+			typename M = plain_type<result_of<Fn(const T&)>>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	M par_foldMap(Executor& ex, Fn fn, const std::vector<T,A>& v) {
+		static_assert(
+			Monoid<M>(),
+			"The result of Fn(T) is not an instance of Monoid."
+		);
+
+		return _dtl::par_foldMap<Executor,Fn,std::vector<T,A>,M>(ex, fn, v);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename Fn,
+			typename T,
+			typename A,
+			typename M = plain_type<result_of<Fn(const T&)>>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	M par_foldMap(Executor& ex, Fn fn, const std::deque<T,A>& d) {
+		static_assert(
+			Monoid<M>(),
+			"The result of Fn(T) is not an instance of Monoid."
+		);
+
+		return _dtl::par_foldMap<Executor,Fn,std::deque<T,A>,M>(ex, fn, d);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename Fn,
+			typename T,
+			size_t N,
+			typename M = plain_type<result_of<Fn(const T&)>>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	M par_foldMap(Executor& ex, Fn fn, const chunked_seq<T,N>& s) {
+		static_assert(
+			Monoid<M>(),
+			"The result of Fn(T) is not an instance of Monoid."
+		);
+
+		return _dtl::par_foldMap_chunks<Executor,Fn,T,N,M>(ex, fn, s);
+	}
+
+	/**
+	 * Fold a vector per key into a map, in parallel.
+	 *
+	 * Gives the same result as `foldMapByKey<Map>(keyFn, valFn, v)`. Each
+	 * chunk is folded into a map of its own, and the maps are then merged in
+	 * order, appending the values of keys found in more than one chunk.
+	 * `keyFn` and `valFn` may be called concurrently, and in any order.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *   auto counts = par_foldMapByKey<std::unordered_map>(
+	 *       pool, [](int x){ return x % 10; }, [](int){ return sum(1); }, v
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			template<typename...> class Map,
+			typename Executor,
+			typename KFn,
+			typename VFn,
+			typename T,
+			typename A,
+			typename K = plain_type<result_of<KFn(const T&)>>,
+			typename M = plain_type<result_of<VFn(const T&)>>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	Map<K,M> par_foldMapByKey(
+			Executor& ex, KFn keyFn, VFn valFn, const std::vector<T,A>& v) {
+		static_assert(
+			Monoid<M>(),
+			"The result of VFn(T) is not an instance of Monoid."
+		);
+
+		return _dtl::par_foldMapByKey<Map<K,M>>(ex, keyFn, valFn, v);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			template<typename...> class Map,
+			typename Executor,
+			typename KFn,
+			typename VFn,
+			typename T,
+			typename A,
+			typename K = plain_type<result_of<KFn(const T&)>>,
+			typename M = plain_type<result_of<VFn(const T&)>>,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	Map<K,M> par_foldMapByKey(
+			Executor& ex, KFn keyFn, VFn valFn, const std::deque<T,A>& d) {
+		static_assert(
+			Monoid<M>(),
+			"The result of VFn(T) is not an instance of Monoid."
+		);
+
+		return _dtl::par_foldMapByKey<Map<K,M>>(ex, keyFn, valFn, d);
+	}
+
+	/**
+	 * Fold a vector of monoids, in parallel.
+	 *
+	 * Gives the same result as `fold(v)`.
+	 *
+	 * \tparam Executor must satisfy \ref executorpg
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename T,
+			typename A,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	T par_fold(Executor& ex, const std::vector<T,A>& v) {
+		return par_foldMap(ex, id, v);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename T,
+			typename A,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	T par_fold(Executor& ex, const std::deque<T,A>& d) {
+		return par_foldMap(ex, id, d);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup parallel
+	 */
+	template<
+			typename Executor,
+			typename T,
+			size_t N,
+			typename = Requires<is_executor<Executor>::value>
+	>
+	T par_fold(Executor& ex, const chunked_seq<T,N>& s) {
+		return par_foldMap(ex, id, s);
+	}
+}
+
+#endif
+
@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERSISTENT_MAP_H
+#define FTL_PERSISTENT_MAP_H
+
+#include <utility>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <initializer_list>
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "implementation/shared_node.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup pmap Persistent Map
+	 *
+	 * Ordered associative container whose copies share structure.
+	 *
+	 * \code
+	 *   #include <ftl/persistent_map.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::persistent_map`:
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \par Dependencies
+	 * - `<vector>`
+	 * - `<memory>`
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	namespace _dtl {
+		struct pm_emplace {};
+
+		template<typename K, typename V>
+		struct pm_node {
+			template<typename...Args>
+			explicit pm_node(pm_emplace, Args&&...args)
+			: kv(std::forward<Args>(args)...) {}
+
+			std::pair<const K,V> kv;
+			std::shared_ptr<pm_node> left;
+			std::shared_ptr<pm_node> right;
+			int height = 1;
+		};
+	}
+
+	/**
+	 * Ordered map with constant time copies.
+	 *
+	 * Key/value pairs are kept in an AVL tree of reference counted nodes.
+	 * Copying a `persistent_map` only copies the pointer to the root; the
+	 * copies then share every node until one of them is modified. A
+	 * modification copies the nodes on the path from the root to the changed
+	 * one, \f$ O(log(n)) \f$ of them, and leaves every other copy as it was.
+	 * Nodes that are not shared with any other map are modified in place.
+	 *
+	 * The interface is a subset of `std::map`'s, minus anything that hands
+	 * out mutable references into the tree, since those could not tell
+	 * whether the node they point to is shared. Use `insert_or_assign` to
+	 * change the value of a key. Any modification invalidates iterators into
+	 * the modified map, but never into other copies.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   persistent_map<int,std::string> m{{1,"one"},{2,"two"}};
+	 *   auto n = m;
+	 *
+	 *   n.insert_or_assign(3, "three");
+	 *   n.erase(1);
+	 *   // m still holds 1 and 2, n holds 2 and 3
+	 * \endcode
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename V, typename C = std::less<K>>
+	class persistent_map {
+		using node = _dtl::pm_node<K,V>;
+		using node_ptr = std::shared_ptr<node>;
+
+		template<typename, typename, typename>
+		friend class persistent_map;
+
+		template<typename>
+		friend struct functor;
+
+		template<typename>
+		friend struct foldable;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<const K,V>;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using key_compare = C;
+		using reference = const value_type&;
+		using const_reference = const value_type&;
+
+		/**
+		 * In-order iterator over the key/value pairs.
+		 *
+		 * Keeps the path of nodes still left to visit, so it is somewhat
+		 * more expensive to copy than most iterators.
+		 */
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::pair<const K,V>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			const_iterator() = default;
+
+			reference operator* () const {
+				return path.back()->kv;
+			}
+
+			pointer operator-> () const {
+				return &path.back()->kv;
+			}
+
+			const_iterator& operator++ () {
+				auto n = path.back();
+				path.pop_back();
+				descend(n->right.get());
+				return *this;
+			}
+
+			const_iterator operator++ (int) {
+				auto it = *this;
+				++*this;
+				return it;
+			}
+
+			bool operator== (const const_iterator& it) const noexcept {
+				return current() == it.current();
+			}
+
+			bool operator!= (const const_iterator& it) const noexcept {
+				return !(*this == it);
+			}
+
+		private:
+			friend class persistent_map;
+
+			const node* current() const noexcept {
+				return path.empty() ? nullptr : path.back();
+			}
+
+			void descend(const node* n) {
+				for(; n; n = n->left.get())
+					path.push_back(n);
+			}
+
+			std::vector<const node*> path;
+		};
+
+		using iterator = const_iterator;
+
+		persistent_map() = default;
+		persistent_map(const persistent_map&) = default;
+
+		persistent_map(persistent_map&& m) noexcept
+		: root(std::move(m.root)), length(m.length), cmp(std::move(m.cmp)) {
+			m.length = 0;
+		}
+
+		explicit persistent_map(const C& cmp) : cmp(cmp) {}
+
+		persistent_map(std::initializer_list<value_type> l, const C& cmp = C())
+		: cmp(cmp) {
+			for(auto& kv : l)
+				insert(kv);
+		}
+
+		template<
+				typename It,
+				typename = Requires<std::is_convertible<
+					typename std::iterator_traits<It>::iterator_category,
+					std::input_iterator_tag
+				>::value>
+		>
+		persistent_map(It first, It last, const C& cmp = C()) : cmp(cmp) {
+			for(; first != last; ++first)
+				insert(*first);
+		}
+
+		persistent_map& operator= (const persistent_map&) = default;
+
+		persistent_map& operator= (persistent_map&& m) noexcept {
+			if(this != &m) {
+				root = std::move(m.root);
+				length = m.length;
+				cmp = std::move(m.cmp);
+				m.length = 0;
+			}
+
+			return *this;
+		}
+
+		size_type size() const noexcept {
+			return length;
+		}
+
+		bool empty() const noexcept {
+			return length == 0;
+		}
+
+		key_compare key_comp() const {
+			return cmp;
+		}
+
+		const_iterator begin() const {
+			const_iterator it;
+			it.descend(root.get());
+			return it;
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator();
+		}
+
+		const_iterator find(const K& k) const {
+			const_iterator it;
+			for(const node* n = root.get(); n;) {
+				if(cmp(k, n->kv.first)) {
+					it.path.push_back(n);
+					n = n->left.get();
+				}
+				else if(cmp(n->kv.first, k)) {
+					n = n->right.get();
+				}
+				else {
+					it.path.push_back(n);
+					return it;
+				}
+			}
+
+			return end();
+		}
+
+		size_type count(const K& k) const {
+			return lookup(k) ? 1 : 0;
+		}
+
+		/// Value associated with `k`, throws `std::out_of_range` if none is.
+		const V& at(const K& k) const {
+			auto n = lookup(k);
+			if(!n)
+				throw std::out_of_range("persistent_map::at");
+
+			return n->kv.second;
+		}
+
+		/**
+		 * Insert a key/value pair, unless the key is already present.
+		 *
+		 * Leaves the tree untouched, sharing and all, if it is.
+		 *
+		 * \return `true` if the pair was inserted.
+		 */
+		bool insert(const value_type& kv) {
+			if(lookup(kv.first))
+				return false;
+
+			put(root, kv.first, kv.second);
+			return true;
+		}
+
+		/**
+		 * Associate `v` with `k`, whether or not `k` is already present.
+		 *
+		 * \return `true` if `k` was not present before.
+		 */
+		bool insert_or_assign(const K& k, V v) {
+			auto n = length;
+			put(root, k, std::move(v));
+			return length != n;
+		}
+
+		/// Remove the value associated with `k`, if there is one.
+		size_type erase(const K& k) {
+			if(!lookup(k))
+				return 0;
+
+			erase_at(root, k);
+			--length;
+			return 1;
+		}
+
+		void clear() noexcept {
+			root.reset();
+			length = 0;
+		}
+
+	private:
+		const node* lookup(const K& k) const {
+			const node* n = root.get();
+			while(n) {
+				if(cmp(k, n->kv.first))
+					n = n->left.get();
+				else if(cmp(n->kv.first, k))
+					n = n->right.get();
+				else
+					break;
+			}
+
+			return n;
+		}
+
+		template<typename V_>
+		void put(node_ptr& t, const K& k, V_&& v) {
+			if(!t) {
+				t = std::make_shared<node>(
+						_dtl::pm_emplace(), k, std::forward<V_>(v)
+				);
+				++length;
+				return;
+			}
+
+			auto& n = _dtl::own_node(t);
+			if(cmp(k, n.kv.first)) {
+				put(n.left, k, std::forward<V_>(v));
+			}
+			else if(cmp(n.kv.first, k)) {
+				put(n.right, k, std::forward<V_>(v));
+			}
+			else {
+				n.kv.second = std::forward<V_>(v);
+				return;
+			}
+
+			rebalance(t);
+		}
+
+		void erase_at(node_ptr& t, const K& k) {
+			auto& n = _dtl::own_node(t);
+			if(cmp(k, n.kv.first)) {
+				erase_at(n.left, k);
+			}
+			else if(cmp(n.kv.first, k)) {
+				erase_at(n.right, k);
+			}
+			else if(!n.left) {
+				t = n.right;
+				return;
+			}
+			else if(!n.right) {
+				t = n.left;
+				return;
+			}
+			else {
+				// Keys are immutable, so relink the successor node instead
+				auto s = take_min(n.right);
+				s->left = std::move(n.left);
+				s->right = std::move(n.right);
+				t = std::move(s);
+			}
+
+			rebalance(t);
+		}
+
+		// Detach the leftmost node of t, which is returned unshared
+		static node_ptr take_min(node_ptr& t) {
+			auto& n = _dtl::own_node(t);
+			if(!n.left) {
+				auto m = std::move(t);
+				t = m->right;
+				return m;
+			}
+
+			auto m = take_min(n.left);
+			rebalance(t);
+			return m;
+		}
+
+		static int height(const node_ptr& n) noexcept {
+			return n ? n->height : 0;
+		}
+
+		static void update(node& n) noexcept {
+			n.height = 1 + std::max(height(n.left), height(n.right));
+		}
+
+		// The rotations expect t to be unshared already
+		static void rotate_left(node_ptr& t) {
+			_dtl::own_node(t->right);
+			auto r = std::move(t->right);
+			t->right = std::move(r->left);
+			update(*t);
+			r->left = std::move(t);
+			update(*r);
+			t = std::move(r);
+		}
+
+		static void rotate_right(node_ptr& t) {
+			_dtl::own_node(t->left);
+			auto l = std::move(t->left);
+			t->left = std::move(l->right);
+			update(*t);
+			l->right = std::move(t);
+			update(*l);
+			t = std::move(l);
+		}
+
+		static void rebalance(node_ptr& t) {
+			auto& n = *t;
+			auto balance = height(n.left) - height(n.right);
+
+			if(balance > 1) {
+				if(height(n.left->left) < height(n.left->right)) {
+					_dtl::own_node(n.left);
+					rotate_left(n.left);
+				}
+
+				rotate_right(t);
+			}
+			else if(balance < -1) {
+				if(height(n.right->right) < height(n.right->left)) {
+					_dtl::own_node(n.right);
+					rotate_right(n.right);
+				}
+
+				rotate_left(t);
+			}
+			else {
+				update(n);
+			}
+		}
+
+		node_ptr root;
+		size_type length = 0;
+		C cmp;
+	};
+
+	template<typename K, typename V, typename C>
+	struct parametric_type_traits<persistent_map<K,V,C>> {
+		using value_type = V;
+
+		template<typename U>
+		using rebind = persistent_map<K,U,C>;
+	};
+
+	/**
+	 * Monoid instance for persistent maps.
+	 *
+	 * Identity element is the empty map, monoid operation is left biased
+	 * union: keys present in both operands keep their value from the left.
+	 * The result shares the left operand's nodes wherever the right one did
+	 * not add anything.
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename V, typename C>
+	struct monoid<persistent_map<K,V,C>> {
+		static persistent_map<K,V,C> id() {
+			return persistent_map<K,V,C>();
+		}
+
+		static persistent_map<K,V,C> append(
+				persistent_map<K,V,C> m1,
+				const persistent_map<K,V,C>& m2) {
+
+			if(m1.empty())
+				return m2;
+
+			for(auto& kv : m2)
+				m1.insert(kv);
+
+			return m1;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Functor instance for persistent maps.
+	 *
+	 * Maps over the values, keeping the keys. As the keys do not change, the
+	 * result is built with the exact shape of the original tree, without any
+	 * comparisons or rebalancing.
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename T, typename C>
+	struct functor<persistent_map<K,T,C>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = persistent_map<K,U,C>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			Map<U> rm(m.cmp);
+			rm.root = copy_nodes<U>(f, m.root.get());
+			rm.length = m.length;
+
+			return rm;
+		}
+
+		/**
+		 * Endofunction mapped over a temporary.
+		 *
+		 * Assigns the results in place, copying only the nodes `m` still
+		 * shares with other maps.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			map_nodes(f, m.root);
+			return std::move(m);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename U, typename F>
+		static std::shared_ptr<_dtl::pm_node<K,U>> copy_nodes(
+				F& f, const _dtl::pm_node<K,T>* n) {
+
+			if(!n)
+				return nullptr;
+
+			auto r = std::make_shared<_dtl::pm_node<K,U>>(
+					_dtl::pm_emplace(), n->kv.first, f(n->kv.second)
+			);
+			r->left = copy_nodes<U>(f, n->left.get());
+			r->right = copy_nodes<U>(f, n->right.get());
+			r->height = n->height;
+
+			return r;
+		}
+
+		template<typename F>
+		static void map_nodes(F& f, std::shared_ptr<_dtl::pm_node<K,T>>& t) {
+			if(!t)
+				return;
+
+			auto& n = _dtl::own_node(t);
+			n.kv.second = f(std::move(n.kv.second));
+			map_nodes(f, n.left);
+			map_nodes(f, n.right);
+		}
+	};
+
+	/**
+	 * Foldable instance for persistent maps.
+	 *
+	 * Folds over the values, in key order.
+	 *
+	 * \ingroup pmap
+	 */
+	template<typename K, typename T, typename C>
+	struct foldable<persistent_map<K,T,C>>
+	: deriving_fold<persistent_map<K,T,C>>
+	, deriving_foldMap<persistent_map<K,T,C>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const persistent_map<K,T,C>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const persistent_map<K,T,C>& m) {
+			return foldr_nodes(f, std::move(z), m.root.get());
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename F, typename U>
+		static U foldr_nodes(F& f, U z, const _dtl::pm_node<K,T>* n) {
+			if(!n)
+				return z;
+
+			z = foldr_nodes(f, std::move(z), n->right.get());
+			z = f(n->kv.second, std::move(z));
+			return foldr_nodes(f, std::move(z), n->left.get());
+		}
+	};
+}
+
+#endif
+
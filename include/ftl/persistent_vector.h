@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERSISTENT_VECTOR_H
+#define FTL_PERSISTENT_VECTOR_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <initializer_list>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "implementation/shared_node.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup pvector Persistent Vector
+	 *
+	 * Sequence container whose copies share structure.
+	 *
+	 * \code
+	 *   #include <ftl/persistent_vector.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::persistent_vector`:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Dependencies
+	 * - `<vector>`
+	 * - `<memory>`
+	 * - \ref foldable
+	 * - \ref monad
+	 */
+
+	namespace _dtl {
+		constexpr unsigned pv_bits = 5;
+		constexpr size_t pv_width = size_t(1) << pv_bits;
+		constexpr size_t pv_mask = pv_width - 1;
+
+		/*
+		 * A node of the trie. Inner nodes only use children, leaves only
+		 * values.
+		 */
+		template<typename T>
+		struct pv_node {
+			std::vector<std::shared_ptr<pv_node>> children;
+			std::vector<T> values;
+		};
+	}
+
+	/**
+	 * Sequence container with constant time copies.
+	 *
+	 * Elements are stored in the leaves of a 32-way trie, indexed by the bits
+	 * of their position, with the last leaf kept aside for quick appends.
+	 * Copying a `persistent_vector` only copies the two pointers to all that;
+	 * the copies then share every node until one of them is modified. A
+	 * modification copies the at most \f$ log_{32}(n) \f$ nodes on the path
+	 * to the element, leaving every other copy as it was.
+	 *
+	 * This makes it cheap to keep old versions around, to hand a snapshot to
+	 * another thread, or to build a new sequence out of an old one, which a
+	 * pure functional style does a lot of. When a node is not shared at all,
+	 * it is simply modified in place, so building a vector from scratch does
+	 * not pay for the persistence.
+	 *
+	 * Indexing and modifying an element are \f$ O(log_{32}(n)) \f$,
+	 * appending an element is amortised constant time.
+	 *
+	 * Elements can only be accessed through `const` references; use `set` to
+	 * replace one. Any modification invalidates iterators into the modified
+	 * container, but never into other copies.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref eq, if `T` is
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   persistent_vector<int> v{1,2,3};
+	 *   auto w = v;
+	 *
+	 *   w.set(0, 5);
+	 *   w.push_back(4);
+	 *   // v == {1,2,3}, w == {5,2,3,4}, sharing the node holding 2 and 3
+	 * \endcode
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	class persistent_vector {
+		using node = _dtl::pv_node<T>;
+		using node_ptr = std::shared_ptr<node>;
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const T&;
+		using const_reference = const T&;
+
+		/**
+		 * Bidirectional iterator over the elements.
+		 *
+		 * Remembers the last leaf it looked in, so walking the sequence in
+		 * order only descends the trie once every 32 elements.
+		 */
+		class const_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+
+			reference operator* () const {
+				if(!leaf || (i & ~_dtl::pv_mask) != base) {
+					leaf = &v->leaf_for(i);
+					base = i & ~_dtl::pv_mask;
+				}
+
+				return (*leaf)[i & _dtl::pv_mask];
+			}
+
+			pointer operator-> () const {
+				return &**this;
+			}
+
+			const_iterator& operator++ () noexcept {
+				++i;
+				return *this;
+			}
+
+			const_iterator operator++ (int) noexcept {
+				auto it = *this;
+				++i;
+				return it;
+			}
+
+			const_iterator& operator-- () noexcept {
+				--i;
+				return *this;
+			}
+
+			const_iterator operator-- (int) noexcept {
+				auto it = *this;
+				--i;
+				return it;
+			}
+
+			bool operator== (const const_iterator& it) const noexcept {
+				return i == it.i && v == it.v;
+			}
+
+			bool operator!= (const const_iterator& it) const noexcept {
+				return !(*this == it);
+			}
+
+		private:
+			friend class persistent_vector;
+
+			const_iterator(const persistent_vector* v, size_type i) noexcept
+			: v(v), i(i) {}
+
+			const persistent_vector* v = nullptr;
+			size_type i = 0;
+
+			mutable const std::vector<T>* leaf = nullptr;
+			mutable size_type base = 0;
+		};
+
+		using iterator = const_iterator;
+		using reverse_iterator = std::reverse_iterator<const_iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+		persistent_vector() = default;
+		persistent_vector(const persistent_vector&) = default;
+
+		persistent_vector(persistent_vector&& v) noexcept
+		: root(std::move(v.root)), tail(std::move(v.tail))
+		, count(v.count), shift(v.shift) {
+			v.count = 0;
+			v.shift = _dtl::pv_bits;
+		}
+
+		persistent_vector(std::initializer_list<T> l) {
+			for(auto& x : l)
+				push_back(x);
+		}
+
+		template<
+				typename It,
+				typename = Requires<std::is_convertible<
+					typename std::iterator_traits<It>::iterator_category,
+					std::input_iterator_tag
+				>::value>
+		>
+		persistent_vector(It first, It last) {
+			for(; first != last; ++first)
+				push_back(*first);
+		}
+
+		persistent_vector& operator= (const persistent_vector&) = default;
+
+		persistent_vector& operator= (persistent_vector&& v) noexcept {
+			if(this != &v) {
+				root = std::move(v.root);
+				tail = std::move(v.tail);
+				count = v.count;
+				shift = v.shift;
+				v.count = 0;
+				v.shift = _dtl::pv_bits;
+			}
+
+			return *this;
+		}
+
+		size_type size() const noexcept {
+			return count;
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		const T& operator[] (size_type i) const {
+			return leaf_for(i)[i & _dtl::pv_mask];
+		}
+
+		/// Bounds checked element access, throws `std::out_of_range`.
+		const T& at(size_type i) const {
+			if(i >= count)
+				throw std::out_of_range("persistent_vector::at");
+
+			return (*this)[i];
+		}
+
+		const T& front() const {
+			return (*this)[0];
+		}
+
+		const T& back() const {
+			return tail->values.back();
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(this, 0);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(this, count);
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		reverse_iterator rbegin() const noexcept {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() const noexcept {
+			return reverse_iterator(begin());
+		}
+
+		void push_back(const T& x) {
+			emplace_back(x);
+		}
+
+		void push_back(T&& x) {
+			emplace_back(std::move(x));
+		}
+
+		/// Append an element constructed from `args`.
+		template<typename...Args>
+		void emplace_back(Args&&...args) {
+			if(tail && tail->values.size() < _dtl::pv_width) {
+				_dtl::own_node(tail).values.emplace_back(
+						std::forward<Args>(args)...
+				);
+			}
+			else {
+				auto t = std::make_shared<node>();
+				t->values.reserve(_dtl::pv_width);
+				t->values.emplace_back(std::forward<Args>(args)...);
+
+				if(tail)
+					push_tail();
+
+				tail = std::move(t);
+			}
+
+			++count;
+		}
+
+		/**
+		 * Replace the element at position `i`.
+		 *
+		 * Copies any node on the way down that is shared with another
+		 * container.
+		 */
+		void set(size_type i, T x) {
+			if(i >= tail_offset()) {
+				_dtl::own_node(tail).values[i & _dtl::pv_mask] = std::move(x);
+				return;
+			}
+
+			node_ptr* n = &root;
+			for(unsigned level = shift; level > 0; level -= _dtl::pv_bits) {
+				n = &_dtl::own_node(*n).children[(i >> level) & _dtl::pv_mask];
+			}
+
+			_dtl::own_node(*n).values[i & _dtl::pv_mask] = std::move(x);
+		}
+
+		void clear() noexcept {
+			root.reset();
+			tail.reset();
+			count = 0;
+			shift = _dtl::pv_bits;
+		}
+
+	private:
+		// Index of the first element in the tail
+		size_type tail_offset() const noexcept {
+			return count < _dtl::pv_width
+				? 0 : ((count - 1) >> _dtl::pv_bits) << _dtl::pv_bits;
+		}
+
+		const std::vector<T>& leaf_for(size_type i) const {
+			if(i >= tail_offset())
+				return tail->values;
+
+			const node* n = root.get();
+			for(unsigned level = shift; level > 0; level -= _dtl::pv_bits) {
+				n = n->children[(i >> level) & _dtl::pv_mask].get();
+			}
+
+			return n->values;
+		}
+
+		// Move the (full) tail into the trie, growing it a level if needed
+		void push_tail() {
+			if(!root)
+				root = std::make_shared<node>();
+
+			if((count >> _dtl::pv_bits) > (size_type(1) << shift)) {
+				auto r = std::make_shared<node>();
+				r->children.push_back(root);
+				r->children.push_back(new_path(shift, tail));
+
+				root = std::move(r);
+				shift += _dtl::pv_bits;
+			}
+			else {
+				push_tail(shift, root);
+			}
+		}
+
+		void push_tail(unsigned level, node_ptr& parent) {
+			auto& p = _dtl::own_node(parent);
+
+			if(level == _dtl::pv_bits) {
+				p.children.push_back(tail);
+				return;
+			}
+
+			auto sub = ((count - 1) >> level) & _dtl::pv_mask;
+			if(sub < p.children.size())
+				push_tail(level - _dtl::pv_bits, p.children[sub]);
+			else
+				p.children.push_back(new_path(level - _dtl::pv_bits, tail));
+		}
+
+		static node_ptr new_path(unsigned level, const node_ptr& n) {
+			if(level == 0)
+				return n;
+
+			auto r = std::make_shared<node>();
+			r->children.push_back(new_path(level - _dtl::pv_bits, n));
+
+			return r;
+		}
+
+		node_ptr root;
+		node_ptr tail;
+		size_type count = 0;
+		unsigned shift = _dtl::pv_bits;
+	};
+
+	/**
+	 * Equality comparison of persistent vectors.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	bool operator== (
+			const persistent_vector<T>& a, const persistent_vector<T>& b) {
+
+		if(a.size() != b.size())
+			return false;
+
+		return std::equal(a.begin(), a.end(), b.begin());
+	}
+
+	/// \ingroup pvector
+	template<typename T>
+	bool operator!= (
+			const persistent_vector<T>& a, const persistent_vector<T>& b) {
+		return !(a == b);
+	}
+
+	/**
+	 * Free function versions of `begin` and `end`, for argument dependent
+	 * lookup.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	typename persistent_vector<T>::const_iterator begin(
+			const persistent_vector<T>& v) noexcept {
+		return v.begin();
+	}
+
+	/// \ingroup pvector
+	template<typename T>
+	typename persistent_vector<T>::const_iterator end(
+			const persistent_vector<T>& v) noexcept {
+		return v.end();
+	}
+
+	template<typename T>
+	struct parametric_type_traits<persistent_vector<T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = persistent_vector<U>;
+	};
+
+	/**
+	 * Monoid instance for persistent vectors.
+	 *
+	 * Identity element is the empty vector, monoid operation is
+	 * concatenation. The result shares all of the left operand's nodes, so
+	 * appending is linear only in the length of the right operand.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct monoid<persistent_vector<T>> {
+		static persistent_vector<T> id() {
+			return persistent_vector<T>();
+		}
+
+		static persistent_vector<T> append(
+				persistent_vector<T> v1,
+				const persistent_vector<T>& v2) {
+
+			if(v1.empty())
+				return v2;
+
+			for(auto& x : v2)
+				v1.push_back(x);
+
+			return v1;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for persistent vectors.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct foldable<persistent_vector<T>>
+	: deriving_foldable<bidirectional_iterable<persistent_vector<T>>> {};
+
+	/**
+	 * Monad instance for persistent vectors.
+	 *
+	 * Equivalent to `monad<std::vector<T>>`.
+	 *
+	 * \ingroup pvector
+	 */
+	template<typename T>
+	struct monad<persistent_vector<T>>
+	: deriving_pure<persistent_vector<T>>
+	, deriving_join<in_terms_of_bind<persistent_vector<T>>>
+	, deriving_apply<in_terms_of_bind<persistent_vector<T>>> {
+
+		template<typename U>
+		using pvector = persistent_vector<U>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static pvector<U> map(F&& f, const pvector<T>& v) {
+			pvector<U> r;
+			for(auto& x : v)
+				r.push_back(f(x));
+
+			return r;
+		}
+
+		/**
+		 * Endofunction mapped over a temporary.
+		 *
+		 * Replaces the elements one by one, which copies only the nodes `v`
+		 * still shares with other vectors.
+		 */
+		template<
+				typename F,
+				typename = Requires<std::is_same<T, result_of<F(T)>>::value>
+		>
+		static pvector<T> map(F&& f, pvector<T>&& v) {
+			for(size_t i = 0; i < v.size(); ++i)
+				v.set(i, f(v[i]));
+
+			return std::move(v);
+		}
+
+		template<
+				typename F,
+				typename Cu = result_of<F(T)>,
+				typename U = Value_type<Cu>
+		>
+		static pvector<U> bind(const pvector<T>& v, F&& f) {
+			pvector<U> r;
+			for(auto& x : v) {
+				auto c = f(x);
+				for(auto& y : c)
+					r.push_back(std::move(y));
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
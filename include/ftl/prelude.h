@@ -166,14 +166,19 @@ namespace ftl {
 			return val;
 		}
 
-		T& operator*() noexcept {
+		T& operator*() & noexcept {
 			return val;
 		}
 
-		constexpr const T& operator*() const noexcept {
+		constexpr const T& operator*() const & noexcept {
 			return val;
 		}
 
+		/// Moves the value out of a temporary.
+		T&& operator*() && noexcept {
+			return std::move(val);
+		}
+
 		T* operator->() noexcept {
 			return std::addressof(val);
 		}
@@ -285,15 +290,30 @@ namespace ftl {
 	 * returns a function that takes another one and _then_ returns the
 	 * answer.
 	 *
-	 * \note This operation is actually exactly equivalent of wrapping the
-	 *       function in an ftl::function object, as those support curried
-	 *       calling by default.
+	 * The result is a statically typed function object; partially applying
+	 * it stores the given arguments by value, without allocating or type
+	 * erasing anything. It converts to an `ftl::function` of the same
+	 * signature if need be.
+	 *
+	 * \code
+	 *   int add(int x, int y, int z);
+	 *
+	 *   auto f = ftl::curry(add);
+	 *   // f(1)(2)(3) == f(1,2)(3) == add(1,2,3), all inlineable calls
+	 *
+	 *   ftl::function<int(int,int,int)> g = f; // Type erased
+	 * \endcode
 	 *
 	 * \ingroup prelude
 	 */
 	template<typename R, typename P1, typename P2, typename...Ps>
-	function<R(P1,P2,Ps...)> curry(R (*f) (P1, P2, Ps...)) {
-		return function<R(P1,P2,Ps...)>(f);
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::monomorphic_curried<R (*) (P1, P2, Ps...), R, P1, P2, Ps...>
+#else
+	ImplementationDefined
+#endif
+	curry(R (*f) (P1, P2, Ps...)) {
+		return f;
 	}
 
 	/**
@@ -302,8 +322,13 @@ namespace ftl {
 	 * \ingroup prelude
 	 */
 	template<typename R, typename P1, typename P2, typename...Ps>
-	function<R(P1,P2,Ps...)> curry(const std::function<R(P1,P2,Ps...)>& f) {
-		return function<R(P1,P2,Ps...)>(f);
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::monomorphic_curried<std::function<R(P1,P2,Ps...)>, R, P1, P2, Ps...>
+#else
+	ImplementationDefined
+#endif
+	curry(const std::function<R(P1,P2,Ps...)>& f) {
+		return f;
 	}
 
 	/**
@@ -381,11 +406,36 @@ namespace ftl {
 		};
 	}
 
+	namespace _dtl {
+		// The statically typed composition of f and g
+		template<typename F, typename G>
+		struct composed {
+			F f;
+			G g;
+
+			template<typename...Args>
+			constexpr auto operator() (Args&&...args) const &
+			-> decltype(f(g(std::forward<Args>(args)...))) {
+				return f(g(std::forward<Args>(args)...));
+			}
+
+			template<typename...Args>
+			auto operator() (Args&&...args) &&
+			-> decltype(std::move(f)(std::move(g)(std::forward<Args>(args)...))) {
+				return std::move(f)(std::move(g)(std::forward<Args>(args)...));
+			}
+		};
+	}
+
 	/**
 	 * Function composition first base case.
 	 *
 	 * Composes an arbitrary function object with a function pointer.
 	 *
+	 * The result is a statically typed function object, supporting curried
+	 * calling just like the result of `curry`. Calling it invokes `fn` and
+	 * `f` directly, rather than through any type erasure.
+	 *
 	 * \ingroup prelude
 	 */
 	template<
@@ -393,10 +443,13 @@ namespace ftl {
 		typename A,
 		typename B = typename std::result_of<F(A)>::type,
 		typename...Ps>
-	function<B(Ps...)> compose(F f, A (*fn)(Ps...)) {
-		return [f,fn](Ps...ps) {
-			return f(fn(std::forward<Ps>(ps)...));
-		};
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::monomorphic_curried<_dtl::composed<F,A (*)(Ps...)>, B, Ps...>
+#else
+	ImplementationDefined
+#endif
+	compose(F f, A (*fn)(Ps...)) {
+		return _dtl::composed<F,A (*)(Ps...)>{std::move(f), fn};
 	}
 
 	/**
@@ -404,16 +457,83 @@ namespace ftl {
 	 *
 	 * Composes an arbitrary function object with an ftl::function.
 	 *
+	 * As with the first base case, only `fn` itself is type erased.
+	 *
+	 * \ingroup prelude
+	 */
+	template<
+		typename F,
+		typename A,
+		typename B = typename std::result_of<F(A)>::type,
+		typename...Ps>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::monomorphic_curried<_dtl::composed<F,function<A(Ps...)>>, B, Ps...>
+#else
+	ImplementationDefined
+#endif
+	compose(F f, function<A(Ps...)> fn) {
+		return _dtl::composed<F,function<A(Ps...)>>{std::move(f), std::move(fn)};
+	}
+
+	/**
+	 * Function composition third base case.
+	 *
+	 * Composes an arbitrary function object with a curried function.
+	 *
 	 * \ingroup prelude
 	 */
 	template<
 		typename F,
+		typename G,
 		typename A,
 		typename B = typename std::result_of<F(A)>::type,
 		typename...Ps>
-	function<B(Ps...)> compose(F f, function<A(Ps...)> fn) {
-		return [f,fn](Ps...ps) {
-			return f(fn(std::forward<Ps>(ps)...));
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::monomorphic_curried<
+		_dtl::composed<F,_dtl::monomorphic_curried<G,A,Ps...>>, B, Ps...
+	>
+#else
+	ImplementationDefined
+#endif
+	compose(F f, _dtl::monomorphic_curried<G,A,Ps...> fn) {
+		return _dtl::composed<F,_dtl::monomorphic_curried<G,A,Ps...>>{
+			std::move(f), std::move(fn)
+		};
+	}
+
+	/**
+	 * Function composition of arbitrary function objects.
+	 *
+	 * Used when `g` is not monomorphic, such as a lambda or a generic function
+	 * object. The result is a function object that forwards any arguments to
+	 * `g`, and its result to `f`, and is as easily inlined as the two are.
+	 *
+	 * Example:
+	 * \code
+	 *   auto f = [](int x){ return x+1; };
+	 *   auto g = [](int x){ return x*2; };
+	 *
+	 *   std::vector<int> v{1,2,3};
+	 *
+	 *   // One pass over v, in place, with neither call type erased
+	 *   auto r = ftl::compose(f, g) % std::move(v);
+	 *   // r == {3,5,7}
+	 * \endcode
+	 *
+	 * \ingroup prelude
+	 */
+	template<
+		typename F,
+		typename G,
+		typename = Requires<!is_monomorphic<plain_type<G>>::value>>
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr _dtl::composed<plain_type<F>,plain_type<G>>
+#else
+	ImplementationDefined
+#endif
+	compose(F&& f, G&& g) {
+		return _dtl::composed<plain_type<F>,plain_type<G>>{
+			std::forward<F>(f), std::forward<G>(g)
 		};
 	}
 
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_RC_H
+#define FTL_RC_H
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include "concepts/monoid.h"
+#include "concepts/monad.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup rc Rc
+	 *
+	 * A reference counted pointer for single threaded use, and its concept
+	 * instances.
+	 *
+	 * \code
+	 *   #include <ftl/rc.h>
+	 * \endcode
+	 *
+	 * `ftl::rc` has the same instances as `std::shared_ptr` does in
+	 * \ref memory:
+	 * - \ref monoid
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 * - \ref foldable
+	 *
+	 * \par Dependencies
+	 * - `<memory>`
+	 * - \ref monoid
+	 * - \ref monad
+	 * - \ref foldable
+	 */
+
+	namespace _dtl {
+		/* Reference count of an rc, followed in memory by the object.
+		 *
+		 * destroy knows the concrete type of the object, and of the
+		 * allocator that made the block, so neither needs a virtual
+		 * destructor.
+		 */
+		struct rc_block {
+			using destroy_type = void (*)(rc_block*);
+
+			explicit rc_block(destroy_type d) noexcept : destroy(d) {}
+
+			size_t count = 1;
+			destroy_type destroy;
+		};
+
+		template<typename T, typename A>
+		struct rc_inplace : rc_block {
+			using allocator_type = typename std::allocator_traits<A>
+				::template rebind_alloc<rc_inplace>;
+
+			using traits = std::allocator_traits<allocator_type>;
+
+			template<typename...Args>
+			explicit rc_inplace(const A& a, Args&&...args)
+			: rc_block(&rc_inplace::destroy_block)
+			, alloc(a)
+			, value(std::forward<Args>(args)...)
+			{}
+
+			static void destroy_block(rc_block* b) noexcept {
+				auto self = static_cast<rc_inplace*>(b);
+				allocator_type a(self->alloc);
+
+				self->~rc_inplace();
+				traits::deallocate(a, self, 1);
+			}
+
+			A alloc;
+			T value;
+		};
+	}
+
+	/**
+	 * Reference counted pointer, for single threaded use.
+	 *
+	 * Works like `std::shared_ptr`, but the reference count is a plain
+	 * integer rather than an atomic one. Copying an `rc` is thus a plain
+	 * increment, whereas with `std::shared_ptr`, every copy and destruction
+	 * is an atomic read-modify-write as soon as the program is linked with
+	 * threading support. The count lives next to the object, in the single
+	 * allocation made by `make_rc` or `allocate_rc`.
+	 *
+	 * In exchange, copies of an `rc` that refer to the same object must
+	 * never be copied, assigned or destroyed concurrently. There are no
+	 * weak references, and no custom deleters: an `rc` always owns an object
+	 * made by `make_rc` or `allocate_rc`.
+	 *
+	 * An `rc<T>` converts to an `rc<U>` wherever a `T*` converts to a `U*`.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref deref to `T`
+	 * - \ref eq
+	 * - \ref monoid, if `T` is a monoid
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 * - \ref foldable
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T>
+	class rc {
+	public:
+		using element_type = T;
+
+		rc() noexcept = default;
+
+		rc(std::nullptr_t) noexcept {}
+
+		rc(const rc& p) noexcept : ptr(p.ptr), blk(p.blk) {
+			retain();
+		}
+
+		rc(rc&& p) noexcept : ptr(p.ptr), blk(p.blk) {
+			p.ptr = nullptr;
+			p.blk = nullptr;
+		}
+
+		template<
+				typename U,
+				typename = Requires<std::is_convertible<U*,T*>::value>
+		>
+		rc(const rc<U>& p) noexcept : ptr(p.ptr), blk(p.blk) {
+			retain();
+		}
+
+		template<
+				typename U,
+				typename = Requires<std::is_convertible<U*,T*>::value>
+		>
+		rc(rc<U>&& p) noexcept : ptr(p.ptr), blk(p.blk) {
+			p.ptr = nullptr;
+			p.blk = nullptr;
+		}
+
+		~rc() {
+			release();
+		}
+
+		rc& operator= (rc p) noexcept {
+			swap(p);
+			return *this;
+		}
+
+		void swap(rc& p) noexcept {
+			std::swap(ptr, p.ptr);
+			std::swap(blk, p.blk);
+		}
+
+		/// Let go of the object, if any, leaving this empty.
+		void reset() noexcept {
+			rc().swap(*this);
+		}
+
+		T* get() const noexcept {
+			return ptr;
+		}
+
+		T& operator*() const noexcept {
+			return *ptr;
+		}
+
+		T* operator->() const noexcept {
+			return ptr;
+		}
+
+		explicit operator bool() const noexcept {
+			return ptr != nullptr;
+		}
+
+		/// Number of `rc`s referring to the object, or 0 if this is empty.
+		size_t use_count() const noexcept {
+			return blk ? blk->count : 0;
+		}
+
+	private:
+		template<typename> friend class rc;
+
+		template<typename U, typename A, typename...Args>
+		friend rc<U> allocate_rc(const A&, Args&&...);
+
+		rc(T* p, _dtl::rc_block* b) noexcept : ptr(p), blk(b) {}
+
+		void retain() noexcept {
+			if(blk)
+				++blk->count;
+		}
+
+		void release() noexcept {
+			if(blk && --blk->count == 0)
+				blk->destroy(blk);
+		}
+
+		T* ptr = nullptr;
+		_dtl::rc_block* blk = nullptr;
+	};
+
+	/**
+	 * Make an object of type `T` from `args`, owned by an `rc`.
+	 *
+	 * The object and its reference count are allocated with `alloc`, in one
+	 * go.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T, typename A, typename...Args>
+	rc<T> allocate_rc(const A& alloc, Args&&...args) {
+		using block = _dtl::rc_inplace<T,A>;
+
+		typename block::allocator_type a(alloc);
+		auto p = block::traits::allocate(a, 1);
+		try {
+			::new (static_cast<void*>(p)) block(
+				alloc, std::forward<Args>(args)...
+			);
+		}
+		catch(...) {
+			block::traits::deallocate(a, p, 1);
+			throw;
+		}
+
+		return rc<T>(std::addressof(p->value), p);
+	}
+
+	/**
+	 * Make an object of type `T` from `args`, owned by an `rc`.
+	 *
+	 * The `rc` counterpart of `std::make_shared`.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T, typename...Args>
+	rc<T> make_rc(Args&&...args) {
+		return allocate_rc<T>(std::allocator<T>(), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Equality by address, as for `std::shared_ptr`.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T, typename U>
+	bool operator== (const rc<T>& p, const rc<U>& q) noexcept {
+		return p.get() == q.get();
+	}
+
+	/// \ingroup rc
+	template<typename T, typename U>
+	bool operator!= (const rc<T>& p, const rc<U>& q) noexcept {
+		return p.get() != q.get();
+	}
+
+	/// \ingroup rc
+	template<typename T>
+	bool operator== (const rc<T>& p, std::nullptr_t) noexcept {
+		return !p;
+	}
+
+	/// \ingroup rc
+	template<typename T>
+	bool operator== (std::nullptr_t, const rc<T>& p) noexcept {
+		return !p;
+	}
+
+	/// \ingroup rc
+	template<typename T>
+	bool operator!= (const rc<T>& p, std::nullptr_t) noexcept {
+		return bool(p);
+	}
+
+	/// \ingroup rc
+	template<typename T>
+	bool operator!= (std::nullptr_t, const rc<T>& p) noexcept {
+		return bool(p);
+	}
+
+	/**
+	 * Monoid instance for rc.
+	 *
+	 * As for `std::shared_ptr`: empty pointers are the identity, and the
+	 * values of two non-empty ones are appended into a new object.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T>
+	struct monoid<rc<T>> {
+		static auto id() noexcept
+		-> typename std::enable_if<monoid<T>::instance, rc<T>>::type {
+			return rc<T>();
+		}
+
+		static auto append(rc<T> a, rc<T> b)
+		-> typename std::enable_if<monoid<T>::instance, rc<T>>::type {
+			if(a && b)
+				return make_rc<T>(monoid<T>::append(*a, *b));
+
+			return a ? a : b;
+		}
+
+		static constexpr bool instance = monoid<T>::instance;
+	};
+
+	/**
+	 * Monad instance of rc.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T>
+	struct monad<rc<T>>
+	: deriving_join<in_terms_of_bind<rc<T>>>
+	, deriving_apply<in_terms_of_bind<rc<T>>> {
+
+		static rc<T> pure(T&& a) {
+			return make_rc<T>(std::forward<T>(a));
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static rc<U> map(F f, rc<T> p) {
+			if(p)
+				return make_rc<U>(f(*p));
+
+			return rc<U>();
+		}
+
+		template<
+				typename F,
+				typename U = typename result_of<F(T)>::element_type
+		>
+		static rc<U> bind(rc<T> a, F f) {
+			if(a)
+				return f(*a);
+
+			return rc<U>();
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for rc.
+	 *
+	 * \ingroup rc
+	 */
+	template<typename T>
+	struct foldable<rc<T>>
+	: deriving_foldMap<rc<T>>, deriving_fold<rc<T>> {
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<std::is_same<U, result_of<Fn(U,T)>>::value>
+		>
+		static U foldl(Fn&& fn, U z, const rc<T>& p) {
+			if(p)
+				return fn(std::move(z), *p);
+
+			return z;
+		}
+
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<std::is_same<U, result_of<Fn(T,U)>>::value>
+		>
+		static U foldr(Fn&& fn, U z, const rc<T>& p) {
+			if(p)
+				return fn(*p, std::move(z));
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
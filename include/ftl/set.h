@@ -24,6 +24,9 @@
 #define FTL_SET_H
 
 #include <set>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 #include "concepts/monad.h"
 #include "concepts/foldable.h"
 
@@ -47,6 +50,8 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <set>
+	 * - <vector>
+	 * - <algorithm>
 	 * - \ref monad
 	 * - \ref foldable
 	 */
@@ -66,7 +71,7 @@ namespace ftl {
 		using value_type = T;
 
 		template<typename U>
-		using rebind = std::set<U,Rebind<Cmp,U>,rebind_allocator<U>>;
+		using rebind = std::set<U,RebindCompare<Cmp,U>,rebind_allocator<U>>;
 	};
 
 	/**
@@ -81,6 +86,12 @@ namespace ftl {
 	 * In cases where e.g. one of the sets is a temporary, `append`
 	 * might actually mutate one of the sets instead of making a copy.
 	 *
+	 * Two `const` sets are merged in a single linear pass, every element
+	 * inserted at the end of the result with a hint. Where the standard
+	 * library supports node extraction (C++17), two temporaries are merged
+	 * by relinking the nodes of the smaller one into the larger, without
+	 * copying or allocating anything.
+	 *
 	 * \ingroup set
 	 */
 	template<typename T, typename Cmp, typename A>
@@ -95,8 +106,11 @@ namespace ftl {
 				const std::set<T,Cmp,A>& s1,
 				const std::set<T,Cmp,A>& s2) {
 
-			std::set<T,Cmp,A> rs{s1};
-			rs.insert(s2.begin(), s2.end());
+			std::set<T,Cmp,A> rs(s1.key_comp(), s1.get_allocator());
+			std::set_union(
+					s1.begin(), s1.end(), s2.begin(), s2.end(),
+					std::inserter(rs, rs.end()), s1.key_comp()
+			);
 
 			return rs;
 		}
@@ -106,7 +120,7 @@ namespace ftl {
 				const std::set<T,Cmp,A>& s2) {
 
 			s1.insert(s2.begin(), s2.end());
-			return s1;
+			return std::move(s1);
 		}
 
 		static std::set<T,Cmp,A> append(
@@ -114,41 +128,81 @@ namespace ftl {
 				std::set<T,Cmp,A>&& s2) {
 
 			s2.insert(s1.begin(), s1.end());
-			return s2;
+			return std::move(s2);
 		}
 
 		static std::set<T,Cmp,A> append(
 				std::set<T,Cmp,A>&& s1,
 				std::set<T,Cmp,A>&& s2) {
 
-			if(s1.size() > s2.size()) {
-				s1.insert(s2.begin(), s2.end());
-
-				return s1;
+			if(s1.size() >= s2.size()) {
+				splice(s1, s2);
+				return std::move(s1);
 			}
 
 			else {
-				s2.insert(s1.begin(), s1.end());
-
-				return s2;
+				splice(s2, s1);
+				return std::move(s2);
 			}
 		}
 
 		static constexpr bool instance = true;
+
+	private:
+		static void splice(std::set<T,Cmp,A>& to, std::set<T,Cmp,A>& from) {
+#if defined(__cpp_lib_node_extract)
+			to.merge(from);
+#else
+			to.insert(from.begin(), from.end());
+#endif
+		}
 	};
 
+	namespace _dtl {
+		/*
+		 * Build a set of buffered elements in one go. Once the elements are
+		 * sorted, every insertion is hinted at the end and takes amortised
+		 * constant time. The sort is stable, so that of several equivalent
+		 * elements, the first one is kept, just as repeated inserts would.
+		 */
+		template<typename S, typename T, typename C = typename S::key_compare>
+		S sorted_set(std::vector<T>& buf, const C& c = C()) {
+			// Keeps the source set's comparator, where it fits S
+			using compare = typename S::key_compare;
+			S s(_dtl::rebound_compare<compare,C>::from(c));
+			auto cmp = s.key_comp();
+
+			if(!std::is_sorted(buf.begin(), buf.end(), cmp))
+				std::stable_sort(buf.begin(), buf.end(), cmp);
+
+			for(auto& e : buf) {
+				s.emplace_hint(s.end(), std::move(e));
+			}
+
+			return s;
+		}
+	}
+
 	/**
 	 * \ref monadpg implementation for std::set with parametrised comparator.
 	 *
 	 * Generally behaves as the other collections. The main difference being,
 	 * of course, the data structure used.
 	 *
+	 * `map`, `join` and `bind` gather their results in a buffer and sort it
+	 * before building the result set, rather than paying for a full tree
+	 * search on each insertion.
+	 *
+	 * Transparent comparators, such as `std::less<>` or `ftl::asc()`, are
+	 * kept by `map` and `bind`, along with any state they have, so results
+	 * still support heterogeneous lookups. Other comparators are rebound to
+	 * the new element type.
+	 *
 	 * \ingroup set
 	 */
 	template<typename T, typename Cmp, typename A>
 	struct monad<std::set<T,Cmp,A>>
-	: deriving_bind<std::set<T,Cmp,A>>
-	, deriving_apply<std::set<T,Cmp,A>> {
+	: deriving_apply<std::set<T,Cmp,A>> {
 
 		/// Alias for cleaner type signatures
 		template<typename U>
@@ -187,23 +241,25 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static set<U> map(F&& f, const set<T>& s) {
-			set<U> rs;
+			std::vector<U> buf;
+			buf.reserve(s.size());
 			for(const auto& e : s) {
-				rs.insert(f(e));
+				buf.push_back(f(e));
 			}
 
-			return rs;
+			return _dtl::sorted_set<set<U>>(buf, s.key_comp());
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
 		static set<U> map(F&& f, set<T>&& s) {
-			set<U> rs;
+			std::vector<U> buf;
+			buf.reserve(s.size());
 			for(auto& e : s) {
-				rs.insert(f(std::move(e)));
+				buf.push_back(f(std::move(e)));
 			}
 
-			return rs;
+			return _dtl::sorted_set<set<U>>(buf, s.key_comp());
 		}
 
 		/**
@@ -221,17 +277,14 @@ namespace ftl {
 		 * \endcode
 		 */
 		static set<T> join(const set<set<T>>& s) {
-			 set<T> rs;
-			 for(const auto& ss : s) {
-				 for(const auto& e : ss) {
-					 rs.insert(e);
-				 }
-			 }
+			std::vector<T> buf;
+			for(const auto& ss : s) {
+				buf.insert(buf.end(), ss.begin(), ss.end());
+			}
 
-			return rs;
+			return _dtl::sorted_set<set<T>>(buf);
 		}
 
-#ifdef DOCUMENTATION_GENERATOR
 		/**
 		 * \tparam F must satisfy \ref fn`<set<U>(T)>`, for some type `U` that
 		 *           is comparable using `Cmp<U>`.
@@ -240,8 +293,17 @@ namespace ftl {
 				typename F,
 				typename U = typename result_of<F(T)>::value_type
 		>
-		static set<U> bind(const set<T>& s, F&& f);
-#endif
+		static set<U> bind(const set<T>& s, F&& f) {
+			std::vector<U> buf;
+			for(const auto& e : s) {
+				auto c = f(e);
+				for(auto& x : c) {
+					buf.push_back(std::move(x));
+				}
+			}
+
+			return _dtl::sorted_set<set<U>>(buf, s.key_comp());
+		}
 
 		static constexpr bool instance = true;
 	};
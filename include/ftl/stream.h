@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_STREAM_H
+#define FTL_STREAM_H
+
+#include <istream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include "concepts/foldable.h"
+#include "string.h"
+
+namespace ftl {
+	/**
+	 * \defgroup stream Stream
+	 *
+	 * Foldable sources reading from input streams and files.
+	 *
+	 * \code
+	 *   #include <ftl/stream.h>
+	 * \endcode
+	 *
+	 * `lines`, `records` and `chunks` split a stream into strings, and fold
+	 * over them in constant memory, however large the input. Each element
+	 * is read into the same string buffer, which is handed to the folding
+	 * function by reference, and only lives until the next element is read.
+	 *
+	 * The stream is read in large blocks, by a background thread that
+	 * fills one block while the other is being folded.
+	 *
+	 * \par Examples
+	 *
+	 * Counting the requests per status code in a log file:
+	 * \code
+	 *   auto counts = ftl::foldMapByKey<std::unordered_map>(
+	 *       [](const std::string& l){ return l.substr(0, 3); },
+	 *       [](const std::string&){ return ftl::sum(1); },
+	 *       ftl::lines("access.log")
+	 *   );
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<istream>`
+	 * - `<fstream>`
+	 * - `<string>`
+	 * - `<thread>`
+	 * - `<mutex>`
+	 * - `<condition_variable>`
+	 * - \ref foldable
+	 * - \ref string
+	 */
+
+	namespace _dtl {
+		/*
+		 * Reads an istream in blocks on a background thread, keeping one
+		 * block ahead of the consumer. The two buffers take turns: while the
+		 * consumer holds one, the thread fills the other.
+		 */
+		class block_reader {
+		public:
+			block_reader(std::istream& is, size_t block) : is(is) {
+				bufs[0].resize(block);
+				bufs[1].resize(block);
+				t = std::thread([this]{ run(); });
+			}
+
+			block_reader(const block_reader&) = delete;
+			block_reader& operator= (const block_reader&) = delete;
+
+			~block_reader() {
+				{
+					std::lock_guard<std::mutex> l(m);
+					stop = true;
+				}
+				cv.notify_all();
+				t.join();
+			}
+
+			/*
+			 * Hand the current block back to the thread, and wait for the
+			 * next one. An empty block means the stream is exhausted.
+			 */
+			std::pair<const char*, size_t> next() {
+				std::unique_lock<std::mutex> l(m);
+				if(cur >= 0) {
+					full[cur] = false;
+					cv.notify_all();
+				}
+
+				cur = cur < 0 ? 0 : cur ^ 1;
+				cv.wait(l, [this]{ return full[cur]; });
+
+				if(err)
+					std::rethrow_exception(err);
+
+				return std::make_pair(bufs[cur].data(), len[cur]);
+			}
+
+		private:
+			void run() {
+				for(int i = 0;; i ^= 1) {
+					std::unique_lock<std::mutex> l(m);
+					cv.wait(l, [this, i]{ return stop || !full[i]; });
+					if(stop)
+						return;
+
+					l.unlock();
+
+					size_t n = 0;
+					std::exception_ptr e;
+					try {
+						is.read(bufs[i].data(), std::streamsize(bufs[i].size()));
+						n = size_t(is.gcount());
+					}
+					catch(...) {
+						e = std::current_exception();
+					}
+
+					l.lock();
+					len[i] = n;
+					err = e;
+					full[i] = true;
+					cv.notify_all();
+
+					if(n == 0)
+						return;
+				}
+			}
+
+			std::istream& is;
+			std::vector<char> bufs[2];
+			size_t len[2] = {0, 0};
+			bool full[2] = {false, false};
+			int cur = -1;
+			bool stop = false;
+			std::exception_ptr err;
+
+			std::mutex m;
+			std::condition_variable cv;
+			std::thread t;
+		};
+
+		// The stream, its reader, and the element last read
+		struct stream_state {
+			stream_state(
+					std::shared_ptr<std::istream> is,
+					char delim, size_t chunk, size_t block)
+			: is(std::move(is)), reader(*this->is, block)
+			, delim(delim), chunk(chunk) {
+				if(chunk)
+					rec.reserve(chunk);
+			}
+
+			bool next() {
+				return chunk ? next_chunk() : next_record();
+			}
+
+			bool next_record() {
+				rec.clear();
+				bool any = false;
+
+				for(;;) {
+					if(p == e && !refill())
+						return any;
+
+					auto d = static_cast<const char*>(
+						std::memchr(p, delim, size_t(e - p))
+					);
+					if(d) {
+						rec.append(p, d);
+						p = d + 1;
+						return true;
+					}
+
+					rec.append(p, e);
+					p = e;
+					any = true;
+				}
+			}
+
+			bool next_chunk() {
+				rec.clear();
+				while(rec.size() < chunk) {
+					if(p == e && !refill())
+						break;
+
+					auto k = std::min(chunk - rec.size(), size_t(e - p));
+					rec.append(p, k);
+					p += k;
+				}
+
+				return !rec.empty();
+			}
+
+			bool refill() {
+				if(ended)
+					return false;
+
+				auto b = reader.next();
+				p = b.first;
+				e = b.first + b.second;
+				ended = b.second == 0;
+
+				return !ended;
+			}
+
+			std::shared_ptr<std::istream> is;
+			block_reader reader;
+			char delim;
+			size_t chunk;
+
+			const char* p = nullptr;
+			const char* e = nullptr;
+			bool ended = false;
+			std::string rec;
+		};
+
+		// Input iterator; all copies share, and advance, the same state
+		class stream_iterator {
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string*;
+			using reference = const std::string&;
+
+			stream_iterator() = default;
+
+			explicit stream_iterator(std::shared_ptr<stream_state> s)
+			: s(std::move(s)) {
+				++*this;
+			}
+
+			const std::string& operator* () const noexcept {
+				return s->rec;
+			}
+
+			const std::string* operator-> () const noexcept {
+				return &s->rec;
+			}
+
+			stream_iterator& operator++ () {
+				if(!s->next())
+					s.reset();
+
+				return *this;
+			}
+
+			stream_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const stream_iterator& o) const noexcept {
+				return s == o.s;
+			}
+
+			bool operator!= (const stream_iterator& o) const noexcept {
+				return s != o.s;
+			}
+
+		private:
+			std::shared_ptr<stream_state> s;
+		};
+	}
+
+	/**
+	 * A stream, split into strings.
+	 *
+	 * Made by `lines`, `records` or `chunks`. The stream is not read until
+	 * the source is iterated, and a source can only be iterated once: its
+	 * iterators are input iterators. The elements are only valid until the
+	 * next one is read.
+	 *
+	 * While a source is being iterated, the stream is read by another
+	 * thread, and must not be used by anything else. Reading runs up to two
+	 * blocks ahead, so when the iteration is cut short, the stream has been
+	 * read further than what was consumed.
+	 *
+	 * \par Concepts
+	 * - \ref foldablepg, except `foldr`, which could not run in constant
+	 *   memory
+	 *
+	 * Sources have `begin` and `end`, but are input ranges, not
+	 * \ref fwditerable: every iterator advances the same reader, and
+	 * copies of one do not keep their place. Calling `begin` a second time
+	 * carries on from wherever the stream is, so iterating twice, or
+	 * folding after iterating, does not see what was already consumed.
+	 * They still pass the `ForwardIterable` check, which only looks for
+	 * `begin` and `end`, so that the folds here, which each make a single
+	 * pass, accept them.
+	 *
+	 * \ingroup stream
+	 */
+	class istream_source {
+	public:
+		using value_type = std::string;
+		using iterator = _dtl::stream_iterator;
+		using const_iterator = _dtl::stream_iterator;
+
+		/// Size of the blocks read at a time, unless specified.
+		static constexpr size_t default_block_size = size_t(1) << 20;
+
+		istream_source(
+				std::shared_ptr<std::istream> is,
+				char delim, size_t chunk, size_t block)
+		: is(std::move(is)), delim(delim), chunk(chunk), block(block) {}
+
+		/// Start reading the stream.
+		iterator begin() const {
+			return iterator(std::make_shared<_dtl::stream_state>(
+				is, delim, chunk, block
+			));
+		}
+
+		iterator end() const {
+			return iterator();
+		}
+
+	private:
+		std::shared_ptr<std::istream> is;
+		char delim;
+		size_t chunk;
+		size_t block;
+	};
+
+	// For folds and foldMapByKey, which look begin and end up unqualified
+	inline _dtl::stream_iterator begin(const istream_source& s) {
+		return s.begin();
+	}
+
+	inline _dtl::stream_iterator end(const istream_source& s) {
+		return s.end();
+	}
+
+	namespace _dtl {
+		// Refers to a stream owned by someone else
+		inline std::shared_ptr<std::istream> borrow_stream(std::istream& is) {
+			return std::shared_ptr<std::istream>(&is, [](std::istream*){});
+		}
+
+		inline std::shared_ptr<std::istream> open_stream(
+				const std::string& path) {
+
+			auto f = std::make_shared<std::ifstream>(
+				path, std::ios::in | std::ios::binary
+			);
+
+			if(!f->is_open())
+				throw std::ios_base::failure("Could not open " + path);
+
+			return f;
+		}
+	}
+
+	/**
+	 * Records of `is`, separated by `delim`.
+	 *
+	 * The delimiters are not part of the records. A delimiter at the very
+	 * end of the stream does not start an empty record, but two in a row
+	 * elsewhere do.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::ifstream f("words.txt");
+	 *   auto longest = ftl::foldl(
+	 *       [](size_t n, const std::string& w){ return std::max(n, w.size()); },
+	 *       size_t(0), ftl::records(f, ' ')
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source records(
+			std::istream& is, char delim,
+			size_t block = istream_source::default_block_size) {
+
+		return istream_source(_dtl::borrow_stream(is), delim, 0, block);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Opens the file at `path` in binary mode, and keeps it open for as long
+	 * as the source is. Throws `std::ios_base::failure` if the file cannot
+	 * be opened.
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source records(
+			const std::string& path, char delim,
+			size_t block = istream_source::default_block_size) {
+
+		return istream_source(_dtl::open_stream(path), delim, 0, block);
+	}
+
+	/**
+	 * Lines of `is`, without their line breaks.
+	 *
+	 * Equivalent to `records(is, '\n', block)`. Carriage returns are kept.
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source lines(
+			std::istream& is,
+			size_t block = istream_source::default_block_size) {
+
+		return records(is, '\n', block);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source lines(
+			const std::string& path,
+			size_t block = istream_source::default_block_size) {
+
+		return records(path, '\n', block);
+	}
+
+	/**
+	 * Consecutive chunks of `n` bytes of `is`.
+	 *
+	 * The last chunk holds whatever is left, and may be shorter. `n` must
+	 * not be 0.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto checksum = ftl::foldl(
+	 *       [](uint32_t h, const std::string& c){ return crc32(h, c); },
+	 *       uint32_t(0), ftl::chunks("image.bin", 4096)
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source chunks(
+			std::istream& is, size_t n,
+			size_t block = istream_source::default_block_size) {
+
+		return istream_source(_dtl::borrow_stream(is), 0, n, block);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup stream
+	 */
+	inline istream_source chunks(
+			const std::string& path, size_t n,
+			size_t block = istream_source::default_block_size) {
+
+		return istream_source(_dtl::open_stream(path), 0, n, block);
+	}
+
+	template<>
+	struct parametric_type_traits<istream_source> {
+		using value_type = std::string;
+	};
+
+	/**
+	 * Foldable instance for stream sources.
+	 *
+	 * Every fold is a single pass over the stream, and consumes it.
+	 * `foldMap` stops reading as soon as its result is absorbing.
+	 * `foldMapByKey` works too, as it only needs `begin` and `end`, and
+	 * visits each element once.
+	 *
+	 * \ingroup stream
+	 */
+	template<>
+	struct foldable<istream_source>
+	: deriving_foldl<istream_source>
+	, deriving_foldMap<istream_source>
+	, deriving_fold<istream_source> {
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
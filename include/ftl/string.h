@@ -24,7 +24,11 @@
 #define FTL_STRING_H
 
 #include <string>
+#include <vector>
+#include <iterator>
 #include "concepts/monoid.h"
+#include "concepts/foldable.h"
+#include "implementation/contiguous_fold.h"
 
 namespace ftl {
 
@@ -33,9 +37,17 @@ namespace ftl {
 	 *
 	 * Concept implementations for the standard string classes.
 	 *
+	 * Concatenating strings one at a time reallocates the result over and
+	 * over. Folds of strings, whether by `fold` or by `foldMap` with a
+	 * function that returns strings, therefore size up the result first and
+	 * build it with a single allocation. For concatenations spread out over
+	 * other code, `string_builder` collects the pieces to be put together
+	 * at the end.
+	 *
 	 * \par Dependencies
 	 * - <string>
 	 * - \ref monoid
+	 * - \ref foldable
 	 */
 
 	/**
@@ -90,7 +102,7 @@ namespace ftl {
 				std::basic_string<Ts...>&& s1,
 				std::basic_string<Ts...>&& s2) {
 
-			std::move(s2.begin(), s2.end(), std::back_inserter(s1));
+			s1 += s2;
 			return std::move(s1);
 		}
 
@@ -98,6 +110,184 @@ namespace ftl {
 
 	};
 
+	/**
+	 * A string that is put together only once it is asked for.
+	 *
+	 * Keeps the pieces appended to it, and concatenates them in `str`, with
+	 * a single allocation of exactly the right size.
+	 *
+	 * \par Concepts
+	 * - \ref monoidpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::string_builder<std::string> b;
+	 *   for(auto& w : words)
+	 *       b += w;
+	 *
+	 *   std::string s = b.str();
+	 * \endcode
+	 *
+	 * \ingroup string
+	 */
+	template<typename S>
+	class string_builder {
+	public:
+		using size_type = typename S::size_type;
+
+		string_builder() = default;
+
+		explicit string_builder(S s) {
+			*this += std::move(s);
+		}
+
+		/// Append a piece, without copying any previous ones.
+		string_builder& operator+= (S s) {
+			if(!s.empty()) {
+				n += s.size();
+				pieces.push_back(std::move(s));
+			}
+
+			return *this;
+		}
+
+		/// Length of the string that `str` would build.
+		size_type size() const noexcept {
+			return n;
+		}
+
+		/// Concatenate all pieces.
+		S str() const {
+			S s;
+			s.reserve(n);
+			for(auto& p : pieces) {
+				s += p;
+			}
+
+			return s;
+		}
+
+		friend struct monoid<string_builder>;
+
+	private:
+		std::vector<S> pieces;
+		size_type n = 0;
+	};
+
+	/**
+	 * Monoid instance for `string_builder`.
+	 *
+	 * Appending only moves pieces around, it never concatenates them.
+	 *
+	 * \ingroup string
+	 */
+	template<typename S>
+	struct monoid<string_builder<S>> {
+		static string_builder<S> id() {
+			return string_builder<S>{};
+		}
+
+		static string_builder<S> append(
+				const string_builder<S>& b1, const string_builder<S>& b2) {
+
+			return append(string_builder<S>(b1), b2);
+		}
+
+		static string_builder<S> append(
+				string_builder<S>&& b1, const string_builder<S>& b2) {
+
+			b1.pieces.insert(b1.pieces.end(), b2.pieces.begin(), b2.pieces.end());
+			b1.n += b2.n;
+			return std::move(b1);
+		}
+
+		static string_builder<S> append(
+				string_builder<S>&& b1, string_builder<S>&& b2) {
+
+			b1.pieces.insert(
+				b1.pieces.end(),
+				std::make_move_iterator(b2.pieces.begin()),
+				std::make_move_iterator(b2.pieces.end())
+			);
+			b1.n += b2.n;
+			return std::move(b1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		template<typename...Ts>
+		struct deferred_foldMap<std::basic_string<Ts...>> : std::true_type {
+			using S = std::basic_string<Ts...>;
+
+			template<typename Fn, typename F>
+			static S foldMap(Fn& fn, const F& f) {
+				using It = decltype(adl::begin_of(f));
+				using R = decltype(fn(*adl::begin_of(f)));
+
+				// Single pass sources, such as streams, cannot be measured
+				return foldMap(fn, f, std::integral_constant<bool,
+					std::is_lvalue_reference<R>::value
+					&& std::is_base_of<
+						std::forward_iterator_tag,
+						typename std::iterator_traits<It>::iterator_category
+					>::value
+				>());
+			}
+
+		private:
+			// fn refers to existing strings, so they can be measured first
+			template<typename Fn, typename F>
+			static S foldMap(Fn& fn, const F& f, std::true_type) {
+				typename S::size_type n = 0;
+				for(auto&& e : f) {
+					n += fn(e).size();
+				}
+
+				S s;
+				s.reserve(n);
+				for(auto&& e : f) {
+					s += fn(e);
+				}
+
+				return s;
+			}
+
+			// fn makes new strings, which are kept until they are all made
+			template<typename Fn, typename F>
+			static S foldMap(Fn& fn, const F& f, std::false_type) {
+				string_builder<S> b;
+				for(auto&& e : f) {
+					b += fn(e);
+				}
+
+				return b.str();
+			}
+		};
+
+		template<typename...Ts>
+		struct contiguous_fold<std::basic_string<Ts...>> {
+			using S = std::basic_string<Ts...>;
+
+			static S fold(const S* p, size_t n) {
+				typename S::size_type len = 0;
+				for(size_t i = 0; i < n; ++i) {
+					len += p[i].size();
+				}
+
+				S s;
+				s.reserve(len);
+				for(size_t i = 0; i < n; ++i) {
+					s += p[i];
+				}
+
+				return s;
+			}
+		};
+	}
+
 }
 
 #endif
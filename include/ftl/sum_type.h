@@ -26,6 +26,10 @@
 #include <stdexcept>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <tuple>
 #include "type_functions.h"
 #include "concepts/basic.h"
 #include "concepts/orderable.h"
@@ -122,72 +126,123 @@ namespace ftl {
 		constexpr otherwise(T&&) noexcept {}
 	};
 
+	/**
+	 * Opt-in trait describing an invalid, "spare" value of `T`.
+	 *
+	 * A type with a niche can mark a `T` that does not hold a proper value.
+	 * `sum_type<T,E>`, where `E` is an empty type such as `Nothing`, uses
+	 * this to store the `E` state inside the bytes of `T`. That makes
+	 * e.g. `maybe<std::reference_wrapper<T>>` exactly as large as a pointer.
+	 *
+	 * Specialisations must be trivially copyable and must provide:
+	 * \code
+	 *   // Construct the niche value in uninitialised storage for a T
+	 *   static void set_niche(T*) noexcept;
+	 *
+	 *   // Check whether the T at the given address is the niche value
+	 *   static bool is_niche(const T*) noexcept;
+	 *
+	 *   static constexpr bool instance = true;
+	 * \endcode
+	 *
+	 * The niche value must never be one that can be constructed normally.
+	 * Plain pointers have no such value: even addresses where no object can
+	 * live, such as `(void*)-1`, are stored and compared as sentinels.
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename T>
+	struct niche_traits {
+		static constexpr bool instance = false;
+	};
+
+	/**
+	 * References can never be null, so a null `reference_wrapper` is the niche.
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename T>
+	struct niche_traits<std::reference_wrapper<T>> {
+		static_assert(
+			sizeof(std::reference_wrapper<T>) == sizeof(T*),
+			"reference_wrapper is expected to be a single pointer"
+		);
+
+		static void set_niche(std::reference_wrapper<T>* p) noexcept {
+			T* n = nullptr;
+			std::memcpy(static_cast<void*>(p), &n, sizeof(n));
+		}
+
+		static bool is_niche(const std::reference_wrapper<T>* p) noexcept {
+			T* r;
+			std::memcpy(&r, static_cast<const void*>(p), sizeof(r));
+			return r == nullptr;
+		}
+
+		static constexpr bool instance = true;
+	};
+
 	namespace _dtl {
 
-		template<typename, typename...>
-		struct is_type_set;
+		/*
+		 * The checks below expand packs, rather than recurse over them, so
+		 * that wide sum types and long matches nest few templates deep.
+		 */
 
-		template<typename T>
-		struct is_type_set<T> {
-			static constexpr bool value = true;
-		};
+		template<typename S, typename...Ts>
+		struct is_type_set_impl;
 
-		template<typename T, typename U, typename...Ts>
-		struct is_type_set<T,U,Ts...> {
-			static constexpr bool value =
-				is_type_set<T,Ts...>::value
-				&& is_type_set<U,Ts...>::value;
-		};
+		// Each type is unique if it is found first where it is
+		template<size_t...Is, typename...Ts>
+		struct is_type_set_impl<seq<Is...>,Ts...>
+		: all_true<(index_of_impl<Ts,Ts...>::value == Is)...> {};
 
 		template<typename T, typename...Ts>
-		struct is_type_set<T,T,Ts...> {
-			static constexpr bool value = false;
+		struct is_type_set
+		: is_type_set_impl<typename make_seq<sizeof...(Ts) + 1>::type,T,Ts...>
+		{};
+
+		template<bool Found, size_t I, typename T, typename...Fs>
+		struct call_match_at {
+			using type = typename is_callable<type_at<I,Fs...>,T>::type;
 		};
 
-		template<typename,typename...>
-		struct find_call_match {
+		template<size_t I, typename T, typename...Fs>
+		struct call_match_at<false,I,T,Fs...> {
 			using type = _dtl::no;
 		};
 
-		template<typename T, typename F, typename...Fs>
-		struct find_call_match<T,F,Fs...> {
-			using type = if_<is_callable<F,T>::value,
-				  typename is_callable<F,T>::type,
-				  typename find_call_match<T,Fs...>::type
-			>;
+		// The result of the first of Fs that accepts a T, or no if none does
+		template<typename T, typename...Fs>
+		struct find_call_match {
+			static constexpr size_t index
+				= first_of<is_callable<Fs,T>::value...>::value;
+
+			static constexpr bool found = index < sizeof...(Fs);
+
+			using type = typename call_match_at<found,index,T,Fs...>::type;
 		};
 
 		template<typename,typename>
 		struct all_return_types;
 
-		template<typename...Fs>
-		struct all_return_types<type_seq<>,type_seq<Fs...>> {
-			using types = type_seq<>;
-		};
-
-		template<typename T, typename...Ts, typename...Fs>
-		struct all_return_types<type_seq<T,Ts...>,type_seq<Fs...>> {
-			using types =
-				typename concat_type_seqs<
-					type_seq<typename find_call_match<T,Fs...>::type>,
-					typename all_return_types<
-						type_seq<Ts...>,
-						type_seq<Fs...>
-					>::types
-				>::type;
+		template<typename...Ts, typename...Fs>
+		struct all_return_types<type_seq<Ts...>,type_seq<Fs...>> {
+			using types = type_seq<typename find_call_match<Ts,Fs...>::type...>;
 		};
 
 		template<typename>
 		struct find_common_type;
 
-		template<typename,typename>
-		struct exhaustive_match;
-
+		// std::common_type is not associative, so it folds left to right
 		template<typename...Ts>
 		struct find_common_type<type_seq<Ts...>> {
 			using type = typename std::common_type<Ts...>::type;
 		};
 
+		template<typename,typename>
+		struct exhaustive_match;
+
 		template<typename Ts,typename Fs>
 		struct common_return_type {
 
@@ -200,37 +255,10 @@ namespace ftl {
 			using type = typename find_common_type<types>::type;
 		};
 
-		// A match is exhaustive if we've functions to spare
-		template<typename...Fs>
-		struct exhaustive_match<type_seq<Fs...>,type_seq<>> {
-			static constexpr bool value = true;
-		};
-
-		// A match is exhaustive if the final function accepts the final type
-		template<typename F, typename T>
-		struct exhaustive_match<type_seq<F>,type_seq<T>> {
-			static constexpr bool value = is_callable<F,T>::value;
-		};
-
-		// A match is NOT exhaustive if there are left-over types
-		template<typename T, typename...Ts>
-		struct exhaustive_match<type_seq<>,type_seq<T,Ts...>> {
-			static constexpr bool value = false;
-		};
-
-		template<typename F, typename...Fs, typename T, typename...Ts>
-		struct exhaustive_match<type_seq<F,Fs...>,type_seq<T,Ts...>> {
-			static constexpr bool value =
-				(
-					is_callable<F,T>::value
-					&& exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value
-				)
-				||
-				(
-					exhaustive_match<type_seq<F,Fs...>,type_seq<Ts...>>::value
-					&& exhaustive_match<type_seq<Fs...>,type_seq<T>>::value
-				);
-		};
+		// A match is exhaustive if every type is accepted by some function
+		template<typename...Fs, typename...Ts>
+		struct exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>
+		: all_true<find_call_match<Ts,Fs...>::found...> {};
 
 		template<typename...>
 		struct recursive_union {};
@@ -271,197 +299,48 @@ namespace ftl {
 		template<typename T>
 		struct overload_tag {};
 
+		/*
+		 * Calls the first of fs that accepts a T. Which one that is, is
+		 * known statically, so it is picked out directly rather than by
+		 * trying each clause in turn, which would generate a chain of
+		 * functions for every element of the sum type.
+		 */
 		template<typename R, typename T, typename...>
 		struct union_visitor {
-			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O>, const T& t, F&& f, Fs&&...) {
-				return std::forward<F>(f)(t);
-			}
-
-			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O>, T& t, F&& f, Fs&&...) {
-				return std::forward<F>(f)(t);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O> o, const T& t, F&&, Fs&&...fs) {
-				return union_visitor::visit(o, t, std::forward<Fs>(fs)...);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O> o, T& t, F&&, Fs&&...fs) {
-				return union_visitor::visit(o, t, std::forward<Fs>(fs)...);
+			template<typename O, typename...Fs>
+			static FTL_CONSTEXPR14 R visit(overload_tag<O>, const T& t, Fs&&...fs) {
+				return std::get<find_call_match<T,Fs...>::index>(
+					std::forward_as_tuple(std::forward<Fs>(fs)...)
+				)(t);
 			}
-		};
 
-		template<typename T, typename...Ts>
-		struct union_visitor<void,T,Ts...> {
-			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O>, const T& t, F&& f, Fs&&...) {
-				std::forward<F>(f)(t);
-			}
-
-			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O>, T& t, F&& f, Fs&&...) {
-				std::forward<F>(f)(t);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O> o, const T& t, F&&, Fs&&...fs) {
-				union_visitor::visit(o, t, std::forward<Fs>(fs)...);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O> o, T& t, F&&, Fs&&...fs) {
-				union_visitor::visit(o, t, std::forward<Fs>(fs)...);
+			template<typename O, typename...Fs>
+			static FTL_CONSTEXPR14 R visit(overload_tag<O>, T& t, Fs&&...fs) {
+				return std::get<find_call_match<T,Fs...>::index>(
+					std::forward_as_tuple(std::forward<Fs>(fs)...)
+				)(t);
 			}
 		};
 
-		template<typename R, typename...Ts>
-		struct union_visitor<R,seq<>,Ts...> {
-			template<typename...Fs>
-			static R visit(const recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
-			}
-
-			template<typename...Fs>
-			static R visit(recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
-			}
-		};
-
-		template<typename...Ts>
-		struct union_visitor<void,seq<>,Ts...> {
-			template<typename...Fs>
-			static void visit(const recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
-			}
-
-			template<typename...Fs>
-			static void visit(recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+		template<typename T, typename...Ts>
+		struct union_visitor<void,T,Ts...> {
+			template<typename O, typename...Fs>
+			static FTL_CONSTEXPR14 void visit(overload_tag<O>, const T& t, Fs&&...fs) {
+				std::get<find_call_match<T,Fs...>::index>(
+					std::forward_as_tuple(std::forward<Fs>(fs)...)
+				)(t);
 			}
-		};
 
-		template<typename R, size_t I, size_t...Is, typename T, typename...Ts>
-		struct union_visitor<R,seq<I,Is...>,T,Ts...> {
-			template<typename...Fs>
-			static R visit(
-					const recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
-			}
-
-			template<typename...Fs>
-			static R visit(
-					recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
-			}
-		};
-
-		template<size_t I, size_t...Is, typename T, typename...Ts>
-		struct union_visitor<void,seq<I,Is...>,T,Ts...> {
-			template<typename...Fs>
-			static void visit(
-					const recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					union_visitor<void,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					union_visitor<void,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
-			}
-
-			template<typename...Fs>
-			static void visit(
-					recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					union_visitor<void,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<void,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
+			template<typename O, typename...Fs>
+			static FTL_CONSTEXPR14 void visit(overload_tag<O>, T& t, Fs&&...fs) {
+				std::get<find_call_match<T,Fs...>::index>(
+					std::forward_as_tuple(std::forward<Fs>(fs)...)
+				)(t);
 			}
 		};
 
 		template<>
-		struct recursive_union<> {
-			void copy(size_t, const recursive_union&) noexcept {}
-			void move(size_t, recursive_union&&) noexcept {}
-			void destruct(size_t) noexcept {}
-
-			constexpr bool compare( size_t,const recursive_union&) const noexcept
-			{ return false; }
-		};
+		struct recursive_union<> {};
 
 		template<typename T, typename...Ts>
 		struct recursive_union<T,Ts...> {
@@ -503,64 +382,477 @@ namespace ftl {
 				>::value
 			) : r(t, l) {}
 
-			~recursive_union() {}
+			union {
+				T v;
+				recursive_union<Ts...> r;
+			};
+		};
+
+		template<typename...>
+		struct max_sizeof {
+			static constexpr size_t value = 1;
+		};
+
+		template<typename T, typename...Ts>
+		struct max_sizeof<T,Ts...> {
+			static constexpr size_t value =
+				sizeof(T) > max_sizeof<Ts...>::value
+				? sizeof(T) : max_sizeof<Ts...>::value;
+		};
+
+		/* Flat storage for sum types.
+		 *
+		 * A single, suitably aligned buffer that is large enough for any one
+		 * of Ts. Unlike recursive_union, nothing about it grows with the
+		 * number of elements, save its size.
+		 */
+		template<typename...Ts>
+		struct flat_union {
+			flat_union() noexcept {}
+
+			template<typename T, typename...Args>
+			explicit flat_union(constructor<T>, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value) {
+				new (static_cast<void*>(bytes)) T(std::forward<Args>(args)...);
+			}
 
-			void copy(size_t i, const recursive_union& u)
+			template<typename T, typename U>
+			flat_union(constructor<T>, std::initializer_list<U> l)
 			noexcept(
-				std::is_nothrow_copy_constructible<T>::value
-				&& noexcept(std::declval<recursive_union>().r.copy(i-1, u.r))
-			)
-			{
-				if(i == 0) {
-					new (std::addressof(v)) T(u.v);
-				}
-				else {
-					r.copy(i-1, u.r);
-				}
+				std::is_nothrow_constructible<T,std::initializer_list<U>>::value
+			) {
+				new (static_cast<void*>(bytes)) T(l);
 			}
 
-			void move(size_t i, recursive_union&& u)
+			alignas(Ts...) unsigned char bytes[max_sizeof<Ts...>::value];
+		};
+
+		template<size_t I, typename...Ts>
+		constexpr auto union_ref(recursive_union<Ts...>& u)
+		-> decltype(union_indexer<I,Ts...>::ref(u)) {
+			return union_indexer<I,Ts...>::ref(u);
+		}
+
+		template<size_t I, typename...Ts>
+		constexpr auto union_ref(const recursive_union<Ts...>& u)
+		-> decltype(union_indexer<I,Ts...>::ref(u)) {
+			return union_indexer<I,Ts...>::ref(u);
+		}
+
+		template<size_t I, typename...Ts>
+		type_at<I,Ts...>& union_ref(flat_union<Ts...>& u) noexcept {
+			return *reinterpret_cast<type_at<I,Ts...>*>(u.bytes);
+		}
+
+		template<size_t I, typename...Ts>
+		const type_at<I,Ts...>& union_ref(const flat_union<Ts...>& u) noexcept {
+			return *reinterpret_cast<const type_at<I,Ts...>*>(u.bytes);
+		}
+
+		/* Storage used by sum_type<Ts...>.
+		 *
+		 * Sums of trivially destructible types keep recursive_union, as it
+		 * can be constant initialised. Everything else gets the flat buffer,
+		 * which is cheaper to instantiate for wide sums.
+		 */
+		template<typename...Ts>
+		using sum_storage = if_<
+			All<std::is_trivially_destructible,Ts...>::value,
+			recursive_union<Ts...>,
+			flat_union<Ts...>
+		>;
+
+		/* Copying, moving, destruction and comparison of sum_type storage.
+		 *
+		 * Each operation looks up the function for the active element in a
+		 * table, so they are all constant time regardless of the index.
+		 */
+		template<typename U, typename, typename...>
+		struct union_ops;
+
+		template<typename U, size_t...Is, typename...Ts>
+		struct union_ops<U,seq<Is...>,Ts...> {
+			static void copy(size_t i, U& dst, const U& src)
+			noexcept(All<std::is_nothrow_copy_constructible,Ts...>::value) {
+				using copy_t = void (*) (U&, const U&);
+
+				static constexpr copy_t table[] = { &copy_at<Is>... };
+
+				table[i](dst, src);
+			}
+
+			static void move(size_t i, U& dst, U& src)
+			noexcept(All<std::is_nothrow_move_constructible,Ts...>::value) {
+				using move_t = void (*) (U&, U&);
+
+				static constexpr move_t table[] = { &move_at<Is>... };
+
+				table[i](dst, src);
+			}
+
+			static void destruct(size_t i, U& u)
+			noexcept(All<std::is_nothrow_destructible,Ts...>::value) {
+				using destruct_t = void (*) (U&);
+
+				static constexpr destruct_t table[] = { &destruct_at<Is>... };
+
+				table[i](u);
+			}
+
+			static bool compare(size_t i, const U& a, const U& b) {
+				using compare_t = bool (*) (const U&, const U&);
+
+				static constexpr compare_t table[] = { &compare_at<Is>... };
+
+				return table[i](a, b);
+			}
+
+		private:
+			template<size_t I>
+			static void copy_at(U& dst, const U& src) {
+				using T = type_at<I,Ts...>;
+				new (static_cast<void*>(std::addressof(union_ref<I>(dst))))
+					T(union_ref<I>(src));
+			}
+
+			template<size_t I>
+			static void move_at(U& dst, U& src) {
+				using T = type_at<I,Ts...>;
+				new (static_cast<void*>(std::addressof(union_ref<I>(dst))))
+					T(std::move(union_ref<I>(src)));
+			}
+
+			template<size_t I>
+			static void destruct_at(U& u) {
+				using T = type_at<I,Ts...>;
+				union_ref<I>(u).~T();
+			}
+
+			template<size_t I>
+			static bool compare_at(const U& a, const U& b) {
+				return union_ref<I>(a) == union_ref<I>(b);
+			}
+		};
+
+		/* Smallest unsigned type able to hold the index of N alternatives. */
+		template<size_t N>
+		using index_type = if_<(N <= 0xff),
+			std::uint8_t,
+			if_<(N <= 0xffff), std::uint16_t, size_t>
+		>;
+
+		/* Whether sum_type<Ts...> can keep its second element in a niche of
+		 * the first, doing away with the index altogether.
+		 */
+		template<typename...Ts>
+		struct has_niche_layout {
+			static constexpr bool value = false;
+		};
+
+		template<typename T, typename E>
+		struct has_niche_layout<T,E> {
+			static constexpr bool value =
+				niche_traits<T>::instance
+				&& std::is_empty<E>::value
+				&& std::is_trivially_default_constructible<E>::value
+				&& std::is_trivially_destructible<E>::value;
+		};
+
+		/* Storage and active index of a sum_type.
+		 *
+		 * The special members that depend on both are added by
+		 * sum_layout_impl, unless they can all be trivial.
+		 */
+		template<typename...Ts>
+		struct sum_layout_base {
+			using storage = sum_storage<Ts...>;
+			using ops = union_ops<storage,gen_seq<0,sizeof...(Ts)-1>,Ts...>;
+
+			template<typename T, typename...Args>
+			explicit constexpr sum_layout_base(constructor<T> t, Args&&...args)
 			noexcept(
-				std::is_nothrow_move_constructible<T>::value
-				&& noexcept(
-					std::declval<recursive_union>().r.move(i-1, std::move(u.r))
-				)
+				std::is_nothrow_constructible<
+					storage,constructor<T>,Args...
+				>::value
 			)
-			{
-				if(i == 0) {
-					new (std::addressof(v)) T(std::move(u.v));
-				}
-				else {
-					r.move(i-1, std::move(u.r));
-				}
-			}
+			: s(t, std::forward<Args>(args)...)
+			, cons(index_of<T,Ts...>::value) {}
 
-			void destruct(size_t i)
+			template<typename T, typename U>
+			constexpr sum_layout_base(
+					constructor<T> t, std::initializer_list<U> l
+			)
 			noexcept(
-				std::is_nothrow_destructible<T>::value
-				&& noexcept(std::declval<recursive_union>().r.destruct(i))
+				std::is_nothrow_constructible<
+					storage,constructor<T>,std::initializer_list<U>
+				>::value
 			)
-			{
-				if(i == 0)
-				{
-					v.~T();
-				}
-				else {
-					r.destruct(i-1);
-				}
+			: s(t, l), cons(index_of<T,Ts...>::value) {}
+
+			constexpr size_t index() const noexcept {
+				return cons;
 			}
 
-			constexpr bool compare(size_t i, const recursive_union& rhs) const
-			noexcept {
-				return i == 0 ? v == rhs.v : r.compare(i-1, rhs.r);
+			bool compare(size_t i, const sum_layout_base& l) const {
+				return ops::compare(i, s, l.s);
 			}
 
-			union {
-				T v;
-				recursive_union<Ts...> r;
+			template<size_t I>
+			FTL_CONSTEXPR14 type_at<I,Ts...>& ref() noexcept {
+				return union_ref<I>(s);
+			}
+
+			template<size_t I>
+			constexpr const type_at<I,Ts...>& ref() const noexcept {
+				return union_ref<I>(s);
+			}
+
+			// Must only be used when the constructor cannot throw
+			template<size_t I, typename...Args>
+			void emplace(Args&&...args) noexcept {
+				using T = type_at<I,Ts...>;
+
+				if(!All<std::is_trivially_destructible,Ts...>::value)
+					ops::destruct(cons, s);
+
+				new (static_cast<void*>(std::addressof(union_ref<I>(s))))
+					T(std::forward<Args>(args)...);
+				cons = I;
+			}
+
+			storage s;
+			index_type<sizeof...(Ts)> cons;
+
+		protected:
+			// Leaves the layout uninitialised, for copy and move
+			sum_layout_base() noexcept {}
+		};
+
+		/* Elements for which destruction followed by copy construction is
+		 * the same as plain, trivial assignment.
+		 */
+		template<typename T>
+		struct is_trivial_element {
+			static constexpr bool value =
+				std::is_trivially_copy_constructible<T>::value
+				&& std::is_trivially_move_constructible<T>::value
+				&& std::is_trivially_copy_assignable<T>::value
+				&& std::is_trivially_move_assignable<T>::value
+				&& std::is_trivially_destructible<T>::value;
+		};
+
+		template<bool Niche, bool Trivial, typename...Ts>
+		struct sum_layout_impl;
+
+		template<typename...Ts>
+		using sum_layout = sum_layout_impl<
+			has_niche_layout<Ts...>::value,
+			All<is_trivial_element,Ts...>::value,
+			Ts...
+		>;
+
+		/* If every element is trivially copyable, then so is the layout:
+		 * copying is a plain copy of the union and the index.
+		 */
+		template<typename...Ts>
+		struct sum_layout_impl<false,true,Ts...> : sum_layout_base<Ts...> {
+			using sum_layout_base<Ts...>::sum_layout_base;
+		};
+
+		template<typename...Ts>
+		struct sum_layout_impl<false,false,Ts...> : sum_layout_base<Ts...> {
+			using base = sum_layout_base<Ts...>;
+			using typename base::storage;
+			using typename base::ops;
+			using base::s;
+			using base::cons;
+
+			using base::base;
+
+			sum_layout_impl(const sum_layout_impl& l)
+			noexcept(noexcept(ops::copy(0, std::declval<storage&>(), l.s)))
+			: base() {
+				cons = l.cons;
+				ops::copy(cons, s, l.s);
+			}
+
+			sum_layout_impl(sum_layout_impl&& l)
+			noexcept(noexcept(ops::move(0, std::declval<storage&>(), l.s)))
+			: base() {
+				cons = l.cons;
+				ops::move(cons, s, l.s);
+			}
+
+			~sum_layout_impl()
+			noexcept(noexcept(ops::destruct(0, std::declval<storage&>()))) {
+				ops::destruct(cons, s);
+			}
+
+			// TODO: Use assignment instead of construction if cons and l.cons
+			// are equal
+			sum_layout_impl& operator= (const sum_layout_impl& l) {
+				// Deal with self assignment
+				if(std::addressof(l) == this)
+					return *this;
+
+				ops::destruct(cons, s);
+				cons = l.cons;
+				ops::copy(cons, s, l.s);
+
+				return *this;
+			}
+
+			sum_layout_impl& operator= (sum_layout_impl&& l) {
+				// Deal with self assignment
+				if(std::addressof(l) == this)
+					return *this;
+
+				ops::destruct(cons, s);
+				cons = l.cons;
+				ops::move(cons, s, l.s);
+
+				return *this;
+			}
+		};
+
+		/* A T with a niche, where the niche stands in for E.
+		 *
+		 * Since T must be trivially copyable and E is empty, all special
+		 * members are trivial.
+		 */
+		template<bool Trivial, typename T, typename E>
+		struct sum_layout_impl<true,Trivial,T,E> {
+			static_assert(
+				std::is_trivially_copyable<T>::value,
+				"Types with a niche must be trivially copyable"
+			);
+
+			template<typename...Args>
+			explicit sum_layout_impl(constructor<T>, Args&&...args)
+			noexcept(std::is_nothrow_constructible<T,Args...>::value) {
+				new (static_cast<void*>(s.bytes)) T(std::forward<Args>(args)...);
+			}
+
+			template<typename U>
+			sum_layout_impl(constructor<T>, std::initializer_list<U> l)
+			noexcept(
+				std::is_nothrow_constructible<T,std::initializer_list<U>>::value
+			) {
+				new (static_cast<void*>(s.bytes)) T(l);
+			}
+
+			explicit sum_layout_impl(constructor<E>) noexcept {
+				niche_traits<T>::set_niche(std::addressof(union_ref<0>(s)));
+			}
+
+			size_t index() const noexcept {
+				return niche_traits<T>::is_niche(std::addressof(union_ref<0>(s)));
+			}
+
+			bool compare(size_t i, const sum_layout_impl& l) const {
+				return i == 1 || union_ref<0>(s) == union_ref<0>(l.s);
+			}
+
+			// Must only be used when the constructor cannot throw
+			template<size_t I, typename...Args>
+			void emplace(Args&&...args) noexcept {
+				emplace(
+					std::integral_constant<size_t,I>(),
+					std::forward<Args>(args)...
+				);
+			}
+
+			template<size_t I>
+			type_at<I,T,E>& ref() noexcept {
+				return ref(std::integral_constant<size_t,I>());
+			}
+
+			template<size_t I>
+			const type_at<I,T,E>& ref() const noexcept {
+				return ref(std::integral_constant<size_t,I>());
+			}
+
+			flat_union<T> s;
+
+		private:
+			T& ref(std::integral_constant<size_t,0>) noexcept {
+				return union_ref<0>(s);
+			}
+
+			const T& ref(std::integral_constant<size_t,0>) const noexcept {
+				return union_ref<0>(s);
+			}
+
+			// E has no state, any instance will do
+			E& ref(std::integral_constant<size_t,1>) noexcept {
+				static E e;
+				return e;
+			}
+
+			const E& ref(std::integral_constant<size_t,1>) const noexcept {
+				static const E e{};
+				return e;
+			}
+
+			template<typename...Args>
+			void emplace(std::integral_constant<size_t,0>, Args&&...args) {
+				new (static_cast<void*>(s.bytes)) T(std::forward<Args>(args)...);
+			}
+
+			void emplace(std::integral_constant<size_t,1>) noexcept {
+				niche_traits<T>::set_niche(std::addressof(union_ref<0>(s)));
+			}
+		};
+
+		/* Dispatches a match to the clause handling the active element.
+		 *
+		 * Rather than comparing the active index against every possible
+		 * index in turn, a table of visiting functions is generated for each
+		 * set of match clauses, and the index used to look up the right one.
+		 * Matching on the final element of a wide sum type is thus exactly as
+		 * cheap as matching on the first.
+		 */
+		template<typename R, typename, typename...>
+		struct union_dispatcher;
+
+		template<typename R, size_t...Is, typename...Ts>
+		struct union_dispatcher<R,seq<Is...>,Ts...> {
+			template<typename U, typename...Fs>
+			static FTL_CONSTEXPR14 R visit(U& u, size_t i, Fs&&...fs) {
+				return table<U,Fs...>::value[i](u, std::forward<Fs>(fs)...);
+			}
+
+		private:
+			template<size_t I, typename U, typename...Fs>
+			static FTL_CONSTEXPR14 R visit_at(U& u, Fs&&...fs) {
+				using T = type_at<I,Ts...>;
+
+				return union_visitor<R,T>::visit(
+					overload_tag<T>{},
+					u.template ref<I>(),
+					std::forward<Fs>(fs)...
+				);
+			}
+
+			// A static data member rather than a local, so that visit may
+			// be constexpr
+			template<typename U, typename...Fs>
+			struct table {
+				using visit_t = R (*) (U&, Fs&&...);
+
+				static constexpr visit_t value[sizeof...(Is)] = {
+					&visit_at<Is,U,Fs...>...
+				};
 			};
 		};
 
+		template<typename R, size_t...Is, typename...Ts>
+		template<typename U, typename...Fs>
+		constexpr typename union_dispatcher<R,seq<Is...>,Ts...>
+			::template table<U,Fs...>::visit_t
+		union_dispatcher<R,seq<Is...>,Ts...>
+			::table<U,Fs...>::value[sizeof...(Is)];
+
 		template<size_t I, typename...Ts>
 		class get_sum_type_element;
 
@@ -586,6 +878,11 @@ namespace ftl {
 	 * - \ref copyassignable, if all sub-types are CopyConstructible
 	 * - \ref moveassignable, if all sub-types are MoveConstructible
 	 *
+	 * If all sub-types are trivially copyable, so is the sum type. With
+	 * `FTL_CPP14` defined, such sum types of literal types can also be
+	 * constructed, matched on (with constexpr match clauses) and accessed in
+	 * constant expressions.
+	 *
 	 * \ingroup sum_type
 	 */
 	template<typename...Ts>
@@ -600,15 +897,13 @@ namespace ftl {
 
 		friend class ::ftl::_dtl::sum_type_accessor;
 
+		using layout = _dtl::sum_layout<Ts...>;
+		using indices = gen_seq<0,sizeof...(Ts)-1>;
+
 	public:
 		sum_type() = delete;
-		sum_type(const sum_type& st) : cons(st.cons) {
-			data.copy(cons, st.data);
-		}
-
-		sum_type(sum_type&& st) : cons(st.cons) {
-			data.move(cons, std::move(st.data));
-		}
+		sum_type(const sum_type&) = default;
+		sum_type(sum_type&&) = default;
 
 		/**
 		 * Construct the sum type as an instance of `T`.
@@ -619,11 +914,10 @@ namespace ftl {
 		explicit constexpr sum_type(constructor<T> t, Args&&...args)
 		noexcept(
 			std::is_nothrow_constructible<
-				_dtl::recursive_union<Ts...>,constructor<T>,Args...
+				layout,constructor<T>,Args...
 			>::value
 		)
-		: data(t, std::forward<Args>(args)...)
-		, cons(index_of<T,Ts...>::value) {}
+		: data(t, std::forward<Args>(args)...) {}
 
 		/**
 		 * Construct as an instance of `T`, using an initializer_list.
@@ -640,20 +934,15 @@ namespace ftl {
 		)
 		noexcept(
 			std::is_nothrow_constructible<
-				_dtl::recursive_union<Ts...>,
+				layout,
 				constructor<T>,
 				std::initializer_list<U>
 			>::value
 		)
-		: data(t, l), cons(index_of<T,Ts...>::value)
+		: data(t, l)
 		{}
 
-		~sum_type() noexcept(
-			noexcept(std::declval<_dtl::recursive_union<Ts...>>().destruct(0))
-		)
-		{
-			data.destruct(cons);
-		}
+		~sum_type() = default;
 
 		/**
 		 * Check whether the `sum_type` is currently an instance of `T`.
@@ -669,7 +958,7 @@ namespace ftl {
 		 */
 		template<typename T>
 		constexpr bool is() const noexcept {
-			return cons == index_of<T,Ts...>::value;
+			return data.index() == index_of<T,Ts...>::value;
 		}
 
 		/**
@@ -686,33 +975,54 @@ namespace ftl {
 		 */
 		template<size_t I>
 		constexpr bool isTypeAt() const noexcept {
-			return cons == I;
+			return data.index() == I;
 		}
 
-		// TODO: Use assignment instead of construction if cons and s.cons
-		// are equal
-		sum_type& operator= (const sum_type& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
-
-			data.destruct(cons);
-			cons = s.cons;
-			data.copy(cons, s.data);
+		sum_type& operator= (const sum_type&) = default;
+		sum_type& operator= (sum_type&&) = default;
 
-			return *this;
-		}
-
-		sum_type& operator= (sum_type&& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
+		/**
+		 * Replace the active element with a `U`, constructed in place.
+		 *
+		 * `args` are forwarded to `U`'s constructor. Unlike assigning a newly
+		 * constructed sum type, no temporary sum type is created, and the old
+		 * element is destroyed directly rather than by a move and destruct.
+		 *
+		 * Gives the strong exception guarantee: if `U`'s constructor throws,
+		 * the sum type is left unchanged. To be able to give it, `U` must be
+		 * either nothrow constructible from `args`, or nothrow move
+		 * constructible. In the latter case, a `U` is first constructed on the
+		 * side, then moved into place.
+		 *
+		 * \return A reference to the new element.
+		 *
+		 * \par Examples
+		 *
+		 * \code
+		 *   sum_type<int,std::string> x{constructor<int>(), 5};
+		 *   x.emplace<std::string>(3, 'a');
+		 *   // get<std::string>(x) == "aaa"
+		 * \endcode
+		 */
+		template<typename U, typename...Args>
+		U& emplace(Args&&...args)
+		noexcept(std::is_nothrow_constructible<U,Args...>::value) {
+			static_assert(
+				std::is_nothrow_constructible<U,Args...>::value
+				|| std::is_nothrow_move_constructible<U>::value,
+				"emplace requires U to be nothrow constructible from the "
+				"arguments, or nothrow move constructible"
+			);
 
-			data.destruct(cons);
-			cons = s.cons;
-			data.move(cons, std::move(s.data));
+			emplace_(
+				std::integral_constant<
+					bool, std::is_nothrow_constructible<U,Args...>::value
+				>(),
+				constructor<U>(),
+				std::forward<Args>(args)...
+			);
 
-			return *this;
+			return data.template ref<index_of<U,Ts...>::value>();
 		}
 
 		/**
@@ -765,32 +1075,30 @@ namespace ftl {
 		 *
 		 */
 		template<typename...Fs>
-		auto match(Fs&&...fs) const -> typename ::ftl::_dtl::common_return_type<
+		FTL_CONSTEXPR14 auto match(Fs&&...fs) const -> typename ::ftl::_dtl::common_return_type<
 			type_seq<Ts...>,type_seq<Fs...>
 		>::type {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 			using return_type = typename _dtl::common_return_type<
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
-			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			return _dtl::union_dispatcher<return_type,indices,Ts...>
+				::visit(data, data.index(), std::forward<Fs>(fs)...);
 		}
 
 		/// \overload
 		template<typename...Fs>
-		auto match(Fs&&...fs) -> typename ::ftl::_dtl::common_return_type<
+		FTL_CONSTEXPR14 auto match(Fs&&...fs) -> typename ::ftl::_dtl::common_return_type<
 			type_seq<Ts...>,type_seq<Fs...>
 		>::type {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 			using return_type = typename _dtl::common_return_type<
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
-			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			return _dtl::union_dispatcher<return_type,indices,Ts...>
+				::visit(data, data.index(), std::forward<Fs>(fs)...);
 		}
 
 		/**
@@ -846,27 +1154,37 @@ namespace ftl {
 		 *
 		 */
 		template<typename...Fs>
-		void matchE(Fs&&...fs) {
+		FTL_CONSTEXPR14 void matchE(Fs&&...fs) {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 
-			::ftl::_dtl::union_visitor<void,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			::ftl::_dtl::union_dispatcher<void,indices,Ts...>
+				::visit(data, data.index(), std::forward<Fs>(fs)...);
 		}
 
 		/// \overload
 		template<typename...Fs>
-		void matchE(Fs&&...fs) const {
+		FTL_CONSTEXPR14 void matchE(Fs&&...fs) const {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 
-			::ftl::_dtl::union_visitor<void,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			::ftl::_dtl::union_dispatcher<void,indices,Ts...>
+				::visit(data, data.index(), std::forward<Fs>(fs)...);
 		}
 
 	private:
-		_dtl::recursive_union<Ts...> data;
-		size_t cons;
+		template<typename U, typename...Args>
+		void emplace_(std::true_type, constructor<U>, Args&&...args) noexcept {
+			data.template emplace<index_of<U,Ts...>::value>(
+				std::forward<Args>(args)...
+			);
+		}
+
+		template<typename U, typename...Args>
+		void emplace_(std::false_type, constructor<U>, Args&&...args) {
+			U u(std::forward<Args>(args)...);
+			data.template emplace<index_of<U,Ts...>::value>(std::move(u));
+		}
+
+		layout data;
 	};
 
 	namespace _dtl {
@@ -875,11 +1193,24 @@ namespace ftl {
 			template<typename...Ts>
 			static constexpr size_t activeIndex(const sum_type<Ts...>& u)
 			noexcept {
-				return u.cons;
+				return u.data.index();
+			}
+
+			template<size_t I, typename...Ts>
+			static FTL_CONSTEXPR14 type_at<I,Ts...>& ref(sum_type<Ts...>& u)
+			noexcept {
+				return u.data.template ref<I>();
+			}
+
+			template<size_t I, typename...Ts>
+			static constexpr const type_at<I,Ts...>& ref(
+					const sum_type<Ts...>& u
+			) noexcept {
+				return u.data.template ref<I>();
 			}
 
 			template<typename...Ts>
-			static constexpr bool compareAt(size_t i,
+			static bool compareAt(size_t i,
 					const sum_type<Ts...>& a, const sum_type<Ts...>& b
 			) noexcept
 			{
@@ -890,32 +1221,30 @@ namespace ftl {
 		template<size_t I, typename...Ts>
 		class get_sum_type_element {
 		public:
-			// TODO: C++14: With relaxed constexpr requirements,
-			// these are possible candidates
-			static auto get(sum_type<Ts...>& u)
-			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
+			static FTL_CONSTEXPR14 auto get(sum_type<Ts...>& u)
+			-> decltype(u.data.template ref<I>()) {
+				if(u.data.index() != I)
 					throw invalid_sum_type_access{
 						std::string("Indexing with ")
 						+ std::to_string(I)
 						+ std::string(", but active index is ")
-						+ std::to_string(u.cons)
+						+ std::to_string(u.data.index())
 					};
 
-				return union_indexer<I,Ts...>::ref(u.data);
+				return u.data.template ref<I>();
 			}
 
-			static auto get(const sum_type<Ts...>& u)
-			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
+			static FTL_CONSTEXPR14 auto get(const sum_type<Ts...>& u)
+			-> decltype(u.data.template ref<I>()) {
+				if(u.data.index() != I)
 					throw invalid_sum_type_access{
 						std::string("Indexing with ")
 						+ std::to_string(I)
 						+ std::string(", but active index is ")
-						+ std::to_string(u.cons)
+						+ std::to_string(u.data.index())
 					};
 
-				return union_indexer<I,Ts...>::ref(u.data);
+				return u.data.template ref<I>();
 			}
 		};
 	}
@@ -997,6 +1326,308 @@ namespace ftl {
 	bool operator!= (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
 		return !(a == b);
 	}
+
+	namespace _dtl {
+		template<typename>
+		struct is_sum_type {
+			static constexpr bool value = false;
+		};
+
+		template<typename...Ts>
+		struct is_sum_type<sum_type<Ts...>> {
+			static constexpr bool value = true;
+		};
+
+		// Number of leading arguments that are sum types
+		template<typename...>
+		struct count_subjects {
+			static constexpr size_t value = 0;
+		};
+
+		template<typename A, typename...As>
+		struct count_subjects<A,As...> {
+			static constexpr size_t value =
+				is_sum_type<plain_type<A>>::value
+				? 1 + count_subjects<As...>::value
+				: 0;
+		};
+
+		template<typename>
+		struct subject_traits;
+
+		template<typename...Ts>
+		struct subject_traits<sum_type<Ts...>> {
+			static constexpr size_t size = sizeof...(Ts);
+
+			template<size_t I>
+			using element = type_at<I,Ts...>&;
+		};
+
+		template<typename...Ts>
+		struct subject_traits<const sum_type<Ts...>> {
+			static constexpr size_t size = sizeof...(Ts);
+
+			template<size_t I>
+			using element = const type_at<I,Ts...>&;
+		};
+
+		template<bool...>
+		struct all_of {
+			static constexpr bool value = true;
+		};
+
+		template<bool B, bool...Bs>
+		struct all_of<B,Bs...> {
+			static constexpr bool value = B && all_of<Bs...>::value;
+		};
+
+		template<size_t...>
+		struct size_product {
+			static constexpr size_t value = 1;
+		};
+
+		template<size_t N, size_t...Ns>
+		struct size_product<N,Ns...> {
+			static constexpr size_t value = N * size_product<Ns...>::value;
+		};
+
+		template<size_t, typename>
+		struct prepend_index;
+
+		template<size_t I, size_t...Is>
+		struct prepend_index<I,seq<Is...>> {
+			using type = seq<I,Is...>;
+		};
+
+		/* The digits of K in a mixed radix system with radices Ns, most
+		 * significant first. This is how a combined index into a cross
+		 * product of sum types is taken apart.
+		 */
+		template<size_t K, size_t...Ns>
+		struct radix_digits {
+			using type = seq<>;
+		};
+
+		template<size_t K, size_t N, size_t...Ns>
+		struct radix_digits<K,N,Ns...> {
+			using type = typename prepend_index<
+				(K / size_product<Ns...>::value) % N,
+				typename radix_digits<K % size_product<Ns...>::value,Ns...>::type
+			>::type;
+		};
+
+		template<typename, typename...>
+		struct find_multi_call_match {
+			using type = _dtl::no;
+		};
+
+		template<typename...As, typename F, typename...Fs>
+		struct find_multi_call_match<type_seq<As...>,F,Fs...> {
+			using type = if_<is_callable<F,As...>::value,
+				  typename is_callable<F,As...>::type,
+				  typename find_multi_call_match<type_seq<As...>,Fs...>::type
+			>;
+		};
+
+		// Invokes the first of Fs that accepts As
+		template<typename R, typename, typename>
+		struct clause_picker;
+
+		template<typename R, typename...As, size_t...Js>
+		struct clause_picker<R,type_seq<As...>,seq<Js...>> {
+			template<typename F, typename...Fs>
+			static FTL_CONSTEXPR14
+			typename std::enable_if<is_callable<F,As...>::value,R>::type
+			visit(std::tuple<As...>& as, F&& f, Fs&&...) {
+				return std::forward<F>(f)(std::get<Js>(as)...);
+			}
+
+			template<typename F, typename...Fs>
+			static FTL_CONSTEXPR14
+			typename std::enable_if<!is_callable<F,As...>::value,R>::type
+			visit(std::tuple<As...>& as, F&&, Fs&&...fs) {
+				return clause_picker::visit(as, std::forward<Fs>(fs)...);
+			}
+		};
+
+		/* Matches on several sum types at once.
+		 *
+		 * Every combination of elements gets an entry in a single table,
+		 * indexed by the combination of the sum types' active indices.
+		 */
+		template<typename Ss, typename Fs, typename Ks>
+		struct multi_match;
+
+		template<typename...Ss, typename...Fs, size_t...Ks>
+		struct multi_match<type_seq<Ss...>,type_seq<Fs...>,seq<Ks...>> {
+		private:
+			template<typename S>
+			using traits = subject_traits<typename std::remove_reference<S>::type>;
+
+			template<size_t K>
+			using digits = typename radix_digits<K,traits<Ss>::size...>::type;
+
+			template<typename>
+			struct elements_at;
+
+			template<size_t...Ds>
+			struct elements_at<seq<Ds...>> {
+				using type = type_seq<
+					typename traits<Ss>::template element<Ds>...
+				>;
+			};
+
+			template<size_t K>
+			using clause_result = typename find_multi_call_match<
+				typename elements_at<digits<K>>::type, Fs...
+			>::type;
+
+			static_assert(
+				all_of<!std::is_same<clause_result<Ks>,_dtl::no>::value...>
+					::value,
+				"Match expressions must be exhaustive"
+			);
+
+		public:
+			using result_type =
+				typename std::common_type<clause_result<Ks>...>::type;
+
+		private:
+			using R = result_type;
+			using subjects = std::tuple<
+				typename std::remove_reference<Ss>::type&...
+			>;
+
+			template<size_t...Ds, size_t...Js>
+			static FTL_CONSTEXPR14 R visit_digits(
+					seq<Ds...>, seq<Js...>, subjects& ss, Fs&&...fs
+			) {
+				using As = type_seq<typename traits<Ss>::template element<Ds>...>;
+
+				std::tuple<typename traits<Ss>::template element<Ds>...> as{
+					sum_type_accessor::template ref<Ds>(std::get<Js>(ss))...
+				};
+
+				return clause_picker<R,As,seq<Js...>>::visit(
+					as, std::forward<Fs>(fs)...
+				);
+			}
+
+			template<size_t K>
+			static FTL_CONSTEXPR14 R visit_at(subjects& ss, Fs&&...fs) {
+				return visit_digits(
+					digits<K>{}, gen_seq<0,sizeof...(Ss)-1>{},
+					ss, std::forward<Fs>(fs)...
+				);
+			}
+
+			struct table {
+				using visit_t = R (*) (subjects&, Fs&&...);
+
+				static constexpr visit_t value[sizeof...(Ks)] = {
+					&visit_at<Ks>...
+				};
+			};
+
+			static FTL_CONSTEXPR14 size_t index(const subjects& ss) {
+				return index(ss, gen_seq<0,sizeof...(Ss)-1>{});
+			}
+
+			template<size_t...Js>
+			static FTL_CONSTEXPR14 size_t index(
+					const subjects& ss, seq<Js...>
+			) {
+				const size_t is[] = {
+					sum_type_accessor::activeIndex(std::get<Js>(ss))...
+				};
+				const size_t ns[] = { traits<Ss>::size... };
+
+				size_t k = 0;
+				for(size_t j = 0; j < sizeof...(Ss); ++j)
+					k = k * ns[j] + is[j];
+
+				return k;
+			}
+
+		public:
+			static FTL_CONSTEXPR14 R visit(Ss&&...ss, Fs&&...fs) {
+				subjects t{ss...};
+				return table::value[index(t)](t, std::forward<Fs>(fs)...);
+			}
+		};
+
+		template<typename...Ss, typename...Fs, size_t...Ks>
+		constexpr typename multi_match<type_seq<Ss...>,type_seq<Fs...>,seq<Ks...>>
+			::table::visit_t
+		multi_match<type_seq<Ss...>,type_seq<Fs...>,seq<Ks...>>
+			::table::value[sizeof...(Ks)];
+
+		template<typename, typename>
+		struct multi_match_of;
+
+		template<typename...Ss, typename...Fs>
+		struct multi_match_of<type_seq<Ss...>,type_seq<Fs...>> {
+			using type = multi_match<
+				type_seq<Ss...>,
+				type_seq<Fs...>,
+				gen_seq<0,
+					size_product<
+						subject_traits<typename std::remove_reference<Ss>::type>
+							::size...
+					>::value - 1
+				>
+			>;
+		};
+
+		template<typename...Args>
+		using multi_match_for = typename multi_match_of<
+			typename take_types<count_subjects<Args...>::value,Args...>::type,
+			typename drop_types<count_subjects<Args...>::value,Args...>::type
+		>::type;
+	}
+
+	/**
+	 * Pattern match on several sum types at once.
+	 *
+	 * All leading arguments that are sum types are matched on, the rest of
+	 * the arguments are the match clauses. Each clause takes one argument per
+	 * matched sum type, or may use `otherwise` in place of any of them.
+	 *
+	 * Clauses are selected the same way as in `sum_type::match`: the first
+	 * one that can be called with the active elements is used. It is a
+	 * compile time error if some combination of elements is not covered by
+	 * any clause.
+	 *
+	 * Rather than nesting one dispatch per sum type, the combined active
+	 * indices are used to index a single table.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   either<int,float> e = ...;
+	 *   maybe<int> m = ...;
+	 *
+	 *   auto r = match(e, m,
+	 *       [](Left<int>, int x){ return x; },
+	 *       [](float y, int x){ return y + x; },
+	 *       [](otherwise, Nothing){ return 0.f; }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<
+			typename...Args,
+			typename = typename std::enable_if<
+				(_dtl::count_subjects<Args...>::value > 0)
+			>::type
+	>
+	FTL_CONSTEXPR14 auto match(Args&&...args)
+	-> typename _dtl::multi_match_for<Args...>::result_type {
+		return _dtl::multi_match_for<Args...>::visit(
+			std::forward<Args>(args)...
+		);
+	}
 }
 
 #endif
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SUM_VECTOR_H
+#define FTL_SUM_VECTOR_H
+
+#include <vector>
+#include <tuple>
+#include "sum_type.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup sum_vector Sum Vector
+	 *
+	 * A sequence of sum types, stored one column per sub-type.
+	 *
+	 * \code
+	 *   #include <ftl/sum_vector.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <vector>
+	 * - <tuple>
+	 * - \ref sum_type
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	/**
+	 * Sequence container of `sum_type<Ts...>`, in "struct of arrays" form.
+	 *
+	 * Rather than storing each element as a complete sum type, with room for
+	 * the largest sub-type and an index, a `sum_vector` keeps a dense array of
+	 * indices, and one tightly packed `std::vector` per sub-type.
+	 *
+	 * Elements can be appended and read (by value), but not removed or
+	 * modified in place, other than through `match_all`.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref assignable
+	 * - \ref functor
+	 * - \ref foldable
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   sum_vector<int,std::string> v;
+	 *   v.push_back(sum_type<int,std::string>{constructor<int>(), 5});
+	 *   v.emplace_back<std::string>("foo");
+	 *
+	 *   int n = 0;
+	 *   v.match_all(
+	 *       [&](int x){ n += x; },
+	 *       [&](const std::string& s){ n += s.size(); }
+	 *   );
+	 *   // n == 8
+	 * \endcode
+	 *
+	 * \ingroup sum_vector
+	 */
+	template<typename...Ts>
+	class sum_vector {
+		using indices = gen_seq<0,sizeof...(Ts)-1>;
+		using index_t = _dtl::index_type<sizeof...(Ts)>;
+
+	public:
+		/// The type of the elements of the sequence.
+		using value_type = sum_type<Ts...>;
+
+		using size_type = size_t;
+
+		/// Number of elements.
+		size_type size() const noexcept {
+			return tags.size();
+		}
+
+		bool empty() const noexcept {
+			return tags.empty();
+		}
+
+		/// Number of elements whose active sub-type is `T`.
+		template<typename T>
+		size_type count() const noexcept {
+			return column<T>().size();
+		}
+
+		/**
+		 * Reserve room for `n` elements.
+		 *
+		 * As it is not known what sub-types future elements will be, only
+		 * the bookkeeping arrays are affected. Use `reserve<T>` to reserve room
+		 * in a particular column.
+		 */
+		void reserve(size_type n) {
+			tags.reserve(n);
+			offsets.reserve(n);
+		}
+
+		/// Reserve room for `n` elements of sub-type `T`.
+		template<typename T>
+		void reserve(size_type n) {
+			mutable_column<T>().reserve(n);
+		}
+
+		void clear() noexcept {
+			tags.clear();
+			offsets.clear();
+			clear_columns(indices());
+		}
+
+		/// Append a copy of a sum type.
+		void push_back(const value_type& x) {
+			using push_t = void (*) (sum_vector&, const value_type&);
+
+			static constexpr push_t table[] = { &push_at<Ts>... };
+
+			table[_dtl::sum_type_accessor::activeIndex(x)](*this, x);
+		}
+
+		/// \overload
+		void push_back(value_type&& x) {
+			using push_t = void (*) (sum_vector&, value_type&);
+
+			static constexpr push_t table[] = { &move_at<Ts>... };
+
+			table[_dtl::sum_type_accessor::activeIndex(x)](*this, x);
+		}
+
+		/// Append a `T`, constructed from `args`.
+		template<typename T, typename...Args>
+		void emplace_back(Args&&...args) {
+			auto& c = mutable_column<T>();
+			c.emplace_back(std::forward<Args>(args)...);
+
+			note<T>(c.size() - 1);
+		}
+
+		/**
+		 * Copy the element at position `i`.
+		 *
+		 * As elements are not stored as sum types, the returned value is
+		 * constructed on demand.
+		 */
+		value_type operator[] (size_type i) const {
+			using at_t = value_type (*) (const sum_vector&, size_type);
+
+			static constexpr at_t table[] = { &at<Ts>... };
+
+			return table[tags[i]](*this, offsets[i]);
+		}
+
+		/// The packed array of all elements of type `T`.
+		template<typename T>
+		const std::vector<T>& column() const noexcept {
+			return std::get<index_of<T,Ts...>::value>(columns);
+		}
+
+		/**
+		 * Apply match clauses to every element.
+		 *
+		 * Unlike calling `match` on each element of a `std::vector` of sum
+		 * types, elements are visited one sub-type at a time: first every
+		 * element of the first sub-type, then the second, and so on. In each
+		 * case, the loop runs over a packed array of one type, calling the
+		 * same clause, which the compiler is free to vectorise.
+		 *
+		 * Relative order is preserved among elements of the same sub-type, but
+		 * not between different sub-types.
+		 *
+		 * The clauses are subject to the same exhaustiveness check as
+		 * `sum_type::match`. Their results, if any, are discarded.
+		 */
+		template<typename...Fs>
+		void match_all(Fs&&...fs) {
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+				"Match expressions must be exhaustive"
+			);
+
+			match_columns(*this, indices(), fs...);
+		}
+
+		/// \overload
+		template<typename...Fs>
+		void match_all(Fs&&...fs) const {
+			static_assert(
+				_dtl::exhaustive_match<type_seq<Fs...>,type_seq<Ts...>>::value,
+				"Match expressions must be exhaustive"
+			);
+
+			match_columns(*this, indices(), fs...);
+		}
+
+	private:
+		template<typename T>
+		std::vector<T>& mutable_column() noexcept {
+			return std::get<index_of<T,Ts...>::value>(columns);
+		}
+
+		template<typename T>
+		void note(size_type offset) {
+			tags.push_back(static_cast<index_t>(index_of<T,Ts...>::value));
+			offsets.push_back(offset);
+		}
+
+		template<typename T>
+		static void push_at(sum_vector& v, const value_type& x) {
+			v.template emplace_back<T>(get<T>(x));
+		}
+
+		template<typename T>
+		static void move_at(sum_vector& v, value_type& x) {
+			v.template emplace_back<T>(std::move(get<T>(x)));
+		}
+
+		template<typename T>
+		static value_type at(const sum_vector& v, size_type offset) {
+			return value_type{constructor<T>(), v.column<T>()[offset]};
+		}
+
+		template<size_t...Is>
+		void clear_columns(seq<Is...>) noexcept {
+			int dummy[] = { (std::get<Is>(columns).clear(), 0)... };
+			(void)dummy;
+		}
+
+		template<typename V, size_t...Is, typename...Fs>
+		static void match_columns(V& v, seq<Is...>, Fs&...fs) {
+			int dummy[] = { (match_column<Is>(v, fs...), 0)... };
+			(void)dummy;
+		}
+
+		template<size_t I, typename V, typename...Fs>
+		static void match_column(V& v, Fs&...fs) {
+			using T = type_at<I,Ts...>;
+
+			for(auto& x : std::get<I>(v.columns)) {
+				_dtl::union_visitor<void,T>::visit(
+					_dtl::overload_tag<T>{}, x, fs...
+				);
+			}
+		}
+
+		std::vector<index_t> tags;
+		std::vector<size_type> offsets;
+		std::tuple<std::vector<Ts>...> columns;
+	};
+
+	namespace _dtl {
+		template<typename U>
+		struct sum_vector_of {
+			using type = std::vector<U>;
+		};
+
+		template<typename...Us>
+		struct sum_vector_of<sum_type<Us...>> {
+			using type = sum_vector<Us...>;
+		};
+	}
+
+	/**
+	 * Parametric type traits for sum_vector.
+	 *
+	 * Rebinding to another sum type yields another `sum_vector`. Rebinding to
+	 * anything else yields a `std::vector`.
+	 *
+	 * \ingroup sum_vector
+	 */
+	template<typename...Ts>
+	struct parametric_type_traits<sum_vector<Ts...>> {
+		using value_type = sum_type<Ts...>;
+
+		template<typename U>
+		using rebind = typename _dtl::sum_vector_of<U>::type;
+	};
+
+	/**
+	 * Functor instance for sum_vector.
+	 *
+	 * Maps over the elements in order.
+	 *
+	 * \ingroup sum_vector
+	 */
+	template<typename...Ts>
+	struct functor<sum_vector<Ts...>> {
+		using T = sum_type<Ts...>;
+
+		template<typename U>
+		using F = Rebind<sum_vector<Ts...>,U>;
+
+		template<typename Fn, typename U = result_of<Fn(T)>>
+		static F<U> map(Fn&& fn, const sum_vector<Ts...>& v) {
+			F<U> r;
+			r.reserve(v.size());
+
+			for(size_t i = 0; i < v.size(); ++i)
+				r.push_back(fn(v[i]));
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for sum_vector.
+	 *
+	 * Folds over the elements in order.
+	 *
+	 * \ingroup sum_vector
+	 */
+	template<typename...Ts>
+	struct foldable<sum_vector<Ts...>>
+	: deriving_foldMap<sum_vector<Ts...>>, deriving_fold<sum_vector<Ts...>> {
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<Fn(U,sum_type<Ts...>)>>::value
+				>
+		>
+		static U foldl(Fn&& fn, U z, const sum_vector<Ts...>& v) {
+			for(size_t i = 0; i < v.size(); ++i)
+				z = fn(std::move(z), v[i]);
+
+			return z;
+		}
+
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<Fn(sum_type<Ts...>,U)>>::value
+				>
+		>
+		static U foldr(Fn&& fn, U z, const sum_vector<Ts...>& v) {
+			for(size_t i = v.size(); i > 0; --i)
+				z = fn(v[i-1], std::move(z));
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
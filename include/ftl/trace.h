@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_TRACE_H
+#define FTL_TRACE_H
+
+#include <utility>
+#include "type_functions.h"
+
+#ifdef FTL_TRACE
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <ostream>
+#endif
+
+/* Number of stages each thread remembers, when tracing. Older ones are
+ * overwritten first.
+ */
+#ifndef FTL_TRACE_BUFFER_SIZE
+#define FTL_TRACE_BUFFER_SIZE 4096
+#endif
+
+namespace ftl {
+	/**
+	 * \defgroup trace Trace
+	 *
+	 * Optional timing of named pipeline stages.
+	 *
+	 * \code
+	 *   #include <ftl/trace.h>
+	 * \endcode
+	 *
+	 * Wrapping a function in `traced` gives it a name, and if `FTL_TRACE` is
+	 * defined (which must then be the case in every translation unit of the
+	 * program), every call to it is recorded: when it started and ended, on
+	 * which thread, and for continuations of an `ftl::future` run by an
+	 * executor, how long they were queued before that. Each thread records
+	 * its own calls in a fixed size ring buffer, without locks.
+	 * `write_chrome_trace` exports what all threads recorded, for
+	 * `chrome://tracing` or Perfetto.
+	 *
+	 * Without `FTL_TRACE`, `traced` returns the function as it is, and none
+	 * of the rest is declared, so traced stages cost nothing.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto r = std::move(f)
+	 *       .then(pool, ftl::traced("parse", parse))
+	 *       .then(pool, ftl::traced("render", render));
+	 *
+	 *   ftl::lazy<config> c(ftl::traced("load config", load));
+	 *
+	 *   // Later, once r and c are done
+	 *   std::ofstream out("trace.json");
+	 *   ftl::write_chrome_trace(out);
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<utility>`
+	 * - \ref typelevel
+	 * - `<chrono>`, `<atomic>`, `<mutex>`, `<memory>`, `<vector>` and
+	 *   `<ostream>`, if `FTL_TRACE` is defined
+	 */
+
+#ifdef FTL_TRACE
+	/**
+	 * Clock used for all trace timestamps.
+	 *
+	 * \ingroup trace
+	 */
+	using trace_clock = std::chrono::steady_clock;
+
+	/**
+	 * One recorded call of a traced function.
+	 *
+	 * Only available if `FTL_TRACE` is defined.
+	 *
+	 * \ingroup trace
+	 */
+	struct trace_event {
+		/// Name given to `traced`
+		const char* name;
+
+		/**
+		 * When the call was queued to run.
+		 *
+		 * Equal to start, unless the call was handed to an executor.
+		 */
+		trace_clock::time_point ready;
+
+		/// When the call started
+		trace_clock::time_point start;
+
+		/// When the call returned or threw
+		trace_clock::time_point end;
+
+		/// Number of the thread the call ran on, counting from 1
+		size_t thread;
+	};
+
+	namespace _dtl {
+		struct trace_record {
+			const char* name;
+			trace_clock::time_point ready;
+			trace_clock::time_point start;
+			trace_clock::time_point end;
+		};
+
+		// Written only by the thread it belongs to
+		struct trace_buffer {
+			explicit trace_buffer(size_t t) noexcept : thread(t) {}
+
+			size_t thread;
+			std::atomic<size_t> head{0};
+			trace_record records[FTL_TRACE_BUFFER_SIZE];
+		};
+
+		// Buffers outlive their threads, so that their calls can be exported
+		struct trace_registry {
+			std::mutex m;
+			std::vector<std::unique_ptr<trace_buffer>> buffers;
+			trace_clock::time_point epoch = trace_clock::now();
+		};
+
+		inline trace_registry& trace_buffers() {
+			static trace_registry r;
+			return r;
+		}
+
+		inline trace_buffer& local_trace_buffer() {
+			static thread_local trace_buffer* b = nullptr;
+			if(!b) {
+				auto& r = trace_buffers();
+				std::lock_guard<std::mutex> lock(r.m);
+				r.buffers.emplace_back(new trace_buffer(r.buffers.size() + 1));
+				b = r.buffers.back().get();
+			}
+
+			return *b;
+		}
+
+		inline void trace_record_call(
+				const char* name, trace_clock::time_point ready,
+				trace_clock::time_point start) {
+			auto& b = local_trace_buffer();
+			auto h = b.head.load(std::memory_order_relaxed);
+			b.records[h % FTL_TRACE_BUFFER_SIZE] = trace_record{
+				name, ready, start, trace_clock::now()
+			};
+			b.head.store(h + 1, std::memory_order_release);
+		}
+
+		// Records a call when it goes out of scope, even if by exception
+		struct trace_scope {
+			~trace_scope() {
+				trace_record_call(name, ready, start);
+			}
+
+			const char* name;
+			trace_clock::time_point ready;
+			trace_clock::time_point start;
+		};
+
+		inline void trace_write_name(std::ostream& os, const char* name) {
+			for(; *name; ++name) {
+				if(*name == '"' || *name == '\\')
+					os << '\\';
+				os << *name;
+			}
+		}
+	}
+
+	/**
+	 * A function that records its calls.
+	 *
+	 * Made by `traced`. Only available if `FTL_TRACE` is defined.
+	 *
+	 * \ingroup trace
+	 */
+	template<typename F>
+	class traced_function {
+	public:
+		traced_function(const char* name, F f)
+		: name(name), f(std::move(f)) {
+			// Start the clock of the trace before any call is timed
+			_dtl::trace_buffers();
+		}
+
+		template<typename...Args>
+		auto operator() (Args&&...args)
+		-> decltype(std::declval<F&>()(std::forward<Args>(args)...)) {
+			auto now = trace_clock::now();
+			_dtl::trace_scope s{name, take_ready(now), now};
+			return f(std::forward<Args>(args)...);
+		}
+
+		template<typename...Args>
+		auto operator() (Args&&...args) const
+		-> decltype(std::declval<const F&>()(std::forward<Args>(args)...)) {
+			auto now = trace_clock::now();
+			_dtl::trace_scope s{name, now, now};
+			return f(std::forward<Args>(args)...);
+		}
+
+		/// Note that the next call is queued to run, as of now
+		void mark_ready() noexcept {
+			ready = trace_clock::now();
+		}
+
+	private:
+		trace_clock::time_point take_ready(trace_clock::time_point now) {
+			auto r = ready == trace_clock::time_point() ? now : ready;
+			ready = trace_clock::time_point();
+			return r;
+		}
+
+		const char* name;
+		F f;
+		trace_clock::time_point ready;
+	};
+
+	/**
+	 * Give `f` a name to record its calls under.
+	 *
+	 * `name` must outlive the trace, e.g. be a string literal.
+	 *
+	 * \ingroup trace
+	 */
+	template<typename F>
+	traced_function<plain_type<F>> traced(const char* name, F&& f) {
+		return traced_function<plain_type<F>>(name, std::forward<F>(f));
+	}
+
+	/**
+	 * Get every call recorded so far, by all threads.
+	 *
+	 * Calls of each thread are in the order they ended, threads in the
+	 * order they first recorded a call. Only the latest
+	 * `FTL_TRACE_BUFFER_SIZE` calls of each thread are kept.
+	 *
+	 * Should be called once the traced work is done. Calls that end in the
+	 * meanwhile may or may not be included, and with a full buffer, may
+	 * overwrite ones being copied.
+	 *
+	 * \ingroup trace
+	 */
+	inline std::vector<trace_event> trace_events() {
+		auto& r = _dtl::trace_buffers();
+		std::lock_guard<std::mutex> lock(r.m);
+
+		std::vector<trace_event> es;
+		for(auto& b : r.buffers) {
+			size_t h = b->head.load(std::memory_order_acquire);
+			size_t n = h < FTL_TRACE_BUFFER_SIZE ? h : FTL_TRACE_BUFFER_SIZE;
+			for(size_t i = h - n; i != h; ++i) {
+				auto& t = b->records[i % FTL_TRACE_BUFFER_SIZE];
+				es.push_back(trace_event{
+					t.name, t.ready, t.start, t.end, b->thread
+				});
+			}
+		}
+
+		return es;
+	}
+
+	/**
+	 * Forget every call recorded so far.
+	 *
+	 * As with `trace_events`, no traced function should be running.
+	 *
+	 * \ingroup trace
+	 */
+	inline void clear_trace() {
+		auto& r = _dtl::trace_buffers();
+		std::lock_guard<std::mutex> lock(r.m);
+		for(auto& b : r.buffers) {
+			b->head.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Write all recorded calls in Chrome's trace event format.
+	 *
+	 * Each call is a complete (`"X"`) event, timed in microseconds from
+	 * when tracing started. Time spent queued, if any, is a separate event
+	 * named after the call with `" (queued)"` appended, on the same thread.
+	 *
+	 * \ingroup trace
+	 */
+	inline void write_chrome_trace(std::ostream& os) {
+		using us = std::chrono::duration<double,std::micro>;
+
+		auto epoch = _dtl::trace_buffers().epoch;
+		bool first = true;
+
+		auto event = [&](
+				const trace_event& e, const char* suffix,
+				trace_clock::time_point from, trace_clock::time_point to) {
+			os << (first ? "\n" : ",\n") << "{\"name\":\"";
+			_dtl::trace_write_name(os, e.name);
+			os << suffix << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+				<< ",\"ts\":" << us(from - epoch).count()
+				<< ",\"dur\":" << us(to - from).count() << "}";
+			first = false;
+		};
+
+		os << "{\"traceEvents\":[";
+		for(auto& e : trace_events()) {
+			if(e.ready != e.start)
+				event(e, " (queued)", e.ready, e.start);
+
+			event(e, "", e.start, e.end);
+		}
+		os << "\n]}\n";
+	}
+
+	namespace _dtl {
+		template<typename F>
+		void trace_ready(traced_function<F>& f) noexcept {
+			f.mark_ready();
+		}
+	}
+
+#else
+	/**
+	 * Give `f` a name to record its calls under.
+	 *
+	 * Without `FTL_TRACE`, nothing is recorded, and this returns `f`.
+	 *
+	 * \ingroup trace
+	 */
+	template<typename F>
+	plain_type<F> traced(const char*, F&& f) {
+		return std::forward<F>(f);
+	}
+#endif
+
+	namespace _dtl {
+		// Called as a call of f is handed to an executor
+		template<typename F>
+		void trace_ready(F&) noexcept {}
+	}
+
+}
+
+#endif
+
@@ -24,6 +24,7 @@
 #define FTL_TUPLE_H
 
 #include <tuple>
+#include <functional>
 #include "concepts/monoid.h"
 #include "concepts/monad.h"
 
@@ -40,6 +41,7 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <tuple>
+	 * - <functional>
 	 * - \ref monoid
 	 * - \ref monad
 	 */
@@ -47,74 +49,83 @@ namespace ftl {
 	// Private namespace for various tuple helpers
 	namespace _dtl {
 
-		template<std::size_t N, typename T>
-		struct tup {
-			static void app(T& ret, const T& t2) {
-				tup<N-1, T>::app(ret, t2);
-				std::get<N>(ret) = std::get<N>(ret) ^ std::get<N>(t2);
-			}
-
-			template<typename F, typename O>
-			static void fmap(F&& f, const T& tupl, O& out) {
-				tup<N-1,T>::fmap(std::forward<F>(f), tupl, out);
-				std::get<N>(out) = std::get<N>(tupl);
-			}
-
-			template<typename F, typename O>
-			static void fmap(F&& f, T&& tupl, O& out) {
-				tup<N-1,T>::fmap(std::forward<F>(f), std::move(tupl), out);
-				std::get<N>(out) = std::get<N>(std::move(tupl));
-			}
-		};
+		// Map the first element of a tuple, and forward the rest as they are
+		template<typename R, typename F, typename Tuple, size_t...S>
+		R tup_fmap(F&& f, Tuple&& t, seq<S...>) {
+			return R(
+				std::forward<F>(f)(std::get<0>(std::forward<Tuple>(t))),
+				std::get<S+1>(std::forward<Tuple>(t))...
+			);
+		}
 
-		template<typename T>
-		struct tup<0, T> {
-			static void app(T& ret, const T& t2) {
-				std::get<0>(ret) = std::get<0>(ret) ^ std::get<0>(t2);
-			}
-
-			template<typename F, typename O>
-			static void fmap(F&& f, const T& tupl, O& out) {
-				std::get<0>(out) = std::forward<F>(f)(std::get<0>(tupl));
-			}
-
-			template<typename F, typename O>
-			static void fmap(F&& f, T&& tupl, O& out) {
-				std::get<0>(out)
-					= std::forward<F>(f)(std::get<0>(std::move(tupl)));
-			}
-		};
+		// Append the elements of t2 onto those of t1, in place
+		template<typename...Ts, size_t...S>
+		void tup_append(
+				std::tuple<Ts...>& t1, const std::tuple<Ts...>& t2, seq<S...>) {
+
+			int dummy[] = {
+				(std::get<S>(t1) = monoid<Ts>::append(
+					std::move(std::get<S>(t1)), std::get<S>(t2)
+				), 0)...
+			};
+			(void)dummy;
+		}
 
-		template<
-			typename F,
-			typename A,
-			typename B = result_of<F(A)>,
-			typename...Ts,
-			size_t...S>
-		std::tuple<B,Ts...> apply_on_first(
-				const std::tuple<F,Ts...>& t1,
-				const std::tuple<A,Ts...>& t2,
+		template<typename...Ts, size_t...S>
+		std::tuple<Ts...> tup_append(
+				const std::tuple<Ts...>& t1,
+				const std::tuple<Ts...>& t2,
 				seq<S...>) {
 
-			auto f = std::get<0>(t1);
-			return std::tuple<B,Ts...>(
-					f(std::get<0>(t2)),
-					monoid<
-						typename std::decay<decltype(std::get<S>(t1))>::type
-					>::append(
-						std::get<S>(t1), std::get<S>(t2))...
-					);
+			return std::tuple<Ts...>(
+				monoid<Ts>::append(std::get<S>(t1), std::get<S>(t2))...
+			);
 		}
 
-		template<
-			typename F,
-			typename A,
-			typename B = result_of<F(A)>,
-			typename...Ts>
-		std::tuple<B,Ts...> applicative_implementation(
-				const std::tuple<F,Ts...>& t1,
-				const std::tuple<A,Ts...>& t2) {
-			return apply_on_first(t1, t2, gen_seq<1,sizeof...(Ts)>{});
+		/* Apply the function first in t1 to the value first in t2, and
+		 * append the rest of the elements.
+		 *
+		 * Elements of rvalue tuples are moved from, each one exactly once.
+		 */
+		template<typename R, typename T1, typename T2, size_t...S>
+		R apply_on_first(T1&& t1, T2&& t2, seq<S...>) {
+			using T = plain_type<T1>;
+
+			return R(
+				std::get<0>(std::forward<T1>(t1))(
+					std::get<0>(std::forward<T2>(t2))
+				),
+				monoid<typename std::tuple_element<S+1,T>::type>::append(
+					std::get<S+1>(std::forward<T1>(t1)),
+					std::get<S+1>(std::forward<T2>(t2))
+				)...
+			);
+		}
+
+		template<typename F, typename Tuple, size_t...S>
+		auto tup_map_all_result(seq<S...>) -> std::tuple<
+			result_of<F&(decltype(std::get<S>(std::declval<Tuple>())))>...
+		>;
+
+		template<typename R, typename F, typename Tuple, size_t...S>
+		R tup_map_all(F& f, Tuple&& t, seq<S...>) {
+			// Braces, so that f is applied in order
+			return R{f(std::get<S>(std::forward<Tuple>(t)))...};
+		}
+
+		template<typename T, typename...Ms, typename...Fns, size_t...Is>
+		void foldMaps_step(
+				std::tuple<Ms...>& acc,
+				std::tuple<Fns...>& fns,
+				const T& x,
+				seq<Is...>) {
+
+			int dummy[] = {
+				(std::get<Is>(acc) = monoid<Ms>::append(
+					std::move(std::get<Is>(acc)), std::get<Is>(fns)(x)
+				), 0)...
+			};
+			(void)dummy;
 		}
 
 		template<typename...>
@@ -183,14 +194,153 @@ namespace ftl {
 				_dtl::allMonoids<Ts...>::value,
 				std::tuple<Ts...>>::type {
 
-			auto ret = t1;
-			_dtl::tup<sizeof...(Ts)-1, std::tuple<Ts...>>::app(ret, t2);
-			return ret;
+			return _dtl::tup_append(t1, t2, gen_seq<0,sizeof...(Ts)-1>());
+		}
+
+		static auto append(
+				std::tuple<Ts...>&& t1,
+				const std::tuple<Ts...>& t2)
+		-> typename std::enable_if<
+				_dtl::allMonoids<Ts...>::value,
+				std::tuple<Ts...>>::type {
+
+			_dtl::tup_append(t1, t2, gen_seq<0,sizeof...(Ts)-1>());
+			return std::move(t1);
 		}
 
 		static constexpr bool instance = _dtl::allMonoids<Ts...>::value;
 	};
 
+	/**
+	 * Fold a container into several monoids at once, in a single pass.
+	 *
+	 * Gives the same result as
+	 * \code
+	 *   std::make_tuple(foldMap(fns, xs)...)
+	 * \endcode
+	 * but traverses `xs` only once. It is also cheaper than a `foldMap` into
+	 * `std::tuple<Ms...>`: each element is appended straight into its field
+	 * of the accumulator, with the appends unrolled at compile time, and no
+	 * tuple is built per element.
+	 *
+	 * As the functions are variadic, the container comes first.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<double> v{2., 4., 9.};
+	 *   auto stats = ftl::foldMaps(
+	 *       v, ftl::minimum<double>, ftl::maximum<double>, ftl::mean<double>
+	 *   );
+	 *   // stats == {2., 9., 5.}
+	 * \endcode
+	 *
+	 * \ingroup tuple
+	 */
+	template<
+			typename F,
+			typename...Fns,
+			typename T = Value_type<F>,
+			typename = Requires<ForwardIterable<F>()>
+	>
+	std::tuple<plain_type<result_of<Fns(const T&)>>...>
+	foldMaps(const F& xs, Fns...fns) {
+		using R = std::tuple<plain_type<result_of<Fns(const T&)>>...>;
+
+		static_assert(sizeof...(Fns) > 0, "foldMaps needs a function to fold");
+
+		static_assert(
+			_dtl::allMonoids<plain_type<result_of<Fns(const T&)>>...>::value,
+			"The results of Fns(T) must all be instances of Monoid."
+		);
+
+		R acc = monoid<R>::id();
+		std::tuple<Fns...> fs(std::move(fns)...);
+
+		for(auto& x : xs) {
+			_dtl::foldMaps_step(acc, fs, x, gen_seq<0,sizeof...(Fns)-1>());
+		}
+
+		return acc;
+	}
+
+	/**
+	 * Apply a polymorphic function to every element of a tuple.
+	 *
+	 * Unlike `fmap`, which only maps the first element, gives the tuple of
+	 * `f(std::get<I>(t))` for every `I`, in order. `f` must thus accept
+	 * each of the element types, as a generic lambda or an overloaded
+	 * function object does. Elements of an rvalue tuple are moved into `f`.
+	 *
+	 * The calls are expanded from an index sequence, with no recursion,
+	 * and the result is constructed in one go.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto t = std::make_tuple(1, 2.5, std::string("abc"));
+	 *   auto u = tuple_map_all([](const auto& x){ return sizeof(x); }, t);
+	 * \endcode
+	 *
+	 * \ingroup tuple
+	 */
+	template<
+			typename F,
+			typename Tuple,
+			typename T = plain_type<Tuple>,
+			typename I = typename _dtl::make_seq<std::tuple_size<T>::value>::type
+	>
+	auto tuple_map_all(F&& f, Tuple&& t)
+	-> decltype(_dtl::tup_map_all_result<F,Tuple>(I{})) {
+		using R = decltype(_dtl::tup_map_all_result<F,Tuple>(I{}));
+		return _dtl::tup_map_all<R>(f, std::forward<Tuple>(t), I{});
+	}
+
+	namespace _dtl {
+		inline size_t hash_mix(size_t seed, size_t h) noexcept {
+			return seed ^ (h + size_t(0x9e3779b97f4a7c15ull)
+				+ (seed << 6) + (seed >> 2));
+		}
+
+		template<typename Tuple, size_t...Is>
+		size_t tup_hash(const Tuple& t, seq<Is...>) {
+			size_t seed = 0;
+			int dummy[] = {0, (seed = hash_mix(seed, std::hash<
+				typename std::tuple_element<Is,Tuple>::type
+			>()(std::get<Is>(t))), 0)...};
+			(void)dummy;
+
+			return seed;
+		}
+	}
+
+	/**
+	 * Hash function for tuples.
+	 *
+	 * Combines the `std::hash` of each element, in order, so that tuples
+	 * can key unordered containers. Every element type must thus have a
+	 * `std::hash` specialisation.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::unordered_map<
+	 *       std::tuple<int,std::string>, double,
+	 *       ftl::tuple_hash<std::tuple<int,std::string>>
+	 *   > m;
+	 * \endcode
+	 *
+	 * \ingroup tuple
+	 */
+	template<typename Tuple>
+	struct tuple_hash {
+		size_t operator() (const Tuple& t) const {
+			return _dtl::tup_hash(
+				t, typename _dtl::make_seq<std::tuple_size<Tuple>::value>::type{}
+			);
+		}
+	};
+
 	/**
 	 * Functor instance for tuples.
 	 *
@@ -204,23 +354,25 @@ namespace ftl {
 	 */
 	template<typename T, typename...Ts>
 	struct functor<std::tuple<T,Ts...>> {
-		/// Apply `f` to first element in the tuple
+		/**
+		 * Apply `f` to first element in the tuple.
+		 *
+		 * The result is built directly from `f`'s result and the remaining
+		 * elements, none of which need be default constructible.
+		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static std::tuple<U,Ts...> map(F&& f, const std::tuple<T,Ts...>& t) {
-
-			std::tuple<U,Ts...> ret;
-			_dtl::tup<sizeof...(Ts), std::tuple<T,Ts...>>::fmap(
-					std::forward<F>(f), t, ret);
-			return ret;
+			return _dtl::tup_fmap<std::tuple<U,Ts...>>(
+				std::forward<F>(f), t, gen_seq<0,sizeof...(Ts)-1>()
+			);
 		}
 
+		/// \overload Moves every element of `t`, and copies none.
 		template<typename F, typename U = result_of<F(T)>>
 		static std::tuple<U,Ts...> map(F&& f, std::tuple<T,Ts...>&& t) {
-
-			std::tuple<U,Ts...> ret;
-			_dtl::tup<sizeof...(Ts), std::tuple<T,Ts...>>::fmap(
-					std::forward<F>(f), std::move(t), ret);
-			return ret;
+			return _dtl::tup_fmap<std::tuple<U,Ts...>>(
+				std::forward<F>(f), std::move(t), gen_seq<0,sizeof...(Ts)-1>()
+			);
 		}
 
 		static constexpr bool instance = true;
@@ -277,7 +429,19 @@ namespace ftl {
 		static std::tuple<U,Ts...> apply(
 				const std::tuple<F,Ts...>& tfn,
 				const std::tuple<T,Ts...>& t) {
-			return _dtl::applicative_implementation(tfn, t);
+			return _dtl::apply_on_first<std::tuple<U,Ts...>>(
+				tfn, t, gen_seq<0,sizeof...(Ts)-1>()
+			);
+		}
+
+		/// \overload Moves the elements of both tuples.
+		template<typename F, typename U = result_of<F(T)>>
+		static std::tuple<U,Ts...> apply(
+				std::tuple<F,Ts...>&& tfn,
+				std::tuple<T,Ts...>&& t) {
+			return _dtl::apply_on_first<std::tuple<U,Ts...>>(
+				std::move(tfn), std::move(t), gen_seq<0,sizeof...(Ts)-1>()
+			);
 		}
 
 		static constexpr bool instance = true;
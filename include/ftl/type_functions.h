@@ -26,6 +26,15 @@
 #include <type_traits>
 #include <cstddef>
 
+/* Marks functions that can only be constexpr given C++14's relaxed
+ * requirements on constexpr functions.
+ */
+#ifdef FTL_CPP14
+#define FTL_CONSTEXPR14 constexpr
+#else
+#define FTL_CONSTEXPR14
+#endif
+
 namespace ftl {
 	/**
 	 * \mainpage
@@ -206,6 +215,134 @@ namespace ftl {
 	template<typename...Ts>
 	struct type_seq {};
 
+	/**
+	 * A number sequence.
+	 *
+	 * \ingroup typelevel
+	 */
+	template<size_t...> struct seq {};
+
+	namespace _dtl {
+		// Join two halves, shifting the second past the first
+		template<typename S1, typename S2>
+		struct seq_cat;
+
+		template<size_t...I, size_t...J>
+		struct seq_cat<seq<I...>,seq<J...>> {
+			using type = seq<I..., (sizeof...(I) + J)...>;
+		};
+
+		// seq<0,...,N-1>, built by halving, so in logarithmic depth
+		template<size_t N>
+		struct make_seq : seq_cat<
+			typename make_seq<N/2>::type,
+			typename make_seq<N - N/2>::type
+		> {};
+
+		template<>
+		struct make_seq<0> {
+			using type = seq<>;
+		};
+
+		template<>
+		struct make_seq<1> {
+			using type = seq<0>;
+		};
+
+		template<size_t Z, typename S>
+		struct seq_offset;
+
+		template<size_t Z, size_t...I>
+		struct seq_offset<Z,seq<I...>> {
+			using type = seq<(Z + I)...>;
+		};
+
+		template<size_t Z, size_t N>
+		struct gen_seq_impl
+		: seq_offset<Z, typename make_seq<N + 1 - Z>::type> {};
+	}
+
+	/**
+	 * Generate a sequence of numbers.
+	 *
+	 * \tparam Z The first number in the sequence.
+	 * \tparam N The final number in the sequence. May be `Z-1`, for an
+	 *           empty sequence.
+	 *
+	 * Example:
+	 * \code
+	 *   // S is of type seq<0,1,2,3,4,5>
+	 *   gen_seq<0,5> S{};
+	 * \endcode
+	 *
+	 * \ingroup typelevel
+	 */
+	template<size_t Z, size_t N>
+	using gen_seq = typename ::ftl::_dtl::gen_seq_impl<Z,N>::type;
+
+	namespace _dtl {
+		/*
+		 * The algorithms below avoid recursing once per element, which
+		 * would make a sum type of N alternatives instantiate templates
+		 * nested N deep. Instead, they expand whole packs at once, with
+		 * seq (built in logarithmic depth) for indices where needed.
+		 */
+
+		// Finding the Ith type: overload resolution picks the one base of
+		// indexed_types that has index I, without visiting the others
+		template<size_t I, typename T>
+		struct indexed_type {
+			using type = T;
+		};
+
+		template<typename S, typename...Ts>
+		struct indexed_types;
+
+		template<size_t...Is, typename...Ts>
+		struct indexed_types<seq<Is...>,Ts...> : indexed_type<Is,Ts>... {};
+
+		template<size_t I, typename T>
+		indexed_type<I,T> select_indexed(const indexed_type<I,T>*);
+
+		template<bool...>
+		struct bool_seq {};
+
+		// Whether every one of Bs is true
+		template<bool...Bs>
+		struct all_true
+		: std::is_same<bool_seq<true, Bs...>, bool_seq<Bs..., true>> {};
+
+		// The first index in [lo,hi) where bs is true, or hi if none is,
+		// halving the range so as to recurse in logarithmic depth
+		constexpr size_t first_true(const bool* bs, size_t lo, size_t hi);
+
+		constexpr size_t first_true_after(
+				size_t l, const bool* bs, size_t mid, size_t hi) {
+			return l != mid ? l : first_true(bs, mid, hi);
+		}
+
+		constexpr size_t first_true(const bool* bs, size_t lo, size_t hi) {
+			return hi - lo == 0 ? hi
+				: hi - lo == 1 ? (bs[lo] ? lo : hi)
+				: first_true_after(
+					first_true(bs, lo, lo + (hi - lo)/2),
+					bs, lo + (hi - lo)/2, hi
+				);
+		}
+
+		// Index of the first true in Bs, or sizeof...(Bs) if none is
+		template<bool...Bs>
+		struct first_of {
+			// Never empty, so always a valid array
+			static constexpr bool bs[sizeof...(Bs) + 1] = { Bs..., false };
+
+			static constexpr size_t value = first_true(bs, 0, sizeof...(Bs));
+		};
+
+		template<bool...Bs>
+		constexpr bool first_of<Bs...>::bs[sizeof...(Bs) + 1];
+	}
+
 	namespace _dtl {
 		template<typename T, typename TSeq>
 		struct prepend_type_impl;
@@ -236,26 +373,12 @@ namespace ftl {
 
 	namespace _dtl {
 		template<template<typename> class F, typename...Ts>
-		struct map_types_impl;
-
-		template<template<typename> class F>
-		struct map_types_impl<F> {
-			using type = type_seq<>;
-		};
-
-		template<template<typename> class F, typename T, typename...Ts>
-		struct map_types_impl<F,T,Ts...> {
-			using type =
-				prepend_type<
-					typename F<T>::type,
-					typename map_types_impl<F,Ts...>::type
-				>;
+		struct map_types_impl {
+			using type = type_seq<typename F<Ts>::type...>;
 		};
 
 		template<template<typename> class F, typename...Ts>
-		struct map_types_impl<F,type_seq<Ts...>> {
-			using type = typename map_types_impl<F,Ts...>::type;
-		};
+		struct map_types_impl<F,type_seq<Ts...>> : map_types_impl<F,Ts...> {};
 
 		template<template<typename,typename> class F, typename L1, typename L2>
 		struct zip_types_impl;
@@ -357,29 +480,18 @@ namespace ftl {
 	template<template<typename,typename> class F, typename Ts1, typename Ts2>
 	using zip_types = typename _dtl::zip_types_impl<F,Ts1,Ts2>::type;
 
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl;
-
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl<I,T,type_seq<T,Ts...>> {
-		static constexpr size_t value = I;
-	};
-
-	template<size_t I, typename X, typename T, typename...Ts>
-	struct index_of_impl<I,X,type_seq<T,Ts...>> {
-		static constexpr size_t value
-			= index_of_impl<I+1,X,type_seq<Ts...>>::value;
-	};
-
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl<I,T,T,Ts...> {
-		static constexpr size_t value = I;
-	};
+	namespace _dtl {
+		template<typename T, typename...Ts>
+		struct index_of_impl : first_of<std::is_same<T,Ts>::value...> {
+			static_assert(
+				first_of<std::is_same<T,Ts>::value...>::value < sizeof...(Ts),
+				"index_of: the type is not among those searched"
+			);
+		};
 
-	template<size_t I, typename X, typename T, typename...Ts>
-	struct index_of_impl<I,X,T,Ts...> {
-		static constexpr size_t value = index_of_impl<I+1,X,Ts...>::value;
-	};
+		template<typename T, typename...Ts>
+		struct index_of_impl<T,type_seq<Ts...>> : index_of_impl<T,Ts...> {};
+	}
 
 	/**
 	 * Gets the index of a specific type in a pack or sequence.
@@ -389,6 +501,7 @@ namespace ftl {
 	 *            types to search.
 	 *
 	 * If the type is not among those given, a compile error will be generated.
+	 * If it occurs more than once, the first index is given.
 	 *
 	 * \par Examples
 	 *
@@ -408,15 +521,18 @@ namespace ftl {
 	 */
 	template<typename T, typename...Ts>
 	struct index_of {
-		static constexpr size_t value = index_of_impl<0,T,Ts...>::value;
+		static constexpr size_t value = _dtl::index_of_impl<T,Ts...>::value;
 	};
 
-	template<size_t I, typename T, typename...Ts>
-	struct type_at_impl : type_at_impl<I-1,Ts...> {};
-
-	template<typename T, typename...Ts>
-	struct type_at_impl<0,T,Ts...> {
-		using type = T;
+	template<size_t I, typename...Ts>
+	struct type_at_impl {
+		using type = typename decltype(
+			_dtl::select_indexed<I>(
+				static_cast<_dtl::indexed_types<
+					typename _dtl::make_seq<sizeof...(Ts)>::type, Ts...
+				>*>(nullptr)
+			)
+		)::type;
 	};
 
 	/**
@@ -437,6 +553,97 @@ namespace ftl {
 	template<size_t I, typename...Ts>
 	using type_at = typename type_at_impl<I,Ts...>::type;
 
+	/**
+	 * Finds the first type in a pack or sequence satisfying a predicate.
+	 *
+	 * \tparam P a unary type level predicate, with a static member `value`
+	 *           convertible to `bool`
+	 * \tparam Ts either a regular variadic pack to search, or a `type_seq` of
+	 *            types to search.
+	 *
+	 * `value` is the index of the first type `T` for which `P<T>::value` is
+	 * true, or the number of types searched, if there is none.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   size_t i = ftl::find_type<std::is_pointer, int, char*, void*>::value;
+	 *   // i == 1
+	 * \endcode
+	 *
+	 * \ingroup typelevel
+	 */
+	template<template<typename> class P, typename...Ts>
+	struct find_type : _dtl::first_of<bool(P<Ts>::value)...> {};
+
+	template<template<typename> class P, typename...Ts>
+	struct find_type<P,type_seq<Ts...>> : find_type<P,Ts...> {};
+
+	namespace _dtl {
+		template<size_t B, typename S, typename...Ts>
+		struct slice_types_impl;
+
+		template<size_t B, size_t...Is, typename...Ts>
+		struct slice_types_impl<B,seq<Is...>,Ts...> {
+			using type = type_seq<type_at<B + Is, Ts...>...>;
+		};
+
+		// The types [B,E) of Ts, as a type_seq
+		template<size_t B, size_t E, typename...Ts>
+		using slice_types = typename slice_types_impl<
+			B, typename make_seq<E - B>::type, Ts...
+		>::type;
+
+		// Folds a non-empty type_seq as a balanced tree of applications of F
+		template<template<typename,typename> class F, typename S>
+		struct fold_tree;
+
+		template<template<typename,typename> class F, typename T>
+		struct fold_tree<F,type_seq<T>> {
+			using type = T;
+		};
+
+		template<template<typename,typename> class F, typename...Ts>
+		struct fold_tree<F,type_seq<Ts...>> {
+			static constexpr size_t h = sizeof...(Ts) / 2;
+
+			using type = typename F<
+				typename fold_tree<F,slice_types<0,h,Ts...>>::type,
+				typename fold_tree<F,slice_types<h,sizeof...(Ts),Ts...>>::type
+			>::type;
+		};
+	}
+
+	/**
+	 * Folds a pack of types with a binary type level function.
+	 *
+	 * \tparam F a binary type level function with a member typedef `type` as
+	 *           result. Must be associative, with `Z` as its identity.
+	 * \tparam Z the result of folding no types.
+	 * \tparam Ts the types to fold.
+	 *
+	 * The types are combined pairwise, as a balanced tree, so that folding
+	 * N types nests templates only log(N) deep. Given the requirements on
+	 * `F` and `Z`, the result is the same as that of folding from the left.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename A, typename B>
+	 *   struct larger {
+	 *       using type = ftl::if_<(sizeof(B) > sizeof(A)), B, A>;
+	 *   };
+	 *
+	 *   using T = ftl::fold_types<larger, char, short, double, int>;
+	 *   // T is an alias of double
+	 * \endcode
+	 *
+	 * \ingroup typelevel
+	 */
+	template<template<typename,typename> class F, typename Z, typename...Ts>
+	using fold_types =
+		typename _dtl::fold_tree<F,type_seq<Z,Ts...>>::type;
+
 	/**
 	 * Concatenates two type_seqs.
 	 *
@@ -497,20 +704,10 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename T, typename...Ts>
-	struct get_nth : get_nth<N-1,Ts...> {};
-
-	template<typename T, typename...Ts>
-	struct get_nth<0,T,Ts...> {
-		using type = T;
-	};
+	struct get_nth : type_at_impl<N,T,Ts...> {};
 
 	template<size_t N, typename T, typename...Ts>
-	struct get_nth<N,type_seq<T,Ts...>> : get_nth<N-1,type_seq<Ts...>> {};
-
-	template<typename T, typename...Ts>
-	struct get_nth<0,type_seq<T,Ts...>> {
-		using type = T;
-	};
+	struct get_nth<N,type_seq<T,Ts...>> : type_at_impl<N,T,Ts...> {};
 
 	/**
 	 * Get the final element in a type sequence
@@ -538,13 +735,8 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename T, typename...Ts>
-	struct take_types : concat_type_seqs<
-						type_seq<T>,
-						typename take_types<N-1,Ts...>::type> {};
-
-	template<typename T, typename...Ts>
-	struct take_types<1,T,Ts...> {
-		using type = type_seq<T>;
+	struct take_types {
+		using type = _dtl::slice_types<0,N,T,Ts...>;
 	};
 
 	/**
@@ -590,19 +782,10 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename...Ts>
-	struct drop_types {};
-
-	template<size_t N, typename T, typename...Ts>
-	struct drop_types<N,T,Ts...> : drop_types<N-1, Ts...> {};
-
-	template<typename T, typename...Ts>
-	struct drop_types<0,T,Ts...> {
-		using type = type_seq<T,Ts...>;
-	};
-
-	template<size_t N>
-	struct drop_types<N> {
-		using type = type_seq<>;
+	struct drop_types {
+		using type = _dtl::slice_types<
+			(N < sizeof...(Ts) ? N : sizeof...(Ts)), sizeof...(Ts), Ts...
+		>;
 	};
 
 	template<template<typename...> class To, typename From>
@@ -616,40 +799,6 @@ namespace ftl {
 		using type = To<Ts...>;
 	};
 
-	/**
-	 * A number sequence.
-	 *
-	 * \ingroup typelevel
-	 */
-	template<size_t...> struct seq {};
-
-	namespace _dtl {
-		template<size_t Z, size_t N, size_t...S>
-		struct gen_seq_impl : gen_seq_impl<Z,N-1,N,S...> {};
-
-		template<size_t Z, size_t...S>
-		struct gen_seq_impl<Z,Z,S...> {
-			using type = seq<Z,S...>;
-		};
-	}
-
-	/**
-	 * Generate a sequence of numbers.
-	 *
-	 * \tparam Z The first number in the sequence.
-	 * \tparam N The final number in the sequence.
-	 *
-	 * Example:
-	 * \code
-	 *   // S is of type seq<0,1,2,3,4,5>
-	 *   gen_seq<0,5> S{};
-	 * \endcode
-	 *
-	 * \ingroup typelevel
-	 */
-	template<size_t Z, size_t N>
-	using gen_seq = typename ::ftl::_dtl::gen_seq_impl<Z,N>::type;
-
 	/**
 	 * Find the first contained type of some parametrised type.
 	 *
@@ -781,6 +930,55 @@ namespace ftl {
 	template<typename X, typename T>
 	using Rebind = typename parametric_type_traits<X>::template rebind<T>;
 
+	namespace _dtl {
+		template<typename C>
+		std::true_type test_transparent(typename C::is_transparent*);
+
+		template<typename C>
+		std::false_type test_transparent(...);
+
+		template<
+				typename C,
+				typename U,
+				bool = decltype(test_transparent<C>(nullptr))::value
+		>
+		struct rebind_compare {
+			using type = Rebind<C,U>;
+		};
+
+		template<typename C, typename U>
+		struct rebind_compare<C,U,true> {
+			using type = C;
+		};
+
+		// A comparator for a rebound container, copied from its source's if
+		// their types are the same
+		template<typename C2, typename C>
+		struct rebound_compare {
+			static C2 from(const C&) {
+				return C2();
+			}
+		};
+
+		template<typename C>
+		struct rebound_compare<C,C> {
+			static C from(const C& c) {
+				return c;
+			}
+		};
+	}
+
+	/**
+	 * Rebind a comparator, such as `std::less<T>`, to compare `U`s.
+	 *
+	 * Transparent comparators, such as `std::less<>`, compare any types
+	 * already, and are kept as they are.
+	 *
+	 * \ingroup typelevel
+	 */
+	template<typename Cmp, typename U>
+	using RebindCompare = typename _dtl::rebind_compare<Cmp,U>::type;
+
 	/**
 	 * Check if a type is just a parametrised version of some templated base.
 	 *
@@ -434,6 +434,9 @@ namespace ftl {
 	template<typename>
 	class function;
 
+	template<typename>
+	class function_ref;
+
 	/**
 	 * Checks if a certain type is a monomorphic function object.
 	 *
@@ -445,7 +448,7 @@ namespace ftl {
 	 * Built in specialisations include:
 	 * - `std::function`
 	 * - function pointers and pointers to member functions
-	 * - `ftl::function`
+	 * - `ftl::function` and `ftl::function_ref`
 	 *
 	 * For everything else, `is_monomorphic::value` will be `false` by
 	 * default.
@@ -467,6 +470,11 @@ namespace ftl {
 		static constexpr bool value = true;
 	};
 
+	template<typename R, typename...Args>
+	struct is_monomorphic<ftl::function_ref<R(Args...)>> {
+		static constexpr bool value = true;
+	};
+
 	template<typename R, typename...Args>
 	struct is_monomorphic<R(*)(Args...)> {
 		static constexpr bool value = true;
@@ -24,7 +24,9 @@
 #define FTL_UNORDERED_MAP_H
 
 #include <unordered_map>
+#include <vector>
 #include "concepts/functor.h"
+#include "concepts/foldable.h"
 
 namespace ftl {
 
@@ -33,24 +35,24 @@ namespace ftl {
 	 *
 	 * Concept implementations for std::unordered_map.
 	 *
-	 * Adds the \ref functorpg concept instance.
+	 * Adds the \ref functorpg, \ref monoidpg and \ref foldablepg concept
+	 * instances.
 	 *
 	 * \code
 	 *   #include <ftl/unordered_map.h>
 	 * \endcode
 	 *
-	 * While it's more or less possible to give `unordered_map` a
-	 * \ref foldablepg instance or a \ref monoidpg instance, none are provided.
-	 * This is because both would lead to unspecified results in certain cases.
-	 *
-	 * For instance, for the Foldable instance, `ftl::foldl` and `ftl::foldr`
-	 * would have unspecified results for non-associative folding functions.
-	 * I.e., given two maps containing the exact same key/value-pairs, a fold
-	 * might give two different results because their bucket count might not be
-	 * the same, or they use different hash functions.
+	 * Unlike that of `std::map`, the iteration order of an `unordered_map`
+	 * depends on its hash function and bucket count, not just its contents.
+	 * Two maps holding the very same key/value pairs may therefore give
+	 * different results for `ftl::foldl` and `ftl::foldr` with functions that
+	 * are not commutative. Folds with commutative functions or monoids, such
+	 * as `sum_monoid`, are unaffected. The monoid instance does not depend on
+	 * iteration order at all.
 	 *
 	 * \par Dependencies
 	 * - \ref functor
+	 * - \ref foldable
 	 */
 
 	template<typename K, typename V, typename H, typename C, typename A>
@@ -71,6 +73,10 @@ namespace ftl {
 	/**
 	 * Functor instance for std::unordered_map.
 	 *
+	 * Results are built with the source map's bucket count, maximum load
+	 * factor, hash function and key equality, so they are never rehashed
+	 * while being filled.
+	 *
 	 * \ingroup unord_map
 	 */
 	template<typename K, typename T, typename H, typename C, typename A>
@@ -85,7 +91,7 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static unordered_map<U> map(F&& f, const unordered_map<T>& m) {
-			unordered_map<U> rm;
+			auto rm = like<U>(m);
 			for(const auto& kv : m) {
 				rm.emplace(kv.first, f(kv.second));
 			}
@@ -106,10 +112,18 @@ namespace ftl {
 				>
 		>
 		static unordered_map<U> map(F&& f, unordered_map<T>&& m) {
-			unordered_map<U> rm;
+			auto rm = like<U>(m);
+#if defined(__cpp_lib_node_extract)
+			// Extracted nodes give up their keys, which iteration cannot
+			while(!m.empty()) {
+				auto n = m.extract(m.begin());
+				rm.emplace(std::move(n.key()), f(std::move(n.mapped())));
+			}
+#else
 			for(auto& kv : m) {
 				rm.emplace(std::move(kv.first), f(std::move(kv.second)));
 			}
+#endif
 
 			return rm;
 		}
@@ -127,15 +141,201 @@ namespace ftl {
 		>
 		static unordered_map<T> map(F&& f, unordered_map<T>&& m) {
 			for(auto& kv : m) {
-				m[kv.first] = f(std::move(kv.second));
+				kv.second = f(std::move(kv.second));
 			}
 
-			return m;
+			return std::move(m);
 		}
 
 		static constexpr bool instance = true;
+
+	private:
+		// An empty map configured like m, with room for all of m
+		template<typename U>
+		static unordered_map<U> like(const unordered_map<T>& m) {
+			unordered_map<U> rm(
+					m.bucket_count(), m.hash_function(), m.key_eq(),
+					typename unordered_map<U>::allocator_type(m.get_allocator())
+			);
+			rm.max_load_factor(m.max_load_factor());
+
+			return rm;
+		}
 	};
 
+	/**
+	 * Monoid instance for std::unordered_map.
+	 *
+	 * Identity element is the empty map, monoid operation is left biased
+	 * union: keys present in both operands keep their value from the
+	 * left. Room for both operands is reserved before anything is
+	 * inserted. Where one operand is a temporary, it is reused to hold the
+	 * result, and with C++17 node extraction, its nodes are relinked rather
+	 * than copied.
+	 *
+	 * \ingroup unord_map
+	 */
+	template<typename K, typename V, typename H, typename C, typename A>
+	struct monoid<std::unordered_map<K,V,H,C,A>> {
+		using unordered_map = std::unordered_map<K,V,H,C,A>;
+
+		static unordered_map id() {
+			return unordered_map();
+		}
+
+		static unordered_map append(
+				const unordered_map& m1, const unordered_map& m2) {
+
+			unordered_map rm(m1);
+			rm.reserve(m1.size() + m2.size());
+			rm.insert(m2.begin(), m2.end());
+
+			return rm;
+		}
+
+		static unordered_map append(
+				unordered_map&& m1, const unordered_map& m2) {
+
+			m1.reserve(m1.size() + m2.size());
+			m1.insert(m2.begin(), m2.end());
+
+			return std::move(m1);
+		}
+
+		static unordered_map append(
+				const unordered_map& m1, unordered_map&& m2) {
+
+			m2.reserve(m1.size() + m2.size());
+			for(const auto& kv : m1) {
+				assign(m2, kv);
+			}
+
+			return std::move(m2);
+		}
+
+		static unordered_map append(unordered_map&& m1, unordered_map&& m2) {
+			if(m1.size() >= m2.size()) {
+				m1.reserve(m1.size() + m2.size());
+#if defined(__cpp_lib_node_extract)
+				m1.merge(m2);
+#else
+				m1.insert(m2.begin(), m2.end());
+#endif
+				return std::move(m1);
+			}
+
+			m2.reserve(m1.size() + m2.size());
+#if defined(__cpp_lib_node_extract)
+			while(!m1.empty()) {
+				auto r = m2.insert(m1.extract(m1.begin()));
+				if(!r.inserted)
+					r.position->second = std::move(r.node.mapped());
+			}
+#else
+			for(auto& kv : m1) {
+				assign(m2, std::move(kv));
+			}
+#endif
+
+			return std::move(m2);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		// Insert kv into m, overwriting the value of an existing key
+		template<typename P>
+		static void assign(unordered_map& m, P&& kv) {
+			auto it = m.find(kv.first);
+			if(it != m.end())
+				it->second = std::forward<P>(kv).second;
+			else
+				m.emplace(std::forward<P>(kv));
+		}
+	};
+
+	/**
+	 * Foldable instance for std::unordered_map.
+	 *
+	 * Folds over the values, in iteration order (or its reverse, for
+	 * `foldr`). See \ref unord_map for why that order is not specified.
+	 *
+	 * \ingroup unord_map
+	 */
+	template<typename K, typename T, typename H, typename C, typename A>
+	struct foldable<std::unordered_map<K,T,H,C,A>>
+	: deriving_fold<std::unordered_map<K,T,H,C,A>>
+	, deriving_foldMap<std::unordered_map<K,T,H,C,A>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const std::unordered_map<K,T,H,C,A>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		/// The map's iterators go forward only, so `foldr` buffers pointers.
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const std::unordered_map<K,T,H,C,A>& m) {
+			std::vector<const T*> vs;
+			vs.reserve(m.size());
+			for(auto& kv : m) {
+				vs.push_back(&kv.second);
+			}
+
+			for(auto it = vs.rbegin(); it != vs.rend(); ++it) {
+				z = f(**it, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		template<typename K, typename V, typename H, typename C, typename A>
+		struct keyed_append<std::unordered_map<K,V,H,C,A>> {
+			template<typename K2>
+			static void append(
+					std::unordered_map<K,V,H,C,A>& m, K2&& k, V&& v) {
+#if defined(__cpp_lib_unordered_map_try_emplace)
+				// Neither k nor v is moved from if the key is present
+				auto r = m.try_emplace(std::forward<K2>(k), std::move(v));
+				if(!r.second) {
+					r.first->second = monoid<V>::append(
+						std::move(r.first->second), std::move(v)
+					);
+				}
+#else
+				auto it = m.find(k);
+				if(it != m.end()) {
+					it->second = monoid<V>::append(
+						std::move(it->second), std::move(v)
+					);
+				}
+				else {
+					m.emplace(std::forward<K2>(k), std::move(v));
+				}
+#endif
+			}
+		};
+	}
+
 }
 
 #endif
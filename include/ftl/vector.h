@@ -24,9 +24,13 @@
 #define FTL_VECTOR_H
 
 #include <vector>
+#include <iterator>
+#include <algorithm>
+#include <utility>
 #include "concepts/foldable.h"
 #include "concepts/monad.h"
 #include "concepts/zippable.h"
+#include "implementation/contiguous_fold.h"
 
 namespace ftl {
 
@@ -49,6 +53,9 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <vector>
+	 * - <iterator>
+	 * - <algorithm>
+	 * - <utility>
 	 * - \ref foldable
 	 * - \ref monad
 	 */
@@ -67,9 +74,52 @@ namespace ftl {
 		using rebind = std::vector<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		template<typename C>
+		auto element_count(const C& c, int) -> decltype(size_t(c.size())) {
+			return c.size();
+		}
+
+		template<typename C>
+		size_t element_count(const C& c, long) {
+			using std::begin;
+			using std::end;
+
+			return size_t(std::distance(begin(c), end(c)));
+		}
+
+		// Concatenate nested containers, allocating the result exactly once
+		template<typename R, typename N>
+		R concat_nested(N& nested) {
+			using std::begin;
+			using std::end;
+
+			size_t n = 0;
+			for(auto& el : nested)
+				n += element_count(el, 0);
+
+			R result;
+			result.reserve(n);
+
+			for(auto& el : nested) {
+				result.insert(
+						result.end(),
+						std::make_move_iterator(begin(el)),
+						std::make_move_iterator(end(el))
+				);
+			}
+
+			note_container_alloc(result);
+			return result;
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * The result is allocated only once, at its exact final size, after all
+	 * calls to `f` are done.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref container`<B>(A)>`
 	 *
 	 * \ingroup vector
@@ -78,24 +128,14 @@ namespace ftl {
 			typename F,
 			typename T,
 			typename A,
-			typename U = typename result_of<F(T)>::value_type,
+			typename U = Value_type<result_of<F(T)>>,
 			typename Au = Rebind<A,U>
 	>
 	std::vector<U,Au> concatMap(F f, const std::vector<T,A>& v) {
 
-		std::vector<U,Au> result;
-		result.reserve(v.size() * 2);
 		auto nested = f % v;
 
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
-		}
-
-		return result;
+		return _dtl::concat_nested<std::vector<U,Au>>(nested);
 	}
 
 	/**
@@ -107,25 +147,68 @@ namespace ftl {
 			typename F,
 			typename T,
 			typename A,
-			typename U = typename result_of<F(T)>::value_type,
+			typename U = Value_type<result_of<F(T)>>,
 			typename Au = Rebind<A,U>
 	>
 	std::vector<U,Au> concatMap(F f, std::vector<T,A>&& v) {
 
 		auto nested = f % std::move(v);
 
-		std::vector<U,Au> result;
-		result.reserve(nested.size() * 2);
+		return _dtl::concat_nested<std::vector<U,Au>>(nested);
+	}
+
+	/**
+	 * Maps and concatenates into an output iterator.
+	 *
+	 * Each result of `f` is moved to `out` as soon as it is computed. Unlike
+	 * the other versions, no intermediate results are held on to, and no
+	 * vector is allocated. Use e.g. a `std::back_inserter` into a container
+	 * that has been reserved to a known size.
+	 *
+	 * \return The output iterator after the last written element.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> r;
+	 *   r.reserve(3 * v.size());
+	 *   concatMap(
+	 *       [](int x){ return std::vector<int>{x-1, x, x+1}; },
+	 *       v, std::back_inserter(r)
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup vector
+	 */
+	template<typename F, typename T, typename A, typename OutIt>
+	OutIt concatMap(F f, const std::vector<T,A>& v, OutIt out) {
+		using std::begin;
+		using std::end;
+
+		for(auto& e : v) {
+			auto c = f(e);
+			out = std::move(begin(c), end(c), out);
+		}
+
+		return out;
+	}
 
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+	/**
+	 * \overload
+	 *
+	 * \ingroup vector
+	 */
+	template<typename F, typename T, typename A, typename OutIt>
+	OutIt concatMap(F f, std::vector<T,A>&& v, OutIt out) {
+		using std::begin;
+		using std::end;
+
+		for(auto& e : v) {
+			auto c = f(std::move(e));
+			out = std::move(begin(c), end(c), out);
 		}
 
-		return result;
+		return out;
 	}
 
 	/**
@@ -186,11 +269,12 @@ namespace ftl {
 	struct monad<std::vector<T,A>>
 	: deriving_monad<back_insertable_container<std::vector<T,A>>> {
 
-#ifdef DOCUMENTATION_GENERATOR
 		/// Alias to make type signatures cleaner
 		template<typename U>
 		using vector = Rebind<std::vector<T,A>,U>;
 
+#ifdef DOCUMENTATION_GENERATOR
+
 		/// Creates a one element vector
 		static vector<T> pure(const T& t);
 
@@ -214,12 +298,14 @@ namespace ftl {
 		/// \overload
 		static vector<T> join(vector<vector<T>>&& v);
 
+#endif
+
 		/**
 		 * Can be viewed as a non-deterministic computation: `v` is a vector of
 		 * possible values, each of which we apply `f` to. As `f` itself is also
 		 * non-deterministic, it may return several possible answers for each
 		 * element in `v`. Finally, all of the results are collected in a flat
-		 * vector.
+		 * vector, which is allocated once, at its exact size.
 		 *
 		 * \note `f` is allowed to return _any_ \ref fwditerable, not only
 		 *       vectors. The final result, however, is always a vector.
@@ -240,7 +326,9 @@ namespace ftl {
 				typename U = Value_type<Cu>,
 				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static vector<U> bind(const vector<T>& v, F&& f);
+		static vector<U> bind(const vector<T>& v, F&& f) {
+			return concatMap(std::forward<F>(f), v);
+		}
 
 		/// \overload
 		template<
@@ -249,18 +337,32 @@ namespace ftl {
 				typename U = Value_type<Cu>,
 				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static vector<U> bind(vector<T>&& v, F&& f);
-#endif
+		static vector<U> bind(vector<T>&& v, F&& f) {
+			return concatMap(std::forward<F>(f), std::move(v));
+		}
 	};
 
 	/**
 	 * Foldable instance for std::vector.
 	 *
+	 * As the elements are stored contiguously, `fold` has faster paths for
+	 * vectors of `sum_monoid` and `prod_monoid` of arithmetic types, and of
+	 * `any` and `all`. The former are split over several accumulators, so
+	 * the compiler can vectorise them, while the latter stop at the first
+	 * `true` or `false`, respectively.
+	 *
 	 * \ingroup vector
 	 */
 	template<typename T, typename A>
 	struct foldable<std::vector<T,A>>
-	: deriving_foldable<bidirectional_iterable<std::vector<T,A>>> {};
+	: deriving_foldable<bidirectional_iterable<std::vector<T,A>>> {
+		template<typename M = T>
+		static M fold(const std::vector<T,A>& v) {
+			static_assert(Monoid<M>(), "M must satisfy Monoid");
+
+			return _dtl::contiguous_fold<T>::fold(v.data(), v.size());
+		}
+	};
 
 	/**
 	 * Zippable instance for std::vector.
@@ -275,6 +377,80 @@ namespace ftl {
 	struct zippable<std::vector<T,A>>
 	: deriving_zippable<back_insertable_container<std::vector<T,A>>> {};
 
+	namespace _dtl {
+		template<typename P, typename V, typename Get>
+		std::pair<plain_type<V>,plain_type<V>> partition_vector(
+				P& p, V& v, Get get) {
+			std::vector<char> keep(v.size());
+			size_t n = 0;
+			for(size_t i = 0; i < v.size(); ++i) {
+				keep[i] = p(static_cast<const Value_type<plain_type<V>>&>(v[i]));
+				n += keep[i];
+			}
+
+			std::pair<plain_type<V>,plain_type<V>> r{
+				plain_type<V>(v.get_allocator()),
+				plain_type<V>(v.get_allocator())
+			};
+			r.first.reserve(n);
+			r.second.reserve(v.size() - n);
+
+			for(size_t i = 0; i < v.size(); ++i) {
+				if(keep[i])
+					r.first.push_back(get(v[i]));
+				else
+					r.second.push_back(get(v[i]));
+			}
+
+			return r;
+		}
+	}
+
+	/**
+	 * Split a vector into the elements that satisfy `p`, and those that don't.
+	 *
+	 * Both halves keep the order of `v`. `p` is invoked once per element,
+	 * and its answers kept, so that each half can be reserved exactly before
+	 * anything is copied into it.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(const T&)>`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v{1,2,3,4,5};
+	 *   auto r = partition([](int x){ return x % 2 == 0; }, v);
+	 *   // r.first == {2,4}, r.second == {1,3,5}
+	 * \endcode
+	 *
+	 * \ingroup vector
+	 */
+	template<typename P, typename T, typename A>
+	std::pair<std::vector<T,A>,std::vector<T,A>> partition(
+			P&& p, const std::vector<T,A>& v) {
+		return _dtl::partition_vector(p, v, [](const T& x) -> const T& {
+			return x;
+		});
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Moves the elements out of `v`.
+	 *
+	 * \ingroup vector
+	 */
+	template<
+			typename P, typename T, typename A,
+			typename = Requires<std::is_move_constructible<T>::value>
+	>
+	std::pair<std::vector<T,A>,std::vector<T,A>> partition(
+			P&& p, std::vector<T,A>&& v) {
+		return _dtl::partition_vector(p, v, [](T& x) -> T&& {
+			return std::move(x);
+		});
+	}
+
 }
 
 #endif
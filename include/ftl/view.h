@@ -0,0 +1,1080 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_VIEW_H
+#define FTL_VIEW_H
+
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <type_traits>
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+#include "maybe.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup view View
+	 *
+	 * Lazy, non-owning ranges, with concept instances that compose without
+	 * building intermediate containers.
+	 *
+	 * \code
+	 *   #include <ftl/view.h>
+	 * \endcode
+	 *
+	 * Mapping, filtering, zipping or binding a view only wraps its iterators;
+	 * no element is computed until the view is iterated, and no container is
+	 * allocated until the view is materialised with `view::to`. A fold over a
+	 * view computes each element exactly once, in a single pass. Hence, in
+	 * \code
+	 *   auto v = f % (g % (h % make_view(xs)));
+	 *   auto r = fold(v);
+	 * \endcode
+	 * `h`, `g` and `f` are called once per element of `xs`, on the way
+	 * through the fold, and nothing is allocated.
+	 *
+	 * A view refers to the container it was made from, which must outlive
+	 * it. Functions mapped over a view are stored in it and shared by its
+	 * iterators. Iteration is single pass in spirit: dereferencing the same
+	 * iterator twice computes the element twice.
+	 *
+	 * Views need not come from a container at all. `iterate`, `unfoldr`,
+	 * `replicate` and `range` generate their elements as they are iterated,
+	 * and `take` cuts any view short, so that
+	 * \code
+	 *   auto r = foldl(fn, z, take(n, iterate(f, x)));
+	 * \endcode
+	 * is a single loop, that calls `f` and `fn` once per element and
+	 * allocates nothing per element.
+	 *
+	 * This module adds the following concept instances to `view`:
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - `<iterator>`
+	 * - `<memory>`
+	 * - `<vector>`
+	 * - `<cmath>`
+	 * - `<type_traits>`
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 * - \ref maybe
+	 */
+
+	template<typename It>
+	class view;
+
+	namespace _dtl {
+		template<typename T>
+		struct view_iterator_base {
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = T;
+		};
+
+		template<typename F, typename...Its>
+		using mapped_type = plain_type<
+			decltype(std::declval<F&>()(*std::declval<Its&>()...))
+		>;
+
+		template<typename It, typename F>
+		class map_iterator : public view_iterator_base<mapped_type<F,It>> {
+		public:
+			map_iterator(It it, std::shared_ptr<F> f)
+			: it(std::move(it)), f(std::move(f)) {}
+
+			mapped_type<F,It> operator* () const {
+				return (*f)(*it);
+			}
+
+			map_iterator& operator++ () {
+				++it;
+				return *this;
+			}
+
+			map_iterator operator++ (int) {
+				auto r = *this;
+				++it;
+				return r;
+			}
+
+			bool operator== (const map_iterator& o) const {
+				return it == o.it;
+			}
+
+			bool operator!= (const map_iterator& o) const {
+				return it != o.it;
+			}
+
+		private:
+			It it;
+			std::shared_ptr<F> f;
+		};
+
+		template<typename It, typename P>
+		class filter_iterator
+		: public view_iterator_base<
+			plain_type<decltype(*std::declval<It&>())>
+		> {
+		public:
+			filter_iterator(It it, It last, std::shared_ptr<P> p)
+			: it(std::move(it)), last(std::move(last)), p(std::move(p)) {
+				skip();
+			}
+
+			auto operator* () const -> decltype(*std::declval<const It&>()) {
+				return *it;
+			}
+
+			filter_iterator& operator++ () {
+				++it;
+				skip();
+				return *this;
+			}
+
+			filter_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const filter_iterator& o) const {
+				return it == o.it;
+			}
+
+			bool operator!= (const filter_iterator& o) const {
+				return it != o.it;
+			}
+
+		private:
+			void skip() {
+				while(it != last && !(*p)(*it))
+					++it;
+			}
+
+			It it, last;
+			std::shared_ptr<P> p;
+		};
+
+		// Stops as soon as either side does
+		template<typename It1, typename It2, typename F>
+		class zip_iterator
+		: public view_iterator_base<mapped_type<F,It1,It2>> {
+		public:
+			zip_iterator(It1 a, It2 b, std::shared_ptr<F> f)
+			: a(std::move(a)), b(std::move(b)), f(std::move(f)) {}
+
+			mapped_type<F,It1,It2> operator* () const {
+				return (*f)(*a, *b);
+			}
+
+			zip_iterator& operator++ () {
+				++a;
+				++b;
+				return *this;
+			}
+
+			zip_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const zip_iterator& o) const {
+				return a == o.a || b == o.b;
+			}
+
+			bool operator!= (const zip_iterator& o) const {
+				return !(*this == o);
+			}
+
+		private:
+			It1 a;
+			It2 b;
+			std::shared_ptr<F> f;
+		};
+
+		template<typename...Its>
+		using zipped_refs =
+			std::tuple<typename std::iterator_traits<Its>::reference...>;
+
+		/* Iterates through any number of ranges in lockstep, producing tuples
+		 * of references to their elements. Like zip_iterator, it compares
+		 * equal to another as soon as any of its iterators do.
+		 */
+		template<typename...Its>
+		class zipn_iterator : public view_iterator_base<zipped_refs<Its...>> {
+			using indices = gen_seq<0,sizeof...(Its)-1>;
+
+		public:
+			explicit zipn_iterator(Its...its) : its(std::move(its)...) {}
+
+			zipped_refs<Its...> operator* () const {
+				return deref(indices());
+			}
+
+			zipn_iterator& operator++ () {
+				zip_next(its, indices());
+				return *this;
+			}
+
+			zipn_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const zipn_iterator& o) const {
+				return zip_done(its, o.its, indices());
+			}
+
+			bool operator!= (const zipn_iterator& o) const {
+				return !(*this == o);
+			}
+
+		private:
+			template<size_t...Is>
+			zipped_refs<Its...> deref(seq<Is...>) const {
+				return zipped_refs<Its...>(*std::get<Is>(its)...);
+			}
+
+			std::tuple<Its...> its;
+		};
+
+		/* Iterates through every element of every f(x), for each x.
+		 *
+		 * Only the inner range currently being iterated is kept, and it is
+		 * shared by copies of the iterator. The inner iterator is held by
+		 * pointer, as it need not be default constructible.
+		 */
+		template<typename It, typename F>
+		class bind_iterator
+		: public view_iterator_base<Value_type<mapped_type<F,It>>> {
+			using Cu = mapped_type<F,It>;
+			using inner = decltype(std::declval<const Cu&>().begin());
+
+		public:
+			bind_iterator(It it, It last, std::shared_ptr<F> f)
+			: it(std::move(it)), last(std::move(last)), f(std::move(f)) {
+				load();
+			}
+
+			bind_iterator(const bind_iterator& b)
+			: it(b.it), last(b.last), f(b.f), cur(b.cur)
+			, in(b.in ? new inner(*b.in) : nullptr), pos(b.pos) {}
+
+			bind_iterator(bind_iterator&&) = default;
+
+			bind_iterator& operator= (const bind_iterator& b) {
+				if(this != &b)
+					*this = bind_iterator(b);
+
+				return *this;
+			}
+
+			bind_iterator& operator= (bind_iterator&&) = default;
+
+			auto operator* () const -> decltype(*std::declval<const inner&>()) {
+				return **in;
+			}
+
+			bind_iterator& operator++ () {
+				++*in;
+				++pos;
+
+				if(*in == cur->end()) {
+					++it;
+					load();
+				}
+
+				return *this;
+			}
+
+			bind_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const bind_iterator& o) const {
+				return it == o.it && (it == last || pos == o.pos);
+			}
+
+			bool operator!= (const bind_iterator& o) const {
+				return !(*this == o);
+			}
+
+		private:
+			// Find the next non-empty inner range, starting at it
+			void load() {
+				pos = 0;
+				for(; it != last; ++it) {
+					cur = std::make_shared<Cu>((*f)(*it));
+					in.reset(new inner(cur->begin()));
+
+					if(*in != cur->end())
+						return;
+				}
+
+				cur.reset();
+				in.reset();
+			}
+
+			It it, last;
+			std::shared_ptr<F> f;
+			std::shared_ptr<Cu> cur;
+			std::unique_ptr<inner> in;
+			size_t pos = 0;
+		};
+
+		template<typename T>
+		class single_iterator : public view_iterator_base<T> {
+		public:
+			single_iterator(std::shared_ptr<T> t, bool done) noexcept
+			: t(std::move(t)), done(done) {}
+
+			const T& operator* () const noexcept {
+				return *t;
+			}
+
+			single_iterator& operator++ () noexcept {
+				done = true;
+				return *this;
+			}
+
+			single_iterator operator++ (int) noexcept {
+				auto r = *this;
+				done = true;
+				return r;
+			}
+
+			bool operator== (const single_iterator& o) const noexcept {
+				return done == o.done;
+			}
+
+			bool operator!= (const single_iterator& o) const noexcept {
+				return done != o.done;
+			}
+
+		private:
+			std::shared_ptr<T> t;
+			bool done;
+		};
+
+		// x, f(x), f(f(x)), ..., without end
+		template<typename T, typename F>
+		class iterate_iterator : public view_iterator_base<T> {
+		public:
+			iterate_iterator(T x, std::shared_ptr<F> f, bool done)
+			: x(std::move(x)), f(std::move(f)), done(done) {}
+
+			const T& operator* () const noexcept {
+				return x;
+			}
+
+			iterate_iterator& operator++ () {
+				x = (*f)(std::move(x));
+				return *this;
+			}
+
+			iterate_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const iterate_iterator& o) const noexcept {
+				return done == o.done;
+			}
+
+			bool operator!= (const iterate_iterator& o) const noexcept {
+				return done != o.done;
+			}
+
+		private:
+			T x;
+			std::shared_ptr<F> f;
+			bool done;
+		};
+
+		// The same value, n times
+		template<typename T>
+		class repeat_iterator : public view_iterator_base<T> {
+		public:
+			repeat_iterator(T x, size_t n) : x(std::move(x)), n(n) {}
+
+			const T& operator* () const noexcept {
+				return x;
+			}
+
+			repeat_iterator& operator++ () noexcept {
+				--n;
+				return *this;
+			}
+
+			repeat_iterator operator++ (int) noexcept {
+				auto r = *this;
+				--n;
+				return r;
+			}
+
+			bool operator== (const repeat_iterator& o) const noexcept {
+				return n == o.n;
+			}
+
+			bool operator!= (const repeat_iterator& o) const noexcept {
+				return n != o.n;
+			}
+
+		private:
+			T x;
+			size_t n;
+		};
+
+		// n steps of an arithmetic sequence
+		template<typename T>
+		class range_iterator : public view_iterator_base<T> {
+		public:
+			range_iterator(T x, T step, size_t n) noexcept
+			: x(x), step(step), n(n) {}
+
+			const T& operator* () const noexcept {
+				return x;
+			}
+
+			// The step past the last element is never taken, lest it overflow
+			range_iterator& operator++ () noexcept {
+				if(--n)
+					x += step;
+
+				return *this;
+			}
+
+			range_iterator operator++ (int) noexcept {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const range_iterator& o) const noexcept {
+				return n == o.n;
+			}
+
+			bool operator!= (const range_iterator& o) const noexcept {
+				return n != o.n;
+			}
+
+		private:
+			T x;
+			T step;
+			size_t n;
+		};
+
+		template<typename T>
+		size_t range_size(T first, T last, T step, std::true_type) {
+			using U = typename std::make_unsigned<T>::type;
+
+			if(step > 0 ? !(first < last) : !(last < first))
+				return 0;
+
+			// Unsigned, as the distance may not fit in T
+			U d = step > 0 ? U(U(last) - U(first)) : U(U(first) - U(last));
+			U s = step > 0 ? U(step) : U(U(0) - U(step));
+
+			return size_t((d - 1) / s) + 1;
+		}
+
+		template<typename T>
+		size_t range_size(T first, T last, T step, std::false_type) {
+			if(step > 0 ? !(first < last) : !(last < first))
+				return 0;
+
+			return size_t(std::ceil((last - first) / step));
+		}
+
+		// At most n elements of another view
+		template<typename It>
+		class take_iterator
+		: public view_iterator_base<typename std::iterator_traits<It>::value_type> {
+		public:
+			take_iterator(It it, It last, size_t n)
+			: it(std::move(it)), last(std::move(last)), n(n) {}
+
+			auto operator* () const -> decltype(*std::declval<const It&>()) {
+				return *it;
+			}
+
+			// Like range_iterator, never steps past the last element taken
+			take_iterator& operator++ () {
+				if(--n)
+					++it;
+
+				return *this;
+			}
+
+			take_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const take_iterator& o) const {
+				return done() == o.done();
+			}
+
+			bool operator!= (const take_iterator& o) const {
+				return done() != o.done();
+			}
+
+		private:
+			bool done() const {
+				return n == 0 || it == last;
+			}
+
+			It it, last;
+			size_t n;
+		};
+
+		// Elements of the results of f, until it gives nothing
+		template<typename F, typename S>
+		using unfold_pair = Value_type<result_of<F(S)>>;
+
+		template<typename F, typename S>
+		class unfold_iterator : public view_iterator_base<
+			plain_type<typename std::tuple_element<0,unfold_pair<F,S>>::type>
+		> {
+			using step = result_of<F(S)>;
+			using pair = unfold_pair<F,S>;
+
+		public:
+			unfold_iterator(step s, std::shared_ptr<F> f)
+			: s(std::move(s)), f(std::move(f)) {}
+
+			const typename std::tuple_element<0,pair>::type& operator* () const {
+				return std::get<0>(ftl::get<pair>(s));
+			}
+
+			unfold_iterator& operator++ () {
+				auto next = (*f)(std::get<1>(std::move(ftl::get<pair>(s))));
+				s = std::move(next);
+				return *this;
+			}
+
+			unfold_iterator operator++ (int) {
+				auto r = *this;
+				++*this;
+				return r;
+			}
+
+			bool operator== (const unfold_iterator& o) const noexcept {
+				return done() == o.done();
+			}
+
+			bool operator!= (const unfold_iterator& o) const noexcept {
+				return done() != o.done();
+			}
+
+		private:
+			bool done() const noexcept {
+				return s.template is<Nothing>();
+			}
+
+			step s;
+			std::shared_ptr<F> f;
+		};
+	}
+
+	/**
+	 * A lazy range, delimited by a pair of iterators.
+	 *
+	 * Views are cheap to copy: they hold only their iterators, which in turn
+	 * refer to the underlying container, and share whatever functions they
+	 * have been mapped with.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> xs{1,2,3,4};
+	 *
+	 *   auto v = [](int x){ return x*x; } % make_view(xs);
+	 *   auto ys = filter([](int x){ return x > 4; }, v).to<std::vector<int>>();
+	 *   // ys == std::vector<int>{9,16}
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	class view {
+	public:
+		using iterator = It;
+		using const_iterator = It;
+		using value_type = typename std::iterator_traits<It>::value_type;
+
+		view(It first, It last) : first(std::move(first)), last(std::move(last))
+		{}
+
+		It begin() const {
+			return first;
+		}
+
+		It end() const {
+			return last;
+		}
+
+		bool empty() const {
+			return first == last;
+		}
+
+		/**
+		 * Materialise the view into a container.
+		 *
+		 * Elements are computed in order, and inserted at the end of a default
+		 * constructed `C`.
+		 *
+		 * \par Examples
+		 *
+		 * \code
+		 *   auto l = v.to<std::list<int>>();
+		 * \endcode
+		 */
+		template<typename C>
+		C to() const {
+			C c;
+			for(auto it = first; it != last; ++it)
+				c.insert(c.end(), *it);
+
+			return c;
+		}
+
+	private:
+		It first, last;
+	};
+
+	/**
+	 * Create a view of every element of a container.
+	 *
+	 * `c` must outlive the view, and any view derived from it.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	auto make_view(const C& c) -> view<decltype(c.begin())> {
+		return view<decltype(c.begin())>(c.begin(), c.end());
+	}
+
+	/**
+	 * Create a view of the elements in `[first, last)`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	view<It> make_view(It first, It last) {
+		return view<It>(std::move(first), std::move(last));
+	}
+
+	/**
+	 * Lazily zip any number of containers into a view of tuples.
+	 *
+	 * The elements of the view are tuples of references into `cs`, so
+	 * nothing is copied, and nothing allocated: iterating the view steps
+	 * through all the containers in lockstep, and it ends with the shortest
+	 * of them. The references are to non-const elements, if the containers
+	 * are not const. Each of `cs` must outlive the view.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> ids{1,2,3};
+	 *   std::vector<std::string> names{"a","b","c"};
+	 *
+	 *   for(auto row : zip_view(ids, names)) {
+	 *       // std::get<0>(row) is an int&, std::get<1>(row) a std::string&
+	 *   }
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename...Cs,
+			typename Zi = _dtl::zipn_iterator<decltype(std::declval<Cs&>().begin())...>
+	>
+	view<Zi> zip_view(Cs&...cs) {
+		return view<Zi>(Zi(cs.begin()...), Zi(cs.end()...));
+	}
+
+	/**
+	 * Lazily keep only the elements satisfying `p`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename P, typename It>
+	view<_dtl::filter_iterator<It,plain_type<P>>> filter(
+			P&& p, const view<It>& v) {
+		using Fi = _dtl::filter_iterator<It,plain_type<P>>;
+
+		auto sp = std::make_shared<plain_type<P>>(std::forward<P>(p));
+		return view<Fi>(Fi(v.begin(), v.end(), sp), Fi(v.end(), v.end(), sp));
+	}
+
+	/**
+	 * The infinite view of `x`, `f(x)`, `f(f(x))`, and so on.
+	 *
+	 * The view holds the current value, and computes the next one each
+	 * time it is advanced. Use `take` to make it finite, before folding.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto powers = take(4, iterate([](int x){ return 2*x; }, 1));
+	 *   // 1, 2, 4, 8
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename F,
+			typename T,
+			typename Ii = _dtl::iterate_iterator<T,plain_type<F>>
+	>
+	view<Ii> iterate(F&& f, T x) {
+		auto sf = std::make_shared<plain_type<F>>(std::forward<F>(f));
+		return view<Ii>(Ii(x, sf, false), Ii(x, sf, true));
+	}
+
+	/**
+	 * The view of the values given by repeatedly unfolding `seed`.
+	 *
+	 * `f` takes a seed, and returns either `nothing`, which ends the view,
+	 * or `just` a pair (or tuple) of the next element and the next seed.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto digits = unfoldr(
+	 *       [](int n){
+	 *           return n == 0
+	 *               ? nothing<std::pair<int,int>>()
+	 *               : just(std::make_pair(n % 10, n / 10));
+	 *       },
+	 *       1234
+	 *   );
+	 *   // 4, 3, 2, 1
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename F,
+			typename S,
+			typename Ui = _dtl::unfold_iterator<plain_type<F>,S>
+	>
+	view<Ui> unfoldr(F&& f, S seed) {
+		using P = _dtl::unfold_pair<plain_type<F>,S>;
+
+		auto sf = std::make_shared<plain_type<F>>(std::forward<F>(f));
+		auto first = (*sf)(std::move(seed));
+		return view<Ui>(Ui(std::move(first), sf), Ui(nothing<P>(), sf));
+	}
+
+	/**
+	 * The view of `n` copies of `x`.
+	 *
+	 * Only one copy is kept. For an endless supply, `iterate` the identity
+	 * function.
+	 *
+	 * \ingroup view
+	 */
+	template<typename T>
+	view<_dtl::repeat_iterator<T>> replicate(size_t n, T x) {
+		using Ri = _dtl::repeat_iterator<T>;
+		return view<Ri>(Ri(x, n), Ri(x, 0));
+	}
+
+	/**
+	 * The view of `first`, `first + step`, and so on, up to but excluding
+	 * `last`.
+	 *
+	 * `T` must be an arithmetic type, and `step` must not be 0. With a
+	 * negative `step`, the view counts down to `last`. The number of
+	 * elements is worked out up front, so integral ranges reaching up to
+	 * the limits of `T` do not overflow.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto r = foldl(std::plus<long>(), 0L, range(0L, 1000000000L));
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename T,
+			typename = Requires<std::is_arithmetic<T>::value>
+	>
+	view<_dtl::range_iterator<T>> range(T first, T last, T step) {
+		using Ri = _dtl::range_iterator<T>;
+
+		auto n = _dtl::range_size(
+			first, last, step, std::is_integral<T>()
+		);
+
+		return view<Ri>(Ri(first, step, n), Ri(first, step, 0));
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename T,
+			typename = Requires<std::is_arithmetic<T>::value>
+	>
+	view<_dtl::range_iterator<T>> range(T first, T last) {
+		return range(first, last, T(1));
+	}
+
+	/**
+	 * The first `n` elements of `v`, or all of them if there are fewer.
+	 *
+	 * Never advances `v` past the last element taken, so taking from
+	 * `iterate` computes exactly `n` values.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	view<_dtl::take_iterator<It>> take(size_t n, const view<It>& v) {
+		using Ti = _dtl::take_iterator<It>;
+		return view<Ti>(Ti(v.begin(), v.end(), n), Ti(v.end(), v.end(), 0));
+	}
+
+	template<typename It>
+	struct parametric_type_traits<view<It>> {
+		using value_type = typename view<It>::value_type;
+	};
+
+	/**
+	 * Functor instance for views.
+	 *
+	 * Maps lazily: `fn` is called whenever an element of the result is
+	 * dereferenced.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	struct functor<view<It>> {
+		template<
+				typename Fn,
+				typename Mi = _dtl::map_iterator<It,plain_type<Fn>>
+		>
+		static view<Mi> map(Fn&& fn, const view<It>& v) {
+			auto f = std::make_shared<plain_type<Fn>>(std::forward<Fn>(fn));
+			return view<Mi>(Mi(v.begin(), f), Mi(v.end(), f));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		template<typename It>
+		struct view_apply {
+			template<typename Fn>
+			auto operator() (const Fn& fn) const
+			-> decltype(functor<view<It>>::map(fn, std::declval<view<It>&>())) {
+				return functor<view<It>>::map(fn, v);
+			}
+
+			view<It> v;
+		};
+	}
+
+	/**
+	 * Monad instance for views.
+	 *
+	 * Like the container monads, models non-deterministic computations, but
+	 * lazily: `bind` holds on to one result of `f` at a time, while it is
+	 * being iterated.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	struct monad<view<It>> {
+		using T = typename view<It>::value_type;
+
+		/// Create a view of a single, owned value.
+		template<typename U = T>
+		static view<_dtl::single_iterator<U>> pure(U x) {
+			using Si = _dtl::single_iterator<U>;
+
+			auto p = std::make_shared<U>(std::move(x));
+			return view<Si>(Si(p, false), Si(p, true));
+		}
+
+		template<typename Fn>
+		static auto map(Fn&& fn, const view<It>& v)
+		-> decltype(functor<view<It>>::map(std::forward<Fn>(fn), v)) {
+			return functor<view<It>>::map(std::forward<Fn>(fn), v);
+		}
+
+		/**
+		 * Lazily concatenate `f(x)` for every `x` in `v`.
+		 *
+		 * `f` may return any \ref fwditerable, including another view.
+		 */
+		template<
+				typename F,
+				typename Bi = _dtl::bind_iterator<It,plain_type<F>>
+		>
+		static view<Bi> bind(const view<It>& v, F&& f) {
+			auto sf = std::make_shared<plain_type<F>>(std::forward<F>(f));
+			return view<Bi>(
+				Bi(v.begin(), v.end(), sf), Bi(v.end(), v.end(), sf)
+			);
+		}
+
+		/// Flatten a view of ranges.
+		static auto join(const view<It>& v)
+		-> decltype(bind(v, id)) {
+			return bind(v, id);
+		}
+
+		/// Apply every function in the view `fs` to every element of `v`.
+		template<typename Fs>
+		static auto apply(const Fs& fs, const view<It>& v)
+		-> decltype(monad<Fs>::bind(fs, std::declval<_dtl::view_apply<It>>())) {
+			return monad<Fs>::bind(fs, _dtl::view_apply<It>{v});
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Applicative instance for views.
+	 *
+	 * Equivalent to the monad instance.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	struct applicative<view<It>> {
+		template<typename U>
+		static auto pure(U x) -> decltype(monad<view<It>>::pure(std::move(x))) {
+			return monad<view<It>>::pure(std::move(x));
+		}
+
+		template<typename Fn>
+		static auto map(Fn&& fn, const view<It>& v)
+		-> decltype(functor<view<It>>::map(std::forward<Fn>(fn), v)) {
+			return functor<view<It>>::map(std::forward<Fn>(fn), v);
+		}
+
+		template<typename Fs>
+		static auto apply(const Fs& fs, const view<It>& v)
+		-> decltype(monad<view<It>>::apply(fs, v)) {
+			return monad<view<It>>::apply(fs, v);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for views.
+	 *
+	 * `foldl`, `foldMap` and `fold` make a single pass over the view. As
+	 * views can only be iterated forwards, `foldr` first collects the
+	 * elements in a vector.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	struct foldable<view<It>>
+	: deriving_foldMap<view<It>>, deriving_fold<view<It>> {
+		using T = typename view<It>::value_type;
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const view<It>& v) {
+			for(auto it = v.begin(), last = v.end(); it != last; ++it)
+				z = fn(std::move(z), *it);
+
+			return z;
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const view<It>& v) {
+			auto xs = v.template to<std::vector<T>>();
+			for(auto it = xs.rbegin(); it != xs.rend(); ++it)
+				z = fn(*it, std::move(z));
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for views.
+	 *
+	 * `zipWith` is lazy; the resulting view ends with the shorter of `v` and
+	 * `i`. `i` must outlive the result.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	struct zippable<view<It>> {
+		template<
+				typename F,
+				typename Iterable,
+				typename It2 = decltype(std::declval<const Iterable&>().begin()),
+				typename Zi = _dtl::zip_iterator<It,It2,plain_type<F>>
+		>
+		static view<Zi> zipWith(F&& f, const view<It>& v, const Iterable& i) {
+			auto sf = std::make_shared<plain_type<F>>(std::forward<F>(f));
+			return view<Zi>(
+				Zi(v.begin(), i.begin(), sf), Zi(v.end(), i.end(), sf)
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
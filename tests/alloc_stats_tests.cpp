@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <list>
+#include <forward_list>
+#include <memory>
+#include <thread>
+#include <ftl/alloc_stats.h>
+#include <ftl/function.h>
+#include <ftl/lazy.h>
+#include <ftl/memory.h>
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include <ftl/forward_list.h>
+#include "alloc_stats_tests.h"
+
+test_set alloc_stats_tests{
+	std::string("alloc_stats"),
+	{
+		std::make_tuple(
+			std::string("function: counts heap storage only"),
+			std::function<bool()>([]() -> bool {
+				struct big {
+					char pad[64];
+					int operator() (int x) const { return x + pad[0]; }
+				};
+
+				ftl::reset_alloc_stats();
+
+				ftl::function<int(int)> f([](int x){ return x + 1; });
+				bool inplace = ftl::alloc_stats().function == 0;
+
+				ftl::function<int(int)> g(big{{1}});
+				ftl::function<int(int)> h(g);
+
+				return inplace && ftl::alloc_stats().function == 2
+					&& f(1) == 2 && h(1) == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy: counts shared states"),
+			std::function<bool()>([]() -> bool {
+				ftl::reset_alloc_stats();
+
+				ftl::lazy<int> l([](){ return 4; });
+				auto m = l;
+				bool forced = *m == 4;
+
+				return forced && ftl::alloc_stats().lazy == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("shared_ptr: counts new results"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto p = std::make_shared<int>(2);
+				std::shared_ptr<int> n;
+
+				ftl::reset_alloc_stats();
+
+				auto q = [](int x){ return x * 2; } % p;
+				auto r = [](int x){ return x * 2; } % n;
+
+				return *q == 4 && !r && ftl::alloc_stats().shared_ptr == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("containers: counts result storage"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return x + 1; };
+				std::vector<int> v{1, 2, 3};
+				std::list<int> l{1, 2, 3};
+				std::forward_list<int> fl{1, 2, 3};
+
+				ftl::reset_alloc_stats();
+				auto rv = f % v;
+				bool vec = ftl::alloc_stats().container == 1;
+
+				ftl::reset_alloc_stats();
+				auto rl = f % l;
+				auto rfl = f % fl;
+				bool lists = ftl::alloc_stats().container == 6;
+
+				ftl::reset_alloc_stats();
+				auto rz = ftl::zipWith(std::plus<int>(), v, rv);
+				bool zip = ftl::alloc_stats().container == 1;
+
+				// Mapping a temporary to its own type reuses it
+				ftl::reset_alloc_stats();
+				auto rt = f % std::move(rv);
+				bool reused = ftl::alloc_stats().container == 0;
+
+				return vec && lists && zip && reused
+					&& rz == std::vector<int>{3, 5, 7}
+					&& rt == std::vector<int>{3, 4, 5}
+					&& rl.back() == 4 && rfl.front() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("counts are per thread"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1, 2, 3};
+				ftl::reset_alloc_stats();
+
+				std::thread t([&v](){
+					auto r = [](int x){ return x; } % v;
+				});
+				t.join();
+
+				return ftl::alloc_stats().container == 0;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <memory>
+#include <ftl/arena.h>
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include <ftl/set.h>
+#include <ftl/map.h>
+#include <ftl/unordered_map.h>
+#include "arena_tests.h"
+
+template<typename T>
+using avector = std::vector<T,ftl::arena_allocator<T>>;
+
+template<typename T>
+using alist = std::list<T,ftl::arena_allocator<T>>;
+
+test_set arena_tests{
+	std::string("arena"),
+	{
+		std::make_tuple(
+			std::string("arena_allocator[no scope]"),
+			std::function<bool()>([]() -> bool {
+				avector<int> v{1,2,3};
+				v.resize(1000, 4);
+
+				return v.get_allocator().resource() == nullptr
+					&& ftl::arena::current() == nullptr
+					&& v[999] == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("arena_scope[nested]"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a, b;
+				bool ok;
+				{
+					ftl::arena_scope s1(a);
+					ok = ftl::arena::current() == &a;
+					{
+						ftl::arena_scope s2(b);
+						ok = ok && ftl::arena::current() == &b;
+					}
+					ok = ok && ftl::arena::current() == &a;
+				}
+
+				return ok && ftl::arena::current() == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[vector]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::arena a(64);
+				ftl::arena_scope scope(a);
+
+				avector<int> v;
+				for(int i = 0; i < 100; ++i)
+					v.push_back(i);
+
+				auto w = [](int x){ return std::to_string(x); } % v;
+
+				return w.get_allocator().resource() == &a
+					&& w.size() == 100 && w[42] == "42"
+					&& a.used() >= 100 * sizeof(int) + 100 * sizeof(w[0]);
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[list]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::arena a;
+				ftl::arena_scope scope(a);
+
+				alist<int> l{1,2,3};
+				auto r = l >>= [](int x){ return alist<int>{x, -x}; };
+
+				return r.get_allocator().resource() == &a
+					&& r == alist<int>{1,-1,2,-2,3,-3};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[vector]"),
+			std::function<bool()>([]() -> bool {
+				ftl::arena a;
+				ftl::arena_scope scope(a);
+
+				avector<int> v1{1,2,3};
+				avector<int> v2{4,5,6};
+				auto r = ftl::zipWith([](int x, int y){ return x*y; }, v1, v2);
+
+				return r.get_allocator().resource() == &a
+					&& r == avector<int>{4,10,18};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[set,map,unordered_map]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				using pair_t = std::pair<const int,int>;
+
+				ftl::arena a;
+				ftl::arena_scope scope(a);
+
+				std::set<int,std::less<int>,ftl::arena_allocator<int>> s{1,2,3};
+				std::map<int,int,std::less<int>,ftl::arena_allocator<pair_t>> m{
+					{1,1}, {2,2}
+				};
+				std::unordered_map<
+					int, int, std::hash<int>, std::equal_to<int>,
+					ftl::arena_allocator<pair_t>
+				> u{{1,1}, {2,2}};
+
+				auto s2 = [](int x){ return x/2; } % s;
+				auto m2 = [](int x){ return float(x)/2.f; } % m;
+				auto u2 = [](int x){ return float(x)/2.f; } % u;
+
+				return s2.get_allocator().resource() == &a
+					&& m2.get_allocator().resource() == &a
+					&& u2.get_allocator().resource() == &a
+					&& s2.size() == 2 && m2.at(1) == .5f && u2.at(2) == 1.f;
+			})
+		),
+		std::make_tuple(
+			std::string("copy out of arena"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::arena a;
+				std::unique_ptr<avector<std::string>> w;
+				{
+					ftl::arena_scope scope(a);
+
+					avector<int> v{1,2,3};
+					w.reset(new avector<std::string>(
+						[](int x){ return std::string(x, 'x'); } % v
+					));
+				}
+
+				bool in_arena = w->get_allocator().resource() == &a;
+
+				// Copies select the current arena, which is now none at all
+				avector<std::string> out(*w);
+				w.reset();
+				a.release();
+
+				return in_arena && out.get_allocator().resource() == nullptr
+					&& a.used() == 0
+					&& out == avector<std::string>{"x", "xx", "xxx"};
+			})
+		)
+	}
+};
+
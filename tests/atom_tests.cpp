@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <thread>
+#include <vector>
+#include <ftl/atom.h>
+#include <ftl/persistent_vector.h>
+#include "atom_tests.h"
+
+test_set atom_tests{
+	std::string("atom"),
+	{
+		std::make_tuple(
+			std::string("load, store and compare_and_set"),
+			std::function<bool()>([]() -> bool {
+				ftl::atom<int> a(1);
+
+				auto s1 = a.load();
+				a.store(2);
+				auto s2 = a.load();
+
+				bool stale = a.compare_and_set(s1, 3);
+				bool fresh = a.compare_and_set(s2, 4);
+
+				return *s1 == 1 && *s2 == 2
+					&& !stale && fresh && *a.load() == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("swap returns what it published"),
+			std::function<bool()>([]() -> bool {
+				ftl::atom<ftl::persistent_vector<int>> a;
+
+				auto before = a.load();
+				for(int i = 0; i < 100; ++i) {
+					a.swap([i](ftl::persistent_vector<int> v) {
+						v.push_back(i);
+						return v;
+					});
+				}
+				auto after = a.swap([](ftl::persistent_vector<int> v) {
+					v.push_back(100);
+					return v;
+				});
+
+				return before->empty()
+					&& after == a.load()
+					&& after->size() == 101
+					&& (*after)[0] == 0 && (*after)[100] == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("Concurrent swaps and loads"),
+			std::function<bool()>([]() -> bool {
+				const int writers = 4, n = 2000;
+				ftl::atom<long> a(0);
+
+				std::atomic<bool> done{false};
+				std::atomic<bool> ordered{true};
+
+				std::vector<std::thread> ts;
+				for(int i = 0; i < 2; ++i) {
+					ts.emplace_back([&]{
+						long last = 0;
+						while(!done.load()) {
+							long x = *a.load();
+							if(x < last)
+								ordered.store(false);
+							last = x;
+						}
+					});
+				}
+
+				std::vector<std::thread> ws;
+				for(int i = 0; i < writers; ++i) {
+					ws.emplace_back([&]{
+						for(int j = 0; j < n; ++j)
+							a.swap([](long x){ return x + 1; });
+					});
+				}
+
+				for(auto& t : ws)
+					t.join();
+
+				done.store(true);
+				for(auto& t : ts)
+					t.join();
+
+				return *a.load() == long(writers) * n && ordered.load();
+			})
+		),
+		std::make_tuple(
+			std::string("Snapshots are shared_ptr functors"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::atom<int> a(20);
+				auto s = a.load();
+				a.store(0);
+
+				auto r = [](int x){ return x + 1; } % s;
+
+				return *r == 21 && *s == 20;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/chunked_seq.h>
+#include <ftl/vector.h>
+#include "chunked_seq_tests.h"
+
+namespace {
+	template<size_t N>
+	using seq = ftl::chunked_seq<int,N>;
+
+	template<size_t N>
+	std::vector<int> to_vector(const seq<N>& s) {
+		return std::vector<int>(s.begin(), s.end());
+	}
+}
+
+test_set chunked_seq_tests{
+	std::string("chunked_seq"),
+	{
+		std::make_tuple(
+			std::string("push_back, pop_back and iteration"),
+			std::function<bool()>([]() -> bool {
+				seq<4> s;
+				for(int i = 0; i < 10; ++i)
+					s.push_back(i);
+
+				std::vector<int> rev(s.rbegin(), s.rend());
+				s.pop_back();
+				s.pop_back();
+
+				return rev == std::vector<int>{9,8,7,6,5,4,3,2,1,0}
+					&& s.size() == 8 && s.chunk_count() == 2
+					&& s.front() == 0 && s.back() == 7
+					&& to_vector(s) == std::vector<int>{0,1,2,3,4,5,6,7};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append relinks temporaries"),
+			std::function<bool()>([]() -> bool {
+				seq<4> a{1,2,3,4,5};
+				seq<4> b{6,7,8,9};
+				const int* p = &b.front();
+
+				auto c = ftl::monoid<seq<4>>::append(a, std::move(b));
+
+				// Small enough to fit in the last chunk, so moved there
+				auto d = ftl::monoid<seq<4>>::append(seq<4>{1}, seq<4>{2,3});
+
+				return to_vector(c) == std::vector<int>{1,2,3,4,5,6,7,8,9}
+					&& &*std::next(c.begin(), 5) == p
+					&& b.empty()
+					&& to_vector(a) == std::vector<int>{1,2,3,4,5}
+					&& d.chunk_count() == 1
+					&& (a ^ seq<4>{}) == a;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap into chunked_seq"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v;
+				for(int i = 0; i < 1000; ++i)
+					v.push_back(i);
+
+				auto s = ftl::foldMap([](int x){ return seq<16>{x, -x}; }, v);
+
+				auto sum = ftl::foldl(std::plus<long>(), 0L, s);
+
+				return s.size() == 2000 && sum == 0
+					&& s.chunk_count() <= 2000 / 16 + 1
+					&& *std::next(s.begin(), 3) == -1;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl, foldr and fold"),
+			std::function<bool()>([]() -> bool {
+				seq<3> s{1,2,3,4,5,6,7};
+
+				auto snoc = [](std::vector<int> xs, int x){
+					xs.push_back(x);
+					return xs;
+				};
+				auto cons = [](int x, std::vector<int> xs){
+					xs.push_back(x);
+					return xs;
+				};
+
+				ftl::chunked_seq<ftl::sum_monoid<int>,3> m;
+				for(int x : s)
+					m.push_back(ftl::sum(x));
+
+				return ftl::foldl(snoc, std::vector<int>{}, s)
+					== std::vector<int>{1,2,3,4,5,6,7}
+					&& ftl::foldr(cons, std::vector<int>{}, s)
+					== std::vector<int>{7,6,5,4,3,2,1}
+					&& ftl::fold(m) == 28
+					&& ftl::foldMap(ftl::prod<int>, s) == 5040;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				seq<2> s{1,2,3,4,5};
+				auto f = [](int x){ return std::to_string(x); };
+				auto g = [](int x){ return 2*x; };
+
+				auto r = f % s;
+				auto t = g % seq<2>{1,2,3};
+
+				return std::vector<std::string>(r.begin(), r.end())
+					== std::vector<std::string>{"1","2","3","4","5"}
+					&& r.chunk_count() == s.chunk_count()
+					&& to_vector(t) == std::vector<int>{2,4,6};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind, join and pure"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				seq<2> s{1,2,3};
+				auto r = s >>= [](int x){ return std::vector<int>{x, 10*x}; };
+
+				auto p = ftl::monad<seq<2>>::pure(7);
+
+				return to_vector(r) == std::vector<int>{1,10,2,20,3,30}
+					&& to_vector(p) == std::vector<int>{7};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				seq<2> s{1,2,3,4};
+				std::vector<int> v{10,20,30};
+
+				auto r = ftl::zipWith(std::plus<int>(), s, v);
+
+				return to_vector(r) == std::vector<int>{11,22,33};
+			})
+		)
+	}
+};
@@ -261,6 +261,31 @@ test_set concept_tests{
 					== std::list<int>{4,3,2};
 			})
 		),
+		std::make_tuple(
+			std::string("Foldable: foldl_inplace"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto push = [](std::vector<int>& xs, int x){
+					xs.push_back(x);
+				};
+
+				// Only accepts its accumulator if it was moved in
+				auto snoc = [](std::vector<int>&& xs, int x){
+					xs.push_back(x);
+					return std::move(xs);
+				};
+
+				std::list<int> l{2,3,4};
+
+				return foldl_inplace(push, std::vector<int>{1}, l)
+					== std::vector<int>{1,2,3,4}
+					&& foldl_inplace(push)(std::vector<int>{})(l)
+					== std::vector<int>{2,3,4}
+					&& foldl(snoc, std::vector<int>{}, l)
+					== std::vector<int>{2,3,4};
+			})
+		),
 		std::make_tuple(
 			std::string("Zippable: curried zipWith"),
 			std::function<bool()>([]() -> bool {
@@ -319,6 +344,24 @@ test_set concept_tests{
 
 				return r == std::vector<sum_monoid<int>>{sum(3), sum(7)};
 			})
+		),
+		std::make_tuple(
+			std::string("Monoid: min, max, count and mean"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{4, -2, 9, 3};
+				std::list<double> l{1., 2., 6.};
+				std::vector<double> e;
+
+				return foldMap(minimum<int>, v) == -2
+					&& foldMap(maximum<int>, v) == 9
+					&& foldMap(count<int>, v) == 4u
+					&& foldMap(mean<int>, v) == 3
+					&& foldMap(mean<double>, l) == 3.
+					&& foldMap(minimum<double>, e) > 1e300
+					&& foldMap(mean<double>, e) == 0.;
+			})
 		)
 	}
 };
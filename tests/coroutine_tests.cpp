@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include "coroutine_tests.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <ftl/coroutine.h>
+
+namespace {
+	ftl::maybe<int> half(int x) {
+		if(x % 2)
+			return ftl::nothing<int>();
+
+		return ftl::just(x / 2);
+	}
+
+	ftl::maybe<int> quarter_sum(int x, int& steps) {
+		int a = co_await half(x);
+		++steps;
+		int b = co_await half(a);
+		++steps;
+		co_return a + b;
+	}
+
+	ftl::either<std::string,int> checked(int x) {
+		if(x < 0)
+			return ftl::make_left<int>(std::string("negative"));
+
+		return ftl::make_right<std::string>(x);
+	}
+
+	ftl::either<std::string,int> checked_diff(int x, int y) {
+		int a = co_await checked(x);
+		int b = co_await checked(x - y);
+		co_return a * b;
+	}
+
+	ftl::maybe<int> throwing() {
+		co_await half(2);
+		throw std::runtime_error("thrown");
+	}
+
+	ftl::future<int> plus_one(ftl::future<int> f) {
+		int x = co_await std::move(f);
+		co_return x + 1;
+	}
+}
+
+test_set coroutine_tests{
+	std::string("coroutine"),
+	{
+		std::make_tuple(
+			std::string("co_await maybe"),
+			std::function<bool()>([]() -> bool {
+				int s1 = 0, s2 = 0, s3 = 0;
+
+				auto r1 = quarter_sum(8, s1);
+				auto r2 = quarter_sum(6, s2);
+				auto r3 = quarter_sum(3, s3);
+
+				return r1 == ftl::just(6) && s1 == 2
+					&& r2 == ftl::nothing<int>() && s2 == 1
+					&& r3 == ftl::nothing<int>() && s3 == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("co_await either"),
+			std::function<bool()>([]() -> bool {
+				auto r1 = checked_diff(5, 2);
+				auto r2 = checked_diff(5, 7);
+
+				return r1 == ftl::make_right<std::string>(15)
+					&& r2 == ftl::make_left<int>(std::string("negative"));
+			})
+		),
+		std::make_tuple(
+			std::string("Exceptions escape maybe coroutines"),
+			std::function<bool()>([]() -> bool {
+				try {
+					throwing();
+				}
+				catch(std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("co_await future"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p;
+				auto f = plus_one(plus_one(p.get_future()));
+				bool early = f.is_ready();
+
+				std::thread t([&p](){ p.set_value(40); });
+				auto r = f.get();
+				t.join();
+
+				return !early && r == 42
+					&& plus_one(ftl::make_ready_future(1)).get() == 2;
+			})
+		)
+	}
+};
+
+#else
+
+test_set coroutine_tests{
+	std::string("coroutine"),
+	{}
+};
+
+#endif
+
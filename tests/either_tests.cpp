@@ -20,6 +20,8 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <cstdint>
+#include <vector>
 #include <ftl/either.h>
 #include "either_tests.h"
 
@@ -35,6 +37,18 @@ test_set either_tests{
 				return e1 == e2 && !(e1 != e2);
 			})
 		),
+		std::make_tuple(
+			std::string("All-ones pointer is a value"),
+			std::function<bool()>([]() -> bool {
+				void* sentinel = reinterpret_cast<void*>(~std::uintptr_t(0));
+
+				auto l = ftl::make_left<int>(sentinel);
+				auto r = ftl::make_right<int>(sentinel);
+
+				return l.is<ftl::Left<void*>>() && ftl::fromLeft(l) == sentinel
+					&& r.is<ftl::Right<void*>>() && ftl::fromRight(r) == sentinel;
+			})
+		),
 		std::make_tuple(
 			std::string("Preserves Eq[R]"),
 			std::function<bool()>([]() -> bool {
@@ -350,6 +364,121 @@ test_set either_tests{
 
 				return monad<either<int,int>>::join(e) == make_left<int>(2);
 			})
+		),
+		std::make_tuple(
+			std::string("sequence and traverse"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<either<int,int>> v{
+					make_right<int>(1), make_right<int>(2)
+				};
+				std::vector<either<int,int>> w{
+					make_right<int>(1), make_left<int>(7), make_left<int>(8)
+				};
+
+				int calls = 0;
+				auto check = [&calls](int x){
+					++calls;
+					return x < 0 ? make_left<int>(x) : make_right<int>(2*x);
+				};
+
+				return sequence(v)
+						== make_right<int>(std::vector<int>{1, 2})
+					&& sequence(std::move(w))
+						== make_left<std::vector<int>>(7)
+					&& traverse(check, std::vector<int>{1, -1, -2, 3})
+						== make_left<std::vector<int>>(-1)
+					&& calls == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("No copies through rvalue map, bind and apply"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct tracked {
+					tracked(int* c) : copies(c) {}
+					tracked(const tracked& t) : copies(t.copies) { ++*copies; }
+					tracked(tracked&&) = default;
+					tracked& operator= (tracked&&) = default;
+
+					int* copies;
+				};
+
+				int copies = 0;
+				auto pass = [](tracked t){ return t; };
+				auto rightPass = [](tracked t){
+					return make_right<int>(std::move(t));
+				};
+
+				auto e = make_right<int>(tracked(&copies)) >>= rightPass;
+				auto r = aapply(
+					make_right<int>(std::function<tracked(tracked)>(pass)),
+					fmap(pass, std::move(e))
+				);
+				auto j = monad<either<int,tracked>>::join(
+					make_right<int>(std::move(r))
+				);
+
+				// Dereferencing temporary Left and Right moves out of them
+				tracked t = *Right<tracked>(tracked(&copies));
+				tracked u = *Left<tracked>(std::move(t));
+
+				return j.is<Right<tracked>>() && u.copies == &copies
+					&& copies == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("partitionEithers"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<either<std::string,int>> v{
+					make_right<std::string>(1),
+					make_left<int>(std::string("bad")),
+					make_right<std::string>(2),
+					make_left<int>(std::string("worse"))
+				};
+
+				auto r1 = partitionEithers(v);
+				auto r2 = partitionEithers(std::move(v));
+
+				return r1.first == std::vector<std::string>{"bad", "worse"}
+					&& r1.second == std::vector<int>{1,2}
+					&& r1.first.capacity() == 2 && r1.second.capacity() == 2
+					&& r2 == r1
+					&& fromLeft(v[1]).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("mapEither"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto check = [](const std::string& s) -> either<std::string,int> {
+					if(s.empty() || s[0] < '0' || s[0] > '9')
+						return make_left<int>(s);
+
+					return make_right<std::string>(s[0] - '0');
+				};
+				auto take = [](std::string&& s) -> either<std::string,size_t> {
+					if(s.empty())
+						return make_left<size_t>(std::string("empty"));
+
+					return make_right<std::string>(s.size());
+				};
+
+				std::vector<std::string> v{"1", "x", "7", "", "3"};
+
+				auto r1 = mapEither(check, v);
+				auto r2 = mapEither(take, std::move(v));
+
+				return r1.first == std::vector<std::string>{"x", ""}
+					&& r1.second == std::vector<int>{1,7,3}
+					&& r2.first == std::vector<std::string>{"empty"}
+					&& r2.second == std::vector<size_t>{1,1,1,1};
+			})
 		)
 	}
 };
@@ -347,6 +347,75 @@ test_set eithert_tests{
 					[](Right<int> r) { return r == 8; }
 				);
 			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[chain]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ef = eitherT<std::string,function<int(int)>>;
+
+				int calls = 0;
+				auto step = [&calls](int x){
+					++calls;
+					return ef{inplace_tag(), [x](int y){
+						return x + y > 10
+							? make_left<int>(std::string("big"))
+							: make_right<std::string>(x + y);
+					}};
+				};
+				auto check = [](int x){
+					return x < 0
+						? make_left<int>(std::string("neg"))
+						: make_right<std::string>(x);
+				};
+
+				auto p = monad<ef>::pure(0);
+				for(int i = 0; i < 10; ++i)
+					p = (std::move(p) >>= step) >>= check;
+
+				bool ok = (*p)(1) == make_right<std::string>(10);
+				int callsOk = calls;
+
+				return ok && callsOk == 10
+					&& (*p)(3) == make_left<int>(std::string("big"))
+					&& calls == 14;
+			})
+		),
+		std::make_tuple(
+			std::string("monoidA::orDo[chain]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using ef = eitherT<std::string,function<int(int)>>;
+				using alts = _dtl::fused_eitherT<
+					function<either<std::string,int>(int)>
+				>::alternatives;
+
+				int calls = 0;
+				auto keyword = [&calls](int k){
+					return ef{inplace_tag(), [&calls,k](int x){
+						++calls;
+						return x == k
+							? make_right<std::string>(k)
+							: make_left<int>(std::string(1, char('a' + k % 26)));
+					}};
+				};
+
+				auto p = keyword(0) | keyword(1);
+				for(int k = 2; k < 50; ++k)
+					p = std::move(p) | keyword(k);
+
+				auto q = keyword(50) | (keyword(51) | keyword(52));
+
+				bool flat = (*p).target<alts>()
+					&& (*p).target<alts>()->fs.size() == 50
+					&& (*q).target<alts>()->fs.size() == 3;
+
+				bool found = (*p)(7) == make_right<std::string>(7);
+				int callsFound = calls;
+
+				return flat && found && callsFound == 8
+					&& (*q)(0) == make_left<int>(std::string("yza"));
+			})
 		)
 	}
 };
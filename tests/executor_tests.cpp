@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <ftl/executor.h>
+#include <ftl/future.h>
+#include "executor_tests.h"
+
+test_set executor_tests{
+	std::string("executor"),
+	{
+		std::make_tuple(
+			std::string("is_executor"),
+			std::function<bool()>([]() -> bool {
+				return ftl::is_executor<ftl::thread_pool>::value
+					&& ftl::is_executor<ftl::inline_executor>::value
+					&& !ftl::is_executor<int>::value;
+			})
+		),
+		std::make_tuple(
+			std::string("thread_pool runs every task"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> runs{0};
+
+				{
+					ftl::thread_pool pool(3);
+
+					for(int i = 0; i < 1000; ++i)
+						pool.execute([&runs](){ ++runs; });
+				}
+
+				return runs == 1000;
+			})
+		),
+		std::make_tuple(
+			std::string("thread_pool runs tasks submitted by tasks"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> runs{0};
+
+				{
+					ftl::thread_pool pool(2);
+
+					for(int i = 0; i < 10; ++i) {
+						pool.execute([&pool,&runs](){
+							for(int j = 0; j < 10; ++j)
+								pool.execute([&runs](){ ++runs; });
+						});
+					}
+				}
+
+				return runs == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("thread_pool on_start"),
+			std::function<bool()>([]() -> bool {
+				std::mutex m;
+				std::set<size_t> started;
+
+				{
+					ftl::thread_pool pool(4, [&](size_t i){
+						std::lock_guard<std::mutex> lock(m);
+						started.insert(i);
+					});
+
+					if(pool.size() != 4)
+						return false;
+				}
+
+				return started == std::set<size_t>{0, 1, 2, 3};
+			})
+		),
+		std::make_tuple(
+			std::string("future::then on thread_pool"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(2);
+				ftl::promise<int> p;
+
+				auto caller = std::this_thread::get_id();
+				auto f = p.get_future().then(pool, [caller](int x){
+					return std::this_thread::get_id() != caller ? x*2 : 0;
+				});
+
+				p.set_value(2);
+
+				return f.get() == 4;
+			})
+		)
+	}
+};
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <random>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <ftl/flat_hash_map.h>
+#include <ftl/concepts/monoid.h>
+#include "flat_hash_map_tests.h"
+
+namespace {
+	// Element slots beyond this many are refused, control bytes are not
+	size_t slot_limit = size_t(-1);
+
+	template<typename T>
+	struct limited_allocator {
+		using value_type = T;
+
+		limited_allocator() = default;
+
+		template<typename U>
+		limited_allocator(const limited_allocator<U>&) noexcept {}
+
+		T* allocate(size_t n) {
+			if(sizeof(T) > 1 && n > slot_limit)
+				throw std::bad_alloc();
+
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, size_t n) noexcept {
+			std::allocator<T>().deallocate(p, n);
+		}
+	};
+
+	template<typename T, typename U>
+	bool operator== (const limited_allocator<T>&, const limited_allocator<U>&) {
+		return true;
+	}
+
+	template<typename T, typename U>
+	bool operator!= (const limited_allocator<T>&, const limited_allocator<U>&) {
+		return false;
+	}
+}
+
+test_set flat_hash_map_tests{
+	std::string("flat_hash_map"),
+	{
+		std::make_tuple(
+			std::string("insert/erase[against unordered_map]"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_hash_map<int,int> m;
+				std::unordered_map<int,int> ref;
+				std::mt19937 gen(5);
+				std::uniform_int_distribution<int> key(0, 499);
+
+				for(int i = 0; i < 20000; ++i) {
+					int k = key(gen);
+					switch(gen() % 3) {
+					case 0:
+						m.insert(std::make_pair(k, i));
+						ref.insert(std::make_pair(k, i));
+						break;
+					case 1:
+						m.insert_or_assign(k, i);
+						ref[k] = i;
+						break;
+					default:
+						if(m.erase(k) != ref.erase(k))
+							return false;
+					}
+				}
+
+				if(m.size() != ref.size())
+					return false;
+
+				size_t n = 0;
+				for(auto& kv : m) {
+					auto it = ref.find(kv.first);
+					if(it == ref.end() || it->second != kv.second)
+						return false;
+					++n;
+				}
+
+				return n == ref.size() && m.load_factor() <= m.max_load_factor();
+			})
+		),
+		std::make_tuple(
+			std::string("Failed reserve leaves the map intact"),
+			std::function<bool()>([]() -> bool {
+				using map = ftl::flat_hash_map<
+					int, int, std::hash<int>, std::equal_to<int>,
+					limited_allocator<std::pair<int,int>>
+				>;
+
+				map m;
+				for(int i = 0; i < 10; ++i)
+					m.insert(std::make_pair(i, i));
+
+				slot_limit = 64;
+				bool threw = false;
+				try {
+					m.reserve(1000);
+				}
+				catch(std::bad_alloc&) {
+					threw = true;
+				}
+				slot_limit = size_t(-1);
+
+				m.insert(std::make_pair(10, 10));
+				m.erase(0);
+
+				return threw && m.size() == 10 && m.at(5) == 5
+					&& m.count(0) == 0 && m.at(10) == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("lookup"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_hash_map<std::string,int> m{{"one",1},{"two",2}};
+
+				auto get = [](int x){ return x; };
+				auto none = [](ftl::Nothing){ return 0; };
+
+				m.lookup("two").match(
+					[](std::reference_wrapper<int> x){ x.get() = 3; },
+					[](ftl::Nothing){}
+				);
+
+				const auto& c = m;
+				return c.lookup("one").match(get, none) == 1
+					&& c.lookup("two").match(get, none) == 3
+					&& c.lookup("three").match(get, none) == 0
+					&& m.count("one") == 1 && m.count("three") == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("operator[]/at"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_hash_map<int,std::string> m;
+				for(int i = 0; i < 100; ++i)
+					m[i] = std::to_string(i);
+
+				m[7] += "!";
+
+				bool threw = false;
+				try {
+					m.at(100);
+				}
+				catch(std::out_of_range&) {
+					threw = true;
+				}
+
+				return threw && m.size() == 100 && m.at(7) == "7!"
+					&& m.at(99) == "99";
+			})
+		),
+		std::make_tuple(
+			std::string("copy/move"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_hash_map<int,std::string> m;
+				for(int i = 0; i < 50; ++i)
+					m.insert(std::make_pair(i, std::to_string(i)));
+
+				for(int i = 0; i < 50; i += 2)
+					m.erase(i);
+
+				auto c = m;
+				auto d = std::move(m);
+				m = c;
+
+				return c == d && m == c && c.size() == 25
+					&& c.find(4) == c.end() && c.at(5) == "5";
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::flat_hash_map<std::string,int> m{{"a",1},{"b",2},{"c",3}};
+				auto r = [](int x){ return float(x)*1.5f; } % m;
+
+				return r == ftl::flat_hash_map<std::string,float>{
+					{"a",1.5f}, {"b",3.f}, {"c",4.5f}
+				} && m.at("c") == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a|a->b,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::flat_hash_map<std::string,int> m{{"a",1},{"b",2},{"c",3}};
+				auto r1 = [](int x){ return x+1; } % std::move(m);
+				auto r2 = [](int x){ return std::to_string(x); } % std::move(r1);
+
+				r2.insert(std::make_pair(std::string("d"), std::string("x")));
+
+				return r2 == ftl::flat_hash_map<std::string,std::string>{
+					{"a","2"}, {"b","3"}, {"c","4"}, {"d","x"}
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using map_t = ftl::flat_hash_map<int,int>;
+
+				map_t m1{{1,1},{2,2}};
+				map_t m2{{2,20},{3,30}};
+				map_t expected{{1,1},{2,2},{3,30}};
+
+				auto a = m1 ^ m2;
+				auto b = map_t(m1) ^ m2;
+				auto c = m1 ^ map_t(m2);
+				auto d = map_t(m1) ^ map_t(m2);
+
+				return a == expected && b == expected && c == expected
+					&& d == expected
+					&& (ftl::monoid<map_t>::id() ^ m1) == m1;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_hash_map<int,int> m;
+				for(int i = 1; i <= 10; ++i)
+					m.insert(std::make_pair(i, i*i));
+
+				auto l = ftl::foldl(
+					[](int z, int x){ return z + x; }, 0, m
+				);
+				auto r = ftl::foldr(
+					[](int x, int z){ return z + x; }, 0, m
+				);
+				auto s = ftl::fold(
+					ftl::fmap([](int x){ return ftl::sum(x); }, m)
+				);
+
+				return l == 385 && r == 385 && s == 385;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/flat_map.h>
+#include <ftl/concepts/monoid.h>
+#include <ftl/ord.h>
+#include "flat_map_tests.h"
+
+namespace {
+	// Ordered against strings by first letter, but no string itself
+	struct initial {
+		char c;
+	};
+
+	bool operator< (const std::string& s, initial i) {
+		return s.empty() || s[0] < i.c;
+	}
+
+	bool operator< (initial i, const std::string& s) {
+		return !s.empty() && i.c < s[0];
+	}
+}
+
+test_set flat_map_tests{
+	std::string("flat_map"),
+	{
+		std::make_tuple(
+			std::string("construction keeps the first of each key"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_map<int,char> m{{2,'b'},{1,'a'},{2,'x'}};
+
+				return m.size() == 2
+					&& m.begin()->first == 1 && m.at(2) == 'b';
+			})
+		),
+		std::make_tuple(
+			std::string("insert, operator[] and erase"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_map<std::string,int> m;
+				bool ok = m.insert({"b", 2}).second && m.insert({"d", 4}).second
+					&& !m.insert({"b", 0}).second;
+
+				m["a"] = 1;
+				m["d"] += 10;
+				ok = ok && !m.insert_or_assign("c", 3).first->first.empty();
+				ok = ok && !m.insert_or_assign("c", 30).second;
+
+				ok = ok && m.size() == 4 && m.at("a") == 1 && m.at("b") == 2
+					&& m.at("c") == 30 && m.at("d") == 14;
+
+				ok = ok && m.erase("b") == 1 && m.count("b") == 0;
+
+				try {
+					m.at("z");
+					return false;
+				}
+				catch(std::out_of_range&) {
+					return ok && m.begin()->first == "a";
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_map<int,int> m{{1,1},{2,2}};
+				flat_map<int,int> n{{2,20},{3,30}};
+
+				return (m ^ n) == flat_map<int,int>{{1,1},{2,2},{3,30}};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_map<int,int> m{{1,1},{2,2},{3,3}};
+
+				auto r = [](int x){ return std::to_string(x*2); } % m;
+				auto t = [](int x){ return x + 1; } % flat_map<int,int>(m);
+
+				return r.size() == 3 && r.at(1) == "2" && r.at(3) == "6"
+					&& t == flat_map<int,int>{{1,2},{2,3},{3,4}};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl and foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_map<int,int> m{{3,3},{1,1},{2,2}};
+
+				auto l = foldl([](int z, int x){ return z*10 + x; }, 0, m);
+				auto r = foldr([](int x, int z){ return z*10 + x; }, 0, m);
+
+				return l == 123 && r == 321;
+			})
+		),
+		std::make_tuple(
+			std::string("Heterogeneous lookup"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<std::string,int,decltype(ftl::asc())> m{
+					{"apple", 1}, {"banana", 2}, {"cherry", 3}
+				};
+
+				auto it = m.find(initial{'b'});
+
+				return it != m.end() && it->second == 2
+					&& m.count(initial{'d'}) == 0
+					&& m.lower_bound(initial{'c'})->second == 3
+					&& m.at("apple") == 1;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/flat_set.h>
+#include <ftl/concepts/monoid.h>
+#include <ftl/ord.h>
+#include "flat_set_tests.h"
+
+namespace {
+	// Ordered against strings by first letter, but no string itself
+	struct initial {
+		char c;
+	};
+
+	bool operator< (const std::string& s, initial i) {
+		return s.empty() || s[0] < i.c;
+	}
+
+	bool operator< (initial i, const std::string& s) {
+		return !s.empty() && i.c < s[0];
+	}
+}
+
+test_set flat_set_tests{
+	std::string("flat_set"),
+	{
+		std::make_tuple(
+			std::string("construction sorts and drops duplicates"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_set<int> s{3,1,2,3,1};
+
+				return s.sequence() == std::vector<int>{1,2,3};
+			})
+		),
+		std::make_tuple(
+			std::string("insert, find and erase"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_set<int> s{2,4};
+
+				bool ok = s.insert(3).second && s.insert(5).second
+					&& !s.insert(4).second && s.insert(0).second;
+
+				ok = ok && s.sequence() == std::vector<int>{0,2,3,4,5};
+				ok = ok && s.count(3) == 1 && s.find(1) == s.end();
+				ok = ok && s.erase(3) == 1 && s.erase(3) == 0;
+
+				std::vector<int> more{6,1,2,1};
+				s.insert(more.begin(), more.end());
+
+				return ok && s.sequence() == std::vector<int>{0,1,2,4,5,6};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_set<int> s1{1,3,5};
+				flat_set<int> s2{2,3,4};
+
+				return (s1 ^ s2) == flat_set<int>{1,2,3,4,5}
+					&& (s1 ^ monoid<flat_set<int>>::id()) == s1;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = [](int x){ return x/2; } % flat_set<int>{1,2,3,4,5,6};
+
+				return s == flat_set<int>{0,1,2,3};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = flat_set<int>{0,1,2};
+				auto s2 = s >>= [](int x){ return flat_set<int>{x,2*x}; };
+
+				return s2 == flat_set<int>{0,1,2,4};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::join"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = flat_set<flat_set<int>>{};
+				s.insert(flat_set<int>{1,2,3});
+				s.insert(flat_set<int>{3,4,5});
+
+				return monad<flat_set<int>>::join(s) == flat_set<int>{1,2,3,4,5};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl and foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				flat_set<int> s{3,1,2};
+
+				auto l = foldl([](int z, int x){ return z*10 + x; }, 0, s);
+				auto r = foldr([](int x, int z){ return z*10 + x; }, 0, s);
+
+				return l == 123 && r == 321;
+			})
+		),
+		std::make_tuple(
+			std::string("Heterogeneous lookup"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_set<std::string,decltype(ftl::asc())> s{"apple", "banana", "cherry"};
+
+				auto it = s.find(initial{'b'});
+
+				return it != s.end() && *it == "banana"
+					&& s.count(initial{'d'}) == 0
+					&& s.lower_bound(initial{'c'}) == s.begin() + 2
+					&& s.upper_bound(initial{'a'}) == s.begin() + 1
+					&& s.find("cherry") == s.begin() + 2;
+			})
+		)
+	}
+};
+
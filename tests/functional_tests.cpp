@@ -21,10 +21,49 @@
  * distribution.
  */
 #include <vector>
+#include <memory>
 #include <ftl/functional.h>
 #include <ftl/ord.h>
 #include "functional_tests.h"
 
+static int identity(int x) {
+	return x;
+}
+
+// Stateful allocator, keeping track of its live allocations
+template<typename T>
+struct counting_allocator {
+	using value_type = T;
+
+	explicit counting_allocator(int* c) noexcept : count(c) {}
+
+	template<typename U>
+	counting_allocator(const counting_allocator<U>& a) noexcept
+	: count(a.count) {}
+
+	T* allocate(size_t n) {
+		++*count;
+		return static_cast<T*>(::operator new(n*sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t) noexcept {
+		--*count;
+		::operator delete(p);
+	}
+
+	int* count;
+};
+
+template<typename T, typename U>
+bool operator== (const counting_allocator<T>& a, const counting_allocator<U>& b) {
+	return a.count == b.count;
+}
+
+template<typename T, typename U>
+bool operator!= (const counting_allocator<T>& a, const counting_allocator<U>& b) {
+	return !(a == b);
+}
+
 test_set functional_tests{
 	std::string("functional"),
 	{
@@ -44,6 +83,110 @@ test_set functional_tests{
 					&& g(1,2,3) == 6;
 			})
 		),
+		std::make_tuple(
+			std::string("function stores small closures in place"),
+			std::function<bool()>([]() -> bool {
+				using fn = ftl::function<size_t()>;
+
+				static_assert(
+					fn::inline_size == sizeof(size_t[2]),
+					"Default inline size should be two size_t"
+				);
+
+				size_t a = 1, b = 2, c = 3;
+				auto small = [a,b](){ return a + b; };
+				auto large = [a,b,c](){ return a + b + c; };
+
+				static_assert(
+					noexcept(fn(small)),
+					"Closures that fit should not allocate"
+				);
+
+				fn f = small, g = large;
+				fn h = std::move(g);
+
+				return f() == 3 && h() == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("function with stateful allocator"),
+			std::function<bool()>([]() -> bool {
+				int live = 0;
+				bool ok = true;
+
+				{
+					counting_allocator<int> alloc{&live};
+
+					ftl::function<int(int,int)> f{
+						std::allocator_arg, alloc, [](int x, int y){ return x+y; }
+					};
+
+					ok = ok && live == 1;
+
+					auto g = f;
+					ok = ok && live == 2;
+
+					// Holds a copy of g in turn, so two allocations
+					ftl::function<int(int,int)> h{std::allocator_arg, alloc, g};
+					ok = ok && live == 4;
+
+					// Does not wrap h again, but copies what h holds
+					ftl::function<int(int,int)> k{std::allocator_arg, alloc, h};
+					auto m = std::move(k);
+
+					ok = ok && live == 6
+						&& f(1,2) == 3 && g(1)(2) == 3 && h(1,2) == 3 && m(1,2) == 3;
+				}
+
+				return ok && live == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("function_ref"),
+			std::function<bool()>([]() -> bool {
+				using ref = ftl::function_ref<int(int,int,int)>;
+
+				static_assert(
+					sizeof(ref) == 2*sizeof(void*),
+					"function_ref should be two pointers wide"
+				);
+
+				int n = 1;
+				auto f = [&n](int x, int y, int z){ return n*(x + y + z); };
+				ref r = f;
+				ref q = r;
+
+				ftl::function_ref<int(int)> id = identity;
+
+				n = 2;
+				return r(1,2,3) == 12
+					&& q(1)(2,3) == 12
+					&& q(1,2)(3) == 12
+					&& id(5) == 5;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_function"),
+			std::function<bool()>([]() -> bool {
+				struct deref {
+					std::unique_ptr<int> p;
+					int operator() (int x) const { return *p + x; }
+				};
+
+				ftl::unique_function<int(int)> f =
+					deref{std::unique_ptr<int>(new int(5))};
+
+				ftl::unique_function<int(int)> g = std::move(f);
+
+				ftl::function<int(int)> h = [](int x){ return 2*x; };
+				ftl::unique_function<int(int)> k = h;
+
+				ftl::unique_function<int(int)> empty;
+				empty = std::move(k);
+
+				return g(1) == 6 && empty(3) == 6 && !f && !k && empty;
+			})
+		),
 		std::make_tuple(
 			std::string("functor<function>::map"),
 			std::function<bool()>([]() -> bool {
@@ -21,6 +21,11 @@
  * distribution.
  */
 #include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+#include <chrono>
 #include <ftl/future.h>
 #include "future_tests.h"
 
@@ -62,6 +67,24 @@ test_set future_tests{
 				return f.get() == 2;
 			})
 		),
+		std::make_tuple(
+			std::string("applicative::apply[move-only]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				struct add_to {
+					std::unique_ptr<int> p;
+					int operator() (int x) const { return *p + x; }
+				};
+
+				auto f = std::async(std::launch::async, [](){
+						return add_to{std::unique_ptr<int>(new int(1))};
+					})
+					* std::async(std::launch::async, [](){ return 1; });
+
+				return f.get() == 2;
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind"),
 			std::function<bool()>([]() -> bool {
@@ -109,6 +132,254 @@ test_set future_tests{
 				return static_cast<int>(f.get()) == 2;
 			})
 		),
+		std::make_tuple(
+			std::string("ftl::future::then"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p;
+				bool ran = false;
+
+				auto f = p.get_future().then([&ran](int x) {
+					ran = true;
+					return std::to_string(x);
+				});
+
+				if(ran || f.is_ready())
+					return false;
+
+				std::thread t([&p](){ p.set_value(1); });
+				t.join();
+
+				// The continuation ran on the thread that set the value
+				return ran && f.is_ready() && f.get() == std::string("1");
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future functor, applicative and monad"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int)> add = [](int x, int y){ return x+y; };
+
+				promise<int> p;
+				auto a = add % p.get_future() * make_ready_future(2);
+				auto b = std::move(a) >>= [](int x) {
+					return aPure<future<std::string>>()(std::to_string(x));
+				};
+				auto c = [](std::string s){ return s + "!"; } % std::move(b);
+
+				p.set_value(1);
+
+				return c.get() == std::string("3!");
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future exceptions"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				promise<int> p;
+				auto f = p.get_future().then([&calls](int x) -> int {
+					++calls;
+					throw std::runtime_error("");
+					return x;
+				});
+				auto g = std::move(f).then([&calls](int x){
+					++calls;
+					return x;
+				});
+
+				p.set_value(1);
+
+				future<int> broken;
+				{
+					promise<int> q;
+					broken = q.get_future();
+				}
+
+				bool threw = false, broke = false;
+				try { g.get(); } catch(std::runtime_error&) { threw = true; }
+				try { broken.get(); } catch(std::future_error&) { broke = true; }
+
+				return threw && broke && calls == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::when_all"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				promise<int> a;
+				promise<std::string> b;
+
+				auto all = when_all(a.get_future(), b.get_future());
+
+				b.set_value("b");
+				if(all.is_ready())
+					return false;
+
+				a.set_value(1);
+				auto t = all.get();
+
+				return std::get<0>(t) == 1 && std::get<1>(t) == std::string("b");
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future applicative completes in any order"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int,int)> f = [](int x, int y, int z) {
+					return 100*x + 10*y + z;
+				};
+
+				promise<int> p1, p2, p3;
+				auto r = f % p1.get_future() * p2.get_future() * p3.get_future();
+
+				p3.set_value(3);
+				p2.set_value(2);
+				if(r.is_ready())
+					return false;
+
+				p1.set_value(1);
+
+				return r.get() == 123;
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::sequence and ftl::traverse"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<promise<int>> ps(3);
+				std::vector<future<int>> fs;
+				for(auto& p : ps)
+					fs.push_back(p.get_future());
+
+				auto all = sequence(std::move(fs));
+				ps[2].set_value(2);
+				ps[0].set_value(0);
+				ps[1].set_value(1);
+
+				auto t = traverse(
+					[](int x){ return make_ready_future(x*2); },
+					std::vector<int>{1, 2, 3}
+				);
+
+				return all.get() == std::vector<int>{0, 1, 2}
+					&& t.get() == std::vector<int>{2, 4, 6};
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				promise<sum_monoid<int>> a, b;
+				auto f = a.get_future() ^ b.get_future();
+
+				b.set_value(sum(2));
+				a.set_value(sum(1));
+
+				return static_cast<int>(f.get()) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::when_any"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				promise<int> a, b, c;
+				auto f = when_any(a.get_future(), b.get_future(), c.get_future());
+
+				b.set_value(2);
+				a.set_value(1);
+
+				return f.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::first_success"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using E = either<std::string,int>;
+
+				std::vector<promise<E>> ps(3);
+				std::vector<future<E>> fs, gs;
+				for(auto& p : ps)
+					fs.push_back(p.get_future());
+
+				auto f = first_success(std::move(fs));
+
+				ps[0].set_value(make_left<int>(std::string("timeout")));
+				if(f.is_ready())
+					return false;
+
+				ps[2].set_value(make_right<std::string>(3));
+				ps[1].set_value(make_right<std::string>(2));
+
+				promise<E> q;
+				gs.push_back(q.get_future());
+				auto g = first_success(std::move(gs));
+				q.set_value(make_left<int>(std::string("down")));
+
+				return f.get() == make_right<std::string>(3)
+					&& g.get() == make_left<int>(std::string("down"));
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future cancellation"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int runs = 0;
+				cancellation_source src;
+				promise<int> p;
+
+				auto f = p.get_future().with_cancellation(src.token());
+				auto g = [&runs](int x){ ++runs; return x+1; } % std::move(f);
+				auto h = std::move(g) >>= [&runs](int x) {
+					++runs;
+					return make_ready_future(x);
+				};
+				auto k = when_all(std::move(h), make_ready_future(1));
+
+				src.cancel();
+				p.set_value(1);
+
+				bool cancelled = false;
+				try { k.get(); } catch(operation_cancelled&) { cancelled = true; }
+
+				return cancelled && runs == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("ftl::future deadline"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto src = cancellation_source::with_timeout(
+					std::chrono::milliseconds(1)
+				);
+				promise<int> p, q;
+
+				auto late = p.get_future().with_cancellation(src.token())
+					.then([](int x){ return x; });
+
+				auto early = q.get_future().with_cancellation(
+					cancellation_source::with_timeout(std::chrono::hours(1))
+						.token()
+				).then([](int x){ return x; });
+
+				q.set_value(2);
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				p.set_value(1);
+
+				bool cancelled = false;
+				try { late.get(); } catch(operation_cancelled&) { cancelled = true; }
+
+				return cancelled && early.get() == 2;
+			})
+		),
 	}
 };
-
@@ -20,6 +20,8 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <memory>
+#include <string>
 #include <ftl/forward_list.h>
 #include "fwdlist_tests.h"
 
@@ -141,6 +143,24 @@ test_set fwdlist_tests{
 				return l == std::forward_list<int>{2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::forward_list<std::unique_ptr<int>> l;
+				l.emplace_front(new int(2));
+				l.emplace_front(new int(1));
+				auto p = &l.front();
+
+				auto f = [](std::unique_ptr<int> n){ *n *= 2; return n; };
+				auto r = f % std::move(l);
+
+				return &r.front() == p
+					&& *r.front() == 2
+					&& **std::next(r.begin()) == 4;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -165,6 +185,21 @@ test_set fwdlist_tests{
 				return l == std::forward_list<int>{0,1,2,2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("applicative::apply[a->b]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator*;
+
+				std::forward_list<ftl::function<float(int)>> lf{
+					[](int x){ return float(x)/2.f; },
+					[](int x){ return float(x)*2.f; }
+				};
+
+				auto l = lf * std::forward_list<int>{1,2};
+
+				return l == std::forward_list<float>{.5f,1.f,2.f,4.f};
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind"),
 			std::function<bool()>([]() -> bool {
@@ -177,6 +212,29 @@ test_set fwdlist_tests{
 				return (l >>= f) == std::forward_list<int>{1,2,2,3,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("monad::bind[->forward_list]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				std::forward_list<int> l{1,0,2,3};
+				auto f = [](int x){
+					std::forward_list<int> r;
+					for(int i = 0; i < x; ++i)
+						r.push_front(x);
+
+					return r;
+				};
+
+				auto r = l >>= f;
+				auto j = ftl::monad<std::forward_list<int>>::join(
+					std::forward_list<std::forward_list<int>>{{1},{},{2,3}}
+				);
+
+				return r == std::forward_list<int>{1,2,2,3,3,3}
+					&& j == std::forward_list<int>{1,2,3};
+			})
+		),
 		std::make_tuple(
 			std::string("foldable::foldl"),
 			std::function<bool()>([]() -> bool {
@@ -277,6 +335,56 @@ test_set fwdlist_tests{
 				return l3 == std::forward_list<int>{};
 			})
 		),
+		std::make_tuple(
+			std::string("zippable::zipWith[&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				std::forward_list<std::unique_ptr<int>> l1;
+				l1.emplace_front(new int(3));
+				l1.emplace_front(new int(2));
+				l1.emplace_front(new int(1));
+				auto p = &l1.front();
+
+				std::forward_list<int> l2{10,20};
+
+				auto l3 = ftl::zipWith(
+					[](std::unique_ptr<int> x, int y){ *x += y; return x; },
+					std::move(l1), l2
+				);
+
+				return &l3.front() == p && *l3.front() == 11
+					&& **std::next(l3.begin()) == 22
+					&& std::next(l3.begin(), 2) == l3.end();
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zip[&&,&&]"),
+			std::function<bool()>([]() -> bool {
+				auto l = ftl::zip(
+					std::forward_list<std::string>{"a","b"},
+					std::forward_list<int>{1,2,3}
+				);
+
+				return l == std::forward_list<std::tuple<std::string,int>>{
+					std::make_tuple(std::string("a"),1),
+					std::make_tuple(std::string("b"),2)
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zip[3,2,3]"),
+			std::function<bool()>([]() -> bool {
+				std::forward_list<int> l1{1,2,3};
+				std::forward_list<float> l2{3.f,2.f};
+				std::forward_list<char> l3{'a','b','c'};
+
+				auto l = ftl::zip(l1, l2, l3);
+
+				return l == std::forward_list<std::tuple<int,float,char>>{
+					std::make_tuple(1,3.f,'a'),
+					std::make_tuple(2,2.f,'b')
+				};
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zip[3,3]"),
 			std::function<bool()>([]() -> bool {
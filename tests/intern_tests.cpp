@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <ftl/intern.h>
+#include "intern_tests.h"
+
+static_assert(ftl::Orderable<ftl::interned<std::string>>{},
+		"interned values must be Orderable when the values are");
+
+test_set intern_tests{
+	std::string("intern"),
+	{
+		std::make_tuple(
+			std::string("Equal values share one copy"),
+			std::function<bool()>([]() -> bool {
+				ftl::intern_table<std::string> t;
+
+				std::string big(1000, 'x');
+				auto a = t.intern(big);
+				auto b = t.intern(std::string(1000, 'x'));
+				auto c = t.intern(std::string("y"));
+
+				return &*a == &*b && a == b && a != c
+					&& a.hash() == std::hash<std::string>()(big)
+					&& t.size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Entries go with their last handle"),
+			std::function<bool()>([]() -> bool {
+				ftl::intern_table<int> t;
+
+				auto a = t.intern(1);
+				{
+					auto b = t.intern(2);
+					auto c = t.intern(2);
+					if(t.size() != 2)
+						return false;
+				}
+
+				bool one = t.size() == 1;
+
+				// Back as a new copy once interned again
+				auto d = t.intern(2);
+
+				return one && t.size() == 2 && *a == 1 && *d == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Handles outlive their table"),
+			std::function<bool()>([]() -> bool {
+				std::vector<ftl::interned<std::string>> hs;
+				{
+					ftl::intern_table<std::string> t(4);
+					hs.push_back(t.intern(std::string("a")));
+					hs.push_back(t.intern(std::string("a")));
+				}
+
+				return *hs[0] == "a" && same(hs[0], hs[1]);
+			})
+		),
+		std::make_tuple(
+			std::string("Concurrent interning gives one copy per value"),
+			std::function<bool()>([]() -> bool {
+				ftl::intern_table<std::string> t;
+				std::vector<std::vector<ftl::interned<std::string>>> rs(4);
+
+				std::vector<std::thread> ts;
+				for(size_t i = 0; i < rs.size(); ++i) {
+					ts.emplace_back([&t, &rs, i] {
+						for(int round = 0; round < 20; ++round) {
+							std::vector<ftl::interned<std::string>> hs;
+							for(int j = 0; j < 100; ++j) {
+								hs.push_back(t.intern(std::to_string(j)));
+							}
+							rs[i] = std::move(hs);
+						}
+					});
+				}
+
+				for(auto& th : ts)
+					th.join();
+
+				for(auto& r : rs) {
+					for(size_t j = 0; j < r.size(); ++j) {
+						if(!same(r[j], rs[0][j]) || *r[j] != std::to_string(j))
+							return false;
+					}
+				}
+
+				return t.size() == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("Ordered and unordered containers"),
+			std::function<bool()>([]() -> bool {
+				using ftl::ord;
+
+				ftl::intern_table<std::string> t;
+				auto a = t.intern(std::string("a"));
+				auto b = t.intern(std::string("b"));
+
+				std::set<ftl::interned<std::string>> s{b, a, t.intern("b")};
+				std::unordered_set<ftl::interned<std::string>> u{
+					a, b, t.intern(std::string("a"))
+				};
+
+				// Equal values from another table still compare equal
+				ftl::intern_table<std::string> other;
+				auto a2 = other.intern(std::string("a"));
+
+				return s.size() == 2 && *s.begin() == a && u.size() == 2
+					&& a < b && b > a && a <= a && !(a < a)
+					&& ftl::compare(a, b) == ord::Lt
+					&& ftl::compare(b, b) == ord::Eq
+					&& a2 == a && !same(a2, a);
+			})
+		)
+	}
+};
+
@@ -21,9 +21,49 @@
  * distribution.
  */
 #include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
 #include <ftl/lazy.h>
+#include <ftl/lazy_strategies.h>
 #include "lazy_tests.h"
 
+namespace {
+	int lazy_allocations = 0;
+
+	template<typename T>
+	struct lazy_counting_allocator {
+		using value_type = T;
+
+		lazy_counting_allocator() = default;
+
+		template<typename U>
+		lazy_counting_allocator(const lazy_counting_allocator<U>&) {}
+
+		T* allocate(size_t n) {
+			++lazy_allocations;
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, size_t n) {
+			std::allocator<T>().deallocate(p, n);
+		}
+
+		template<typename U>
+		bool operator== (const lazy_counting_allocator<U>&) const {
+			return true;
+		}
+
+		template<typename U>
+		bool operator!= (const lazy_counting_allocator<U>&) const {
+			return false;
+		}
+	};
+}
+
 test_set lazy_tests{
 	std::string("lazy"),
 	{
@@ -66,6 +106,22 @@ test_set lazy_tests{
 					&& s == std::string("ab");
 			})
 		),
+		std::make_tuple(
+			std::string("defer with move only and no arguments"),
+			std::function<bool()>([]() -> bool {
+				std::unique_ptr<int> p(new int(4));
+
+				auto l1 = ftl::defer(
+					[](std::unique_ptr<int> x, int y){ return *x + y; },
+					std::move(p),
+					1
+				);
+
+				auto l2 = ftl::defer([](){ return std::string("nullary"); });
+
+				return !p && *l1 == 5 && *l2 == std::string("nullary");
+			})
+		),
 		std::make_tuple(
 			std::string("Shared computations are performed once only"),
 			std::function<bool()>([]() -> bool {
@@ -84,6 +140,151 @@ test_set lazy_tests{
 					&& *l1 == x;
 			})
 		),
+		std::make_tuple(
+			std::string("Concurrent forcing computes once"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> runs{0};
+
+				ftl::lazy<std::string> l([&runs](){
+					++runs;
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					return std::string("forced");
+				});
+
+				std::atomic<int> correct{0};
+				std::vector<std::thread> threads;
+				for(int i = 0; i < 8; ++i) {
+					threads.emplace_back([l,&correct](){
+						if(*l == std::string("forced"))
+							++correct;
+					});
+				}
+
+				for(auto& t : threads)
+					t.join();
+
+				return runs == 1 && correct == 8
+					&& l.status() == ftl::value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("Throwing computation stays deferred"),
+			std::function<bool()>([]() -> bool {
+				int attempts = 0;
+
+				ftl::lazy<int> l([&attempts](){
+					if(++attempts == 1)
+						throw std::runtime_error("first attempt");
+
+					return attempts;
+				});
+
+				try {
+					*l;
+					return false;
+				}
+				catch(std::runtime_error&) {}
+
+				return l.status() == ftl::value_status::deferred
+					&& *l == 2 && *l == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("spark computes once"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> runs{0};
+
+				auto l = ftl::spark(ftl::make_lazy([&runs](){
+					++runs;
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					return 7;
+				}));
+
+				bool ok = *l == 7;
+
+				ftl::spark(l);
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+				return ok && runs == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("parallel_force"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> runs{0};
+
+				std::vector<ftl::lazy<int>> ls;
+				for(int i = 0; i < 64; ++i) {
+					ls.push_back(ftl::make_lazy([&runs,i](){
+						++runs;
+						return i*i;
+					}));
+				}
+
+				ftl::parallel_force(ls);
+
+				for(int i = 0; i < 64; ++i) {
+					if(ls[i].status() != ftl::value_status::ready || *ls[i] != i*i)
+						return false;
+				}
+
+				return runs == 64;
+			})
+		),
+		std::make_tuple(
+			std::string("make_lazy allocates once"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				lazy_allocations = 0;
+
+				auto l = make_lazy(
+					std::allocator_arg, lazy_counting_allocator<int>(),
+					[](){ return std::string("abc"); }
+				);
+
+				static_assert(
+					std::is_same<decltype(l), lazy<std::string>>::value,
+					"make_lazy should deduce the value type"
+				);
+
+				auto l2(l);
+
+				return lazy_allocations == 1
+					&& *l2 == std::string("abc")
+					&& l.status() == value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("Forcing releases captures"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto before = lazy_stats();
+				auto p = std::make_shared<int>(2);
+
+				auto l1 = defer(
+					[](std::shared_ptr<int> x, int y){ return *x + y; }, p, 1
+				);
+				auto l2(l1);
+				auto l3 = fmap([p](int x){ return x * *p; }, l1);
+
+				auto deferred = lazy_stats();
+				if(p.use_count() != 3
+					|| deferred.deferred != before.deferred + 2
+					|| deferred.thunk_bytes <= before.thunk_bytes)
+					return false;
+
+				int x = *l3;
+				auto forced = lazy_stats();
+
+				return x == 6 && p.use_count() == 1
+					&& l2.status() == value_status::ready
+					&& forced.deferred == before.deferred
+					&& forced.ready == before.ready + 2
+					&& forced.thunk_bytes == before.thunk_bytes;
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::append"),
 			std::function<bool()>([]() -> bool {
@@ -187,7 +388,28 @@ test_set lazy_tests{
 
 				return *l2 == .5f;
 			})
+		),
+		std::make_tuple(
+			std::string("Deep chains force in constant stack"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](int x){ return applicative<lazy<int>>::pure(x+1); };
+
+				auto l = applicative<lazy<int>>::pure(0);
+				for(int i = 0; i < 200000; ++i)
+					l = (l >>= f);
+
+				auto m = applicative<lazy<int>>::pure(0);
+				for(int i = 0; i < 200000; ++i)
+					m = fmap([](int x){ return x-1; }, m);
+
+				auto dropped = applicative<lazy<int>>::pure(0);
+				for(int i = 0; i < 200000; ++i)
+					dropped = (dropped >>= f);
+
+				return *l == 200000 && *m == -200000;
+			})
 		)
 	}
 };
-
@@ -23,6 +23,8 @@
 #include <string>
 #include <ftl/maybe.h>
 #include <ftl/lazy_trans.h>
+#include <ftl/lazy_strategies.h>
+#include <ftl/vector.h>
 #include <ftl/functional.h>
 #include "lazyt_tests.h"
 
@@ -113,7 +115,24 @@ test_set lazyt_tests{
 
 				return *ftl::get<0>(*b) == 6;
 			})
+		),
+		std::make_tuple(
+			std::string("parallel_force"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using lazyV = lazyT<std::vector<int>>;
+
+				lazyV a{std::vector<lazy<int>>{
+					make_lazy([](){ return 1; }),
+					make_lazy([](){ return 2; })
+				}};
+				auto b = [](int x){ return x*3; } % a;
+
+				parallel_force(b);
+
+				return (*b)[0].status() == value_status::ready
+					&& *(*b)[1] == 6;
+			})
 		)
 	}
 };
-
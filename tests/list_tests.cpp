@@ -20,6 +20,7 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <memory>
 #include <ftl/list.h>
 #include <ftl/vector.h>
 #include <ftl/maybe.h>
@@ -171,6 +172,19 @@ test_set list_tests{
 				return l == std::list<int>{2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::list<int> l{1,2,3};
+				auto p = &l.front();
+
+				auto r = [](int x){ return x*2; } % std::move(l);
+
+				return &r.front() == p && r == std::list<int>{2,4,6};
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -218,6 +232,40 @@ test_set list_tests{
 					== std::list<int>{1,2,2,3,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("monad::bind[&&,->list<move only>]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				auto f = [](int x){
+					std::list<std::unique_ptr<int>> l;
+					l.emplace_back(new int(x));
+					l.emplace_back(new int(x*10));
+					return l;
+				};
+
+				auto l = std::list<int>{1,2} >>= f;
+
+				std::list<int> r;
+				for(auto& p : l)
+					r.push_back(*p);
+
+				return r == std::list<int>{1,10,2,20};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::join[&&,splices]"),
+			std::function<bool()>([]() -> bool {
+				std::list<std::list<int>> ll{{1,2},{},{3}};
+				auto p1 = &ll.front().front();
+				auto p3 = &ll.back().front();
+
+				auto l = ftl::monad<std::list<int>>::join(std::move(ll));
+
+				return l == std::list<int>{1,2,3}
+					&& &l.front() == p1 && &l.back() == p3;
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind[&,->maybe]"),
 			std::function<bool()>([]() -> bool {
@@ -273,6 +321,16 @@ test_set list_tests{
 				return fold(l) == 12;
 			})
 		),
+		std::make_tuple(
+			std::string("foldable::foldMap"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::list<int> l{1,2,3};
+
+				return foldMap([](int x){ return sum(x*2); }, l) == 12;
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zipWith[3,3]"),
 			std::function<bool()>([]() -> bool {
@@ -354,6 +412,27 @@ test_set list_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("partition"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto odd = [](int x){ return x % 2 != 0; };
+				std::list<int> l{1,2,3,4,5};
+
+				auto r1 = partition(odd, l);
+
+				auto first = &l.front();
+				auto r2 = partition(odd, std::move(l));
+
+				return r1.first == std::list<int>{1,3,5}
+					&& r1.second == std::list<int>{2,4}
+					&& r2 == r1
+					// Relinked, not copied
+					&& &r2.first.front() == first
+					&& l.empty();
+			})
 		)
 	}
 };
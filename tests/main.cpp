@@ -22,7 +22,15 @@
  */
 #include <iostream>
 #include "sum_type_tests.h"
+#include "sum_vector_tests.h"
+#include "maybe_vector_tests.h"
+#include "atom_tests.h"
+#include "intern_tests.h"
+#include "persistent_vector_tests.h"
+#include "chunked_seq_tests.h"
 #include "either_tests.h"
+#include "executor_tests.h"
+#include "parallel_tests.h"
 #include "maybe_tests.h"
 #include "future_tests.h"
 #include "lazy_tests.h"
@@ -34,14 +42,26 @@
 #include "lazyt_tests.h"
 #include "list_tests.h"
 #include "vector_tests.h"
+#include "view_tests.h"
+#include "stream_tests.h"
 #include "fwdlist_tests.h"
 #include "tuple_tests.h"
 #include "memory_tests.h"
+#include "memoize_tests.h"
+#include "rc_tests.h"
 #include "string_tests.h"
 #include "set_tests.h"
+#include "flat_set_tests.h"
 #include "map_tests.h"
+#include "flat_map_tests.h"
 #include "unordered_map_tests.h"
+#include "flat_hash_map_tests.h"
+#include "arena_tests.h"
+#include "alloc_stats_tests.h"
+#include "trace_tests.h"
+#include "persistent_map_tests.h"
 #include "concept_tests.h"
+#include "coroutine_tests.h"
 
 bool run_test_set(test_set& ts, std::ostream& os) {
 	os << "Running test set '" << std::get<0>(ts) << "'...";
@@ -84,7 +104,15 @@ int main(int, char**) {
 
 	flawless &= run_test_set(prelude_tests, std::cout);
 	flawless &= run_test_set(sum_type_tests, std::cout);
+	flawless &= run_test_set(sum_vector_tests, std::cout);
+	flawless &= run_test_set(maybe_vector_tests, std::cout);
+	flawless &= run_test_set(atom_tests, std::cout);
+	flawless &= run_test_set(intern_tests, std::cout);
+	flawless &= run_test_set(persistent_vector_tests, std::cout);
+	flawless &= run_test_set(chunked_seq_tests, std::cout);
 	flawless &= run_test_set(either_tests, std::cout);
+	flawless &= run_test_set(executor_tests, std::cout);
+	flawless &= run_test_set(parallel_tests, std::cout);
 	flawless &= run_test_set(eithert_tests, std::cout);
 	flawless &= run_test_set(maybe_tests, std::cout);
 	flawless &= run_test_set(maybet_tests, std::cout);
@@ -95,14 +123,26 @@ int main(int, char**) {
 	flawless &= run_test_set(functional_tests, std::cout);
 	flawless &= run_test_set(list_tests, std::cout);
 	flawless &= run_test_set(vector_tests, std::cout);
+	flawless &= run_test_set(view_tests, std::cout);
+	flawless &= run_test_set(stream_tests, std::cout);
 	flawless &= run_test_set(fwdlist_tests, std::cout);
 	flawless &= run_test_set(tuple_tests, std::cout);
 	flawless &= run_test_set(memory_tests, std::cout);
+	flawless &= run_test_set(memoize_tests, std::cout);
+	flawless &= run_test_set(rc_tests, std::cout);
 	flawless &= run_test_set(string_tests, std::cout);
 	flawless &= run_test_set(set_tests, std::cout);
+	flawless &= run_test_set(flat_set_tests, std::cout);
 	flawless &= run_test_set(map_tests, std::cout);
+	flawless &= run_test_set(flat_map_tests, std::cout);
 	flawless &= run_test_set(unordered_map_tests, std::cout);
+	flawless &= run_test_set(flat_hash_map_tests, std::cout);
+	flawless &= run_test_set(arena_tests, std::cout);
+	flawless &= run_test_set(alloc_stats_tests, std::cout);
+	flawless &= run_test_set(trace_tests, std::cout);
+	flawless &= run_test_set(persistent_map_tests, std::cout);
 	flawless &= run_test_set(concept_tests, std::cout);
+	flawless &= run_test_set(coroutine_tests, std::cout);
 
 	if(!flawless)
 		return -1;
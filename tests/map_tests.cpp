@@ -20,7 +20,10 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
+#include <vector>
 #include <ftl/map.h>
+#include <ftl/string.h>
 #include "map_tests.h"
 
 test_set map_tests{
@@ -46,6 +49,22 @@ test_set map_tests{
 				};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[comparator]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using std::make_pair;
+
+				std::map<int,int,std::greater<int>> m;
+				for(int i = 0; i < 100; ++i)
+					m.insert(make_pair(i, i));
+
+				auto r = [](int x){ return float(x)/2; } % m;
+
+				return r.size() == 100 && r.begin()->first == 99
+					&& r.at(10) == 5.f;
+			})
+		),
 		std::make_tuple(
 			std::string("functor::map[a->a,&]"),
 			std::function<bool()>([]() -> bool {
@@ -114,6 +133,41 @@ test_set map_tests{
 
 				return fold(m) == 24;
 			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldMap[absorbing]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::make_pair;
+
+				std::map<int,int> m{
+					make_pair(0, 2),
+					make_pair(1, 3),
+					make_pair(2, 4)
+				};
+
+				auto odd = foldMap([](int x){ return any(x % 2 == 1); }, m);
+				auto big = foldMap([](int x){ return all(x > 2); }, m);
+
+				return odd && !big;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMapByKey"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> ws{"ab", "c", "de", "f", "gh"};
+
+				auto m = ftl::foldMapByKey<std::map>(
+					[](const std::string& w){ return w.size(); },
+					[](const std::string& w){ return w; },
+					ws
+				);
+
+				return m == std::map<size_t,std::string>{
+					std::make_pair(1, "cf"),
+					std::make_pair(2, "abdegh")
+				};
+			})
 		)
 	}
 };
@@ -20,7 +20,10 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <cstdint>
+#include <vector>
 #include <ftl/maybe.h>
+#include <ftl/ord.h>
 #include <ftl/type_functions.h>
 #include "maybe_tests.h"
 
@@ -109,6 +112,81 @@ test_set maybe_tests{
 				return success;
 			})
 		),
+		std::make_tuple(
+			std::string("ForwardIterable[iterator]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using it = _dtl::maybe_iterator<int>;
+				using cit = _dtl::const_maybe_iterator<int>;
+
+				static_assert(noexcept(*std::declval<it>()), "");
+				static_assert(noexcept(++std::declval<it&>()), "");
+				static_assert(cit{} == cit{}, "");
+				static_assert(
+					std::is_same<
+						std::iterator_traits<cit>::value_type, int
+					>::value, ""
+				);
+
+				auto m1 = just(10);
+				const auto m2 = nothing<int>();
+
+				auto b = begin(m1);
+				auto i = b++;
+
+				return &*i == &get<int>(m1)
+					&& b == end(m1)
+					&& begin(m2) == end(m2)
+					&& std::distance(begin(m1), end(m1)) == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("Niche layout"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int x = 5;
+
+				maybe<int*> m1 = just(&x);
+				maybe<int*> m2 = just(static_cast<int*>(nullptr));
+				maybe<int*> m3 = nothing<int*>();
+				maybe<ord> m4 = just(ord(ord::Gt));
+				maybe<ord> m5 = nothing<ord>();
+
+				m3 = m1;
+				m1 = nothing<int*>();
+				m5.emplace<ord>(ord::Lt);
+				m5.emplace<Nothing>();
+
+				int y = 7;
+				maybe<std::reference_wrapper<int>> m6 = just(std::ref(y));
+
+				return sizeof(maybe<std::reference_wrapper<int>>) == sizeof(int*)
+					&& sizeof(maybe<ord>) == sizeof(ord)
+					&& get<std::reference_wrapper<int>>(m6).get() == 7
+					&& m1.is<Nothing>()
+					&& m2.is<int*>() && get<int*>(m2) == nullptr
+					&& *get<int*>(m3) == 5
+					&& get<ord>(m4) == ord::Gt
+					&& m5.is<Nothing>()
+					&& m5 != m4 && m5 == nothing<ord>();
+			})
+		),
+		std::make_tuple(
+			std::string("All-ones pointer is a value"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Such as MAP_FAILED, or INVALID_HANDLE_VALUE
+				void* sentinel = reinterpret_cast<void*>(~std::uintptr_t(0));
+
+				maybe<void*> m = just(sentinel);
+				maybe<void*> c = m;
+
+				return m.is<void*>() && get<void*>(m) == sentinel
+					&& c == just(sentinel) && c != nothing<void*>();
+			})
+		),
 		std::make_tuple(
 			std::string("Pattern matching"),
 			std::function<bool()>([]() -> bool {
@@ -271,6 +349,54 @@ test_set maybe_tests{
 
 				return fold(m1) == 2 && fold(m2) == 1;
 			})
+		),
+		std::make_tuple(
+			std::string("sequence and traverse"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<maybe<int>> v{just(1), just(2), just(3)};
+				std::vector<maybe<int>> w{just(1), Nothing{}, just(3)};
+
+				int calls = 0;
+				auto half = [&calls](int x){
+					++calls;
+					return x % 2 == 0 ? just(x/2) : nothing<int>();
+				};
+
+				return sequence(v) == just(std::vector<int>{1, 2, 3})
+					&& sequence(std::move(w)) == nothing<std::vector<int>>()
+					&& traverse(half, std::vector<int>{2, 4})
+						== just(std::vector<int>{1, 2})
+					&& traverse(half, std::vector<int>{2, 3, 4, 6})
+						== nothing<std::vector<int>>()
+					&& calls == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("No copies through rvalue map, bind and apply"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct tracked {
+					tracked(int* c) : copies(c) {}
+					tracked(const tracked& t) : copies(t.copies) { ++*copies; }
+					tracked(tracked&&) = default;
+					tracked& operator= (tracked&&) = default;
+
+					int* copies;
+				};
+
+				int copies = 0;
+				auto pass = [](tracked t){ return t; };
+				auto justPass = [](tracked t){ return just(std::move(t)); };
+
+				auto m = ((just(tracked(&copies)) >>= justPass) >>= justPass);
+				auto r = aapply(just(pass), fmap(pass, std::move(m)));
+				auto j = monad<maybe<tracked>>::join(just(std::move(r)));
+
+				return j.is<tracked>() && copies == 0;
+			})
 		)
 	}
 };
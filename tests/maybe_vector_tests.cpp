@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/maybe_vector.h>
+#include "maybe_vector_tests.h"
+
+namespace {
+	// Every third element of n holds a value, the rest are nothing
+	std::vector<ftl::maybe<int>> sparse(int n) {
+		std::vector<ftl::maybe<int>> v;
+		for(int i = 0; i < n; ++i) {
+			if(i % 3 == 0)
+				v.push_back(ftl::just(i));
+			else
+				v.push_back(ftl::nothing<int>());
+		}
+
+		return v;
+	}
+}
+
+test_set maybe_vector_tests{
+	std::string("maybe_vector"),
+	{
+		std::make_tuple(
+			std::string("Round trip through std::vector<maybe>"),
+			std::function<bool()>([]() -> bool {
+				auto v = sparse(200);
+				ftl::maybe_vector<int> mv(v);
+
+				bool all = true;
+				for(size_t i = 0; i < v.size(); ++i)
+					all = all && mv[i] == v[i] && mv.has_value(i) == (i % 3 == 0);
+
+				return all
+					&& mv.size() == 200 && mv.count() == 67
+					&& mv.to_vector() == v
+					&& ftl::maybe_vector<int>(sparse(0)).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("push_back and emplace_back"),
+			std::function<bool()>([]() -> bool {
+				ftl::maybe_vector<std::string> mv;
+				mv.push_back(ftl::just(std::string("a")));
+				mv.push_back(ftl::Nothing{});
+				mv.emplace_back(3, 'b');
+
+				return mv.size() == 3
+					&& mv[0] == ftl::just(std::string("a"))
+					&& mv[1] == ftl::nothing<std::string>()
+					&& mv[2] == ftl::just(std::string("bbb"))
+					&& mv.values() == std::vector<std::string>{"a", "bbb"};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map keeps nothings in place"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::maybe_vector<int> mv(sparse(100));
+
+				auto f = [](int x){ return std::to_string(x); };
+				auto g = [](int x){ return x + 1; };
+
+				auto r = f % mv;
+				auto s = g % ftl::maybe_vector<int>(sparse(100));
+
+				bool ok = true;
+				for(size_t i = 0; i < 100; ++i) {
+					ok = ok && r.has_value(i) == mv.has_value(i)
+						&& s[i] == (g % mv[i]);
+				}
+
+				return ok && r[99] == ftl::just(std::string("99"));
+			})
+		),
+		std::make_tuple(
+			std::string("foldable skips nothings"),
+			std::function<bool()>([]() -> bool {
+				ftl::maybe_vector<int> mv(sparse(10));
+
+				auto snoc = [](std::vector<int> xs, int x){
+					xs.push_back(x);
+					return xs;
+				};
+
+				ftl::maybe_vector<ftl::sum_monoid<int>> sums;
+				sums.push_back(ftl::just(ftl::sum(2)));
+				sums.push_back(ftl::Nothing{});
+				sums.push_back(ftl::just(ftl::sum(5)));
+
+				return ftl::foldl(snoc, std::vector<int>{}, mv)
+					== std::vector<int>{0,3,6,9}
+					&& ftl::foldr(std::plus<int>(), 0, mv) == 18
+					&& ftl::foldMap(ftl::prod<int>, mv) == 0
+					&& ftl::fold(sums) == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith where both hold values"),
+			std::function<bool()>([]() -> bool {
+				// Values at multiples of 3 and of 2 respectively
+				ftl::maybe_vector<int> a(sparse(150));
+				ftl::maybe_vector<int> b;
+				for(int i = 0; i < 130; ++i) {
+					if(i % 2 == 0)
+						b.push_back(ftl::just(10 * i));
+					else
+						b.push_back(ftl::Nothing{});
+				}
+
+				auto r = ftl::zipWith(std::plus<int>(), a, b);
+
+				bool ok = r.size() == 130;
+				for(int i = 0; i < 130; ++i) {
+					ok = ok && (i % 6 == 0
+						? r[i] == ftl::just(11 * i)
+						: r[i] == ftl::nothing<int>());
+				}
+
+				return ok && r.count() == 22;
+			})
+		)
+	}
+};
@@ -337,6 +337,63 @@ test_set maybet_tests{
 
 				return fold(m1) == 7;
 			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[chain]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using mf = maybeT<function<int(int)>>;
+
+				int calls = 0;
+				auto step = [&calls](int x){
+					++calls;
+					return mf{inplace_tag(), [x](int y){
+						return x + y > 10 ? nothing<int>() : just(x + y);
+					}};
+				};
+
+				// maybeT cannot be assigned, so the chain is built recursively
+				std::function<mf(mf,int)> chain = [&](mf m, int n){
+					return n == 0 ? m : chain(std::move(m) >>= step, n-1);
+				};
+				auto p = chain(monad<mf>::pure(0), 10);
+
+				bool ok = (*p)(1) == just(10);
+				int callsOk = calls;
+
+				return ok && callsOk == 10
+					&& (*p)(3) == nothing<int>()
+					&& calls == 14;
+			})
+		),
+		std::make_tuple(
+			std::string("monoidA::orDo[chain]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using mf = maybeT<function<int(int)>>;
+				using alts = _dtl::fused_maybeT<function<maybe<int>(int)>>
+					::alternatives;
+
+				int calls = 0;
+				auto keyword = [&calls](int k){
+					return mf{inplace_tag(), [&calls,k](int x){
+						++calls;
+						return x == k ? just(k) : nothing<int>();
+					}};
+				};
+
+				auto p = keyword(0) | keyword(1) | keyword(2) | keyword(3);
+				auto q = keyword(4) | p;
+
+				bool found = (*p)(2) == just(2);
+				int callsFound = calls;
+
+				return found && callsFound == 3
+					&& (*p).target<alts>()->fs.size() == 4
+					&& (*q).target<alts>()->fs.size() == 5
+					&& (*q)(9) == nothing<int>()
+					&& calls == 8;
+			})
 		)
 		/* Crashed gcc, works as it should in clang
 		,
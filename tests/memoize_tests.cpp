@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <ftl/memoize.h>
+#include "memoize_tests.h"
+
+test_set memoize_tests{
+	std::string("memoize"),
+	{
+		std::make_tuple(
+			std::string("memoize: computes once per arguments"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				auto f = ftl::memoize(ftl::function<int(int,int)>(
+					[&calls](int x, int y){ ++calls; return x * y; }
+				));
+
+				bool results = f(3, 4) == 12 && f(3, 4) == 12 && f(4, 3) == 12;
+				auto s = f.stats();
+
+				return results && calls == 2
+					&& s.hits == 1 && s.misses == 2 && s.size == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize: copies and curried calls share the cache"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				auto f = ftl::memoize(ftl::function<int(int,int)>(
+					[&calls](int x, int y){ ++calls; return x - y; }
+				));
+
+				auto g = f;
+				auto from_ten = f(10);
+
+				bool results = from_ten(3) == 7 && f(10, 3) == 7 && g(10, 3) == 7;
+
+				return results && calls == 1 && g.stats().hits == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize: recursive functions"),
+			std::function<bool()>([]() -> bool {
+				ftl::memoized<long long(int)>* self = nullptr;
+				auto fib = ftl::memoize(ftl::function<long long(int)>(
+					[&self](int n) -> long long {
+						return n < 2 ? n : (*self)(n - 1) + (*self)(n - 2);
+					}
+				));
+				self = &fib;
+
+				return fib(90) == 2880067194370816120LL
+					&& fib.stats().misses == 91;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize: clear"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				auto f = ftl::memoize(ftl::function<int(int)>(
+					[&calls](int x){ ++calls; return x; }
+				));
+
+				f(1);
+				f.clear();
+				f(1);
+
+				return calls == 2 && f.stats().size == 1 && f.stats().hits == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize_lru: evicts least recently used"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> computed;
+				auto f = ftl::memoize_lru(
+					ftl::function<std::string(const std::string&)>(
+						[&computed](const std::string& s){
+							computed.push_back(s);
+							return s + s;
+						}
+					),
+					2
+				);
+
+				f("a"); f("b"); f("a"); f("c"); f("a"); f("b");
+				auto s = f.stats();
+
+				return computed == std::vector<std::string>{"a", "b", "c", "b"}
+					&& f("a") == "aa"
+					&& s.hits == 2 && s.misses == 4 && s.size == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize_concurrent"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> calls{0};
+				auto f = ftl::memoize_concurrent(ftl::function<int(int)>(
+					[&calls](int x){ ++calls; return x * 2; }
+				));
+
+				std::atomic<bool> ok{true};
+				std::vector<std::thread> ts;
+				for(int t = 0; t < 4; ++t) {
+					ts.emplace_back([&f, &ok](){
+						for(int i = 0; i < 1000; ++i) {
+							if(f(i % 50) != 2 * (i % 50))
+								ok = false;
+						}
+					});
+				}
+				for(auto& t : ts) {
+					t.join();
+				}
+
+				auto s = f.stats();
+
+				return ok && s.size == 50 && s.hits + s.misses == 4000
+					&& calls >= 50 && calls <= 200;
+			})
+		),
+		std::make_tuple(
+			std::string("memoize_concurrent: bounded"),
+			std::function<bool()>([]() -> bool {
+				auto f = ftl::memoize_concurrent(
+					ftl::function<int(int)>([](int x){ return x; }), 8, 2
+				);
+
+				for(int i = 0; i < 100; ++i) {
+					f(i);
+				}
+
+				return f.stats().size <= 8 && f(99) == 99;
+			})
+		)
+	}
+};
+
@@ -21,6 +21,7 @@
  * distribution.
  */
 #include <ftl/memory.h>
+#include <ftl/arena.h>
 #include "memory_tests.h"
 
 test_set memory_tests{
@@ -63,6 +64,59 @@ test_set memory_tests{
 				return *pr == -3;
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[no copy of source]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto p = std::make_shared<int>(3);
+				long count = 0;
+				auto pr = [&](int x){ count = p.use_count(); return x+1; } % p;
+
+				return *pr == 4 && count == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("allocate_fmap"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				arena a;
+				auto p = std::make_shared<int>(3);
+				std::shared_ptr<int> e;
+
+				auto f = [](int x){ return -x; };
+				auto r = allocate_fmap(arena_allocator<int>(&a), f, p);
+				auto used = a.used();
+				auto re = allocate_fmap(arena_allocator<int>(&a), f, e);
+
+				return *r == -3 && re == nullptr
+					&& used > 0 && a.used() == used;
+			})
+		),
+		std::make_tuple(
+			std::string("project"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct config {
+					std::string host;
+					int ports[2];
+				};
+
+				auto cfg = std::make_shared<config>(config{"example", {80, 443}});
+				std::shared_ptr<config> none;
+
+				std::shared_ptr<const std::string> host = project(cfg, &config::host);
+				auto tls = project(cfg, [](config& c) -> int& { return c.ports[1]; });
+
+				cfg.reset();
+
+				return *host == "example" && *tls == 443
+					&& host.use_count() == 2
+					&& project(none, &config::host) == nullptr;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -22,7 +22,13 @@
  */
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
+#include <algorithm>
 #include <ftl/ord.h>
+#include <ftl/list.h>
+#include <ftl/vector.h>
+#include <ftl/maybe.h>
 #include "ord_tests.h"
 
 test_set ord_tests{
@@ -81,6 +87,152 @@ test_set ord_tests{
 				return cmp(std::string("10"),std::string("5")) == ftl::ord::Gt;
 			})
 		),
+		std::make_tuple(
+			std::string("comparing[fn, no copies]"),
+			std::function<bool()>([]() -> bool {
+				struct counted {
+					counted(int x, int& copies) : x(x), copies(&copies) {}
+					counted(const counted& c) : x(c.x), copies(c.copies) {
+						++*copies;
+					}
+
+					int x;
+					int* copies;
+				};
+
+				int copies = 0;
+				ftl::function<int(const counted&)> f{
+					[](const counted& c){ return c.x; }
+				};
+
+				auto cmp = ftl::comparing(f);
+				counted a{1, copies}, b{2, copies};
+
+				return cmp(a, b) == ftl::ord::Lt && cmp(b, a) == ftl::ord::Gt
+					&& copies == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("sort_on"),
+			std::function<bool()>([]() -> bool {
+				using std::string;
+
+				int calls = 0;
+				auto len = [&](const string& s) {
+					++calls;
+					return s.size();
+				};
+
+				std::vector<string> v{"ccc", "a", "dd", "bbb", "", "ee", "f"};
+				auto r = ftl::sort_on(len, v);
+
+				return r == std::vector<string>{
+						"", "a", "f", "dd", "ee", "ccc", "bbb"
+					}
+					&& calls == 7
+					&& ftl::sort_on(len, std::vector<string>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("radix_sort_on"),
+			std::function<bool()>([]() -> bool {
+				using std::string;
+
+				std::vector<int> ints;
+				std::vector<double> doubles;
+				for(int i = 0; i < 1000; ++i) {
+					int x = (i * 7919) % 2003 - 1000;
+					ints.push_back(x * 65537);
+					doubles.push_back(x / 7.);
+				}
+				doubles.push_back(-0.25);
+
+				auto id = [](const int& x){ return x; };
+				auto idd = [](const double& x){ return x; };
+				auto r1 = ftl::radix_sort_on(id, ints);
+				auto r2 = ftl::radix_sort_on(idd, doubles);
+				std::sort(ints.begin(), ints.end());
+				std::sort(doubles.begin(), doubles.end());
+
+				// Stable, even across bytes
+				std::vector<std::pair<unsigned,char>> ps{
+					{256, 'a'}, {1, 'b'}, {256, 'c'}, {0, 'd'}, {1, 'e'}
+				};
+				auto r3 = ftl::radix_sort_on(
+					[](const std::pair<unsigned,char>& p){ return p.first; }, ps
+				);
+
+				// Strings fall back to sort_on
+				auto r4 = ftl::radix_sort_on(
+					[](const string& s){ return s; },
+					std::vector<string>{"b", "c", "a"}
+				);
+
+				string order;
+				for(auto& p : r3)
+					order += p.second;
+
+				return r1 == ints && r2 == doubles && order == "dbeac"
+					&& r4 == std::vector<string>{"a", "b", "c"}
+					&& ftl::radix_sort_on(id, std::vector<int>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("lexicographic"),
+			std::function<bool()>([]() -> bool {
+				using std::string;
+
+				struct person {
+					string last, first;
+					int age;
+
+					int birth() const {
+						return 2000 - age;
+					}
+				};
+
+				int calls = 0;
+				auto name = [&](const person& p) -> const string& {
+					++calls;
+					return p.last;
+				};
+
+				std::vector<person> v{
+					{"b", "x", 30}, {"a", "y", 20}, {"b", "x", 40}, {"a", "x", 50}
+				};
+
+				auto cmp = ftl::lexicographic(name, &person::first, &person::birth);
+				std::sort(v.begin(), v.end(), cmp);
+
+				calls = 0;
+				bool lt = cmp(v[0], v[3]);
+
+				return v[0].age == 50 && v[1].age == 20
+					&& v[2].age == 40 && v[3].age == 30
+					&& lt && calls == 2
+					&& cmp.compare(v[2], v[3]) == ftl::ord::Lt
+					&& cmp.compare(v[1], v[1]) == ftl::ord::Eq
+					&& !cmp(v[1], v[1]);
+			})
+		),
+		std::make_tuple(
+			std::string("asc/desc[function_ref]"),
+			std::function<bool()>([]() -> bool {
+				using std::string;
+				using cmp_ref = ftl::function_ref<ftl::ord(const string&,const string&)>;
+
+				auto cmp = ftl::comparing(&string::size);
+				std::vector<string> v{"aaa", "a", "aaaa", "aa"};
+				std::vector<string> w = v;
+
+				std::sort(v.begin(), v.end(), ftl::asc(cmp_ref(cmp)));
+				std::sort(w.begin(), w.end(), ftl::desc(cmp_ref(cmp)));
+
+				return v == std::vector<string>{"a", "aa", "aaa", "aaaa"}
+					&& w == std::vector<string>{"aaaa", "aaa", "aa", "a"}
+					&& ftl::equal(cmp_ref(cmp))(string("ab"), string("cd"));
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::append"),
 			std::function<bool()>([]() -> bool {
@@ -99,6 +251,49 @@ test_set ord_tests{
 					&& (gt ^ lt) == ord::Gt
 					&& (gt ^ eq) == ord::Gt;
 			})
+		),
+		std::make_tuple(
+			std::string("foldMap stops at first difference"),
+			std::function<bool()>([]() -> bool {
+				using ftl::ord;
+
+				std::vector<int> a{1,2,3,4,5,6}, b{1,2,4,4,0,0};
+				std::list<int> idx{0,1,2,3,4,5};
+				int calls = 0;
+
+				auto r = ftl::foldMap([&](int i) {
+					++calls;
+					return ftl::compare(a[i], b[i]);
+				}, idx);
+
+				std::vector<ftl::maybe<ord>> ms{
+					ftl::just(ord(ord::Eq)), ftl::nothing<ord>(),
+					ftl::just(ord(ord::Gt)), ftl::just(ord(ord::Lt))
+				};
+
+				return r == ord::Lt && calls == 3
+					&& ftl::fold(ms) == ftl::just(ord(ord::Gt));
+			})
+		),
+		std::make_tuple(
+			std::string("asc/desc[transparent]"),
+			std::function<bool()>([]() -> bool {
+				using std::string;
+
+				std::map<string,int,decltype(ftl::asc())> m{{"a", 1}, {"b", 2}};
+				std::vector<string> v{"b", "c", "a"};
+				std::sort(v.begin(), v.end(), ftl::desc());
+
+				auto by_size = ftl::asc([](const string& a, const string& b) {
+					return ftl::compare(a.size(), b.size());
+				});
+
+				return m.find("b")->second == 2 && m.count("c") == 0
+					&& v == std::vector<string>{"c", "b", "a"}
+					&& by_size(string("z"), string("aa"))
+					&& ftl::comparator()(string("a"), "b") == ftl::ord::Lt
+					&& ftl::comparator()(3, 3) == ftl::ord::Eq;
+			})
 		)
 	}
 };
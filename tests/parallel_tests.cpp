@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdexcept>
+#include <ftl/parallel.h>
+#include <ftl/vector.h>
+#include <ftl/string.h>
+#include <ftl/map.h>
+#include <ftl/unordered_map.h>
+#include "parallel_tests.h"
+
+namespace {
+	struct no_default {
+		explicit no_default(int n) : n(n) {}
+		int n;
+	};
+}
+
+test_set parallel_tests{
+	std::string("parallel"),
+	{
+		std::make_tuple(
+			std::string("par_fmap[vector]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::vector<int> v(100000);
+				for(size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i);
+
+				auto r1 = ftl::par_fmap(pool, [](int x){ return x*2; }, v);
+				auto r2 = ftl::par_fmap(pool, [](int x){ return no_default(x); }, v);
+
+				bool ok = r1.size() == v.size() && r2.size() == v.size();
+				for(size_t i = 0; ok && i < v.size(); ++i)
+					ok = r1[i] == 2*v[i] && r2[i].n == v[i];
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("par_fmap[bool]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				// Odd sized, so chunk bounds fall inside vector<bool>'s words
+				std::vector<int> v(100003);
+				for(size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i);
+
+				auto r = ftl::par_fmap(pool, [](int x){ return x % 3 == 0; }, v);
+
+				bool ok = r.size() == v.size();
+				for(size_t i = 0; ok && i < v.size(); ++i)
+					ok = r[i] == (v[i] % 3 == 0);
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("par_fmap[deque]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::deque<int> d;
+				for(int i = 0; i < 50000; ++i)
+					d.push_back(i);
+
+				auto r = ftl::par_fmap(pool, [](int x){ return x+1; }, d);
+
+				bool ok = r.size() == d.size();
+				for(size_t i = 0; ok && i < d.size(); ++i)
+					ok = r[i] == d[i] + 1;
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("par_foldMap"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::vector<int> v(100000, 1);
+				std::deque<int> d(v.begin(), v.end());
+
+				return ftl::par_foldMap(pool, ftl::sum<int>, v) == 100000
+					&& ftl::par_foldMap(pool, ftl::sum<int>, d) == 100000
+					&& ftl::par_foldMap(pool, ftl::sum<int>, std::vector<int>{}) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("par_fold preserves order"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::vector<std::string> v;
+				std::string expected;
+				for(int i = 0; i < 20000; ++i) {
+					v.push_back(std::to_string(i % 10));
+					expected += v.back();
+				}
+
+				return ftl::par_fold(pool, v) == expected;
+			})
+		),
+		std::make_tuple(
+			std::string("par_foldMap[chunked_seq]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				ftl::chunked_seq<std::string,64> s;
+				std::string expected;
+				for(int i = 0; i < 20000; ++i) {
+					s.push_back(std::to_string(i % 10));
+					expected += s.back();
+				}
+
+				auto len = ftl::par_foldMap(pool,
+					[](const std::string& x){ return ftl::sum(x.size()); }, s
+				);
+
+				return ftl::par_fold(pool, s) == expected
+					&& len == 20000u
+					&& ftl::par_fold(pool, ftl::chunked_seq<std::string>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("Exceptions escape par_foldMap"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(2);
+
+				std::vector<int> v(50000, 1);
+				v[40000] = 0;
+
+				try {
+					ftl::par_foldMap(pool, [](int x) {
+						if(x == 0)
+							throw std::runtime_error("zero");
+
+						return ftl::sum(x);
+					}, v);
+				}
+				catch(std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("Nested parallel calls on one worker"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(1);
+
+				auto f = [&pool](int x) {
+					std::vector<int> v(5000, x);
+					return ftl::par_foldMap(pool, ftl::sum<int>, v);
+				};
+
+				std::vector<int> v(5000, 1);
+				return ftl::par_foldMap(pool, f, v) == 25000000;
+			})
+		),
+		std::make_tuple(
+			std::string("par_foldMapByKey"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::vector<int> v;
+				for(int i = 0; i < 30000; ++i)
+					v.push_back(i);
+				std::deque<int> d(v.begin(), v.end());
+
+				auto key = [](int x){ return x % 7; };
+				auto digit = [](int x){ return std::to_string(x % 10); };
+
+				return ftl::par_foldMapByKey<std::map>(pool, key, digit, v)
+					== ftl::foldMapByKey<std::map>(key, digit, v)
+					&& ftl::par_foldMapByKey<std::unordered_map>(
+						pool, key, ftl::sum<int>, d
+					) == ftl::foldMapByKey<std::unordered_map>(
+						key, ftl::sum<int>, d
+					);
+			})
+		)
+	}
+};
+
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/persistent_map.h>
+#include <ftl/concepts/monoid.h>
+#include "persistent_map_tests.h"
+
+test_set persistent_map_tests{
+	std::string("persistent_map"),
+	{
+		std::make_tuple(
+			std::string("insert and iterate in order"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,int> m;
+
+				// Scramble the insertion order, to exercise all rotations
+				const int n = 5000;
+				for(int i = 0; i < n; ++i)
+					m.insert(std::make_pair((i * 7919) % n, i));
+
+				bool ok = m.size() == size_t(n) && !m.insert({0, -1});
+
+				int k = 0;
+				for(auto& kv : m)
+					ok = ok && kv.first == k++;
+
+				return ok && k == n && m.at(7919 % n) == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("find and erase"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,int> m;
+				for(int i = 0; i < 1000; ++i)
+					m.insert({i, i*i});
+
+				for(int i = 0; i < 1000; i += 2)
+					m.erase(i);
+
+				bool ok = m.size() == 500 && m.erase(0) == 0;
+
+				auto it = m.find(501);
+				ok = ok && it != m.end() && it->second == 501*501;
+				ok = ok && (++it)->first == 503 && m.find(500) == m.end();
+
+				int k = 1;
+				for(auto& kv : m) {
+					ok = ok && kv.first == k;
+					k += 2;
+				}
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("copies are unaffected by modification"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,std::string> m{{1,"one"},{2,"two"}};
+				auto n = m;
+
+				n.insert_or_assign(3, "three");
+				n.insert_or_assign(2, "deux");
+				n.erase(1);
+
+				return m.size() == 2 && m.at(1) == "one" && m.at(2) == "two"
+					&& m.count(3) == 0
+					&& n.size() == 2 && n.at(2) == "deux" && n.at(3) == "three"
+					&& n.count(1) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,int> m{{1,1},{2,2}};
+				persistent_map<int,int> n{{2,20},{3,30}};
+
+				auto r = m ^ n;
+
+				return r.size() == 3
+					&& r.at(1) == 1 && r.at(2) == 2 && r.at(3) == 30
+					&& m.size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,int> m{{1,1},{2,2},{3,3}};
+
+				auto r = [](int x){ return std::to_string(x*2); } % m;
+
+				auto s = m;
+				auto t = [](int x){ return x + 1; } % std::move(s);
+
+				return r.size() == 3 && r.at(1) == "2" && r.at(3) == "6"
+					&& t.at(1) == 2 && t.at(3) == 4 && m.at(1) == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl and foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_map<int,int> m{{3,3},{1,1},{2,2}};
+
+				auto l = foldl([](int z, int x){ return z*10 + x; }, 0, m);
+				auto r = foldr([](int x, int z){ return z*10 + x; }, 0, m);
+
+				return l == 123 && r == 321;
+			})
+		)
+	}
+};
+
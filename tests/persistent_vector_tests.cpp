@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/persistent_vector.h>
+#include <ftl/vector.h>
+#include <ftl/concepts/monoid.h>
+#include "persistent_vector_tests.h"
+
+test_set persistent_vector_tests{
+	std::string("persistent_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back and operator[]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Enough to need a third level in the trie
+				const size_t n = 40000;
+
+				persistent_vector<size_t> v;
+				for(size_t i = 0; i < n; ++i)
+					v.push_back(i);
+
+				bool ok = v.size() == n && v.front() == 0 && v.back() == n-1;
+				for(size_t i = 0; i < n; ++i)
+					ok = ok && v[i] == i;
+
+				size_t i = 0;
+				for(auto x : v)
+					ok = ok && x == i++;
+
+				return ok && i == n;
+			})
+		),
+		std::make_tuple(
+			std::string("copies are unaffected by modification"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v;
+				for(int i = 0; i < 2000; ++i)
+					v.push_back(i);
+
+				auto w = v;
+				auto u = v;
+
+				w.set(3, -3);
+				w.set(1999, -1999);
+				w.push_back(2000);
+				u.set(3, 33);
+
+				return v.size() == 2000 && v[3] == 3 && v[1999] == 1999
+					&& w.size() == 2001 && w[3] == -3 && w[1999] == -1999
+					&& w[2000] == 2000 && w[4] == 4
+					&& u.size() == 2000 && u[3] == 33;
+			})
+		),
+		std::make_tuple(
+			std::string("at"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v{1,2,3};
+
+				try {
+					v.at(3);
+					return false;
+				}
+				catch(std::out_of_range&) {
+					return v.at(2) == 3;
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v{1,2};
+				persistent_vector<int> w{3,4};
+
+				auto r = v ^ w;
+
+				return r == persistent_vector<int>{1,2,3,4}
+					&& v == persistent_vector<int>{1,2}
+					&& (monoid<persistent_vector<int>>::id() ^ w) == w;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl and foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v{1,2,3};
+
+				auto l = foldl([](int z, int x){ return z*10 + x; }, 0, v);
+				auto r = foldr([](int x, int z){ return z*10 + x; }, 0, v);
+
+				return l == 123 && r == 321;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v{1,2,3};
+
+				auto r = [](int x){ return std::to_string(x); } % v;
+
+				return r == persistent_vector<std::string>{"1","2","3"};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v;
+				for(int i = 0; i < 100; ++i)
+					v.push_back(i);
+
+				auto w = v;
+				auto r = [](int x){ return x+1; } % std::move(w);
+
+				return r.size() == 100 && r[0] == 1 && r[99] == 100
+					&& v[0] == 0 && v[99] == 99;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				persistent_vector<int> v{1,2,3};
+
+				auto r = v >>= [](int x){ return std::vector<int>{x, -x}; };
+
+				return r == persistent_vector<int>{1,-1,2,-2,3,-3};
+			})
+		)
+	}
+};
+
@@ -22,12 +22,17 @@
  */
 #include <ftl/prelude.h>
 #include <ftl/maybe.h>
+#include <ftl/vector.h>
 #include "prelude_tests.h"
 
 int curry_me(int x, int y) {
 	return x+y;
 }
 
+int curry_me3(int x, int y, int z) {
+	return x*y+z;
+}
+
 // Test make_curried_n with arbitrarily large function.
 struct _curry5 : public ftl::make_curried_n<5,_curry5> {
     template<typename P1, typename P2, typename P3, typename P4, typename P5>
@@ -39,6 +44,28 @@ struct _curry5 : public ftl::make_curried_n<5,_curry5> {
     using ftl::make_curried_n<5,_curry5>::operator();
 } curry5;
 
+// Counts how many times any instance was copied
+struct copy_counter {
+	copy_counter() = default;
+	copy_counter(const copy_counter&) { ++copies; }
+	copy_counter(copy_counter&&) noexcept {}
+
+	copy_counter& operator= (const copy_counter&) { ++copies; return *this; }
+	copy_counter& operator= (copy_counter&&) noexcept { return *this; }
+
+	static int copies;
+};
+
+int copy_counter::copies = 0;
+
+struct _take_first3 : ftl::_dtl::curried_ternf<_take_first3> {
+	copy_counter operator() (copy_counter c, int, int) const {
+		return c;
+	}
+
+	using ftl::_dtl::curried_ternf<_take_first3>::operator();
+} take_first3;
+
 test_set prelude_tests{
 	std::string("prelude"),
 	{
@@ -176,6 +203,52 @@ test_set prelude_tests{
 				return f(2)(2) == f(2,2) && f(2,2) == curry_me(2,2);
 			})
 		),
+		std::make_tuple(
+			std::string("currying regular functions is statically typed"),
+			std::function<bool()>([]() -> bool {
+				auto f = ftl::curry(curry_me3);
+				auto g = f(2);
+				auto h = g(3);
+
+				static_assert(
+					!std::is_same<decltype(g), ftl::function<int(int,int)>>::value
+					&& !std::is_same<decltype(h), ftl::function<int(int)>>::value,
+					"Partial application should not type erase"
+				);
+
+				using g_params = decltype(g)::parameter_types;
+				static_assert(
+					std::is_same<g_params, ftl::type_seq<int,int>>::value,
+					"Partial application should leave the remaining parameters"
+				);
+
+				ftl::function<int(int,int)> erased = g;
+
+				return h(1) == 7 && g(3,1) == 7 && f(2,3)(1) == 7
+					&& erased(3)(1) == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("curried partials move bound arguments"),
+			std::function<bool()>([]() -> bool {
+				copy_counter::copies = 0;
+
+				copy_counter a = ftl::const_(copy_counter{})(1);
+				copy_counter b = take_first3(copy_counter{})(1)(2);
+				copy_counter c = take_first3(copy_counter{}, 1)(2);
+
+				auto f = ftl::curry([](copy_counter c, int, int){ return c; });
+				copy_counter d = f(copy_counter{})(1)(2);
+
+				int moved = copy_counter::copies;
+
+				auto g = take_first3(copy_counter{}, 1);
+				copy_counter e = g(2);
+
+				(void)a; (void)b; (void)c; (void)d; (void)e;
+				return moved == 0 && copy_counter::copies == 1;
+			})
+		),
 		std::make_tuple(
 			std::string("currying std::function"),
 			std::function<bool()>([]() -> bool {
@@ -235,6 +308,29 @@ test_set prelude_tests{
 				return h(2,2) == 8.f/3.f;
 			})
 		),
+		std::make_tuple(
+			std::string("compose is statically typed"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return x+1; };
+				auto g = [](int x){ return 2*x; };
+
+				auto h = ftl::compose(f, g);
+				auto k = ftl::compose(f, curry_me);
+
+				static_assert(
+					!std::is_same<decltype(k), ftl::function<int(int,int)>>::value,
+					"Composition with a function pointer should not type erase"
+				);
+
+				std::vector<int> v{1,2,3};
+				auto r = h % std::move(v);
+
+				return h(3) == 7 && k(1)(2) == 4 && k(1,2) == 4
+					&& r == std::vector<int>{3,5,7};
+			})
+		),
 		std::make_tuple(
 			std::string("flip[function<R,A,B>]"),
 			std::function<bool()>([]() -> bool {
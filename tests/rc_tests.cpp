@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/rc.h>
+#include "rc_tests.h"
+
+test_set rc_tests{
+	std::string("rc"),
+	{
+		std::make_tuple(
+			std::string("make_rc and use_count"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct tracked {
+					explicit tracked(int& live) : live(live) {
+						++live;
+					}
+
+					~tracked() {
+						--live;
+					}
+
+					int& live;
+				};
+
+				int live = 0;
+				auto p = make_rc<tracked>(live);
+				bool one = live == 1 && p.use_count() == 1;
+
+				rc<tracked> q = p;
+				bool two = p.use_count() == 2 && q == p;
+
+				p.reset();
+				bool still = live == 1 && q.use_count() == 1 && p == nullptr;
+
+				rc<tracked> r = std::move(q);
+				r = nullptr;
+
+				return one && two && still && live == 0 && q == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("conversion to base"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct base {
+					int x;
+				};
+
+				struct derived : base {
+					explicit derived(int y) : base{y} {}
+				};
+
+				auto d = make_rc<derived>(4);
+				rc<base> b = d;
+
+				return b->x == 4 && d.use_count() == 2
+					&& static_cast<const void*>(b.get()) == d.get();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using rptr = rc<sum_monoid<int>>;
+
+				auto p1 = monoid<rptr>::id();
+				auto p2 = make_rc<sum_monoid<int>>(sum(2));
+				auto p3 = make_rc<sum_monoid<int>>(sum(2));
+
+				auto pr = p1 ^ p2 ^ p1 ^ p3 ^ p1;
+
+				return *pr == sum(4) && (p1 ^ p1) == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto p = make_rc<int>(3);
+				auto pr = [](int x){ return -x; } % p;
+
+				rc<int> n;
+				auto nr = [](int x){ return -x; } % n;
+
+				return *pr == -3 && nr == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = function<int(int,int)>(
+					[](int x, int y){ return x-y; }
+				);
+
+				auto p1 = applicative<rc<int>>::pure(2);
+				auto p2 = applicative<rc<int>>::pure(3);
+				rc<int> p3;
+
+				return *(f % p1 * p2) == -1 && (f % p1 * p3) == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto p = make_rc<int>(1);
+				auto f = [](int x){ return make_rc<float>(float(x)/2.f); };
+				auto g = [](int){ return rc<float>{}; };
+
+				return *(p >>= f) == .5f
+					&& (p >>= g) == nullptr
+					&& (rc<int>() >>= f) == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl/foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto p = make_rc<int>(2);
+				rc<int> n;
+				auto minus = [](int x, int y){ return x-y; };
+
+				return foldl(minus, 10, p) == 8
+					&& foldr(minus, 10, p) == -8
+					&& foldl(minus, 10, n) == 10
+					&& foldr(minus, 10, n) == 10;
+			})
+		)
+	}
+};
+
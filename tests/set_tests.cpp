@@ -20,7 +20,10 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
 #include <ftl/set.h>
+#include <ftl/list.h>
+#include <ftl/ord.h>
 #include "set_tests.h"
 
 test_set set_tests{
@@ -48,6 +51,34 @@ test_set set_tests{
 				return s == set<int>{1,2,3,4,5,6,7};
 			})
 		),
+		std::make_tuple(
+			std::string("monoid:append[const]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using std::set;
+
+				const auto s1 = set<int,std::greater<int>>{5,3,1};
+				const auto s2 = set<int,std::greater<int>>{6,3,2};
+
+				auto s = s1 ^ s2;
+				return s == set<int,std::greater<int>>{6,5,3,2,1}
+					&& s1.size() == 3 && s2.size() == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldMap[into set]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::list<int> l;
+				for(int i = 0; i < 2000; ++i)
+					l.push_back(i);
+
+				auto s = foldMap([](int x){ return std::set<int>{x%100, -x}; }, l);
+
+				return s.size() == 2099 && *s.begin() == -1999 && *s.rbegin() == 99;
+			})
+		),
 		std::make_tuple(
 			std::string("functor::map[a->a,&&]"),
 			std::function<bool()>([]() -> bool {
@@ -71,6 +102,52 @@ test_set set_tests{
 				return s == std::set<int>{2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[unordered results]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto s1 = std::set<int>{};
+				for(int i = 0; i < 1000; ++i)
+					s1.insert(i);
+
+				// Results out of order and with duplicates
+				auto s = [](int x){ return (x * 37) % 500; } % s1;
+
+				auto it = s.begin();
+				bool ok = s.size() == 500;
+				for(int i = 0; i < 500; ++i)
+					ok = ok && *it++ == i;
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[keeps first of equivalent]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				struct by_first {
+					bool operator() (
+							const std::pair<int,int>& a,
+							const std::pair<int,int>& b) const {
+						return a.first < b.first;
+					}
+				};
+
+				std::set<std::pair<int,int>,by_first> s1{
+					std::make_pair(0,0), std::make_pair(1,1),
+					std::make_pair(2,2), std::make_pair(3,3)
+				};
+
+				auto s = [](std::pair<int,int> p){
+					return std::make_pair(p.first % 2 == 0 ? 1 : 0, p.second);
+				} % s1;
+
+				return s.size() == 2
+					&& s.begin()->second == 1 && (++s.begin())->second == 0;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -138,6 +215,29 @@ test_set set_tests{
 
 				return fold(l) == 24;
 			})
+		),
+		std::make_tuple(
+			std::string("functor::map[transparent]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using ascending = decltype(asc());
+
+				std::set<int,ascending> s{1,2,3};
+				std::set<int,decltype(desc())> d{1,2,3};
+
+				auto r = fmap([](int x){ return std::to_string(x); }, s);
+				auto e = fmap([](int x){ return x * 2; }, d);
+
+				static_assert(
+					std::is_same<decltype(r), std::set<std::string,ascending>>::value,
+					"Transparent comparators are kept by fmap"
+				);
+
+				return r.count("2") == 1
+					&& e == std::set<int,decltype(desc())>{6,4,2}
+					&& *e.begin() == 6;
+			})
 		)
 	}
 };
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <ftl/stream.h>
+#include <ftl/map.h>
+#include "stream_tests.h"
+
+test_set stream_tests{
+	std::string("stream"),
+	{
+		std::make_tuple(
+			std::string("lines across block boundaries"),
+			std::function<bool()>([]() -> bool {
+				auto push = [](std::vector<std::string> xs, const std::string& l){
+					xs.push_back(l);
+					return xs;
+				};
+
+				std::vector<std::string> expected{
+					"first", "", "a somewhat longer line", "last"
+				};
+
+				bool ok = true;
+				for(size_t block : {1, 3, 7, 4096}) {
+					std::istringstream is(
+						"first\n\na somewhat longer line\nlast\n"
+					);
+					ok = ok && ftl::foldl(
+						push, std::vector<std::string>{}, ftl::lines(is, block)
+					) == expected;
+				}
+
+				std::istringstream unterminated("x\ny");
+				std::istringstream empty("");
+
+				return ok
+					&& ftl::foldl(
+						push, std::vector<std::string>{},
+						ftl::lines(unterminated, 2)
+					) == std::vector<std::string>{"x", "y"}
+					&& ftl::foldl(
+						push, std::vector<std::string>{}, ftl::lines(empty)
+					).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("chunks"),
+			std::function<bool()>([]() -> bool {
+				auto push = [](std::vector<std::string> xs, const std::string& c){
+					xs.push_back(c);
+					return xs;
+				};
+
+				std::istringstream is(std::string("ab\0cdefg", 8));
+
+				return ftl::foldl(
+						push, std::vector<std::string>{}, ftl::chunks(is, 3, 2)
+					) == std::vector<std::string>{
+						std::string("ab\0", 3), "cde", "fg"
+					};
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap, fold and foldMapByKey"),
+			std::function<bool()>([]() -> bool {
+				std::string text = "to be\nor not\nto be\n";
+				std::istringstream is1(text), is2(text), is3(text);
+
+				auto len = ftl::foldMap(
+					[](const std::string& w){ return ftl::sum(w.size()); },
+					ftl::records(is1, ' ', 4)
+				);
+
+				auto joined = ftl::fold(ftl::lines(is2, 4));
+
+				auto counts = ftl::foldMapByKey<std::map>(
+					[](const std::string& l){ return l; },
+					[](const std::string&){ return ftl::sum(1); },
+					ftl::lines(is3, 4)
+				);
+
+				return len == text.size() - 3
+					&& joined == "to beor notto be"
+					&& counts.size() == 2
+					&& counts["to be"] == 2 && counts["or not"] == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("missing file throws"),
+			std::function<bool()>([]() -> bool {
+				try {
+					ftl::lines("/nonexistent/ftl/stream/test");
+				}
+				catch(std::ios_base::failure&) {
+					return true;
+				}
+
+				return false;
+			})
+		)
+	}
+};
@@ -21,6 +21,8 @@
  * distribution.
  */
 #include <ftl/string.h>
+#include <ftl/vector.h>
+#include <ftl/list.h>
 #include "string_tests.h"
 
 test_set string_tests{
@@ -75,6 +77,56 @@ test_set string_tests{
 
 				return (std::move(s1) ^ std::move(s2)) == std::string("abcd");
 			})
+		),
+		std::make_tuple(
+			std::string("string_builder"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using sb = string_builder<std::string>;
+
+				sb b1{std::string("ab")};
+				b1 += std::string("");
+				b1 += std::string("cd");
+
+				sb b2 = monoid<sb>::append(
+					monoid<sb>::append(monoid<sb>::id(), b1),
+					sb{std::string("ef")}
+				);
+
+				return b1.str() == "abcd" && b1.size() == 4
+					&& b2.str() == "abcdef" && b2.size() == 6
+					&& monoid<sb>::id().str().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<std::string> v{"ab", "", "cd", "e"};
+				std::list<std::string> l{"f", "gh"};
+
+				return fold(v) == "abcde" && fold(l) == "fgh"
+					&& fold(std::vector<std::string>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldMap"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1, 2, 3};
+				std::list<std::pair<std::string,int>> l{{"a", 1}, {"bc", 2}};
+
+				auto toString = [](int x){ return std::to_string(x) + ","; };
+				auto key = [](const std::pair<std::string,int>& p)
+					-> const std::string& {
+					return p.first;
+				};
+
+				return foldMap(toString, v) == "1,2,3,"
+					&& foldMap(key, l) == "abc";
+			})
 		)
 	}
 };
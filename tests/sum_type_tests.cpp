@@ -55,6 +55,57 @@ maybe<ftl::plain_type<T>> just(T&& t) {
 	};
 }
 
+#ifdef FTL_CPP14
+struct int_clause {
+	constexpr int operator()(int x) const noexcept {
+		return x;
+	}
+};
+
+struct literal {
+	char c;
+};
+
+struct literal_clause {
+	constexpr int operator()(literal l) const noexcept {
+		return -l.c;
+	}
+};
+#endif
+
+// The alternatives of a wide sum type, told apart by I
+template<size_t I>
+struct alt {
+	explicit alt(int v) : v(v) {}
+
+	int v;
+};
+
+struct any_alt {
+	template<size_t I>
+	int operator()(const alt<I>& a) const {
+		return a.v;
+	}
+};
+
+template<size_t...Is>
+ftl::sum_type<alt<Is>...> wide_sum(ftl::seq<Is...>);
+
+using wide64 = decltype(wide_sum(ftl::gen_seq<0,63>{}));
+
+// Returns every alternative as its own type
+struct as_is {
+	template<typename T>
+	T operator()(T x) const {
+		return x;
+	}
+};
+
+template<typename A, typename B>
+struct larger {
+	using type = ftl::if_<(sizeof(B) > sizeof(A)), B, A>;
+};
+
 test_set sum_type_tests{
 	std::string("sum_type"),
 	{
@@ -184,6 +235,84 @@ test_set sum_type_tests{
 					&& get<0>(x3) == 10;
 			})
 		),
+		std::make_tuple(
+			std::string("Compact index"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				return sizeof(sum_type<int,char>) < sizeof(int) + sizeof(size_t)
+					&& sizeof(sum_type<char,bool>) == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Trivially copyable"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st1 = sum_type<int,float>;
+				using st2 = sum_type<int,std::vector<int>>;
+
+				st1 x{constructor<float>(), 2.f};
+				st1 y{constructor<int>(), 1};
+
+				y = x;
+
+				return std::is_trivially_copyable<st1>::value
+					&& std::is_trivially_destructible<st1>::value
+					&& !std::is_trivially_copyable<st2>::value
+					&& y.is<float>() && get<float>(y) == 2.f;
+			})
+		),
+#ifdef FTL_CPP14
+		std::make_tuple(
+			std::string("constexpr construction, match and get"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st = sum_type<int,literal>;
+
+				constexpr st x{constructor<int>(), 12};
+				constexpr st y{constructor<literal>(), literal{'a'}};
+
+				constexpr int r1 = x.match(int_clause{}, literal_clause{});
+				constexpr int r2 = y.match(int_clause{}, literal_clause{});
+				constexpr bool b = x.is<int>() && y.isTypeAt<1>();
+				constexpr int i = get<int>(x);
+				constexpr char c = get<1>(y).c;
+
+				return r1 == 12 && r2 == -'a' && b && i == 12 && c == 'a';
+			})
+		),
+#endif
+		std::make_tuple(
+			std::string("emplace"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct thrower {
+					explicit thrower(int) { throw 1; }
+					thrower(thrower&&) noexcept {}
+				};
+
+				sum_type<int,std::string,thrower> x{constructor<int>(), 5};
+
+				auto& str = x.emplace<std::string>(3, 'a');
+				bool b1 = x.is<std::string>() && get<std::string>(x) == "aaa";
+
+				str += "b";
+				x.emplace<int>(7);
+				bool b2 = x.is<int>() && get<int>(x) == 7;
+
+				x.emplace<std::string>("abc");
+				try {
+					x.emplace<thrower>(1);
+				}
+				catch(int) {}
+
+				return b1 && b2 && x.is<std::string>()
+					&& get<std::string>(x) == "abc";
+			})
+		),
 		std::make_tuple(
 			std::string("Get by index"),
 			std::function<bool()>([]() -> bool {
@@ -277,6 +406,184 @@ test_set sum_type_tests{
 				return s1 == 0 && s2 == 1 && s3 == 1;
 			})
 		),
+		std::make_tuple(
+			std::string("Match expressions [wide]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct A {};
+				struct B {};
+				struct C {};
+				struct D {};
+				struct E {};
+
+				using wide = sum_type<A,B,C,D,E,int>;
+
+				std::vector<wide> xs{
+					wide{constructor<A>()},
+					wide{constructor<C>()},
+					wide{constructor<int>(), 10},
+					wide{constructor<E>()}
+				};
+
+				int r = 0;
+				for(const auto& x : xs) {
+					r += x.match(
+						[](A){ return 1; },
+						[](B){ return 2; },
+						[](C){ return 3; },
+						[](D){ return 4; },
+						[](E){ return 5; },
+						[](int i){ return i; }
+					);
+				}
+
+				int s = 0;
+				for(const auto& x : xs) {
+					s += x.match(
+						[](int i){ return i; },
+						[](otherwise){ return 0; }
+					);
+				}
+
+				return r == 19 && s == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("Type level find, fold and index"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(
+					find_type<std::is_pointer, int, char*, void*>::value == 1
+					&& find_type<std::is_pointer, int, char>::value == 2
+					&& find_type<std::is_pointer, type_seq<int,void*>>::value == 1,
+					"find_type"
+				);
+
+				static_assert(
+					index_of<alt<50>, type_seq<alt<49>,alt<50>,alt<50>>>::value == 1
+					&& std::is_same<type_at<63, alt<0>, alt<1>, alt<2>,
+						alt<3>, alt<4>, alt<5>, alt<6>, alt<7>, alt<8>, alt<9>,
+						alt<10>, alt<11>, alt<12>, alt<13>, alt<14>, alt<15>,
+						alt<16>, alt<17>, alt<18>, alt<19>, alt<20>, alt<21>,
+						alt<22>, alt<23>, alt<24>, alt<25>, alt<26>, alt<27>,
+						alt<28>, alt<29>, alt<30>, alt<31>, alt<32>, alt<33>,
+						alt<34>, alt<35>, alt<36>, alt<37>, alt<38>, alt<39>,
+						alt<40>, alt<41>, alt<42>, alt<43>, alt<44>, alt<45>,
+						alt<46>, alt<47>, alt<48>, alt<49>, alt<50>, alt<51>,
+						alt<52>, alt<53>, alt<54>, alt<55>, alt<56>, alt<57>,
+						alt<58>, alt<59>, alt<60>, alt<61>, alt<62>, alt<63>
+					>, alt<63>>::value,
+					"index_of and type_at"
+				);
+
+				static_assert(
+					std::is_same<
+						fold_types<larger, char, short, double, int>, double
+					>::value
+					&& std::is_same<fold_types<larger, char>, char>::value,
+					"fold_types"
+				);
+
+				static_assert(
+					std::is_same<
+						drop_types<2,int,float,char>::type, type_seq<char>
+					>::value
+					&& std::is_same<
+						drop_types<4,int,float,char>::type, type_seq<>
+					>::value
+					&& std::is_same<
+						take_types<2,int,float,char>::type, type_seq<int,float>
+					>::value
+					&& std::is_same<
+						map_types<std::add_pointer, int, char>, type_seq<int*,char*>
+					>::value,
+					"take, drop and map"
+				);
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("Match result type [mixed]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_type<int,long,double,char> x{constructor<char>(), 'a'};
+
+				auto r = x.match(as_is{});
+
+				// Clause results are combined left to right, as by common_type
+				static_assert(
+					std::is_same<
+						decltype(r), std::common_type<int,long,double,char>::type
+					>::value,
+					"Match result type"
+				);
+
+				return r == 'a';
+			})
+		),
+		std::make_tuple(
+			std::string("Match expressions [64 wide]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<wide64> xs{
+					wide64{constructor<alt<0>>(), 1},
+					wide64{constructor<alt<40>>(), 2},
+					wide64{constructor<alt<63>>(), 3}
+				};
+
+				int r = 0;
+				for(const auto& x : xs) {
+					r += x.match(
+						[](const alt<40>& a){ return 100 * a.v; },
+						any_alt{}
+					);
+				}
+
+				auto y = xs.back();
+
+				return r == 204
+					&& y.is<alt<63>>() && !y.is<alt<62>>()
+					&& get<alt<63>>(y).v == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("Multi-match"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct A {};
+				struct B {};
+
+				sum_type<A,int> x{constructor<int>(), 3};
+				sum_type<A,int> y{constructor<A>()};
+				const sum_type<B,char,int> z{constructor<char>(), 'a'};
+
+				auto r1 = match(x, z,
+					[](int i, char){ return i; },
+					[](int, int j){ return j; },
+					[](otherwise, B){ return -1; },
+					[](otherwise, otherwise){ return 0; }
+				);
+
+				auto r2 = match(y, z,
+					[](int i, char){ return i; },
+					[](otherwise, otherwise){ return 0; }
+				);
+
+				int r3 = 0;
+				match(x, y, x,
+					[&](int& i, A&, int& k){ ++i; r3 = k; },
+					[](otherwise, otherwise, otherwise){}
+				);
+
+				return r1 == 3 && r2 == 0 && r3 == 4 && get<int>(x) == 4;
+			})
+		),
 		std::make_tuple(
 			std::string("Match expressions [&]"),
 			std::function<bool()>([]() -> bool {
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/sum_vector.h>
+#include <ftl/concepts/monoid.h>
+#include "sum_vector_tests.h"
+
+test_set sum_vector_tests{
+	std::string("sum_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back and operator[]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st = sum_type<int,std::string>;
+
+				sum_vector<int,std::string> v;
+				v.push_back(st{constructor<int>(), 1});
+				v.push_back(st{constructor<std::string>(), "foo"});
+				v.emplace_back<int>(2);
+
+				const st x{constructor<std::string>(), "bar"};
+				v.push_back(x);
+
+				return v.size() == 4
+					&& v.count<int>() == 2 && v.count<std::string>() == 2
+					&& v[0] == st{constructor<int>(), 1}
+					&& v[1] == st{constructor<std::string>(), "foo"}
+					&& v[2] == st{constructor<int>(), 2}
+					&& v[3] == x;
+			})
+		),
+		std::make_tuple(
+			std::string("match_all"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				sum_vector<int,float,std::string> v;
+				v.emplace_back<int>(1);
+				v.emplace_back<std::string>("ab");
+				v.emplace_back<float>(.5f);
+				v.emplace_back<int>(2);
+
+				int n = 0;
+				float f = 0;
+				v.match_all(
+					[&](int& x){ x *= 10; n += x; },
+					[&](float x){ f += x; },
+					[&](const std::string& s){ n += s.size(); }
+				);
+
+				int m = 0;
+				v.match_all(
+					[&](int x){ m += x; },
+					[](otherwise){}
+				);
+
+				return n == 32 && f == .5f && m == 30
+					&& v.column<int>() == std::vector<int>{10,20};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st = sum_type<int,std::string>;
+
+				sum_vector<int,std::string> v;
+				v.emplace_back<int>(1);
+				v.emplace_back<std::string>("ab");
+
+				auto r1 = [](const st& x) {
+					return x.match(
+						[](int i){ return i; },
+						[](const std::string& s){ return -int(s.size()); }
+					);
+				} % v;
+
+				auto r2 = [](const st& x) {
+					return x.match(
+						[](int i){ return st{constructor<std::string>(), i, 'a'}; },
+						[](const std::string& s){
+							return st{constructor<int>(), int(s.size())};
+						}
+					);
+				} % v;
+
+				return r1 == std::vector<int>{1,-2}
+					&& r2.size() == 2
+					&& r2[0] == st{constructor<std::string>(), "a"}
+					&& r2[1] == st{constructor<int>(), 2};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st = sum_type<int,std::string>;
+
+				sum_vector<int,std::string> v;
+				v.emplace_back<int>(1);
+				v.emplace_back<std::string>("two");
+				v.emplace_back<int>(3);
+
+				auto r = foldl(
+					[](std::string z, const st& x) {
+						return z + x.match(
+							[](int i){ return std::to_string(i); },
+							[](const std::string& s){ return s; }
+						);
+					},
+					std::string(),
+					v
+				);
+
+				return r == "1two3";
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using st = sum_type<int,std::string>;
+
+				sum_vector<int,std::string> v;
+				v.emplace_back<int>(1);
+				v.emplace_back<std::string>("two");
+				v.emplace_back<int>(3);
+
+				auto r = foldr(
+					[](const st& x, std::string z) {
+						return z + x.match(
+							[](int i){ return std::to_string(i); },
+							[](const std::string& s){ return s; }
+						);
+					},
+					std::string(),
+					v
+				);
+
+				return r == "3two1";
+			})
+		)
+	}
+};
+
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <ftl/trace.h>
+#include <ftl/future.h>
+#include <ftl/executor.h>
+#include <ftl/lazy.h>
+#include "trace_tests.h"
+
+namespace {
+	std::vector<ftl::trace_event> events_named(const std::string& name) {
+		std::vector<ftl::trace_event> r;
+		for(auto& e : ftl::trace_events()) {
+			if(name == e.name)
+				r.push_back(e);
+		}
+
+		return r;
+	}
+}
+
+test_set trace_tests{
+	std::string("trace"),
+	{
+		std::make_tuple(
+			std::string("traced records each call"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				auto f = ftl::traced("add one", [](int x){ return x + 1; });
+				bool results = f(1) == 2 && f(2) == 3;
+
+				auto es = events_named("add one");
+
+				return results && es.size() == 2
+					&& es[0].ready == es[0].start
+					&& es[0].start <= es[0].end
+					&& es[0].end <= es[1].start
+					&& es[0].thread == es[1].thread;
+			})
+		),
+		std::make_tuple(
+			std::string("traced records calls that throw"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				auto f = ftl::traced("fail", [](int) -> int {
+					throw std::runtime_error("fail");
+				});
+
+				bool threw = false;
+				try {
+					f(0);
+				}
+				catch(std::runtime_error&) {
+					threw = true;
+				}
+
+				return threw && events_named("fail").size() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("future stages on an executor"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				ftl::thread_pool pool(1);
+				ftl::promise<int> p;
+				auto f = p.get_future()
+					.then(pool, ftl::traced("double", [](int x){ return 2*x; }))
+					.then(ftl::traced("inc", [](int x){ return x+1; }));
+
+				p.set_value(4);
+				bool result = f.get() == 9;
+
+				auto d = events_named("double");
+				auto i = events_named("inc");
+
+				return result && d.size() == 1 && i.size() == 1
+					&& d[0].ready <= d[0].start
+					&& d[0].end <= i[0].end;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy thunks are traced when forced"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				ftl::lazy<int> l(ftl::traced("thunk", [](){ return 7; }));
+				bool deferred = events_named("thunk").empty();
+				bool forced = *l == 7 && *l == 7;
+
+				return deferred && forced && events_named("thunk").size() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("ring buffer keeps the latest calls"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				auto f = ftl::traced("tick", [](){});
+				for(int i = 0; i < FTL_TRACE_BUFFER_SIZE + 10; ++i) {
+					f();
+				}
+
+				return events_named("tick").size() == FTL_TRACE_BUFFER_SIZE;
+			})
+		),
+		std::make_tuple(
+			std::string("write_chrome_trace"),
+			std::function<bool()>([]() -> bool {
+				ftl::clear_trace();
+
+				ftl::thread_pool pool(1);
+				ftl::promise<int> p;
+				auto f = p.get_future()
+					.then(pool, ftl::traced("say \"hi\"", [](int x){ return x; }));
+				p.set_value(1);
+				f.get();
+
+				std::ostringstream os;
+				ftl::write_chrome_trace(os);
+				auto s = os.str();
+
+				return s.find("{\"traceEvents\":[") == 0
+					&& s.find("\"name\":\"say \\\"hi\\\"\",\"ph\":\"X\"")
+						!= std::string::npos
+					&& s.find("say \\\"hi\\\" (queued)") != std::string::npos;
+			})
+		)
+	}
+};
+
@@ -20,7 +20,11 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <vector>
+#include <string>
+#include <unordered_map>
 #include <ftl/tuple.h>
+#include <ftl/vector.h>
 #include "tuple_tests.h"
 
 test_set tuple_tests{
@@ -78,6 +82,108 @@ test_set tuple_tests{
 
 				return t == make_tuple(6, sum(5), prod(6));
 			})
+		),
+		std::make_tuple(
+			std::string("foldMaps"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<double> v{2., 4., 9., 1.};
+
+				auto stats = foldMaps(
+					v, minimum<double>, maximum<double>, sum<double>,
+					count<double>, mean<double>
+				);
+
+				return std::get<0>(stats) == 1.
+					&& std::get<1>(stats) == 9.
+					&& std::get<2>(stats) == 16.
+					&& std::get<3>(stats) == 4u
+					&& std::get<4>(stats) == 4.
+					&& stats == foldMap([](double x){
+						return std::make_tuple(
+							minimum(x), maximum(x), sum(x), count(x), mean(x)
+						);
+					}, v);
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[&&, no copies]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Neither copyable, nor default constructible
+				struct move_only {
+					explicit move_only(int x) : x(x) {}
+					move_only(move_only&&) = default;
+					move_only(const move_only&) = delete;
+
+					int x;
+				};
+
+				auto t = std::make_tuple(2, move_only(3), move_only(4));
+				auto r = [](int x){ return x*5; } % std::move(t);
+
+				return std::get<0>(r) == 10
+					&& std::get<1>(r).x == 3
+					&& std::get<2>(r).x == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("tuple_map_all"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct size_of {
+					size_t operator() (const std::string& s) const {
+						return s.size();
+					}
+
+					size_t operator() (const std::vector<int>& v) const {
+						return v.size();
+					}
+
+					size_t operator() (int x) const {
+						return size_t(x);
+					}
+				};
+
+				auto t = std::make_tuple(
+					std::string("abc"), std::vector<int>{1,2}, 7
+				);
+
+				std::vector<int> moved_to;
+				auto steal = [&](std::vector<int>&& v){
+					moved_to = std::move(v);
+					return 0;
+				};
+
+				auto u = tuple_map_all(size_of(), t);
+				auto w = tuple_map_all(steal, std::make_tuple(std::vector<int>{3}));
+
+				return u == std::make_tuple(size_t(3), size_t(2), size_t(7))
+					&& std::get<0>(w) == 0 && moved_to == std::vector<int>{3}
+					&& tuple_map_all(size_of(), std::tuple<>()) == std::tuple<>();
+			})
+		),
+		std::make_tuple(
+			std::string("tuple_hash"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using key = std::tuple<int,std::string>;
+				tuple_hash<key> h;
+
+				std::unordered_map<key,int,tuple_hash<key>> m;
+				m.emplace(std::make_tuple(1, std::string("a")), 1);
+				m.emplace(std::make_tuple(2, std::string("a")), 2);
+
+				return h(std::make_tuple(1, std::string("a")))
+						== h(std::make_tuple(1, std::string("a")))
+					&& h(std::make_tuple(1, std::string("a")))
+						!= h(std::make_tuple(2, std::string("a")))
+					&& m.at(std::make_tuple(2, std::string("a"))) == 2;
+			})
 		)
 	}
 };
@@ -20,7 +20,10 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
+#include <vector>
 #include <ftl/unordered_map.h>
+#include <ftl/concepts/monoid.h>
 #include "unordered_map_tests.h"
 
 test_set unordered_map_tests{
@@ -87,6 +90,82 @@ test_set unordered_map_tests{
 					make_pair(2,4)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("functor::map[keeps configuration]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::unordered_map<int,int> m;
+				m.max_load_factor(.5f);
+				for(int i = 0; i < 1000; ++i)
+					m.emplace(i, i);
+
+				auto r = [](int x){ return std::to_string(x); } % m;
+				auto t = [](int x){ return float(x); }
+					% std::unordered_map<int,int>(m);
+
+				return r.size() == 1000 && r.at(999) == "999"
+					&& r.max_load_factor() == .5f
+					&& r.bucket_count() == m.bucket_count()
+					&& t.size() == 1000 && t.at(10) == 10.f
+					&& t.max_load_factor() == .5f;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using map = std::unordered_map<int,int>;
+
+				const map m1{{1,1},{2,2}};
+				const map m2{{2,20},{3,30}};
+				const map r{{1,1},{2,2},{3,30}};
+
+				return (m1 ^ m2) == r
+					&& (map(m1) ^ m2) == r
+					&& (m1 ^ map(m2)) == r
+					&& (map(m1) ^ map(m2)) == r
+					&& (map{{2,2}} ^ map(m2)) == map{{2,2},{3,30}}
+					&& (map(m1) ^ ftl::monoid<map>::id()) == m1;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl and foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unordered_map<int,int> m{{1,1},{2,2},{3,3}};
+
+				auto l = foldl([](int z, int x){ return z*10 + x; }, 0, m);
+				auto r = foldr([](int x, int z){ return z*10 + x; }, 0, m);
+
+				// The order is unspecified, but foldr visits it in reverse
+				auto digits = [](int n) {
+					std::string s = std::to_string(n);
+					return std::string(s.rbegin(), s.rend());
+				};
+
+				return digits(l) == std::to_string(r)
+					&& foldMap(sum<int>, m) == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMapByKey"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1, 2, 3, 4, 5, 6, 7};
+
+				auto m = foldMapByKey<std::unordered_map>(
+					[](int x){ return x % 3; },
+					[](int x){ return sum(x); },
+					v
+				);
+
+				return m.size() == 3
+					&& m.at(0) == 9 && m.at(1) == 12 && m.at(2) == 7;
+			})
 		)
 	}
 };
@@ -21,7 +21,10 @@
  * distribution.
  */
 #include <ftl/vector.h>
+#include <ftl/maybe.h>
 #include <list>
+#include <memory>
+#include <string>
 #include "vector_tests.h"
 
 test_set vector_tests{
@@ -56,6 +59,41 @@ test_set vector_tests{
 				return v == std::vector<int>{4,3,6,5,8,7};
 			})
 		),
+		std::make_tuple(
+			std::string("concatMap[exact size]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				auto f = [](int x){ return std::vector<int>(size_t(x), x); };
+				std::vector<int> v{3,10,1,12};
+
+				auto v1 = ftl::concatMap(f, v);
+				auto v2 = v >>= f;
+				auto v3 = std::vector<int>{1,2} >>= [](int x) {
+					return ftl::just(x);
+				};
+
+				return v1.size() == 26 && v1.capacity() == 26
+					&& v2 == v1 && v2.capacity() == 26
+					&& v3 == std::vector<int>{1,2};
+			})
+		),
+		std::make_tuple(
+			std::string("concatMap[out]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> r;
+				r.reserve(6);
+
+				ftl::concatMap(
+					[](int x){ return std::vector<int>{x, -x}; },
+					std::vector<int>{1,2,3},
+					std::back_inserter(r)
+				);
+
+				return r == std::vector<int>{1,-1,2,-2,3,-3}
+					&& r.capacity() == 6;
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::id"),
 			std::function<bool()>([]() -> bool {
@@ -142,6 +180,19 @@ test_set vector_tests{
 				return v == std::vector<int>{2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1,2,3};
+				auto p = v.data();
+
+				auto r = [](int x){ return x*2; } % std::move(v);
+
+				return r.data() == p && r == std::vector<int>{2,4,6};
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -241,6 +292,87 @@ test_set vector_tests{
 				return fold(v) == 12;
 			})
 		),
+		std::make_tuple(
+			std::string("tree_foldMap[order]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v;
+				for(int i = 0; i < 37; ++i)
+					v.push_back(i);
+
+				std::vector<int> seen;
+				auto r = ftl::tree_foldMap(
+					[&seen](int x){
+						seen.push_back(x);
+						return std::vector<int>{x};
+					},
+					v
+				);
+
+				return r == v && seen == v
+					&& ftl::tree_fold(std::vector<std::vector<int>>{}).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("tree_foldMap[accuracy]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<float> v(1 << 22, .1f);
+				float exact = float(1 << 22) * .1f;
+
+				float tree = ftl::tree_foldMap(ftl::sum<float>, v);
+				float chain = ftl::foldMap(ftl::sum<float>, v);
+
+				auto err = [exact](float x){
+					return x > exact ? x - exact : exact - x;
+				};
+
+				return err(tree) < exact * 1e-5f && err(tree) < err(chain);
+			})
+		),
+		std::make_tuple(
+			std::string("tree_fold[absorbing]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(100, 1);
+				v[10] = 0;
+
+				int calls = 0;
+				bool r = ftl::tree_foldMap(
+					[&calls](int x){ ++calls; return ftl::all(x != 0); }, v
+				);
+
+				return !r && calls < 100;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold[contiguous]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<sum_monoid<int>> s;
+				std::vector<prod_monoid<double>> p;
+				for(int i = 0; i < 1003; ++i) {
+					s.push_back(sum(i - 500));
+					p.push_back(prod(i % 2 ? 2.0 : 0.5));
+				}
+
+				std::vector<any> a(1000, false);
+				std::vector<all> b(1000, true);
+				bool none = fold(a), every = fold(b);
+
+				a[999] = true;
+				b[70] = false;
+
+				int calls = 0;
+				auto any_even = foldMap([&](int x) {
+					++calls;
+					return any(x % 2 == 0);
+				}, std::vector<int>{1,3,4,5,7});
+
+				return fold(s) == 1003 && fold(p) == 0.5
+					&& any_even && calls == 3
+					&& !none && every && fold(a) && !fold(b)
+					&& fold(std::vector<any>{}) == false;
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zipWith[3,3]"),
 			std::function<bool()>([]() -> bool {
@@ -254,6 +386,107 @@ test_set vector_tests{
 				return v3 == std::vector<int>{3,4,5};
 			})
 		),
+		std::make_tuple(
+			std::string("zippable::zipWith[&&,&&]"),
+			std::function<bool()>([]() -> bool {
+				using up = std::unique_ptr<int>;
+
+				std::vector<up> v1;
+				std::vector<up> v2;
+				for(int i = 0; i < 3; ++i) {
+					v1.emplace_back(new int(i));
+					v2.emplace_back(new int(i*10));
+				}
+				v2.emplace_back(new int(0));
+
+				auto v3 = ftl::zipWith(
+					[](up x, up y){ return *x + *y; },
+					std::move(v1), std::move(v2)
+				);
+
+				return v3 == std::vector<int>{0,11,22} && v3.capacity() == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v1{"a","b","c"};
+				std::list<std::string> l{"x","y"};
+				auto p = v1.data();
+
+				auto v2 = ftl::zipWith(
+					[](std::string x, const std::string& y){ return x + y; },
+					std::move(v1), l
+				);
+
+				return v2 == std::vector<std::string>{"ax","by"}
+					&& v2.data() == p;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[3,4,2,3]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v1{1,2,3};
+				std::vector<float> v2{.5f,1.f,1.5f,2.f};
+				std::list<int> l{10,20};
+				auto v3 = ftl::zipWith(
+					[](int a, float b, int c, std::string d){
+						return d + std::to_string(int(float(a)*b) + c);
+					},
+					v1, v2, l, std::vector<std::string>{"a","b","c"}
+				);
+
+				return v3 == std::vector<std::string>{"a10","b22"}
+					&& v3.capacity() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zip[3,3,3]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v1{1,2,3};
+				std::vector<char> v2{'a','b','c'};
+				std::vector<std::string> v3{"x","y","z"};
+
+				auto v = ftl::zip(v1, v2, std::move(v3));
+
+				return v == std::vector<std::tuple<int,char,std::string>>{
+					std::make_tuple(1,'a',std::string("x")),
+					std::make_tuple(2,'b',std::string("y")),
+					std::make_tuple(3,'c',std::string("z"))
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("unzip"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::tuple<int,std::string,float>> rows{
+					std::make_tuple(1, std::string("a"), .5f),
+					std::make_tuple(2, std::string("b"), 1.f)
+				};
+
+				auto cols = ftl::unzip(rows);
+
+				return std::get<0>(cols) == std::vector<int>{1,2}
+					&& std::get<1>(cols) == std::vector<std::string>{"a","b"}
+					&& std::get<2>(cols) == std::vector<float>{.5f,1.f}
+					&& std::get<1>(cols).capacity() == 2
+					&& std::get<1>(rows[0]) == "a";
+			})
+		),
+		std::make_tuple(
+			std::string("unzip[&&,pairs]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::pair<std::unique_ptr<int>,char>> rows;
+				rows.emplace_back(std::unique_ptr<int>(new int(1)), 'x');
+				rows.emplace_back(std::unique_ptr<int>(new int(2)), 'y');
+
+				auto cols = ftl::unzip(std::move(rows));
+
+				auto& ps = std::get<0>(cols);
+				return ps.size() == 2 && *ps[0] == 1 && *ps[1] == 2
+					&& std::get<1>(cols) == std::vector<char>{'x','y'};
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zipWith[2,3]"),
 			std::function<bool()>([]() -> bool {
@@ -322,6 +555,70 @@ test_set vector_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("functor::map[arithmetic, contiguous]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				// Not a multiple of the block size, to cover the tail
+				std::vector<float> v(19);
+				for(size_t i = 0; i < v.size(); ++i)
+					v[i] = float(i);
+
+				auto r1 = fmap([](float x){ return 2.f*x + 1.f; }, v);
+				auto r2 = fmap(
+					[](std::string&& s){ return s.size(); },
+					std::vector<std::string>{"a", "bb", "", "dddd"}
+				);
+
+				bool ok = r1.size() == v.size();
+				for(size_t i = 0; i < v.size(); ++i)
+					ok = ok && r1[i] == 2.f*v[i] + 1.f;
+
+				return ok
+					&& r2 == std::vector<size_t>{1,2,0,4}
+					&& fmap([](float x){ return x; }, std::vector<float>{})
+						.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[arithmetic, contiguous]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> a(21), b(17);
+				for(size_t i = 0; i < a.size(); ++i)
+					a[i] = int(i);
+				for(size_t i = 0; i < b.size(); ++i)
+					b[i] = int(3*i);
+
+				auto r = zipWith([](int x, int y){ return x*y + 0.5; }, a, b);
+
+				bool ok = r.size() == b.size();
+				for(size_t i = 0; i < b.size(); ++i)
+					ok = ok && r[i] == a[i]*b[i] + 0.5;
+
+				return ok;
+			})
+		),
+		std::make_tuple(
+			std::string("partition"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto even = [](const std::string& s){ return s.size() % 2 == 0; };
+				std::vector<std::string> v{"a", "bb", "ccc", "dddd", "ee"};
+
+				auto r1 = partition(even, v);
+				auto r2 = partition(even, std::vector<std::string>(v));
+
+				return r1.first == std::vector<std::string>{"bb", "dddd", "ee"}
+					&& r1.second == std::vector<std::string>{"a", "ccc"}
+					&& r1.first.capacity() == 3 && r1.second.capacity() == 2
+					&& r2 == r1
+					&& partition(even, std::vector<std::string>{}).first.empty();
+			})
 		)
 	}
 };
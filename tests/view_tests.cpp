@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <vector>
+#include <list>
+#include <functional>
+#include <string>
+#include <climits>
+#include <ftl/view.h>
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include "view_tests.h"
+
+test_set view_tests{
+	std::string("view"),
+	{
+		std::make_tuple(
+			std::string("functor::map is lazy"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> xs{1,2,3,4,5};
+				int calls = 0;
+
+				auto v = [&calls](int x){ ++calls; return x*2; }
+					% ([](int x){ return x+1; } % ftl::make_view(xs));
+
+				bool lazy = calls == 0;
+				auto r = v.to<std::vector<int>>();
+
+				return lazy && calls == 5
+					&& r == std::vector<int>{4,6,8,10,12};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold in one pass"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> xs{1,2,3,4,5};
+				int calls = 0;
+
+				auto v = [&calls](int x){ ++calls; return ftl::sum(x*x); }
+					% ftl::make_view(xs);
+
+				auto r = ftl::fold(v);
+				auto l = ftl::foldr(
+					[](int x, int acc){ return acc*10 + x; }, 0,
+					ftl::make_view(xs)
+				);
+
+				return r == 55 && calls == 5 && l == 54321;
+			})
+		),
+		std::make_tuple(
+			std::string("filter"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> xs{1,2,3,4,5,6};
+
+				auto v = ftl::filter(
+					[](int x){ return x % 2 == 0; }, ftl::make_view(xs)
+				);
+
+				return v.to<std::list<int>>() == std::list<int>{2,4,6}
+					&& ftl::filter(
+						[](int){ return false; }, ftl::make_view(xs)
+					).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> xs{1,2,3,4};
+				std::list<int> ys{10,20,30};
+
+				auto v = ftl::zipWith(
+					[](int a, int b){ return a+b; }, ftl::make_view(xs), ys
+				);
+
+				return v.to<std::vector<int>>() == std::vector<int>{11,22,33};
+			})
+		),
+		std::make_tuple(
+			std::string("zip_view"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> a{1,2,3,4};
+				std::list<std::string> b{"a","b","c"};
+				const std::vector<float> c{.5f,1.f,1.5f};
+
+				static_assert(
+					ftl::ForwardIterable<decltype(ftl::zip_view(a, b, c))>(),
+					"zip_view must be ForwardIterable"
+				);
+
+				std::string s;
+				for(auto row : ftl::zip_view(a, b, c)) {
+					std::get<0>(row) *= 10;
+					s += std::get<1>(row);
+					s += std::to_string(int(std::get<2>(row)*2.f));
+				}
+
+				return s == "a1b2c3" && a == std::vector<int>{10,20,30,4};
+			})
+		),
+		std::make_tuple(
+			std::string("zip_view[functor,foldable]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using row = std::tuple<const int&,const int&>;
+
+				const std::vector<int> x{1,2,3};
+				const std::vector<int> y{4,5,6};
+
+				auto dots = [](row r){
+					return std::get<0>(r) * std::get<1>(r);
+				} % ftl::zip_view(x, y);
+
+				return ftl::foldl(
+					[](int acc, int d){ return acc + d; }, 0, dots
+				) == 32;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				std::vector<int> xs{1,2,3,4,5};
+
+				auto v = ftl::make_view(xs) >>= [](int x) {
+					return std::vector<int>(size_t(x % 3), x);
+				};
+
+				return v.to<std::vector<int>>()
+					== std::vector<int>{1,2,2,4,5,5};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::pure, join and apply"),
+			std::function<bool()>([]() -> bool {
+				using V = ftl::view<std::vector<int>::const_iterator>;
+				using W = ftl::view<std::vector<std::vector<int>>::const_iterator>;
+
+				std::vector<int> xs{1,2};
+				std::vector<std::vector<int>> xss{{1},{},{2,3}};
+				std::vector<std::function<int(int)>> fs{
+					[](int x){ return x+1; }, [](int x){ return -x; }
+				};
+
+				auto p = ftl::monad<V>::pure(7).to<std::vector<int>>();
+				auto j = ftl::monad<W>::join(ftl::make_view(xss));
+				auto a = ftl::applicative<V>::apply(
+					ftl::make_view(fs), ftl::make_view(xs)
+				);
+
+				return p == std::vector<int>{7}
+					&& j.to<std::vector<int>>() == std::vector<int>{1,2,3}
+					&& a.to<std::vector<int>>() == std::vector<int>{2,3,-1,-2};
+			})
+		),
+		std::make_tuple(
+			std::string("iterate, take and foldl"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				auto dbl = [&calls](int x){ ++calls; return 2*x; };
+
+				auto v = ftl::take(4, ftl::iterate(dbl, 1));
+				auto s = ftl::foldl(std::plus<int>(), 0, v);
+
+				// The value past the fourth is never computed
+				return s == 15 && calls == 3
+					&& ftl::take(0, ftl::iterate(dbl, 1)).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("unfoldr"),
+			std::function<bool()>([]() -> bool {
+				auto digits = ftl::unfoldr(
+					[](int n){
+						return n == 0
+							? ftl::nothing<std::pair<int,int>>()
+							: ftl::just(std::make_pair(n % 10, n / 10));
+					},
+					1234
+				);
+
+				auto none = ftl::unfoldr(
+					[](int){ return ftl::nothing<std::tuple<int,int>>(); }, 0
+				);
+
+				return digits.to<std::vector<int>>() == std::vector<int>{4,3,2,1}
+					&& none.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("range and replicate"),
+			std::function<bool()>([]() -> bool {
+				auto count = [](int n, int){ return n+1; };
+				signed char lo = SCHAR_MIN, hi = SCHAR_MAX, m = -1;
+
+				return ftl::range(0, 4).to<std::vector<int>>()
+					== std::vector<int>{0,1,2,3}
+					&& ftl::range(10, 0, -3).to<std::vector<int>>()
+					== std::vector<int>{10,7,4,1}
+					&& ftl::range(0., 1., .25).to<std::vector<double>>()
+					== std::vector<double>{0.,.25,.5,.75}
+					&& ftl::range(3, 3).empty()
+					&& ftl::foldl(count, 0, ftl::range(lo, hi)) == 255
+					&& ftl::foldl(count, 0, ftl::range(hi, lo, m)) == 255
+					&& ftl::foldl(count, 0, ftl::range(INT_MIN, INT_MAX, 1<<30)) == 4
+					&& ftl::replicate(3, std::string("a")).to<std::vector<std::string>>()
+					== std::vector<std::string>{"a","a","a"};
+			})
+		),
+		std::make_tuple(
+			std::string("generators map and zip"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto sq = [](int x){ return x*x; } % ftl::take(3, ftl::range(1, 100));
+				auto z = ftl::zipWith(
+					std::plus<int>(), ftl::range(0, 5), ftl::replicate(3, 10)
+				);
+
+				return sq.to<std::vector<int>>() == std::vector<int>{1,4,9}
+					&& z.to<std::vector<int>>() == std::vector<int>{10,11,12};
+			})
+		)
+	}
+};